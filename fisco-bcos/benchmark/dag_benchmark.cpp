@@ -0,0 +1,205 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ *
+ * @file dag_benchmark.cpp
+ *
+ * schedules the conflict graph of DagTransferPrecompiled transactions by TxDAG. A graph file has
+ * the criticals of a transaction in a line separated by spaces, "*" for the transaction conflicts
+ * with all transactions, the criticals of DagTransferPrecompiled are the users of the transaction.
+ * If no graph file is given, transfers between random users are generated
+ */
+
+#include "libblockverifier/TxDAG.h"
+#include "libinitializer/Initializer.h"
+#include <libdevcrypto/Hash.h>
+#include <tbb/parallel_for.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::blockverifier;
+using namespace dev::initializer;
+
+namespace po = boost::program_options;
+
+using TxsCriticals = std::vector<std::shared_ptr<std::vector<std::string>>>;
+
+po::options_description main_options("Main for DAG benchmark");
+
+po::variables_map initCommandLine(int argc, const char* argv[])
+{
+    main_options.add_options()("help,h", "help of DAG benchmark")("graph,g",
+        po::value<string>()->default_value(""), "the file of the recorded graph")("output,o",
+        po::value<string>()->default_value(""), "write the generated graph to the file")("users,u",
+        po::value<int>()->default_value(10000), "the number of users of generated transfers")(
+        "txs,t", po::value<int>()->default_value(10000), "the number of generated transfers")(
+        "hot,r", po::value<int>()->default_value(0),
+        "percentage of generated transfers from the hot user")("work,w",
+        po::value<int>()->default_value(200), "sha3 rounds of a transaction")("threads,n",
+        po::value<int>()->default_value(std::thread::hardware_concurrency()),
+        "the number of executing threads")(
+        "rounds,c", po::value<int>()->default_value(5), "the number of rounds");
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, main_options), vm);
+        po::notify(vm);
+    }
+    catch (...)
+    {
+        std::cout << "invalid input" << std::endl;
+        exit(0);
+    }
+    if (vm.count("help") || vm.count("h"))
+    {
+        std::cout << main_options << std::endl;
+        exit(0);
+    }
+    return vm;
+}
+
+TxsCriticals loadGraph(string const& _path)
+{
+    TxsCriticals txsCriticals;
+    ifstream graph(_path);
+    string line;
+    while (getline(graph, line))
+    {
+        boost::trim(line);
+        if (line == "*")
+        {
+            txsCriticals.push_back(nullptr);
+            continue;
+        }
+        auto criticals = make_shared<vector<string>>();
+        boost::split(*criticals, line, boost::is_any_of(" "), boost::token_compress_on);
+        txsCriticals.push_back(criticals);
+    }
+    return txsCriticals;
+}
+
+TxsCriticals generateGraph(int _users, int _txs, int _hot)
+{
+    TxsCriticals txsCriticals;
+    srand(0);
+    for (int i = 0; i < _txs; ++i)
+    {
+        auto from = rand() % 100 < _hot ? 0 : rand() % _users;
+        auto to = rand() % _users;
+        auto criticals = make_shared<vector<string>>();
+        criticals->push_back("user" + to_string(from));
+        if (to != from)
+        {
+            criticals->push_back("user" + to_string(to));
+        }
+        txsCriticals.push_back(criticals);
+    }
+    return txsCriticals;
+}
+
+void saveGraph(string const& _path, TxsCriticals const& _txsCriticals)
+{
+    ofstream graph(_path);
+    for (auto& criticals : _txsCriticals)
+    {
+        graph << (criticals ? boost::join(*criticals, " ") : string("*")) << "\n";
+    }
+}
+
+int main(int argc, const char* argv[])
+{
+    boost::property_tree::ptree pt;
+    auto logInitializer = std::make_shared<LogInitializer>();
+    logInitializer->initLog(pt);
+    auto params = initCommandLine(argc, argv);
+    auto graphPath = params["graph"].as<string>();
+    auto outputPath = params["output"].as<string>();
+    auto work = params["work"].as<int>();
+    auto threads = std::max(params["threads"].as<int>(), 1);
+    auto rounds = params["rounds"].as<int>();
+
+    auto txsCriticals = graphPath.empty() ?
+                            generateGraph(params["users"].as<int>(), params["txs"].as<int>(),
+                                params["hot"].as<int>()) :
+                            loadGraph(graphPath);
+    if (!outputPath.empty())
+    {
+        saveGraph(outputPath, txsCriticals);
+    }
+    auto txs = make_shared<Transactions>();
+    for (size_t i = 0; i < txsCriticals.size(); ++i)
+    {
+        txs->push_back(make_shared<Transaction>());
+    }
+
+    // the time of a transaction
+    auto start = std::chrono::steady_clock::now();
+    h256 digest;
+    for (int i = 0; i < work; ++i)
+    {
+        digest = sha3(digest);
+    }
+    auto txTime =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    cout << "txs=" << txs->size() << " threads=" << threads << " work=" << work << endl;
+    double totalTime = 0;
+    for (int round = 0; round < rounds; ++round)
+    {
+        start = std::chrono::steady_clock::now();
+        auto txDag = make_shared<TxDAG>();
+        txDag->init(txs, txsCriticals, round);
+        auto initTime =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        vector<h256> digests(txs->size());
+        txDag->setTxExecuteFunc([&](Transaction::Ptr, ID _txId, executive::Executive::Ptr) {
+            h256 txDigest(_txId);
+            for (int i = 0; i < work; ++i)
+            {
+                txDigest = sha3(txDigest);
+            }
+            digests[_txId] = txDigest;
+            return true;
+        });
+        tbb::parallel_for(tbb::blocked_range<int>(0, threads), [&](tbb::blocked_range<int> const&) {
+            while (!txDag->hasFinished())
+            {
+                txDag->executeUnit(nullptr);
+            }
+        });
+        auto elapsed =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        totalTime += elapsed;
+
+        // no schedule is faster than the critical path or all transactions on all threads
+        auto bound = std::max(txDag->criticalPathLength() * txTime, txs->size() * txTime / threads);
+        cout << "round=" << round << std::setiosflags(std::ios::fixed) << std::setprecision(3)
+             << " init(ms)=" << initTime * 1000 << " execute(ms)=" << elapsed * 1000
+             << " tps=" << txs->size() / elapsed
+             << " criticalPath=" << txDag->criticalPathLength()
+             << " serialTxs=" << txDag->serialTxsNumber() << " efficiency=" << bound / elapsed
+             << endl;
+    }
+    cout << "total tps=" << txs->size() * rounds / totalTime << endl;
+    return 0;
+}
@@ -0,0 +1,170 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ *
+ * @file entry_benchmark.cpp
+ */
+
+#include "libinitializer/Initializer.h"
+#include "libstorage/Table.h"
+#include <boost/program_options.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <new>
+
+using namespace std;
+using namespace dev;
+using namespace dev::storage;
+using namespace dev::initializer;
+
+namespace po = boost::program_options;
+
+// bytes requested from the heap, the size of every block is kept before it to count frees
+static std::atomic<int64_t> g_heapBytes(0);
+
+void* operator new(size_t _size)
+{
+    auto block = static_cast<size_t*>(malloc(_size + sizeof(max_align_t)));
+    if (!block)
+    {
+        throw std::bad_alloc();
+    }
+    *block = _size;
+    g_heapBytes += _size;
+    return reinterpret_cast<char*>(block) + sizeof(max_align_t);
+}
+
+void operator delete(void* _ptr) noexcept
+{
+    if (_ptr)
+    {
+        auto block = reinterpret_cast<size_t*>(static_cast<char*>(_ptr) - sizeof(max_align_t));
+        g_heapBytes -= *block;
+        free(block);
+    }
+}
+
+void operator delete(void* _ptr, size_t) noexcept
+{
+    operator delete(_ptr);
+}
+
+po::options_description main_options("Main for Entry benchmark");
+
+po::variables_map initCommandLine(int argc, const char* argv[])
+{
+    main_options.add_options()("help,h", "help of Entry benchmark")("entries,e",
+        po::value<int>()->default_value(200000), "the number of entries")("fields,f",
+        po::value<int>()->default_value(2), "value fields of every entry besides the key")(
+        "value,v", po::value<int>()->default_value(32), "the length of value");
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, main_options), vm);
+        po::notify(vm);
+    }
+    catch (...)
+    {
+        std::cout << "invalid input" << std::endl;
+        exit(0);
+    }
+    if (vm.count("help") || vm.count("h"))
+    {
+        std::cout << main_options << std::endl;
+        exit(0);
+    }
+    return vm;
+}
+
+int main(int argc, const char* argv[])
+{
+    boost::property_tree::ptree pt;
+    auto logInitializer = std::make_shared<LogInitializer>();
+    logInitializer->initLog(pt);
+    auto params = initCommandLine(argc, argv);
+    auto entryCount = params["entries"].as<int>();
+    auto fieldCount = params["fields"].as<int>();
+    auto valueLength = params["value"].as<int>();
+
+    vector<string> fields;
+    for (int k = 0; k < fieldCount; ++k)
+    {
+        fields.push_back("value" + to_string(k));
+    }
+    string value(valueLength, '0');
+    for (auto& c : value)
+    {
+        c = '0' + rand() % 10;
+    }
+
+    auto performance = [&](const string& description, std::function<void()> operation) {
+        auto now = std::chrono::steady_clock::now();
+        operation();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - now;
+        cout << "time used(s)=" << std::setiosflags(std::ios::fixed) << std::setprecision(3)
+             << elapsed.count() << " rounds=" << entryCount
+             << " ns/op=" << elapsed.count() * 1e9 / entryCount << "|" << description << endl;
+    };
+
+    vector<Entry::Ptr> entries(entryCount);
+    auto heapBytes = g_heapBytes.load();
+    performance("setField", [&]() {
+        for (int i = 0; i < entryCount; ++i)
+        {
+            auto entry = make_shared<Entry>();
+            entry->setField("key", to_string(i));
+            for (auto const& field : fields)
+            {
+                entry->setField(field, value);
+            }
+            entries[i] = entry;
+        }
+    });
+    cout << "heap bytes per entry=" << (g_heapBytes.load() - heapBytes) / entryCount << endl;
+
+    size_t found = 0;
+    performance("getField", [&]() {
+        for (int i = 0; i < entryCount; ++i)
+        {
+            found += entries[i]->getField(fields.back()).size();
+        }
+    });
+
+    auto condition = make_shared<Condition>();
+    condition->EQ("key", "0");
+    for (auto const& field : fields)
+    {
+        condition->EQ(field, value);
+    }
+    performance("Condition::process", [&]() {
+        for (int i = 0; i < entryCount; ++i)
+        {
+            found += condition->process(entries[i]);
+        }
+    });
+
+    performance("copyFrom and setField", [&]() {
+        for (int i = 0; i < entryCount; ++i)
+        {
+            auto entry = make_shared<Entry>();
+            entry->copyFrom(entries[i]);
+            entry->setField(fields.front(), value);
+        }
+    });
+    cout << "entries=" << entryCount << " fields=" << fieldCount + 1
+         << " value length(B)=" << valueLength << " checksum=" << found << endl;
+    return 0;
+}
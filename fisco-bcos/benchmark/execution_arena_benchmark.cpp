@@ -0,0 +1,278 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ *
+ * @file execution_arena_benchmark.cpp
+ *
+ * executes blocks of DagTransferPrecompiled transfers and of transfers of an EVM contract with
+ * the arena disabled and enabled, and reports the heap allocations of a transaction, the
+ * allocations from the arena and its chunks. Every thread allocates chunks of its own, so the
+ * heap allocations left are where the executing threads contend for the allocator
+ *
+ * the EVM contract keeps the balances in storage, the call data is from, to and amount as 32
+ * bytes words, the runtime code is
+ *     PUSH1 0x40 CALLDATALOAD PUSH1 0 CALLDATALOAD DUP2 DUP2 SLOAD SUB SWAP1 SSTORE
+ *     PUSH1 0x20 CALLDATALOAD DUP1 SLOAD DUP3 ADD SWAP1 SSTORE POP STOP
+ */
+
+#include "libblockchain/BlockChainImp.h"
+#include "libblockverifier/BlockVerifier.h"
+#include "libinitializer/Initializer.h"
+#include "libledger/DBInitializer.h"
+#include <libdevcore/CommonData.h>
+#include <libethcore/ABI.h>
+#include <boost/program_options.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::ledger;
+using namespace dev::blockchain;
+using namespace dev::blockverifier;
+using namespace dev::initializer;
+
+namespace
+{
+std::atomic<uint64_t> g_heapAllocations{0};
+}  // namespace
+
+void* operator new(size_t _size)
+{
+    g_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    auto pointer = malloc(_size);
+    if (!pointer)
+    {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void operator delete(void* _pointer) noexcept
+{
+    free(_pointer);
+}
+
+namespace po = boost::program_options;
+
+po::options_description main_options("Main for execution arena benchmark");
+
+po::variables_map initCommandLine(int argc, const char* argv[])
+{
+    main_options.add_options()("help,h", "help of execution arena benchmark")("path,p",
+        po::value<string>()->default_value("benchmark/arena/"), "[RocksDB path]")("users,u",
+        po::value<int>()->default_value(10000), "the number of users")("txs,t",
+        po::value<int>()->default_value(5000), "the number of transfers of a block")("blocks,b",
+        po::value<int>()->default_value(5), "the number of blocks of a workload")("parallel,e",
+        po::value<bool>()->default_value(true), "execute the transactions in parallel");
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, main_options), vm);
+        po::notify(vm);
+    }
+    catch (...)
+    {
+        std::cout << "invalid input" << std::endl;
+        exit(0);
+    }
+    if (vm.count("help") || vm.count("h"))
+    {
+        std::cout << main_options << std::endl;
+        exit(0);
+    }
+    return vm;
+}
+
+class ArenaBenchmark
+{
+public:
+    ArenaBenchmark(string const& _path, bool _enableArena, bool _enableParallel)
+      : m_enableArena(_enableArena)
+    {
+        auto params = std::make_shared<LedgerParam>();
+        params->mutableStorageParam().type = "RocksDB";
+        params->mutableStorageParam().path = _path;
+        params->mutableStateParam().type = "storage";
+        params->mutableTxParam().enableArena = _enableArena;
+        m_dbInitializer = std::make_shared<DBInitializer>(params, 1);
+        m_dbInitializer->initStorageDB();
+        m_blockChain = std::make_shared<BlockChainImp>();
+        m_blockChain->setStateStorage(m_dbInitializer->storage());
+        m_blockChain->setTableFactoryFactory(m_dbInitializer->tableFactoryFactory());
+        GenesisBlockParam initParam = {"", dev::h512s(), dev::h512s(), "consensusType",
+            "storageType", "stateType", 5000, 300000000, 0, -1, -1, 0};
+        m_blockChain->checkAndBuildGenesisBlock(initParam);
+        m_dbInitializer->initState(m_blockChain->getBlockByNumber(0)->headerHash());
+
+        m_blockVerifier = std::make_shared<BlockVerifier>(_enableParallel);
+        m_blockVerifier->setExecutiveContextFactory(m_dbInitializer->executiveContextFactory());
+        auto blockChain = m_blockChain;
+        m_blockVerifier->setNumberHash(
+            [blockChain](int64_t _number) { return blockChain->numberHash(_number); });
+    }
+
+    Transaction::Ptr newTransaction(Address const& _dest, bytes const& _data)
+    {
+        auto tx = std::make_shared<Transaction>(0, 0, 10000000, _dest, _data, u256(m_nonce++));
+        tx->setBlockLimit(m_blockChain->number() + 100);
+        tx->forceSender(Address(0x2333));
+        return tx;
+    }
+
+    Transaction::Ptr newDeployment(bytes const& _code)
+    {
+        auto tx = std::make_shared<Transaction>(0, 0, 10000000, _code, u256(m_nonce++));
+        tx->setBlockLimit(m_blockChain->number() + 100);
+        tx->forceSender(Address(0x2333));
+        return tx;
+    }
+
+    // executes and commits a block, returns the receipts
+    shared_ptr<TransactionReceipts> execute(shared_ptr<Transactions> _txs, string const& _name)
+    {
+        auto parent = m_blockChain->getBlockByNumber(m_blockChain->number());
+        BlockInfo parentInfo = {
+            parent->header().hash(), parent->header().number(), parent->header().stateRoot()};
+        auto block = std::make_shared<Block>();
+        block->header().setNumber(parentInfo.number + 1);
+        block->header().setParentHash(parentInfo.hash);
+        block->setTransactions(_txs);
+        for (auto& tx : *block->transactions())
+        {
+            tx->sender();
+        }
+
+        auto heapAllocations = g_heapAllocations.load();
+        auto start = std::chrono::steady_clock::now();
+        auto context = m_blockVerifier->executeBlock(*block, parentInfo);
+        auto elapsed =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        heapAllocations = g_heapAllocations.load() - heapAllocations;
+
+        auto arena = context->getMemoryTableFactory()->arena();
+        if (!_name.empty())
+        {
+            auto txs = _txs->size();
+            cout << (m_enableArena ? "arena " : "heap  ") << _name << " block="
+                 << block->header().number() << std::setiosflags(std::ios::fixed)
+                 << std::setprecision(1) << " heapAllocations/tx=" << double(heapAllocations) / txs
+                 << " arenaAllocations/tx=" << (arena ? double(arena->allocations()) / txs : 0)
+                 << " arenaChunks=" << (arena ? arena->chunks() : 0)
+                 << " arenaMemory(KB)=" << (arena ? arena->memorySize() / 1024 : 0)
+                 << " tps=" << txs / elapsed << endl;
+            m_elapsed += elapsed;
+            m_heapAllocations += heapAllocations;
+            m_txs += txs;
+        }
+        m_blockChain->commitBlock(block, context);
+        return block->transactionReceipts();
+    }
+
+    void runDagTransfer(int _users, int _txs, int _blocks)
+    {
+        Address dagTransfer(0x5002);
+        ContractABI abi;
+        auto txs = std::make_shared<Transactions>();
+        for (int i = 0; i < _users; ++i)
+        {
+            txs->push_back(newTransaction(
+                dagTransfer, abi.abiIn("userSave(string,uint256)", to_string(i), u256(1000000))));
+        }
+        execute(txs, "");
+        srand(0);
+        for (int block = 0; block < _blocks; ++block)
+        {
+            txs = std::make_shared<Transactions>();
+            for (int i = 0; i < _txs; ++i)
+            {
+                auto from = rand() % _users;
+                auto to = (from + 1 + rand() % (_users - 1)) % _users;
+                txs->push_back(newTransaction(dagTransfer,
+                    abi.abiIn("userTransfer(string,string,uint256)", to_string(from),
+                        to_string(to), u256(1))));
+            }
+            execute(txs, "dagTransfer");
+        }
+    }
+
+    void runEVMTransfer(int _users, int _txs, int _blocks)
+    {
+        auto txs = std::make_shared<Transactions>();
+        txs->push_back(newDeployment(fromHex(
+            "601780600b6000396000f3"
+            "6040356000358181540390556020358054820190555000")));
+        auto receipts = execute(txs, "");
+        auto contract = (*receipts)[0]->contractAddress();
+        srand(0);
+        for (int block = 0; block < _blocks; ++block)
+        {
+            txs = std::make_shared<Transactions>();
+            for (int i = 0; i < _txs; ++i)
+            {
+                auto from = rand() % _users;
+                auto to = (from + 1 + rand() % (_users - 1)) % _users;
+                bytes data = h256(from).asBytes() + h256(to).asBytes() + h256(1).asBytes();
+                txs->push_back(newTransaction(contract, data));
+            }
+            execute(txs, "evmTransfer");
+        }
+    }
+
+    void report()
+    {
+        cout << (m_enableArena ? "arena " : "heap  ") << "total heapAllocations/tx="
+             << double(m_heapAllocations) / m_txs << " tps=" << m_txs / m_elapsed << endl;
+    }
+
+private:
+    bool m_enableArena;
+    std::shared_ptr<DBInitializer> m_dbInitializer;
+    std::shared_ptr<BlockChainImp> m_blockChain;
+    std::shared_ptr<BlockVerifier> m_blockVerifier;
+    int64_t m_nonce = 0;
+    double m_elapsed = 0;
+    uint64_t m_heapAllocations = 0;
+    uint64_t m_txs = 0;
+};
+
+int main(int argc, const char* argv[])
+{
+    boost::property_tree::ptree pt;
+    auto logInitializer = std::make_shared<LogInitializer>();
+    logInitializer->initLog(pt);
+    auto params = initCommandLine(argc, argv);
+    auto path = params["path"].as<string>() + to_string(utcTime());
+    auto users = params["users"].as<int>();
+    auto txs = params["txs"].as<int>();
+    auto blocks = params["blocks"].as<int>();
+    auto parallel = params["parallel"].as<bool>();
+
+    cout << "users=" << users << " txs=" << txs << " blocks=" << blocks
+         << " parallel=" << parallel << endl;
+    for (auto enableArena : {false, true})
+    {
+        ArenaBenchmark benchmark(
+            path + (enableArena ? "/arena" : "/heap"), enableArena, parallel);
+        benchmark.runDagTransfer(users, txs, blocks);
+        benchmark.runEVMTransfer(users, txs, blocks);
+        benchmark.report();
+    }
+    return 0;
+}
@@ -0,0 +1,227 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ *
+ * @file parallel_execution_benchmark.cpp
+ *
+ * transfers between accounts of a table executed serially and by OptimisticExecutor on the same
+ * state, the hashes of both must be the same. A transfer hashes its balances repeatedly to stand
+ * for the work of a contract
+ */
+
+#include "libblockverifier/OptimisticExecutor.h"
+#include "libinitializer/Initializer.h"
+#include "libledger/DBInitializer.h"
+#include "libstorage/CachedStorage.h"
+#include "libstorage/MemoryTableFactoryFactory2.h"
+#include "libstorage/SpeculativeTableFactory.h"
+#include <libdevcrypto/Hash.h>
+#include <boost/lexical_cast.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+
+using namespace std;
+using namespace dev;
+using namespace dev::ledger;
+using namespace dev::storage;
+using namespace dev::blockverifier;
+using namespace dev::initializer;
+
+namespace po = boost::program_options;
+
+po::options_description main_options("Main for parallel execution benchmark");
+
+po::variables_map initCommandLine(int argc, const char* argv[])
+{
+    main_options.add_options()("help,h", "help of parallel execution benchmark")("path,p",
+        po::value<string>()->default_value("benchmark/parallel/"), "[RocksDB path]")("cache,c",
+        po::value<int>()->default_value(256),
+        "memory size(MB) of CachedStorage, if 0 then no CachedStorage")("accounts,a",
+        po::value<int>()->default_value(10000), "the number of accounts")("txs,t",
+        po::value<int>()->default_value(2000), "the number of transfers of a block")("blocks,b",
+        po::value<int>()->default_value(5), "the number of blocks")("conflict,r",
+        po::value<int>()->default_value(0),
+        "percentage of transfers from one hot account, which conflict with each other")("work,w",
+        po::value<int>()->default_value(1000), "sha3 rounds of a transfer");
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, main_options), vm);
+        po::notify(vm);
+    }
+    catch (...)
+    {
+        std::cout << "invalid input" << std::endl;
+        exit(0);
+    }
+    if (vm.count("help") || vm.count("h"))
+    {
+        std::cout << main_options << std::endl;
+        exit(0);
+    }
+    return vm;
+}
+
+struct Transfer
+{
+    string from;
+    string to;
+};
+
+int main(int argc, const char* argv[])
+{
+    boost::property_tree::ptree pt;
+    auto logInitializer = std::make_shared<LogInitializer>();
+    logInitializer->initLog(pt);
+    auto params = initCommandLine(argc, argv);
+    auto storagePath = params["path"].as<string>() + to_string(utcTime());
+    auto cacheSize = params["cache"].as<int>();
+    bool useCachedStorage = cacheSize == 0 ? false : true;
+    auto accounts = params["accounts"].as<int>();
+    auto txs = params["txs"].as<int>();
+    auto blocks = params["blocks"].as<int>();
+    auto conflict = params["conflict"].as<int>();
+    auto work = params["work"].as<int>();
+    int64_t blockNumber = 0;
+    string tableName("t_parallel");
+
+    auto rocksdbStorage = createRocksDBStorage(storagePath, false, false, useCachedStorage);
+    Storage::Ptr storage = rocksdbStorage;
+    if (useCachedStorage)
+    {
+        int16_t groupID = 1;
+        auto cachedStorage = std::make_shared<CachedStorage>(groupID);
+        cachedStorage->setBackend(rocksdbStorage);
+        cachedStorage->setMaxCapacity(cacheSize * 1024 * 1024);  // Bytes
+        cachedStorage->setMaxForwardBlock(1);
+        cachedStorage->init();
+        storage = cachedStorage;
+    }
+    auto tableFactoryFactory = std::make_shared<dev::storage::MemoryTableFactoryFactory2>();
+    tableFactoryFactory->setStorage(storage);
+
+    auto commitData = [&](TableFactory::Ptr tableFactory, int64_t block) {
+        auto statetable = tableFactory->openTable(SYS_CURRENT_STATE);
+        auto entry = statetable->newEntry();
+        entry->setField(SYS_VALUE, to_string(block));
+        entry->setField(SYS_KEY, SYS_KEY_CURRENT_NUMBER);
+        if (block == 0)
+        {
+            statetable->insert(SYS_KEY_CURRENT_NUMBER, entry);
+        }
+        else
+        {
+            statetable->update(SYS_KEY_CURRENT_NUMBER, entry, statetable->newCondition());
+        }
+        tableFactory->commitDB(h256(0), block);
+    };
+
+    auto tableFactory = tableFactoryFactory->newTableFactory(dev::h256(), blockNumber);
+    auto table = tableFactory->createTable(tableName, "key", "value", false);
+    for (int i = 0; i < accounts; ++i)
+    {
+        auto entry = table->newEntry();
+        entry->setField("value", to_string(1000000));
+        table->insert(to_string(i), entry);
+    }
+    commitData(tableFactory, blockNumber++);
+
+    auto transfer = [&](TableFactory& _tableFactory, Transfer const& _transfer) {
+        auto table = _tableFactory.openTable(tableName);
+        auto from = table->select(_transfer.from, table->newCondition());
+        auto to = table->select(_transfer.to, table->newCondition());
+        auto fromValue = from->get(0)->getField("value");
+        auto toValue = to->get(0)->getField("value");
+        h256 digest = sha3(fromValue + toValue);
+        for (int i = 1; i < work; ++i)
+        {
+            digest = sha3(digest);
+        }
+        auto amount = int64_t(digest[0] % 10 + 1);
+        auto entry = table->newEntry();
+        entry->setField("value", to_string(boost::lexical_cast<int64_t>(fromValue) - amount));
+        table->update(_transfer.from, entry, table->newCondition());
+        entry = table->newEntry();
+        entry->setField("value", to_string(boost::lexical_cast<int64_t>(toValue) + amount));
+        table->update(_transfer.to, entry, table->newCondition());
+    };
+
+    auto elapsed = [](std::chrono::steady_clock::time_point const& _start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+    };
+
+    cout << "accounts=" << accounts << " txs=" << txs << " conflict(%)=" << conflict
+         << " work=" << work << endl;
+    srand(0);
+    double serialTime = 0;
+    double optimisticTime = 0;
+    for (int block = 0; block < blocks; ++block)
+    {
+        vector<Transfer> transfers;
+        for (int i = 0; i < txs; ++i)
+        {
+            auto from = rand() % 100 < conflict ? 0 : rand() % accounts;
+            auto to = rand() % accounts;
+            transfers.push_back(Transfer{to_string(from), to_string(to == from ? 1 : to)});
+        }
+
+        auto serialFactory = tableFactoryFactory->newTableFactory(dev::h256(), blockNumber);
+        auto start = std::chrono::steady_clock::now();
+        for (auto& t : transfers)
+        {
+            transfer(*serialFactory, t);
+            serialFactory->commit();
+        }
+        auto serialHash = serialFactory->hash();
+        auto serialElapsed = elapsed(start);
+
+        tableFactory = tableFactoryFactory->newTableFactory(dev::h256(), blockNumber);
+        start = std::chrono::steady_clock::now();
+        OptimisticExecutor executor(std::dynamic_pointer_cast<MemoryTableFactory2>(tableFactory));
+        executor.run(
+            transfers.size(),
+            [&](size_t _index) {
+                auto speculativeFactory = std::make_shared<SpeculativeTableFactory>();
+                speculativeFactory->setStateStorage(storage);
+                speculativeFactory->setBlockNum(blockNumber);
+                transfer(*speculativeFactory, transfers[_index]);
+                return speculativeFactory;
+            },
+            [&](size_t _index) { transfer(*tableFactory, transfers[_index]); });
+        auto optimisticHash = tableFactory->hash();
+        auto optimisticElapsed = elapsed(start);
+
+        serialTime += serialElapsed;
+        optimisticTime += optimisticElapsed;
+        cout << "block=" << blockNumber << std::setiosflags(std::ios::fixed)
+             << std::setprecision(3) << " serial tps=" << txs / serialElapsed
+             << " optimistic tps=" << txs / optimisticElapsed
+             << " speedup=" << serialElapsed / optimisticElapsed
+             << " reexecuted=" << executor.reexecutedNumber()
+             << (serialHash == optimisticHash ? "" : " HASH MISMATCH") << endl;
+        if (serialHash != optimisticHash)
+        {
+            return 1;
+        }
+        commitData(tableFactory, blockNumber++);
+    }
+    cout << "total serial tps=" << txs * blocks / serialTime
+         << " optimistic tps=" << txs * blocks / optimisticTime
+         << " speedup=" << serialTime / optimisticTime << endl;
+    return 0;
+}
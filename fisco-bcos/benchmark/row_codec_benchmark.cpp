@@ -0,0 +1,172 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ *
+ * @file row_codec_benchmark.cpp
+ */
+
+#include "libinitializer/Initializer.h"
+#include "libstorage/BasicRocksDB.h"
+#include "libstorage/RowCodec.h"
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+#include <cstdlib>
+#include <functional>
+
+using namespace std;
+using namespace dev;
+using namespace dev::storage;
+using namespace dev::initializer;
+
+namespace po = boost::program_options;
+
+po::options_description main_options("Main for RocksDB row codec benchmark");
+
+po::variables_map initCommandLine(int argc, const char* argv[])
+{
+    main_options.add_options()("help,h", "help of row codec benchmark")("path,p",
+        po::value<string>()->default_value("benchmark/rowcodec/"), "[RocksDB path]")("keys,k",
+        po::value<int>()->default_value(100000), "the number of different keys")("rows,r",
+        po::value<int>()->default_value(1), "rows of every key")("fields,f",
+        po::value<int>()->default_value(2), "user fields of every row")(
+        "value,v", po::value<int>()->default_value(64), "the length of value");
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, main_options), vm);
+        po::notify(vm);
+    }
+    catch (...)
+    {
+        std::cout << "invalid input" << std::endl;
+        exit(0);
+    }
+    if (vm.count("help") || vm.count("h"))
+    {
+        std::cout << main_options << std::endl;
+        exit(0);
+    }
+    return vm;
+}
+
+size_t directorySize(const string& _path)
+{
+    size_t size = 0;
+    for (boost::filesystem::recursive_directory_iterator it(_path), end; it != end; ++it)
+    {
+        if (boost::filesystem::is_regular_file(it->path()))
+        {
+            size += boost::filesystem::file_size(it->path());
+        }
+    }
+    return size;
+}
+
+int main(int argc, const char* argv[])
+{
+    boost::property_tree::ptree pt;
+    auto logInitializer = std::make_shared<LogInitializer>();
+    logInitializer->initLog(pt);
+    auto params = initCommandLine(argc, argv);
+    auto storagePath = params["path"].as<string>() + to_string(utcTime());
+    auto keys = params["keys"].as<int>();
+    auto rowCount = params["rows"].as<int>();
+    auto fieldCount = params["fields"].as<int>();
+    auto valueLength = params["value"].as<int>();
+
+    vector<Rows> data(keys);
+    for (int i = 0; i < keys; ++i)
+    {
+        for (int j = 0; j < rowCount; ++j)
+        {
+            Row row;
+            row[ID_FIELD] = to_string(i * rowCount + j);
+            row[NUM_FIELD] = to_string(i);
+            row[STATUS] = "0";
+            row["key"] = to_string(i);
+            for (int k = 0; k < fieldCount; ++k)
+            {
+                string value(valueLength, '0');
+                for (auto& c : value)
+                {
+                    c = '0' + rand() % 10;
+                }
+                row["value" + to_string(k)] = value;
+            }
+            data[i].push_back(row);
+        }
+    }
+
+    auto performance = [&](const string& description, std::function<void()> operation) {
+        auto now = std::chrono::steady_clock::now();
+        operation();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - now;
+        cout << "time used(s)=" << std::setiosflags(std::ios::fixed) << std::setprecision(3)
+             << elapsed.count() << " rounds=" << keys << " tps=" << keys / elapsed.count() << "|"
+             << description << endl;
+    };
+
+    auto benchmark = [&](const string& name, RowFormat format) {
+        vector<string> encoded(keys);
+        performance(name + " encode", [&]() {
+            for (int i = 0; i < keys; ++i)
+            {
+                encodeRows(data[i], encoded[i], format);
+            }
+        });
+        performance(name + " decode rows", [&]() {
+            for (int i = 0; i < keys; ++i)
+            {
+                Rows rows;
+                decodeRows(encoded[i], rows);
+            }
+        });
+        performance(name + " decode entries", [&]() {
+            for (int i = 0; i < keys; ++i)
+            {
+                size_t count = 0;
+                decodeEntries(encoded[i], [&count](Entry::Ptr) { ++count; });
+            }
+        });
+
+        size_t encodedSize = 0;
+        for (auto const& value : encoded)
+        {
+            encodedSize += value.size();
+        }
+
+        auto path = storagePath + "/" + name;
+        {
+            auto rocksDB = std::make_shared<BasicRocksDB>();
+            rocksDB->Open(getRocksDBOptions(), path);
+            rocksdb::WriteBatch batch;
+            for (int i = 0; i < keys; ++i)
+            {
+                rocksDB->Put(batch, "t_test_" + to_string(i), encoded[i]);
+            }
+            rocksDB->Write(rocksdb::WriteOptions(), batch);
+            rocksDB->closeDB();
+        }
+        cout << name << " encoded size(B)=" << encodedSize
+             << " on-disk size(B)=" << directorySize(path) << endl;
+    };
+
+    cout << "rocksdb path : " << storagePath << endl;
+    cout << "keys=" << keys << " rows=" << rowCount << " fields=" << fieldCount
+         << " value length(B)=" << valueLength << endl;
+    benchmark("legacy", RowFormat::Legacy);
+    benchmark("v1", RowFormat::V1);
+    return 0;
+}
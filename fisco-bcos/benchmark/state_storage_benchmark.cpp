@@ -0,0 +1,154 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ *
+ * @file state_storage_benchmark.cpp
+ */
+
+#include "libdevcrypto/Hash.h"
+#include "libinitializer/Initializer.h"
+#include "libledger/DBInitializer.h"
+#include "libstorage/MemoryTableFactoryFactory2.h"
+#include "libstoragestate/StorageState.h"
+#include <boost/program_options.hpp>
+#include <cstdlib>
+#include <functional>
+
+using namespace std;
+using namespace dev;
+using namespace dev::ledger;
+using namespace dev::storage;
+using namespace dev::storagestate;
+using namespace dev::initializer;
+
+namespace po = boost::program_options;
+
+po::options_description main_options("Main for StorageState slot benchmark");
+
+po::variables_map initCommandLine(int argc, const char* argv[])
+{
+    main_options.add_options()("help,h", "help of StorageState slot benchmark")("path,p",
+        po::value<string>()->default_value("benchmark/statestorage/"), "[RocksDB path]")(
+        "slots,s", po::value<int>()->default_value(100000), "slots of every contract")(
+        "contracts,c", po::value<int>()->default_value(10), "the number of contracts");
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, main_options), vm);
+        po::notify(vm);
+    }
+    catch (...)
+    {
+        std::cout << "invalid input" << std::endl;
+        exit(0);
+    }
+    if (vm.count("help") || vm.count("h"))
+    {
+        std::cout << main_options << std::endl;
+        exit(0);
+    }
+    return vm;
+}
+
+int main(int argc, const char* argv[])
+{
+    boost::property_tree::ptree pt;
+    auto logInitializer = std::make_shared<LogInitializer>();
+    logInitializer->initLog(pt);
+    g_BCOSConfig.setSupportedVersion("2.4.0", V2_4_0);
+    auto params = initCommandLine(argc, argv);
+    auto storagePath = params["path"].as<string>() + to_string(utcTime());
+    auto slots = params["slots"].as<int>();
+    auto contracts = params["contracts"].as<int>();
+    int rounds = slots * contracts;
+
+    // the slots of solidity mappings are hashes, the values are large numbers
+    vector<u256> keys(slots);
+    for (int i = 0; i < slots; ++i)
+    {
+        keys[i] = u256(sha3(toBigEndian(u256(i))));
+    }
+
+    auto benchmark = [&](const string& name, bool binaryStorage) {
+        auto storage = createRocksDBStorage(storagePath + "/" + name, false, false, false);
+        auto tableFactoryFactory = std::make_shared<MemoryTableFactoryFactory2>();
+        tableFactoryFactory->setStorage(storage);
+        int64_t blockNumber = 1;
+        StorageState state(u256(0));
+        state.setBinaryStorage(binaryStorage);
+        auto newBlock = [&]() {
+            state.setMemoryTableFactory(
+                tableFactoryFactory->newTableFactory(h256(), blockNumber));
+        };
+        auto performance = [&](const string& description, int count,
+                               std::function<void()> operation) {
+            newBlock();
+            auto now = std::chrono::steady_clock::now();
+            operation();
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - now;
+            cout << "time used(s)=" << std::setiosflags(std::ios::fixed) << std::setprecision(3)
+                 << elapsed.count() << " rounds=" << count << " tps=" << count / elapsed.count()
+                 << "|" << name << " " << description << flush;
+            now = std::chrono::steady_clock::now();
+            state.dbCommit(h256(), blockNumber++);
+            elapsed = std::chrono::steady_clock::now() - now;
+            cout << " | commit time(s)=" << elapsed.count() << endl;
+        };
+
+        performance("create contracts", contracts, [&]() {
+            for (int c = 0; c < contracts; ++c)
+            {
+                state.createContract(Address(c + 1));
+            }
+        });
+        performance("insert slots", rounds, [&]() {
+            for (int c = 0; c < contracts; ++c)
+            {
+                for (int i = 0; i < slots; ++i)
+                {
+                    state.setStorage(Address(c + 1), keys[i], keys[i]);
+                }
+            }
+        });
+        performance("update slots", rounds, [&]() {
+            for (int c = 0; c < contracts; ++c)
+            {
+                for (int i = 0; i < slots; ++i)
+                {
+                    state.setStorage(Address(c + 1), keys[i], keys[slots - i - 1]);
+                }
+            }
+        });
+        performance("read slots", rounds, [&]() {
+            for (int c = 0; c < contracts; ++c)
+            {
+                for (int i = 0; i < slots; ++i)
+                {
+                    if (state.storage(Address(c + 1), keys[i]) != keys[slots - i - 1])
+                    {
+                        cout << "wrong value of slot " << i << endl;
+                        exit(1);
+                    }
+                }
+            }
+        });
+    };
+
+    cout << "rocksdb path : " << storagePath << endl;
+    cout << "contracts=" << contracts << " slots=" << slots << endl;
+    benchmark("decimal", false);
+    benchmark("binary", true);
+    return 0;
+}
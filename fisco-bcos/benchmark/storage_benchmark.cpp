@@ -24,6 +24,7 @@
 #include "rocksdb/db.h"
 #include "rocksdb/options.h"
 #include <leveldb/db.h>
+#include <libconfig/GlobalConfigure.h>
 #include <libdevcore/BasicLevelDB.h>
 #include <libdevcore/Common.h>
 #include <libstorage/BasicRocksDB.h>
@@ -40,6 +41,11 @@
 #include <boost/log/support/date_time.hpp>
 #include <boost/log/utility/setup/common_attributes.hpp>
 #include <boost/log/utility/setup/from_stream.hpp>
+#include <boost/program_options.hpp>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <thread>
 
 
 using namespace std;
@@ -48,6 +54,41 @@ using namespace boost;
 using namespace dev::storage;
 using namespace dev::initializer;
 
+namespace po = boost::program_options;
+
+po::options_description main_options("Main for storage benchmark");
+
+po::variables_map initCommandLine(int argc, const char* argv[])
+{
+    main_options.add_options()("help,h", "help of storage benchmark")("mode,m",
+        po::value<string>()->default_value("table"), "[table|prefetch|multithread|hash]")(
+        "round,r",
+        po::value<size_t>()->default_value(3), "the number of rounds")("count,c",
+        po::value<size_t>()->default_value(10000), "the number of keys")("threads,t",
+        po::value<size_t>()->default_value(32), "max threads, only for multithread mode")(
+        "shards,s", po::value<size_t>()->default_value(32),
+        "cache shards, only for multithread mode")("cache,C",
+        po::value<size_t>()->default_value(256), "cache size(MB), only for multithread mode")(
+        "verify,v", "verify the result of every round, only for table mode");
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, main_options), vm);
+        po::notify(vm);
+    }
+    catch (...)
+    {
+        std::cout << "invalid input" << std::endl;
+        exit(0);
+    }
+    if (vm.count("help") || vm.count("h"))
+    {
+        std::cout << main_options << std::endl;
+        exit(0);
+    }
+    return vm;
+}
+
 void testMemoryTable2(size_t round, size_t count, bool verify)
 {
     boost::filesystem::create_directories("./RocksDB");
@@ -181,54 +222,247 @@ void testMemoryTable2(size_t round, size_t count, bool verify)
               << std::setprecision(4) << elapsed.count() << std::endl;
 }
 
-int main(int argc, char* argv[])
+// write count keys into a new RocksDB, keys are returned in random order
+std::shared_ptr<RocksDBStorage> initTestData(const string& path, size_t count, TableKeys& keys)
 {
-    (void)argc;
-    (void)argv;
-
-    boost::multi_index_container<std::pair<std::string, std::string>,
-        boost::multi_index::indexed_by<boost::multi_index::sequenced<>,
-            boost::multi_index::hashed_unique<
-                boost::multi_index::identity<std::pair<std::string, std::string> > > > >
-        m_mru;
-    m_mru.push_back(std::make_pair("a", "b"));
-    m_mru.push_back(std::make_pair("b", "c"));
-    m_mru.push_back(std::make_pair("a", "b"));
-
-    for (auto it = m_mru.begin(); it != m_mru.end();)
+    boost::filesystem::create_directories(path);
+    auto rocksDB = std::make_shared<BasicRocksDB>();
+    rocksDB->Open(getRocksDBOptions(), path);
+    auto rocksdbStorage = std::make_shared<RocksDBStorage>();
+    rocksdbStorage->setDB(rocksDB);
+
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = "test_data";
+    tableInfo->key = "key";
+    tableInfo->fields.push_back("value");
+
+    auto tableData = std::make_shared<TableData>();
+    tableData->info = tableInfo;
+    TableKeys keys;
+    for (size_t i = 0; i < count; ++i)
     {
-        std::cout << "item: " << it->first << ", " << it->second;
+        auto key = (boost::format("[%08d]") % i).str();
+        auto entry = std::make_shared<Entry>();
+        entry->setID(i + 1);
+        entry->setNum(1);
+        entry->setField("key", key);
+        entry->setField("value", string(64, '0'));
+        tableData->newEntries->addEntry(entry);
+        keys.emplace_back(tableInfo, key);
+    }
+    rocksdbStorage->commit(1, std::vector<TableData::Ptr>{tableData});
+    // shuffle the keys to make the point reads random
+    std::random_shuffle(keys.begin(), keys.end());
+    return rocksdbStorage;
+}
+
+// select count keys from a cold CachedStorage, one by one and then through prefetch
+void testPrefetch(size_t round, size_t count)
+{
+    TableKeys keys;
+    auto rocksdbStorage =
+        initTestData("./RocksDB_prefetch/" + to_string(utcTime()), count, keys);
+    auto tableInfo = keys[0].first;
+
+    auto newCachedStorage = [&]() {
+        auto cachedStorage = std::make_shared<CachedStorage>();
+        cachedStorage->setBackend(rocksdbStorage);
+        cachedStorage->setMaxCapacity(256 * 1024 * 1024);
+        cachedStorage->init();
+        return cachedStorage;
+    };
+
+    auto performance = [&](const string& description, std::function<void()> operation) {
+        auto now = std::chrono::steady_clock::now();
+        operation();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - now;
+        cout << "time used(s)=" << std::setiosflags(std::ios::fixed) << std::setprecision(4)
+             << elapsed.count() << " keys=" << count << " qps=" << count / elapsed.count() << "|"
+             << description << endl;
+    };
 
-        it = m_mru.erase(it);
+    for (size_t i = 0; i < round; ++i)
+    {
+        cout << "Round " << i << endl;
+        auto cachedStorage = newCachedStorage();
+        performance("cold select one by one", [&]() {
+            for (auto const& key : keys)
+            {
+                auto condition = std::make_shared<Condition>();
+                condition->EQ(tableInfo->key, key.second);
+                cachedStorage->select(2, tableInfo, key.second, condition);
+            }
+        });
+        cachedStorage->stop();
+
+        cachedStorage = newCachedStorage();
+        performance("cold prefetch", [&]() { cachedStorage->prefetch(2, keys); });
+        performance("warm select after prefetch", [&]() {
+            for (auto const& key : keys)
+            {
+                auto condition = std::make_shared<Condition>();
+                condition->EQ(tableInfo->key, key.second);
+                cachedStorage->select(2, tableInfo, key.second, condition);
+            }
+        });
+        cachedStorage->stop();
     }
+}
 
-#if 0
-    if (argc < 3)
+// select random keys with 1, 2, 4 ... threads through a CachedStorage of cacheSize MB
+void testMultiThread(size_t round, size_t count, size_t threads, size_t shards, size_t cacheSize)
+{
+    TableKeys keys;
+    auto rocksdbStorage =
+        initTestData("./RocksDB_multithread/" + to_string(utcTime()), count, keys);
+    auto tableInfo = keys[0].first;
+    auto total = round * count;
+
+    for (size_t threadCount = 1; threadCount <= threads; threadCount *= 2)
     {
-        std::cout << "Usage: " << argv[0] << " [round] [count] [verify]" << std::endl;
-        return 1;
+        auto cachedStorage = std::make_shared<CachedStorage>();
+        cachedStorage->setShardCount(shards);
+        cachedStorage->setBackend(rocksdbStorage);
+        cachedStorage->setMaxCapacity(cacheSize * 1024 * 1024);
+        cachedStorage->setClearInterval(100);
+        // all keys are flushed, so they can be evicted
+        cachedStorage->setSyncNum(1);
+        cachedStorage->init();
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < threadCount; ++i)
+        {
+            workers.emplace_back([&, i]() {
+                std::mt19937 random(i);
+                for (size_t j = 0; j < total / threadCount; ++j)
+                {
+                    auto const& key = keys[random() % keys.size()];
+                    auto condition = std::make_shared<Condition>();
+                    condition->EQ(tableInfo->key, key.second);
+                    cachedStorage->select(2, tableInfo, key.second, condition);
+                }
+            });
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        uint64_t queryTimes = 0;
+        uint64_t hitTimes = 0;
+        uint64_t evictTimes = 0;
+        size_t minSize = std::numeric_limits<size_t>::max();
+        size_t maxSize = 0;
+        for (auto const& status : cachedStorage->shardStatus())
+        {
+            queryTimes += status.queryTimes;
+            hitTimes += status.hitTimes;
+            evictTimes += status.evictTimes;
+            minSize = std::min(minSize, status.size);
+            maxSize = std::max(maxSize, status.size);
+        }
+        cout << "time used(s)=" << std::setiosflags(std::ios::fixed) << std::setprecision(4)
+             << elapsed.count() << " threads=" << threadCount << " shards=" << shards
+             << " qps=" << total / elapsed.count() << " hit ratio=" << std::setprecision(2)
+             << (double)hitTimes / queryTimes * 100 << "% evict=" << evictTimes
+             << " shard size=[" << minSize << "," << maxSize << "]" << endl;
+        cachedStorage->stop();
     }
+}
 
-#if 1
-    boost::property_tree::ptree pt;
+// hash a table after 0.1%, 1%, 10% and 100% of count rows are updated in a block, and rehash it
+// after one more row is updated
+void testHash(size_t round, size_t count)
+{
+    TableKeys keys;
+    auto rocksdbStorage = initTestData("./RocksDB_hash/" + to_string(utcTime()), count, keys);
+    auto tableInfo = keys[0].first;
+    // MemoryTable2 only dumps and hashes in the optimized way since v2.2.0
+    g_BCOSConfig.setSupportedVersion("2.4.0", V2_4_0);
+
+    auto cachedStorage = std::make_shared<CachedStorage>();
+    cachedStorage->setBackend(rocksdbStorage);
+    cachedStorage->setMaxCapacity(1024 * 1024 * 1024);
+    cachedStorage->init();
+    cachedStorage->prefetch(2, keys);
+
+    for (size_t touched = std::max<size_t>(count / 1000, 1); touched <= count; touched *= 10)
+    {
+        double hashTime = 0;
+        double rehashTime = 0;
+        for (size_t i = 0; i < round; ++i)
+        {
+            auto table = std::make_shared<MemoryTable2>();
+            table->setStateStorage(cachedStorage);
+            table->setBlockNum(2);
+            table->setTableInfo(tableInfo);
+            table->setRecorder([](Table::Ptr, Change::Kind, std::string const&,
+                                   std::vector<Change::Record>&) {});
+            auto update = [&](size_t index) {
+                auto entry = table->newEntry();
+                entry->setField("value", to_string(i) + string(63, '1'));
+                table->update(keys[index].second, entry, table->newCondition());
+            };
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, touched),
+                [&](const tbb::blocked_range<size_t>& range) {
+                    for (size_t j = range.begin(); j < range.end(); ++j)
+                    {
+                        update(j);
+                    }
+                });
+
+            auto start = std::chrono::steady_clock::now();
+            table->hash();
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            hashTime += elapsed.count();
 
-    boost::property_tree::read_ini("config.ini", pt);
+            update(touched % count);
+            start = std::chrono::steady_clock::now();
+            table->hash();
+            elapsed = std::chrono::steady_clock::now() - start;
+            rehashTime += elapsed.count();
+        }
+        cout << "touched rows=" << touched << std::setiosflags(std::ios::fixed)
+             << std::setprecision(3) << " hash(ms)=" << hashTime * 1000 / round
+             << " rehash(ms)=" << rehashTime * 1000 / round << endl;
+    }
+    cachedStorage->stop();
+}
 
-    /// init log
+int main(int argc, const char* argv[])
+{
+    boost::property_tree::ptree pt;
     auto logInitializer = std::make_shared<LogInitializer>();
     logInitializer->initLog(pt);
-#endif
 
-    size_t round = boost::lexical_cast<size_t>(argv[1]);
-    size_t count = boost::lexical_cast<size_t>(argv[2]);
-    bool verify = false;
-    if (argc > 3)
+    auto params = initCommandLine(argc, argv);
+    auto mode = params["mode"].as<string>();
+    auto round = params["round"].as<size_t>();
+    auto count = params["count"].as<size_t>();
+
+    if (mode == "table")
     {
-        verify = boost::lexical_cast<bool>(argv[3]);
+        testMemoryTable2(round, count, params.count("verify") > 0);
+    }
+    else if (mode == "prefetch")
+    {
+        testPrefetch(round, count);
+    }
+    else if (mode == "multithread")
+    {
+        testMultiThread(round, count, params["threads"].as<size_t>(),
+            params["shards"].as<size_t>(), params["cache"].as<size_t>());
+    }
+    else if (mode == "hash")
+    {
+        testHash(round, count);
+    }
+    else
+    {
+        std::cout << "unknown mode: " << mode << std::endl << main_options << std::endl;
+        return 1;
     }
-
-    testMemoryTable2(round, count, verify);
-#endif
-
     return 0;
 }
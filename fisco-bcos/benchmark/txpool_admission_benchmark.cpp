@@ -0,0 +1,227 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ *
+ * @file txpool_admission_benchmark.cpp
+ *
+ * drives the admission of the txPool directly: the transactions are imported one by one by one
+ * thread, which is what the submit thread did, and are submitted by several clients and imported
+ * in batches of different sizes. The transactions are decoded and their senders are recovered
+ * before, as the RPC does, so only the admission is timed
+ */
+
+#include "libblockchain/BlockChainImp.h"
+#include "libinitializer/Initializer.h"
+#include "libledger/DBInitializer.h"
+#include <libp2p/Service.h>
+#include <libtxpool/TxPool.h>
+#include <tbb/parallel_for.h>
+#include <boost/program_options.hpp>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <thread>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::ledger;
+using namespace dev::blockchain;
+using namespace dev::txpool;
+using namespace dev::initializer;
+
+namespace po = boost::program_options;
+
+po::options_description main_options("Main for txPool admission benchmark");
+
+po::variables_map initCommandLine(int argc, const char* argv[])
+{
+    main_options.add_options()("help,h", "help of txPool admission benchmark")("path,p",
+        po::value<string>()->default_value("benchmark/txpool/"), "[RocksDB path]")("txs,t",
+        po::value<int>()->default_value(100000), "the number of transactions")("clients,c",
+        po::value<int>()->default_value(8), "the number of the clients submit transactions")(
+        "batch,b", po::value<int>()->default_value(1000), "the max size of an import batch");
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, main_options), vm);
+        po::notify(vm);
+    }
+    catch (...)
+    {
+        std::cout << "invalid input" << std::endl;
+        exit(0);
+    }
+    if (vm.count("help") || vm.count("h"))
+    {
+        std::cout << main_options << std::endl;
+        exit(0);
+    }
+    return vm;
+}
+
+class AdmissionBenchmark
+{
+public:
+    AdmissionBenchmark(string const& _path, int _txs)
+    {
+        auto keyPair = KeyPair::create();
+        m_service = std::make_shared<dev::p2p::Service>();
+        m_service->setKeyPair(keyPair);
+
+        auto params = std::make_shared<LedgerParam>();
+        params->mutableStorageParam().type = "RocksDB";
+        params->mutableStorageParam().path = _path;
+        params->mutableStateParam().type = "storage";
+        m_dbInitializer = std::make_shared<DBInitializer>(params, 1);
+        m_dbInitializer->initStorageDB();
+        m_blockChain = std::make_shared<BlockChainImp>();
+        m_blockChain->setStateStorage(m_dbInitializer->storage());
+        m_blockChain->setTableFactoryFactory(m_dbInitializer->tableFactoryFactory());
+        // the node is the sealer, or the submitted transactions are refused
+        GenesisBlockParam initParam = {"", dev::h512s{keyPair.pub()}, dev::h512s(),
+            "consensusType", "storageType", "stateType", 5000, 300000000, 0, -1, -1, 0};
+        m_blockChain->checkAndBuildGenesisBlock(initParam);
+
+        // the transactions are signed in parallel, the senders are distinct by the nonces
+        m_txsData.resize(_txs);
+        auto blockLimit = u256(m_blockChain->number() + 500);
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(0, _txs), [&](const tbb::blocked_range<size_t>& _r) {
+                for (size_t i = _r.begin(); i != _r.end(); ++i)
+                {
+                    auto tx = std::make_shared<Transaction>(0, 0, 10000000, Address(0x5002),
+                        bytes(), u256(i + 1), u256(g_BCOSConfig.chainId()), u256(1));
+                    tx->setBlockLimit(blockLimit);
+                    tx->updateSignature(SignatureStruct(sign(keyPair, tx->sha3(WithoutSignature))));
+                    tx->encode(m_txsData[i]);
+                }
+            });
+    }
+
+    std::shared_ptr<dev::txpool::TxPool> newTxPool()
+    {
+        PROTOCOL_ID protocol = getGroupProtoclID(1, dev::eth::ProtocolID::TxPool);
+        return std::make_shared<dev::txpool::TxPool>(
+            m_service, m_blockChain, protocol, m_txsData.size());
+    }
+
+    // decodes the transactions and recovers the senders as the RPC does
+    std::shared_ptr<Transactions> decode()
+    {
+        auto txs = std::make_shared<Transactions>(m_txsData.size());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, m_txsData.size()),
+            [&](const tbb::blocked_range<size_t>& _r) {
+                for (size_t i = _r.begin(); i != _r.end(); ++i)
+                {
+                    (*txs)[i] = std::make_shared<Transaction>(
+                        ref(m_txsData[i]), CheckTransaction::Everything);
+                    (*txs)[i]->sha3();
+                }
+            });
+        return txs;
+    }
+
+    // imports the transactions one by one in one thread, as the submit thread did
+    void runImport()
+    {
+        auto txPool = newTxPool();
+        auto txs = decode();
+        TxPoolInterface::Ptr txPoolInterface = txPool;
+        size_t refused = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (auto const& tx : *txs)
+        {
+            if (txPoolInterface->import(tx) != ImportResult::Success)
+            {
+                ++refused;
+            }
+        }
+        auto elapsed =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        report("import  ", txs->size(), refused, elapsed);
+        txPool->stop();
+    }
+
+    // submits the transactions by _clients clients, they are imported in batches
+    void runSubmit(int _clients, int _batchSize)
+    {
+        auto txPool = newTxPool();
+        txPool->setMaxSubmitBatchSize(_batchSize);
+        auto txs = decode();
+        std::atomic<size_t> refused = {0};
+        for (auto const& tx : *txs)
+        {
+            tx->setRpcCallback([&refused](LocalisedTransactionReceipt::Ptr, bytesConstRef,
+                                   Block::Ptr) { refused++; });
+        }
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> clients;
+        for (int client = 0; client < _clients; ++client)
+        {
+            clients.emplace_back([&txs, txPool, client, _clients]() {
+                for (size_t i = client; i < txs->size(); i += _clients)
+                {
+                    txPool->submit((*txs)[i]);
+                }
+            });
+        }
+        for (auto& client : clients)
+        {
+            client.join();
+        }
+        while (txPool->pendingSize() + refused < txs->size())
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        auto elapsed =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        report("submit clients=" + to_string(_clients) + " batch=" + to_string(_batchSize) + " ",
+            txs->size(), refused, elapsed);
+        txPool->stop();
+    }
+
+    void report(string const& _name, size_t _txs, size_t _refused, double _elapsed)
+    {
+        cout << _name << "txs=" << _txs << " refused=" << _refused
+             << std::setiosflags(std::ios::fixed) << std::setprecision(1)
+             << " elapsed(ms)=" << _elapsed * 1000 << " tps=" << _txs / _elapsed << endl;
+    }
+
+private:
+    std::shared_ptr<dev::p2p::Service> m_service;
+    std::shared_ptr<DBInitializer> m_dbInitializer;
+    std::shared_ptr<BlockChainImp> m_blockChain;
+    std::vector<bytes> m_txsData;
+};
+
+int main(int argc, const char* argv[])
+{
+    boost::property_tree::ptree pt;
+    auto logInitializer = std::make_shared<LogInitializer>();
+    logInitializer->initLog(pt);
+    auto params = initCommandLine(argc, argv);
+    auto path = params["path"].as<string>() + to_string(utcTime());
+    auto txs = params["txs"].as<int>();
+    auto clients = params["clients"].as<int>();
+    auto batch = params["batch"].as<int>();
+
+    cout << "txs=" << txs << " clients=" << clients << " batch=" << batch << endl;
+    AdmissionBenchmark benchmark(path, txs);
+    benchmark.runImport();
+    benchmark.runSubmit(clients, 1);
+    benchmark.runSubmit(clients, batch);
+    return 0;
+}
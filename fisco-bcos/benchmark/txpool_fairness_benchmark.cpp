@@ -0,0 +1,281 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ *
+ * @file txpool_fairness_benchmark.cpp
+ *
+ * a load generator of the txPool under overload: a hot client floods the txPool while several
+ * light clients submit at a steady rate, a sealer takes a block of transactions from the txPool
+ * at every interval and drops them as committed. The confirmation latency of every client is
+ * reported, and the transactions refused or evicted are counted
+ */
+
+#include "libblockchain/BlockChainImp.h"
+#include "libinitializer/Initializer.h"
+#include "libledger/DBInitializer.h"
+#include <libp2p/Service.h>
+#include <libtxpool/TxPool.h>
+#include <tbb/parallel_for.h>
+#include <boost/program_options.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::ledger;
+using namespace dev::blockchain;
+using namespace dev::txpool;
+using namespace dev::initializer;
+
+namespace po = boost::program_options;
+
+po::options_description main_options("Main for txPool fairness benchmark");
+
+po::variables_map initCommandLine(int argc, const char* argv[])
+{
+    main_options.add_options()("help,h", "help of txPool fairness benchmark")("path,p",
+        po::value<string>()->default_value("benchmark/txpool/"), "[RocksDB path]")("hot,t",
+        po::value<int>()->default_value(50000), "the number of transactions of the hot client")(
+        "clients,c", po::value<int>()->default_value(8), "the number of the light clients")(
+        "light,l", po::value<int>()->default_value(200),
+        "the number of transactions of a light client")("rate,r",
+        po::value<int>()->default_value(5), "the interval(ms) of the light clients to submit")(
+        "block,b", po::value<int>()->default_value(1000), "the max transactions of a block")(
+        "interval,i", po::value<int>()->default_value(100), "the interval(ms) to seal a block")(
+        "limit", po::value<int>()->default_value(10000), "the limit of the txPool")(
+        "sender_limit", po::value<int>()->default_value(0), "the limit of a sender, 0 is none");
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, main_options), vm);
+        po::notify(vm);
+    }
+    catch (...)
+    {
+        std::cout << "invalid input" << std::endl;
+        exit(0);
+    }
+    if (vm.count("help") || vm.count("h"))
+    {
+        std::cout << main_options << std::endl;
+        exit(0);
+    }
+    return vm;
+}
+
+using Clock = std::chrono::steady_clock;
+
+struct ClientStat
+{
+    std::mutex lock;
+    size_t refused = 0;
+    std::vector<double> latencies;
+};
+
+class FairnessBenchmark
+{
+public:
+    FairnessBenchmark(string const& _path, int _hotTxs, int _clients, int _lightTxs)
+    {
+        auto keyPair = KeyPair::create();
+        m_service = std::make_shared<dev::p2p::Service>();
+        m_service->setKeyPair(keyPair);
+
+        auto params = std::make_shared<LedgerParam>();
+        params->mutableStorageParam().type = "RocksDB";
+        params->mutableStorageParam().path = _path;
+        params->mutableStateParam().type = "storage";
+        m_dbInitializer = std::make_shared<DBInitializer>(params, 1);
+        m_dbInitializer->initStorageDB();
+        m_blockChain = std::make_shared<BlockChainImp>();
+        m_blockChain->setStateStorage(m_dbInitializer->storage());
+        m_blockChain->setTableFactoryFactory(m_dbInitializer->tableFactoryFactory());
+        // the node is the sealer, or the submitted transactions are refused
+        GenesisBlockParam initParam = {"", dev::h512s{keyPair.pub()}, dev::h512s(),
+            "consensusType", "storageType", "stateType", 5000, 300000000, 0, -1, -1, 0};
+        m_blockChain->checkAndBuildGenesisBlock(initParam);
+
+        // the client 0 is the hot client, every client has its own key pair
+        std::vector<KeyPair> keyPairs;
+        std::vector<size_t> clientOf;
+        for (int client = 0; client <= _clients; ++client)
+        {
+            keyPairs.push_back(KeyPair::create());
+            clientOf.insert(clientOf.end(), client == 0 ? _hotTxs : _lightTxs, client);
+        }
+        m_txs.resize(clientOf.size());
+        auto blockLimit = u256(m_blockChain->number() + 500);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, clientOf.size()),
+            [&](const tbb::blocked_range<size_t>& _r) {
+                for (size_t i = _r.begin(); i != _r.end(); ++i)
+                {
+                    auto tx = std::make_shared<Transaction>(0, 0, 10000000, Address(0x5002),
+                        bytes(), u256(i + 1), u256(g_BCOSConfig.chainId()), u256(1));
+                    tx->setBlockLimit(blockLimit);
+                    tx->updateSignature(
+                        SignatureStruct(sign(keyPairs[clientOf[i]], tx->sha3(WithoutSignature))));
+                    bytes data;
+                    tx->encode(data);
+                    // decodes the transaction and recovers the sender as the RPC does
+                    m_txs[i] =
+                        std::make_shared<Transaction>(ref(data), CheckTransaction::Everything);
+                    m_txs[i]->sha3();
+                }
+            });
+        m_clientTxs.resize(_clients + 1);
+        for (size_t i = 0; i < clientOf.size(); ++i)
+        {
+            m_clientTxs[clientOf[i]].push_back(i);
+        }
+    }
+
+    void run(int _rate, int _blockSize, int _interval, int _limit, int _senderLimit)
+    {
+        PROTOCOL_ID protocol = getGroupProtoclID(1, dev::eth::ProtocolID::TxPool);
+        auto txPool =
+            std::make_shared<dev::txpool::TxPool>(m_service, m_blockChain, protocol, _limit);
+        txPool->setSenderLimit(_senderLimit);
+
+        std::vector<std::shared_ptr<ClientStat>> stats;
+        std::vector<Clock::time_point> submitTime(m_txs.size());
+        std::atomic<size_t> resolved = {0};
+        for (size_t client = 0; client < m_clientTxs.size(); ++client)
+        {
+            auto stat = std::make_shared<ClientStat>();
+            stats.push_back(stat);
+            for (auto i : m_clientTxs[client])
+            {
+                // the transactions dropped with a block are confirmed, the others are refused
+                m_txs[i]->setRpcCallback([stat, i, &submitTime, &resolved](
+                                             LocalisedTransactionReceipt::Ptr, bytesConstRef,
+                                             Block::Ptr _block) {
+                    auto latency =
+                        std::chrono::duration<double, std::milli>(Clock::now() - submitTime[i]);
+                    {
+                        std::lock_guard<std::mutex> l(stat->lock);
+                        if (_block)
+                        {
+                            stat->latencies.push_back(latency.count());
+                        }
+                        else
+                        {
+                            ++stat->refused;
+                        }
+                    }
+                    ++resolved;
+                });
+            }
+        }
+
+        std::atomic_bool sealing = {true};
+        size_t blocks = 0;
+        std::thread sealer([&]() {
+            while (sealing)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(_interval));
+                auto txs = txPool->topTransactions(_blockSize);
+                if (txs->empty())
+                {
+                    continue;
+                }
+                auto block = std::make_shared<Block>();
+                block->setTransactions(txs);
+                txPool->dropBlockTrans(block);
+                ++blocks;
+            }
+        });
+        auto start = Clock::now();
+        std::vector<std::thread> clients;
+        for (size_t client = 0; client < m_clientTxs.size(); ++client)
+        {
+            clients.emplace_back([&, client]() {
+                for (auto i : m_clientTxs[client])
+                {
+                    submitTime[i] = Clock::now();
+                    txPool->submit(m_txs[i]);
+                    // the hot client submits as fast as it can
+                    if (client > 0)
+                    {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(_rate));
+                    }
+                }
+            });
+        }
+        for (auto& client : clients)
+        {
+            client.join();
+        }
+        while (resolved < m_txs.size())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        sealing = false;
+        sealer.join();
+        auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        cout << "blocks=" << blocks << std::setiosflags(std::ios::fixed) << std::setprecision(1)
+             << " elapsed(ms)=" << elapsed * 1000 << endl;
+        for (size_t client = 0; client < stats.size(); ++client)
+        {
+            report(client == 0 ? "hot     " : "light-" + to_string(client) + " ",
+                m_clientTxs[client].size(), *stats[client]);
+        }
+        txPool->stop();
+    }
+
+    void report(string const& _name, size_t _txs, ClientStat& _stat)
+    {
+        auto& latencies = _stat.latencies;
+        std::sort(latencies.begin(), latencies.end());
+        auto percentile = [&latencies](double _p) {
+            return latencies.empty() ? 0 : latencies[(size_t)(_p * (latencies.size() - 1))];
+        };
+        cout << _name << "txs=" << _txs << " confirmed=" << latencies.size()
+             << " refused=" << _stat.refused << std::setiosflags(std::ios::fixed)
+             << std::setprecision(1) << " p50(ms)=" << percentile(0.5)
+             << " p99(ms)=" << percentile(0.99) << " max(ms)=" << percentile(1) << endl;
+    }
+
+private:
+    std::shared_ptr<dev::p2p::Service> m_service;
+    std::shared_ptr<DBInitializer> m_dbInitializer;
+    std::shared_ptr<BlockChainImp> m_blockChain;
+    Transactions m_txs;
+    /// the indexes of the transactions of every client
+    std::vector<std::vector<size_t>> m_clientTxs;
+};
+
+int main(int argc, const char* argv[])
+{
+    boost::property_tree::ptree pt;
+    auto logInitializer = std::make_shared<LogInitializer>();
+    logInitializer->initLog(pt);
+    auto params = initCommandLine(argc, argv);
+    auto path = params["path"].as<string>() + to_string(utcTime());
+    auto hot = params["hot"].as<int>();
+    auto clients = params["clients"].as<int>();
+    auto light = params["light"].as<int>();
+
+    cout << "hot=" << hot << " clients=" << clients << " light=" << light << endl;
+    FairnessBenchmark benchmark(path, hot, clients, light);
+    benchmark.run(params["rate"].as<int>(), params["block"].as<int>(),
+        params["interval"].as<int>(), params["limit"].as<int>(),
+        params["sender_limit"].as<int>());
+    return 0;
+}
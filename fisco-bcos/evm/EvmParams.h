@@ -50,6 +50,7 @@ public:
         m_gasPrice = pt.get<dev::u256>("evm.gasPrice", dev::u256(0));
         m_gasLimit = pt.get<dev::u256>("evm.gasLimit", dev::u256(100000000000));
         m_blockNumber = pt.get<int64_t>("evm.blockNumber", 0);
+        m_repeat = pt.get<size_t>("evm.repeat", 0);
         ParseCodes(pt);
         ParseInput(pt);
     }
@@ -150,6 +151,7 @@ public:
     int64_t const& blockNumber() const { return m_blockNumber; }
     std::vector<dev::bytes> const& code() const { return m_code; }
     std::vector<Input>& input() { return m_input; }
+    size_t repeat() const { return m_repeat; }
 
 private:
     dev::u256 m_transValue;
@@ -160,4 +162,6 @@ private:
     std::vector<dev::bytes> m_code;
     std::vector<Input> m_input;
     int64_t m_blockNumber;
+    /// times of the calls executed to benchmark, 0 for no benchmark
+    size_t m_repeat;
 };
@@ -29,7 +29,10 @@
 #include <libevm/ExtVMFace.h>
 #include <libexecutive/Executive.h>
 #include <libexecutive/StateFace.h>
+#include <libinterpreter/CodeAnalysisCache.h>
+#include <libinterpreter/VM.h>
 #include <libmptstate/MPTState.h>
+#include <chrono>
 
 using namespace dev;
 using namespace dev::eth;
@@ -116,6 +119,45 @@ static void callTransaction(
     EVMC_LOG(INFO) << "[evm_main/callTransaction/result string]: " << result;
 }
 
+/// benchmark the call with and without the cache of the analysed code and the superinstructions
+static void benchmarkCall(
+    std::shared_ptr<MPTState> mptState, EnvInfo& info, Input& input, EvmParams const& param)
+{
+    ContractABI abi;
+    bytes inputData = abi.abiIn(input.inputCall);
+    Transaction::Ptr tx = std::make_shared<Transaction>(
+        param.transValue(), param.gasPrice(), param.gas(), input.addr, inputData, u256(0));
+    updateSender(mptState, tx, param);
+    auto& cache = CodeAnalysisCache::instance();
+    auto capacity = cache.capacity();
+    auto superinstructions = VM::enableSuperinstructions();
+    for (auto fused : {true, false})
+    {
+        VM::setEnableSuperinstructions(fused);
+        for (auto cached : {true, false})
+        {
+            cache.clear();
+            cache.setCapacity(cached ? capacity : 0);
+            auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < param.repeat(); ++i)
+            {
+                ExecutionResult res;
+                ExecuteTransaction(res, mptState, info, tx);
+            }
+            auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start)
+                               .count();
+            EVMC_LOG(INFO) << "[evm_main/benchmark]" << LOG_KV("superinstructions", fused)
+                           << LOG_KV("codeCache", cached) << LOG_KV("repeat", param.repeat())
+                           << LOG_KV("usPerCall", (double)elapsed / param.repeat())
+                           << LOG_KV("cacheQuery", cache.queryTimes())
+                           << LOG_KV("cacheHit", cache.hitTimes());
+        }
+    }
+    VM::setEnableSuperinstructions(superinstructions);
+    cache.setCapacity(capacity);
+}
+
 int main()
 {
     /// init configuration
@@ -142,6 +184,10 @@ int main()
     {
         EVMC_LOG(INFO) << "=======[evm_main/BEGIN call transaction/index]:" << i << "=======";
         callTransaction(mptState, envInfo, param.input()[i], param);
+        if (param.repeat() > 0)
+        {
+            benchmarkCall(mptState, envInfo, param.input()[i], param);
+        }
     }
     return 0;
 }
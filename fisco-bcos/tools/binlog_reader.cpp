@@ -24,7 +24,9 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
+#include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
+#include <chrono>
 
 using namespace std;
 using namespace dev;
@@ -40,7 +42,8 @@ po::variables_map initCommandLine(int argc, const char* argv[])
     main_options.add_options()("help,h", "help of binlog_reader")("path,p",
         po::value<string>()->default_value("data/"),
         "[binlog path]")("interval,i", po::value<int64_t>()->default_value(1), "[block interval]")(
-        "block,b", po::value<int64_t>()->default_value(-1), "[parse specific block]");
+        "block,b", po::value<int64_t>()->default_value(-1), "[parse specific block]")(
+        "quiet,q", "only report the replay throughput, do not print block data");
     po::variables_map vm;
     try
     {
@@ -99,6 +102,29 @@ void printBlockData(const std::vector<TableData::Ptr>& blockData)
     }
 }
 
+size_t entriesCount(const std::vector<TableData::Ptr>& blockData)
+{
+    size_t count = 0;
+    for (auto const& tableData : blockData)
+    {
+        count += tableData->dirtyEntries->size() + tableData->newEntries->size();
+    }
+    return count;
+}
+
+size_t binlogSize(const string& _path)
+{
+    size_t size = 0;
+    for (boost::filesystem::directory_iterator it(_path), end; it != end; ++it)
+    {
+        if (boost::filesystem::is_regular_file(it->path()))
+        {
+            size += boost::filesystem::file_size(it->path());
+        }
+    }
+    return size;
+}
+
 int main(int argc, const char* argv[])
 {
     // init log
@@ -131,9 +157,15 @@ int main(int argc, const char* argv[])
         }
         return 0;
     }
+    bool quiet = params.count("quiet") > 0;
+    size_t blocks = 0;
+    size_t entries = 0;
+    std::chrono::duration<double> replayTime(0);
     for (int64_t num = startNum; num <= lastBlockNum; num += interval)
     {
+        auto start = std::chrono::steady_clock::now();
         auto blocksData = binaryLogger.getMissingBlocksFromBinLog(num, num + interval);
+        replayTime += std::chrono::steady_clock::now() - start;
         if (blocksData->size() > 0)
         {
             for (size_t i = 1; i <= blocksData->size(); ++i)
@@ -147,11 +179,24 @@ int main(int argc, const char* argv[])
                 else
                 {
                     const std::vector<TableData::Ptr>& blockData = blockDataIter->second;
-                    cout << "block" << num + i << endl;
-                    printBlockData(blockData);
+                    ++blocks;
+                    entries += entriesCount(blockData);
+                    if (!quiet)
+                    {
+                        cout << "block" << num + i << endl;
+                        printBlockData(blockData);
+                    }
                 }
             }
         }
     }
+    // the time of printing is excluded, so recovery time can be sized by the binlog size
+    auto seconds = replayTime.count() > 0 ? replayTime.count() : 1e-9;
+    auto megabytes = binlogSize(binlogPath) / (1024.0 * 1024.0);
+    cout << "replay blocks=" << blocks << " entries=" << entries
+         << std::setiosflags(std::ios::fixed) << std::setprecision(3)
+         << " binlog size(MB)=" << megabytes
+         << " time used(s)=" << replayTime.count() << " blocks/s=" << blocks / seconds
+         << " entries/s=" << entries / seconds << " MB/s=" << megabytes / seconds << endl;
     return 0;
 }
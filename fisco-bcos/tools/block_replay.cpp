@@ -0,0 +1,353 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ *
+ * @file block_replay.cpp
+ *
+ * re-executes the blocks of a ledger with BlockVerifier and reports the time of every stage.
+ *
+ * The tables keep only the latest state, so a block can only be executed on the state of its
+ * parent. The blocks are read from the block RocksDB of the source ledger, which is not written,
+ * and executed on the state ledger, the data of the group copied when the node was at the parent
+ * of the first block. Every block is executed repeat times without committing, the receipts, the
+ * state root and the dbHash are verified against the source, and then the last execution is
+ * committed to the state ledger for the next block, so the state ledger must be a copy.
+ *
+ * the cache mode warm executes the block once before the executions measured, cold drops the rows
+ * of CachedStorage before every execution
+ */
+
+#include "libblockchain/BlockChainImp.h"
+#include "libblockverifier/BlockVerifier.h"
+#include "libinitializer/BoostLogInitializer.h"
+#include "libinitializer/GlobalConfigureInitializer.h"
+#include "libledger/DBInitializer.h"
+#include "libledger/LedgerParam.h"
+#include "libstorage/MemoryTableFactory2.h"
+#include "libstorage/MemoryTableFactoryFactory2.h"
+#include <boost/program_options.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <thread>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::ledger;
+using namespace dev::storage;
+using namespace dev::blockchain;
+using namespace dev::blockverifier;
+using namespace dev::initializer;
+namespace po = boost::program_options;
+
+po::options_description main_options("Main for block replay");
+
+po::variables_map initCommandLine(int argc, const char* argv[])
+{
+    main_options.add_options()("help,h", "help of block replay")("config,c",
+        po::value<string>()->default_value("conf/group.1.genesis"),
+        "[genesis file of the group], group.X.ini is in the same directory")("data,d",
+        po::value<string>()->default_value("data/"),
+        "[data path of the state ledger], a copy of the data of the node at the parent of the "
+        "first block, the blocks replayed are committed to it")("source,s", po::value<string>(),
+        "[block RocksDB path of the source ledger], such as data/group1/block of a stopped node "
+        "which has the blocks")("from,f", po::value<int64_t>(),
+        "the first block, the block after the state ledger by default")("to,t",
+        po::value<int64_t>(), "the last block, the last block of the source by default")("mode,m",
+        po::value<string>()->default_value("parallel"), "serial or parallel")("cache,e",
+        po::value<string>()->default_value("warm"), "warm or cold")("repeat,r",
+        po::value<int>()->default_value(1), "the executions measured of every block")(
+        "nodeConfig,n", po::value<string>()->default_value("config.ini"),
+        "[config.ini of the node], for the supported version and the log");
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, main_options), vm);
+        po::notify(vm);
+    }
+    catch (...)
+    {
+        std::cout << "invalid input" << std::endl;
+        exit(0);
+    }
+    if (vm.count("help") || vm.count("h") || !vm.count("source"))
+    {
+        std::cout << main_options << std::endl;
+        exit(0);
+    }
+    return vm;
+}
+
+namespace
+{
+// the time of an execution of a block in milliseconds
+struct Sample
+{
+    double total = 0;
+    ExecutionTimeCost stages;
+    // MemoryTableFactory2::exportData, the dump of the tables committed
+    double dump = 0;
+};
+
+double percentile(vector<double> _values, double _percent)
+{
+    if (_values.empty())
+    {
+        return 0;
+    }
+    std::sort(_values.begin(), _values.end());
+    auto rank = (size_t)std::ceil(_percent / 100 * _values.size());
+    return _values[std::max<size_t>(rank, 1) - 1];
+}
+
+// the same as Ledger::initBlockChain for the RocksDB storage
+std::shared_ptr<BlockChainImp> openBlockChain(
+    Storage::Ptr _storage, TableFactoryFactory::Ptr _tableFactoryFactory)
+{
+    auto blockChain = std::make_shared<BlockChainImp>();
+    blockChain->setEnableHexBlock(g_BCOSConfig.version() < V2_2_0);
+    blockChain->setStateStorage(_storage);
+    blockChain->setTableFactoryFactory(_tableFactoryFactory);
+    return blockChain;
+}
+
+// the rows of the committed blocks are flushed to the backend before they are dropped
+void dropCache(DBInitializer& _dbInitializer, int64_t _number)
+{
+    auto cachedStorage = _dbInitializer.cachedStorage();
+    if (!cachedStorage)
+    {
+        return;
+    }
+    while (cachedStorage->syncNum() < _number)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    cachedStorage->clear();
+}
+
+// the receipts and the header of _block are the same as the ones of _source
+bool verify(Block& _block, Block& _source)
+{
+    auto& receipts = *_block.transactionReceipts();
+    auto& sourceReceipts = *_source.transactionReceipts();
+    bool result = true;
+    for (size_t i = 0; i < receipts.size() && i < sourceReceipts.size(); ++i)
+    {
+        if (receipts[i]->rlp() != sourceReceipts[i]->rlp())
+        {
+            cout << "block " << _block.header().number() << " receipt " << i << " of tx "
+                 << (*_block.transactions())[i]->sha3() << " mismatch, replayed "
+                 << *receipts[i] << " source " << *sourceReceipts[i] << endl;
+            result = false;
+            break;
+        }
+    }
+    if (receipts.size() != sourceReceipts.size() ||
+        _block.header().receiptsRoot() != _source.header().receiptsRoot() ||
+        _block.header().stateRoot() != _source.header().stateRoot() ||
+        _block.header().dbHash() != _source.header().dbHash() ||
+        _block.header().hash() != _source.header().hash())
+    {
+        cout << "block " << _block.header().number() << " mismatch, replayed receiptRoot/"
+             << "stateRoot/dbHash " << _block.header().receiptsRoot() << "/"
+             << _block.header().stateRoot() << "/" << _block.header().dbHash() << " source "
+             << _source.header().receiptsRoot() << "/" << _source.header().stateRoot() << "/"
+             << _source.header().dbHash() << endl;
+        result = false;
+    }
+    return result;
+}
+}  // namespace
+
+int main(int argc, const char* argv[])
+{
+    auto params = initCommandLine(argc, argv);
+    boost::property_tree::ptree pt;
+    if (boost::filesystem::exists(params["nodeConfig"].as<string>()))
+    {
+        boost::property_tree::read_ini(params["nodeConfig"].as<string>(), pt);
+    }
+    auto logInitializer = std::make_shared<LogInitializer>();
+    logInitializer->initLog(pt);
+    initGlobalConfig(pt);
+
+    auto ledgerParam = std::make_shared<LedgerParam>();
+    ledgerParam->init(params["config"].as<string>(), params["data"].as<string>());
+    auto dbInitializer = std::make_shared<DBInitializer>(ledgerParam, ledgerParam->groupId());
+    dbInitializer->initStorageDB();
+    if (!dbInitializer->storage())
+    {
+        cout << "open the state ledger failed" << endl;
+        return 1;
+    }
+    auto blockChain =
+        openBlockChain(dbInitializer->storage(), dbInitializer->tableFactoryFactory());
+    if (blockChain->number() < 0)
+    {
+        cout << "the state ledger is empty" << endl;
+        return 1;
+    }
+    dbInitializer->initState(blockChain->getBlockByNumber(0)->headerHash());
+
+    auto sourceStorage = createRocksDBStorage(
+        params["source"].as<string>(), g_BCOSConfig.diskEncryption.enable, false, false);
+    auto sourceTableFactoryFactory = std::make_shared<MemoryTableFactoryFactory2>();
+    sourceTableFactoryFactory->setStorage(sourceStorage);
+    auto source = openBlockChain(sourceStorage, sourceTableFactoryFactory);
+
+    auto from = params.count("from") ? params["from"].as<int64_t>() : blockChain->number() + 1;
+    auto to = params.count("to") ? params["to"].as<int64_t>() : source->number();
+    if (from != blockChain->number() + 1 || to > source->number() || from > to)
+    {
+        cout << "the state ledger is at " << blockChain->number() << ", the source is at "
+             << source->number() << ", the blocks replayed must be from "
+             << blockChain->number() + 1 << " to at most " << source->number() << endl;
+        return 1;
+    }
+    if (source->numberHash(from - 1) != blockChain->numberHash(from - 1))
+    {
+        cout << "the block " << from - 1 << " of the state ledger is not the one of the source"
+             << endl;
+        return 1;
+    }
+
+    auto parallel = params["mode"].as<string>() == "parallel";
+    auto cold = params["cache"].as<string>() == "cold";
+    auto repeat = std::max(params["repeat"].as<int>(), 1);
+    auto blockVerifier = std::make_shared<BlockVerifier>(parallel);
+    blockVerifier->setExecutiveContextFactory(dbInitializer->executiveContextFactory());
+    blockVerifier->setNumberHash([source](int64_t _number) { return source->numberHash(_number); });
+    blockVerifier->setEvmFlags(ledgerParam->mutableGenesisParam().evmFlags);
+    blockVerifier->setEnablePrefetch(ledgerParam->mutableTxParam().enablePrefetch);
+    blockVerifier->setEnableOptimistic(ledgerParam->mutableTxParam().enableOptimistic);
+    if (cold && !dbInitializer->cachedStorage())
+    {
+        cout << "CachedStorage is disabled, the cache mode cold is the same as warm" << endl;
+    }
+    cout << "replay blocks " << from << " to " << to
+         << " mode=" << (parallel ? "parallel" : "serial") << " cache=" << (cold ? "cold" : "warm")
+         << " repeat=" << repeat << endl;
+
+    vector<Sample> samples;
+    size_t txs = 0;
+    double elapsed = 0;
+    cout << std::setiosflags(std::ios::fixed) << std::setprecision(2);
+    for (auto number = from; number <= to; ++number)
+    {
+        auto sourceBlock = source->getBlockByNumber(number);
+        auto parent = blockChain->getBlockByNumber(number - 1);
+        BlockInfo parentInfo{
+            parent->header().hash(), parent->header().number(), parent->header().stateRoot()};
+
+        std::shared_ptr<Block> block;
+        ExecutiveContext::Ptr context;
+        Sample average;
+        for (int i = cold ? 0 : -1; i < repeat; ++i)
+        {
+            // the execution changes the block, so it is decoded again every time
+            block = std::make_shared<Block>(*source->getBlockRLPByNumber(number),
+                CheckTransaction::None);
+            for (auto& tx : *block->transactions())
+            {
+                tx->sender();
+            }
+            // the roots are verified here instead of by BlockVerifier, which only throws
+            block->header().setRoots(block->header().transactionsRoot(), h256(), h256());
+            if (cold)
+            {
+                dropCache(*dbInitializer, blockChain->number());
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            context = parallel ? blockVerifier->parallelExecuteBlock(*block, parentInfo) :
+                                 blockVerifier->serialExecuteBlock(*block, parentInfo);
+            auto executed = std::chrono::steady_clock::now();
+            auto tableFactory =
+                std::dynamic_pointer_cast<MemoryTableFactory2>(context->getMemoryTableFactory());
+            if (tableFactory)
+            {
+                tableFactory->exportData();
+            }
+            auto dumped = std::chrono::steady_clock::now();
+            if (i < 0)
+            {
+                continue;
+            }
+
+            Sample sample;
+            sample.dump = std::chrono::duration<double, std::milli>(dumped - executed).count();
+            sample.total = std::chrono::duration<double, std::milli>(dumped - start).count();
+            sample.stages = context->timeCost();
+            samples.push_back(sample);
+            average.total += sample.total / repeat;
+            average.dump += sample.dump / repeat;
+            average.stages.initContext += sample.stages.initContext;
+            average.stages.prefetch += sample.stages.prefetch;
+            average.stages.initDag += sample.stages.initDag;
+            average.stages.execute += sample.stages.execute;
+            average.stages.hash += sample.stages.hash;
+        }
+
+        if (!verify(*block, *sourceBlock))
+        {
+            return 1;
+        }
+        auto blockTxs = block->transactions()->size();
+        cout << "block=" << number << " txs=" << blockTxs << " total(ms)=" << average.total
+             << " initContext=" << double(average.stages.initContext) / repeat
+             << " prefetch=" << double(average.stages.prefetch) / repeat
+             << " initDag=" << double(average.stages.initDag) / repeat
+             << " execute=" << double(average.stages.execute) / repeat
+             << " hash=" << double(average.stages.hash) / repeat << " dump=" << average.dump
+             << " tps=" << (average.total > 0 ? blockTxs * 1000 / average.total : 0) << endl;
+        txs += blockTxs;
+        elapsed += average.total;
+
+        if (blockChain->commitBlock(block, context) != CommitResult::OK)
+        {
+            cout << "commit block " << number << " to the state ledger failed" << endl;
+            return 1;
+        }
+    }
+
+    cout << "blocks=" << to - from + 1 << " txs=" << txs
+         << " tps=" << (elapsed > 0 ? txs * 1000 / elapsed : 0) << endl;
+    vector<pair<string, std::function<double(Sample const&)>>> stages{
+        {"total", [](Sample const& _s) { return _s.total; }},
+        {"initContext", [](Sample const& _s) { return _s.stages.initContext; }},
+        {"prefetch", [](Sample const& _s) { return _s.stages.prefetch; }},
+        {"initDag", [](Sample const& _s) { return _s.stages.initDag; }},
+        {"execute", [](Sample const& _s) { return _s.stages.execute; }},
+        {"hash", [](Sample const& _s) { return _s.stages.hash; }},
+        {"dump", [](Sample const& _s) { return _s.dump; }}};
+    cout << std::left << std::setw(12) << "stage(ms)" << std::right << std::setw(10) << "p50"
+         << std::setw(10) << "p90" << std::setw(10) << "p99" << std::setw(10) << "max" << endl;
+    for (auto const& stage : stages)
+    {
+        vector<double> values;
+        for (auto const& sample : samples)
+        {
+            values.push_back(stage.second(sample));
+        }
+        cout << std::left << std::setw(12) << stage.first << std::right << std::setw(10)
+             << percentile(values, 50) << std::setw(10) << percentile(values, 90)
+             << std::setw(10) << percentile(values, 99) << std::setw(10)
+             << percentile(values, 100) << endl;
+    }
+    return 0;
+}
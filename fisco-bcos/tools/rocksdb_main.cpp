@@ -23,10 +23,15 @@
 #include "libstorage/BasicRocksDB.h"
 #include "libstorage/MemoryTableFactory2.h"
 #include "libstorage/RocksDBStorage.h"
+#include "libstorage/RowCodec.h"
+#include "libstorage/RowPruner.h"
+#include "libstorage/StateSnapshot.h"
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/program_options.hpp>
+#include <set>
 
 using namespace std;
 using namespace dev;
@@ -47,7 +52,12 @@ po::variables_map initCommandLine(int argc, const char* argv[])
         po::value<vector<string>>()->multitoken(), "[TableName] [priKey] [Key] [NewValue]")(
         "insert,i", po::value<vector<string>>()->multitoken(),
         "[TableName] [priKey] [Key]:[Value],...,[Key]:[Value]")(
-        "remove,r", po::value<vector<string>>()->multitoken(), "[TableName] [priKey]");
+        "remove,r", po::value<vector<string>>()->multitoken(), "[TableName] [priKey]")("migrate,m",
+        "convert all rows of the legacy boost::archive format to the v1 row format, the node must "
+        "be stopped and disk encryption must be disabled")("reclaimable,g",
+        po::value<string>(),
+        "[RetentionBlocks] report the space of every table reclaimable by pruning tombstones older "
+        "than RetentionBlocks, disk encryption must be disabled");
     po::variables_map vm;
     try
     {
@@ -111,6 +121,216 @@ Storage::Ptr createRocksDBStorage(const std::string& _dbPath)
     return rocksdbStorage;
 }
 
+int migrateRowFormat(const std::string& _dbPath)
+{
+    auto rocksDB = std::make_shared<BasicRocksDB>();
+    auto options = getRocksDBOptions();
+    options.create_if_missing = false;
+    rocksDB->Open(options, _dbPath);
+
+    const size_t batchSize = 1000;
+    size_t total = 0;
+    size_t migrated = 0;
+    size_t legacyBytes = 0;
+    size_t v1Bytes = 0;
+    rocksdb::WriteBatch batch;
+    auto writeBatch = [&]() {
+        if (batch.Count() == 0)
+        {
+            return;
+        }
+        rocksdb::WriteOptions writeOptions;
+        writeOptions.sync = true;
+        rocksDB->Write(writeOptions, batch);
+        batch.Clear();
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    auto it = rocksDB->NewIterator(rocksdb::ReadOptions());
+    for (it->SeekToFirst(); it->Valid(); it->Next())
+    {
+        ++total;
+        auto value = it->value().ToString();
+        if (rowFormat(value) != RowFormat::Legacy)
+        {
+            continue;
+        }
+        Rows rows;
+        try
+        {
+            decodeRows(value, rows);
+        }
+        catch (std::exception& e)
+        {
+            writeBatch();
+            cout << "decode key " << it->key().ToString()
+                 << " failed, stop migration: " << boost::diagnostic_information(e) << endl;
+            return -1;
+        }
+        string newValue;
+        encodeRows(rows, newValue, RowFormat::V1);
+        legacyBytes += value.size();
+        v1Bytes += newValue.size();
+        rocksDB->Put(batch, it->key().ToString(), newValue);
+        if (++migrated % batchSize == 0)
+        {
+            writeBatch();
+            cout << "\rmigrated keys: " << migrated << flush;
+        }
+    }
+    if (!it->status().ok())
+    {
+        cout << endl << "iterate rocksdb failed: " << it->status().ToString() << endl;
+        return -1;
+    }
+    writeBatch();
+    it.reset();
+    rocksDB->flush();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    cout << endl
+         << "migration finished, keys=" << total << " migrated=" << migrated
+         << " legacyBytes=" << legacyBytes << " v1Bytes=" << v1Bytes
+         << " time used(s)=" << elapsed.count() << endl;
+    return 0;
+}
+
+struct ReclaimableStat
+{
+    size_t keys = 0;
+    size_t bytes = 0;
+    size_t tombstones = 0;
+    size_t prunableRows = 0;
+    size_t removableKeys = 0;
+    size_t reclaimableBytes = 0;
+};
+
+int reportReclaimable(const std::string& _dbPath, int64_t _retention)
+{
+    auto rocksDB = std::make_shared<BasicRocksDB>();
+    auto options = getRocksDBOptions();
+    options.create_if_missing = false;
+    rocksDB->Open(options, _dbPath);
+
+    auto currentNumber = StateSnapshotExporter::currentNumber(rocksDB, rocksdb::ReadOptions());
+    auto pruneNumber = std::max(currentNumber - _retention, int64_t(-1));
+    // rows of a table are stored as "table_key", table names may contain '_'
+    std::set<std::string> tables{SYS_TABLES};
+    auto tablesPrefix = SYS_TABLES + "_";
+    rocksDB->Scan(rocksdb::ReadOptions(), tablesPrefix, SYS_TABLES + "`",
+        [&](const std::string& _key, std::string&) {
+            tables.insert(_key.substr(tablesPrefix.size()));
+            return true;
+        });
+    auto tableOf = [&](const std::string& _key) -> std::string {
+        for (auto pos = _key.rfind('_'); pos != std::string::npos && pos > 0;
+             pos = _key.rfind('_', pos - 1))
+        {
+            auto table = _key.substr(0, pos);
+            if (tables.count(table))
+            {
+                return table;
+            }
+        }
+        return "<unknown>";
+    };
+
+    std::map<std::string, ReclaimableStat> stats;
+    ReclaimableStat total;
+    // index keys are derived from the rows, they are reported apart from the tables
+    size_t indexKeys = 0;
+    size_t indexBytes = 0;
+    auto it = rocksDB->NewIterator(rocksdb::ReadOptions());
+    for (it->SeekToFirst(); it->Valid(); it->Next())
+    {
+        auto key = it->key().ToString();
+        auto value = it->value().ToString();
+        if (!isRowKey(key))
+        {
+            if (isIndexKey(key))
+            {
+                ++indexKeys;
+                indexBytes += key.size() + value.size();
+            }
+            continue;
+        }
+        auto& stat = stats[tableOf(key)];
+        ++stat.keys;
+        stat.bytes += key.size() + value.size();
+        Rows rows;
+        try
+        {
+            decodeRows(value, rows);
+        }
+        catch (std::exception&)
+        {
+            continue;
+        }
+        for (auto const& row : rows)
+        {
+            auto status = row.find(STATUS);
+            if (status == row.end() || status->second == "0")
+            {
+                continue;
+            }
+            ++stat.tombstones;
+            auto num = row.find(NUM_FIELD);
+            try
+            {
+                if (num != row.end() && boost::lexical_cast<int64_t>(num->second) <= pruneNumber)
+                {
+                    ++stat.prunableRows;
+                }
+            }
+            catch (boost::bad_lexical_cast&)
+            {  // a malformed row is never pruned
+                continue;
+            }
+        }
+        std::string pruned;
+        if (RowPruner::prune(key, value, pruneNumber, pruned))
+        {
+            if (pruned.empty())
+            {
+                ++stat.removableKeys;
+                stat.reclaimableBytes += key.size() + value.size();
+            }
+            else if (value.size() > pruned.size())
+            {
+                stat.reclaimableBytes += value.size() - pruned.size();
+            }
+        }
+    }
+    if (!it->status().ok())
+    {
+        cout << "iterate rocksdb failed: " << it->status().ToString() << endl;
+        return -1;
+    }
+    it.reset();
+
+    cout << "current number=" << currentNumber << " retention=" << _retention
+         << " pruneNumber=" << pruneNumber << endl;
+    cout << "table keys bytes tombstones prunableRows removableKeys reclaimableBytes" << endl;
+    for (auto const& item : stats)
+    {
+        auto const& stat = item.second;
+        cout << item.first << " " << stat.keys << " " << stat.bytes << " " << stat.tombstones
+             << " " << stat.prunableRows << " " << stat.removableKeys << " "
+             << stat.reclaimableBytes << endl;
+        total.keys += stat.keys;
+        total.bytes += stat.bytes;
+        total.tombstones += stat.tombstones;
+        total.prunableRows += stat.prunableRows;
+        total.removableKeys += stat.removableKeys;
+        total.reclaimableBytes += stat.reclaimableBytes;
+    }
+    cout << "total " << total.keys << " " << total.bytes << " " << total.tombstones << " "
+         << total.prunableRows << " " << total.removableKeys << " " << total.reclaimableBytes
+         << endl;
+    cout << "indices " << indexKeys << " " << indexBytes << ", never pruned" << endl;
+    return 0;
+}
+
 int main(int argc, const char* argv[])
 {
     // init log
@@ -121,6 +341,30 @@ int main(int argc, const char* argv[])
     auto params = initCommandLine(argc, argv);
     auto storagePath = params["path"].as<string>();
     cout << "DB path : " << storagePath << endl;
+    if (params.count("migrate") || params.count("m"))
+    {
+        return migrateRowFormat(storagePath);
+    }
+    if (params.count("reclaimable"))
+    {
+        int64_t retention = 0;
+        try
+        {
+            retention = boost::lexical_cast<int64_t>(params["reclaimable"].as<string>());
+        }
+        catch (boost::bad_lexical_cast&)
+        {
+            cout << "invalid RetentionBlocks: " << params["reclaimable"].as<string>() << endl;
+            cout << main_options << endl;
+            return -1;
+        }
+        if (retention < 0)
+        {
+            cout << "RetentionBlocks must not be negative" << endl;
+            return -1;
+        }
+        return reportReclaimable(storagePath, retention);
+    }
     auto rocksdbStorage = createRocksDBStorage(storagePath);
     MemoryTableFactory2::Ptr tableFactory = std::make_shared<MemoryTableFactory2>();
     tableFactory->setStateStorage(rocksdbStorage);
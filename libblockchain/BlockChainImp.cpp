@@ -28,9 +28,11 @@
 #include <libethcore/CommonJS.h>
 #include <libethcore/Transaction.h>
 #include <libprecompiled/ConsensusPrecompiled.h>
+#include <libstorage/MemoryTableFactory2.h>
 #include <libstorage/StorageException.h>
 #include <libstorage/Table.h>
 #include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
 #include <boost/lexical_cast.hpp>
@@ -96,6 +98,13 @@ std::pair<std::shared_ptr<Block>, h256> BlockCache::get(h256 const& _hash)
     return std::make_pair(nullptr, h256(0));  // just make compiler happy
 }
 
+void BlockCache::clear()
+{
+    WriteGuard guard(m_sharedMutex);
+    m_blockCache.clear();
+    m_blockCacheFIFO.clear();
+}
+
 void BlockChainImp::setStateStorage(Storage::Ptr stateStorage)
 {
     m_stateStorage = stateStorage;
@@ -156,6 +165,7 @@ std::shared_ptr<Block> BlockChainImp::getBlock(dev::h256 const& _blockHash, int6
         BLOCKCHAIN_LOG(TRACE) << LOG_DESC("[#getBlock]Cache missed, read from storage")
                               << LOG_KV("blockNumber", _blockNumber);
         ;
+        waitForIndexed();
         Table::Ptr tb = getMemoryTableFactory(_blockNumber)->openTable(SYS_HASH_2_BLOCK);
         auto openTable_time_cost = utcTime() - record_time;
         record_time = utcTime();
@@ -240,6 +250,7 @@ std::shared_ptr<bytes> BlockChainImp::getBlockRLP(dev::h256 const& _blockHash, i
     else
     {
         BLOCKCHAIN_LOG(TRACE) << LOG_DESC("[#getBlockRLP]Cache missed, read from storage");
+        waitForIndexed();
         Table::Ptr tb = getMemoryTableFactory(_blockNumber)->openTable(SYS_HASH_2_BLOCK);
         auto openTable_time_cost = utcTime() - record_time;
         record_time = utcTime();
@@ -273,6 +284,61 @@ std::shared_ptr<bytes> BlockChainImp::getBlockRLP(dev::h256 const& _blockHash, i
     }
 }
 
+BlockChainImp::~BlockChainImp()
+{
+    if (m_pendingIndex.valid())
+    {
+        m_pendingIndex.wait();
+    }
+}
+
+int64_t BlockChainImp::indexedNumber()
+{
+    auto indexedNumber = m_indexedNumber.load();
+    return indexedNumber < 0 ? number() : indexedNumber;
+}
+
+// the number is published before the block data and tx index of the block are written, so the
+// readers of them wait for the index of the blocks published
+void BlockChainImp::waitForIndexed()
+{
+    auto blockNumber = number();
+    if (indexedNumber() >= blockNumber)
+    {
+        return;
+    }
+    std::unique_lock<std::mutex> l(x_indexedNumber);
+    m_indexSignal.wait(
+        l, [&]() { return m_indexFailed || m_indexedNumber.load() >= blockNumber; });
+}
+
+void BlockChainImp::reloadFromStorage()
+{
+    int64_t blockNumber = 0;
+    {
+        std::lock_guard<std::mutex> l(commitMutex);
+        waitForIndex();
+        m_indexedNumber = -1;
+        blockNumber = obtainNumber();
+        {
+            WriteGuard l(m_blockNumberMutex);
+            m_blockNumber = blockNumber;
+        }
+        {
+            WriteGuard l(m_nodeListMutex);
+            m_cacheNumBySealer = -1;
+            m_cacheNumByObserver = -1;
+        }
+        {
+            WriteGuard l(m_systemConfigMutex);
+            m_systemConfigRecord.clear();
+        }
+        m_blockCache.clear();
+    }
+    BLOCKCHAIN_LOG(INFO) << LOG_DESC("reloadFromStorage") << LOG_KV("number", blockNumber);
+    m_onReady(blockNumber);
+}
+
 int64_t BlockChainImp::number()
 {
     UpgradableGuard ul(m_blockNumberMutex);
@@ -312,6 +378,7 @@ std::shared_ptr<std::vector<dev::eth::NonceKeyType>> BlockChainImp::getNonces(in
         return std::shared_ptr<std::vector<dev::eth::NonceKeyType>>();
     }
     BLOCKCHAIN_LOG(DEBUG) << LOG_DESC("getNonces") << LOG_KV("blkNumber", _blockNumber);
+    waitForIndexed();
     Table::Ptr tb = getMemoryTableFactory(_blockNumber)->openTable(SYS_BLOCK_2_NONCES);
     if (tb)
     {
@@ -791,6 +858,7 @@ std::shared_ptr<bytes> BlockChainImp::getBlockRLPByNumber(int64_t _i)
 
 Transaction::Ptr BlockChainImp::getTxByHash(dev::h256 const& _txHash)
 {
+    waitForIndexed();
     Table::Ptr tb = getMemoryTableFactory()->openTable(SYS_TX_HASH_2_BLOCK, false, true);
     if (tb)
     {
@@ -820,6 +888,7 @@ Transaction::Ptr BlockChainImp::getTxByHash(dev::h256 const& _txHash)
 
 LocalisedTransaction::Ptr BlockChainImp::getLocalisedTxByHash(dev::h256 const& _txHash)
 {
+    waitForIndexed();
     Table::Ptr tb = getMemoryTableFactory()->openTable(SYS_TX_HASH_2_BLOCK, false, true);
     if (tb)
     {
@@ -854,6 +923,7 @@ LocalisedTransaction::Ptr BlockChainImp::getLocalisedTxByHash(dev::h256 const& _
 bool BlockChainImp::getBlockAndIndexByTxHash(const dev::h256& _txHash,
     std::pair<std::shared_ptr<dev::eth::Block>, std::string>& blockInfoWithTxIndex)
 {
+    waitForIndexed();
     Table::Ptr tb = getMemoryTableFactory()->openTable(SYS_TX_HASH_2_BLOCK, false, true);
     if (!tb)
     {
@@ -994,6 +1064,7 @@ void BlockChainImp::getMerkleProof(dev::bytes const& _txHash,
 
 TransactionReceipt::Ptr BlockChainImp::getTransactionReceiptByHash(dev::h256 const& _txHash)
 {
+    waitForIndexed();
     Table::Ptr tb = getMemoryTableFactory()->openTable(SYS_TX_HASH_2_BLOCK, false, true);
     if (tb)
     {
@@ -1174,6 +1245,7 @@ std::shared_ptr<MerkleProofType> BlockChainImp::getTransactionProof(
 LocalisedTransactionReceipt::Ptr BlockChainImp::getLocalisedTxReceiptByHash(
     dev::h256 const& _txHash)
 {
+    waitForIndexed();
     Table::Ptr tb = getMemoryTableFactory()->openTable(SYS_TX_HASH_2_BLOCK, false, true);
     if (tb)
     {
@@ -1396,6 +1468,135 @@ bool BlockChainImp::isBlockShouldCommit(int64_t const& _blockNumber)
     return true;
 }
 
+// give up the deferred commit of a block, called on error paths, so it never throws
+void BlockChainImp::cancelDeferCommit(int64_t _number)
+{
+    try
+    {
+        m_stateStorage->cancelDefer(_number);
+    }
+    catch (std::exception const& e)
+    {
+        BLOCKCHAIN_LOG(ERROR) << LOG_DESC("Cancel the deferred commit failed")
+                              << LOG_KV("number", _number)
+                              << LOG_KV("EINFO", boost::diagnostic_information(e));
+    }
+}
+
+void BlockChainImp::waitForIndex()
+{
+    if (m_pendingIndex.valid())
+    {
+        // rethrow the exception of the index thread
+        m_pendingIndex.get();
+    }
+}
+
+// write the block data, tx index and nonces of a committed block, the storage persists them
+// together with the state of the block, which has been committed by commitBlock
+void BlockChainImp::writeIndex(std::shared_ptr<Block> _block, uint64_t _firstID)
+{
+    auto start_time = utcTime();
+    auto record_time = utcTime();
+    auto number = _block->blockHeader().number();
+    bool indexed = false;
+    // wake up the readers waiting for the index even if it fails
+    ScopeGuard notifyReaders([&]() {
+        if (!indexed)
+        {
+            cancelDeferCommit(number);
+        }
+        {
+            std::lock_guard<std::mutex> l(x_indexedNumber);
+            if (indexed)
+            {
+                m_indexedNumber = number;
+            }
+            else
+            {
+                m_indexFailed = true;
+            }
+        }
+        m_indexSignal.notify_all();
+    });
+    auto newEntry = [number](TableData::Ptr _data, std::string const& _key, uint64_t _id) {
+        Entry::Ptr entry = std::make_shared<Entry>();
+        entry->setID(_id);
+        entry->setNum(number);
+        entry->setField(_data->info->key, _key);
+        entry->setForce(true);
+        return entry;
+    };
+    auto newTableData = [](std::string const& _tableName) {
+        // the same table info as MemoryTableFactory2::openTable
+        auto data = std::make_shared<TableData>();
+        data->info = getSysTableInfo(_tableName);
+        data->info->fields.emplace_back(STATUS);
+        data->info->fields.emplace_back(data->info->key);
+        data->info->fields.emplace_back(NUM_FIELD);
+        data->info->fields.emplace_back(ID_FIELD);
+        return data;
+    };
+
+    auto hash2Block = newTableData(SYS_HASH_2_BLOCK);
+    auto blockEntry = newEntry(hash2Block, _block->blockHeader().hash().hex(), _firstID);
+    writeBlockToField(*_block, blockEntry);
+    hash2Block->newEntries->addEntry(blockEntry);
+    auto encodeBlock_time_cost = utcTime() - record_time;
+    record_time = utcTime();
+
+    auto txs = _block->transactions();
+    auto txHash2Block = newTableData(SYS_TX_HASH_2_BLOCK);
+    txHash2Block->newEntries->resize(txs->size());
+    std::vector<dev::eth::NonceKeyType> nonce_vector(txs->size());
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, txs->size()), [&](const tbb::blocked_range<size_t>& _r) {
+            for (size_t i = _r.begin(); i != _r.end(); ++i)
+            {
+                auto entry = newEntry(txHash2Block, (*txs)[i]->sha3().hex(), _firstID + 1 + i);
+                entry->setField(SYS_VALUE, lexical_cast<std::string>(number));
+                entry->setField("index", lexical_cast<std::string>(i));
+                (*txHash2Block->newEntries)[i] = entry;
+                nonce_vector[i] = (*txs)[i]->nonce();
+            }
+        });
+    tbb::parallel_sort(txHash2Block->newEntries->begin(), txHash2Block->newEntries->end(),
+        EntryLessNoLock(txHash2Block->info));
+
+    auto block2Nonces = newTableData(SYS_BLOCK_2_NONCES);
+    auto nonceEntry =
+        newEntry(block2Nonces, lexical_cast<std::string>(number), _firstID + 1 + txs->size());
+    RLPStream rs;
+    rs.appendVector(nonce_vector);
+    std::shared_ptr<bytes> nonceData = std::make_shared<bytes>();
+    rs.swapOut(*nonceData);
+    writeBytesToField(nonceData, nonceEntry, SYS_VALUE);
+    block2Nonces->newEntries->addEntry(nonceEntry);
+    auto writeTxToBlock_time_cost = utcTime() - record_time;
+    record_time = utcTime();
+
+    // sorted by table name, the same as MemoryTableFactory2::commitDB
+    std::vector<TableData::Ptr> datas{block2Nonces, hash2Block, txHash2Block};
+    try
+    {
+        m_stateStorage->commit(number, datas);
+    }
+    catch (StorageException& e)
+    {
+        BLOCKCHAIN_LOG(FATAL) << LOG_BADGE("WriteIndex: storage exception")
+                              << LOG_KV("EINFO", boost::diagnostic_information(e));
+        raise(SIGTERM);
+        throw;
+    }
+    indexed = true;
+    BLOCKCHAIN_LOG(DEBUG) << LOG_BADGE("WriteIndex") << LOG_DESC("Write index time record")
+                          << LOG_KV("number", number)
+                          << LOG_KV("encodeBlockTimeCost", encodeBlock_time_cost)
+                          << LOG_KV("writeTxToBlockTimeCost", writeTxToBlock_time_cost)
+                          << LOG_KV("commitTimeCost", utcTime() - record_time)
+                          << LOG_KV("totalTimeCost", utcTime() - start_time);
+}
+
 CommitResult BlockChainImp::commitBlock(
     std::shared_ptr<Block> block, std::shared_ptr<ExecutiveContext> context)
 {
@@ -1427,8 +1628,39 @@ CommitResult BlockChainImp::commitBlock(
                 return CommitResult::ERROR_PARENT_HASH;
             }
             auto write_record_time = utcTime();
-            // writeBlockInfo(block, context);
-            writeHash2Block(*block, context);
+            waitForIndex();
+            auto waitForIndex_time_cost = utcTime() - write_record_time;
+            write_record_time = utcTime();
+
+            // the block data and tx index are written by the index thread if the storage can
+            // persist them together with the state of this block
+            auto tableFactory =
+                std::dynamic_pointer_cast<MemoryTableFactory2>(context->getMemoryTableFactory());
+            bool asyncIndex = m_enableAsyncCommit && tableFactory &&
+                              m_stateStorage->deferCommit(block->blockHeader().number());
+            bool indexHandedOver = false;
+            // the second part of the deferred commit never comes if the index is not handed over
+            ScopeGuard cancelDefer([&]() {
+                if (asyncIndex && !indexHandedOver)
+                {
+                    cancelDeferCommit(block->blockHeader().number());
+                }
+            });
+            uint64_t firstID = 0;
+            if (asyncIndex)
+            {
+                firstID = tableFactory->reserveIDs(block->transactions()->size() + 2);
+            }
+            else
+            {
+                {
+                    // the pending index has been written, and this block is indexed with its state
+                    std::lock_guard<std::mutex> l(x_indexedNumber);
+                    m_indexedNumber = -1;
+                }
+                // writeBlockInfo(block, context);
+                writeHash2Block(*block, context);
+            }
             auto writeHash2Block_time_cost = utcTime() - write_record_time;
             write_record_time = utcTime();
 
@@ -1444,7 +1676,10 @@ CommitResult BlockChainImp::commitBlock(
             auto writeTotalTransactionCount_time_cost = utcTime() - write_record_time;
             write_record_time = utcTime();
 
-            writeTxToBlock(*block, context);
+            if (!asyncIndex)
+            {
+                writeTxToBlock(*block, context);
+            }
             auto writeTxToBlock_time_cost = utcTime() - write_record_time;
             write_record_time = utcTime();
             try
@@ -1460,6 +1695,23 @@ CommitResult BlockChainImp::commitBlock(
             }
             auto dbCommit_time_cost = utcTime() - write_record_time;
             write_record_time = utcTime();
+            if (asyncIndex)
+            {
+                {
+                    std::lock_guard<std::mutex> l(x_indexedNumber);
+                    m_indexedNumber = block->blockHeader().number() - 1;
+                    m_indexFailed = false;
+                }
+                if (!m_indexThread)
+                {
+                    m_indexThread = std::make_shared<dev::ThreadPool>("commitIndex", 1);
+                }
+                auto task = std::make_shared<std::packaged_task<void()>>(
+                    std::bind(&BlockChainImp::writeIndex, this, block, firstID));
+                m_pendingIndex = task->get_future();
+                m_indexThread->enqueue([task]() { (*task)(); });
+                indexHandedOver = true;
+            }
             {
                 WriteGuard ll(m_blockNumberMutex);
                 m_blockNumber = block->blockHeader().number();
@@ -1468,6 +1720,8 @@ CommitResult BlockChainImp::commitBlock(
 
             BLOCKCHAIN_LOG(DEBUG) << LOG_BADGE("Commit")
                                   << LOG_DESC("Commit block time record(write)")
+                                  << LOG_KV("asyncIndex", asyncIndex)
+                                  << LOG_KV("waitForIndexTimeCost", waitForIndex_time_cost)
                                   << LOG_KV("writeHash2BlockTimeCost", writeHash2Block_time_cost)
                                   << LOG_KV("writeNumber2HashTimeCost", writeNumber2Hash_time_cost)
                                   << LOG_KV("writeNumberTimeCost", writeNumber_time_cost)
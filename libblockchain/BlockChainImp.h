@@ -25,6 +25,7 @@
 #include "BlockChainInterface.h"
 
 #include <libdevcore/Exceptions.h>
+#include <libdevcore/ThreadPool.h>
 #include <libethcore/Block.h>
 #include <libethcore/Common.h>
 #include <libethcore/Protocol.h>
@@ -37,7 +38,10 @@
 #include <libstorage/Table.h>
 #include <libstoragestate/StorageStateFactory.h>
 #include <boost/thread/shared_mutex.hpp>
+#include <atomic>
+#include <condition_variable>
 #include <deque>
+#include <future>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -65,6 +69,7 @@ public:
     BlockCache(){};
     std::shared_ptr<dev::eth::Block> add(std::shared_ptr<dev::eth::Block> _block);
     std::pair<std::shared_ptr<dev::eth::Block>, dev::h256> get(h256 const& _hash);
+    void clear();
 
 private:
     mutable boost::shared_mutex m_sharedMutex;
@@ -79,7 +84,7 @@ class BlockChainImp : public BlockChainInterface
 {
 public:
     BlockChainImp() {}
-    virtual ~BlockChainImp(){};
+    virtual ~BlockChainImp();
     int64_t number() override;
     dev::h256 numberHash(int64_t _i) override;
     dev::eth::Transaction::Ptr getTxByHash(dev::h256 const& _txHash) override;
@@ -129,6 +134,14 @@ public:
         dev::h256 const& _txHash, dev::eth::LocalisedTransaction& transaction) override;
 
     void setEnableHexBlock(bool const& _enableHexBlock) { m_enableHexBlock = _enableHexBlock; }
+    // write the block data and tx index of a committed block on the index thread, the state and
+    // block number are published first, and the next commitBlock waits for the index
+    void setEnableAsyncCommit(bool _enableAsyncCommit) { m_enableAsyncCommit = _enableAsyncCommit; }
+    // the latest block whose block data and tx index are visible in storage
+    int64_t indexedNumber();
+    // reload the block number and drop the caches after the state of the storage has been
+    // replaced, e.g. by a state snapshot, and notify the new block number
+    void reloadFromStorage();
 
     std::shared_ptr<MerkleProofType> getTransactionReceiptProof(
         dev::eth::Block::Ptr _block, uint64_t const& _index) override;
@@ -176,6 +189,10 @@ private:
         dev::eth::Block& block, std::shared_ptr<dev::blockverifier::ExecutiveContext> context);
 
     bool isBlockShouldCommit(int64_t const& _blockNumber);
+    void writeIndex(std::shared_ptr<dev::eth::Block> _block, uint64_t _firstID);
+    void waitForIndex();
+    void waitForIndexed();
+    void cancelDeferCommit(int64_t _number);
 
     void parseMerkleMap(
         std::shared_ptr<std::map<std::string, std::vector<std::string>>> parent2ChildList,
@@ -233,6 +250,17 @@ private:
     mutable SharedMutex m_receiptWithProofMutex;
 
     bool m_enableHexBlock = false;
+
+    bool m_enableAsyncCommit = false;
+    // -1 means every committed block is indexed
+    std::atomic<int64_t> m_indexedNumber{-1};
+    // notified when the index of a block is written or fails
+    std::mutex x_indexedNumber;
+    std::condition_variable m_indexSignal;
+    bool m_indexFailed = false;
+    // the index of at most one block is pending
+    std::future<void> m_pendingIndex;
+    dev::ThreadPool::Ptr m_indexThread;
 };
 }  // namespace blockchain
 }  // namespace dev
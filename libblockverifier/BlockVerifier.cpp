@@ -20,15 +20,22 @@
  */
 #include "BlockVerifier.h"
 #include "ExecutiveContext.h"
+#include "OptimisticExecutor.h"
 #include "TxDAG.h"
 #include "libstorage/StorageException.h"
 #include <libethcore/Exceptions.h>
 #include <libethcore/PrecompiledContract.h>
 #include <libethcore/TransactionReceipt.h>
 #include <libexecutive/ExecutionResult.h>
+#include <libstorage/MemoryTableFactory2.h>
+#include <libstorage/SpeculativeTableFactory.h>
+#include <libstorage/Storage.h>
 #include <libstorage/Table.h>
+#include <libstoragestate/StorageState.h>
 #include <tbb/parallel_for.h>
 #include <exception>
+#include <map>
+#include <set>
 #include <thread>
 
 using namespace dev;
@@ -76,8 +83,51 @@ ExecutiveContext::Ptr BlockVerifier::executeBlock(Block& block, BlockInfo const&
     return context;
 }
 
+ExecutiveContext::Ptr BlockVerifier::executeBlockAhead(
+    Block& block, BlockInfo const& parentBlockInfo, Storage::Ptr _stateStorage)
+{
+    if (g_BCOSConfig.shouldExit)
+    {
+        return nullptr;
+    }
+    // not serialized with executeBlock, the block is executed on its own state storage and the
+    // result is dropped if the parent is not the one committed
+    try
+    {
+        if (g_BCOSConfig.version() >= RC2_VERSION && m_enableParallel)
+        {
+            return parallelExecuteBlock(block, parentBlockInfo, _stateStorage);
+        }
+        return serialExecuteBlock(block, parentBlockInfo, _stateStorage);
+    }
+    catch (exception& e)
+    {
+        BLOCKVERIFIER_LOG(WARNING) << LOG_BADGE("executeBlockAhead")
+                                   << LOG_DESC("executeBlockAhead exception")
+                                   << LOG_KV("blockNumber", block.blockHeader().number())
+                                   << LOG_KV("EINFO", boost::diagnostic_information(e));
+    }
+    return nullptr;
+}
+
+BlockVerifier::NumberHashCallBackFunction BlockVerifier::numberHash(
+    BlockInfo const& _parentBlockInfo)
+{
+    // the parent may not be committed when the block is executed ahead
+    auto parentNumber = _parentBlockInfo.number;
+    auto parentHash = _parentBlockInfo.hash;
+    auto numberHash = m_pNumberHash;
+    return [parentNumber, parentHash, numberHash](int64_t _number) -> h256 {
+        if (_number == parentNumber)
+        {
+            return parentHash;
+        }
+        return numberHash(_number);
+    };
+}
+
 ExecutiveContext::Ptr BlockVerifier::serialExecuteBlock(
-    Block& block, BlockInfo const& parentBlockInfo)
+    Block& block, BlockInfo const& parentBlockInfo, Storage::Ptr _stateStorage)
 {
     BLOCKVERIFIER_LOG(INFO) << LOG_DESC("executeBlock]Executing block")
                             << LOG_KV("txNum", block.transactions()->size())
@@ -96,8 +146,16 @@ ExecutiveContext::Ptr BlockVerifier::serialExecuteBlock(
     ExecutiveContext::Ptr executiveContext = std::make_shared<ExecutiveContext>();
     try
     {
-        m_executiveContextFactory->initExecutiveContext(
-            parentBlockInfo, parentBlockInfo.stateRoot, executiveContext);
+        if (_stateStorage)
+        {
+            m_executiveContextFactory->initExecutiveContext(
+                parentBlockInfo, parentBlockInfo.stateRoot, executiveContext, _stateStorage);
+        }
+        else
+        {
+            m_executiveContextFactory->initExecutiveContext(
+                parentBlockInfo, parentBlockInfo.stateRoot, executiveContext);
+        }
     }
     catch (exception& e)
     {
@@ -114,8 +172,10 @@ ExecutiveContext::Ptr BlockVerifier::serialExecuteBlock(
     block.resizeTransactionReceipt(block.transactions()->size());
 
 
+    ExecutionTimeCost timeCost;
+    timeCost.initContext = utcTime() - startTime;
     BLOCKVERIFIER_LOG(DEBUG) << LOG_BADGE("executeBlock") << LOG_DESC("Init env takes")
-                             << LOG_KV("time(ms)", utcTime() - startTime)
+                             << LOG_KV("time(ms)", timeCost.initContext)
                              << LOG_KV("txNum", block.transactions()->size())
                              << LOG_KV("num", block.blockHeader().number());
     uint64_t pastTime = utcTime();
@@ -123,7 +183,7 @@ ExecutiveContext::Ptr BlockVerifier::serialExecuteBlock(
     try
     {
         auto executive = createAndInitExecutive();
-        EnvInfo envInfo(block.blockHeader(), m_pNumberHash, 0);
+        EnvInfo envInfo(block.blockHeader(), numberHash(parentBlockInfo), 0);
         envInfo.setPrecompiledEngine(executiveContext);
         executive->setEnvInfo(envInfo);
         executive->setState(executiveContext->getState());
@@ -149,10 +209,12 @@ ExecutiveContext::Ptr BlockVerifier::serialExecuteBlock(
     }
 
 
+    timeCost.execute = utcTime() - pastTime;
     BLOCKVERIFIER_LOG(DEBUG) << LOG_BADGE("executeBlock") << LOG_DESC("Run serial tx takes")
-                             << LOG_KV("time(ms)", utcTime() - pastTime)
+                             << LOG_KV("time(ms)", timeCost.execute)
                              << LOG_KV("txNum", block.transactions()->size())
                              << LOG_KV("num", block.blockHeader().number());
+    pastTime = utcTime();
 
     h256 stateRoot = executiveContext->getState()->rootHash();
     // set stateRoot in receipts
@@ -166,6 +228,8 @@ ExecutiveContext::Ptr BlockVerifier::serialExecuteBlock(
     block.calReceiptRoot();
     block.header().setStateRoot(stateRoot);
     block.header().setDBhash(executiveContext->getMemoryTableFactory()->hash());
+    timeCost.hash = utcTime() - pastTime;
+    executiveContext->setTimeCost(timeCost);
 
     /// if executeBlock is called by consensus module, no need to compare receiptRoot and stateRoot
     /// since origin value is empty if executeBlock is called by sync module, need to compare
@@ -206,7 +270,7 @@ ExecutiveContext::Ptr BlockVerifier::serialExecuteBlock(
 }
 
 ExecutiveContext::Ptr BlockVerifier::parallelExecuteBlock(
-    Block& block, BlockInfo const& parentBlockInfo)
+    Block& block, BlockInfo const& parentBlockInfo, Storage::Ptr _stateStorage)
 
 {
     BLOCKVERIFIER_LOG(INFO) << LOG_DESC("[executeBlock]Executing block")
@@ -221,8 +285,16 @@ ExecutiveContext::Ptr BlockVerifier::parallelExecuteBlock(
     ExecutiveContext::Ptr executiveContext = std::make_shared<ExecutiveContext>();
     try
     {
-        m_executiveContextFactory->initExecutiveContext(
-            parentBlockInfo, parentBlockInfo.stateRoot, executiveContext);
+        if (_stateStorage)
+        {
+            m_executiveContextFactory->initExecutiveContext(
+                parentBlockInfo, parentBlockInfo.stateRoot, executiveContext, _stateStorage);
+        }
+        else
+        {
+            m_executiveContextFactory->initExecutiveContext(
+                parentBlockInfo, parentBlockInfo.stateRoot, executiveContext);
+        }
     }
     catch (exception& e)
     {
@@ -238,6 +310,13 @@ ExecutiveContext::Ptr BlockVerifier::parallelExecuteBlock(
     auto initExeCtx_time_cost = utcTime() - record_time;
     record_time = utcTime();
 
+    if (m_enablePrefetch)
+    {
+        prefetchBlock(block, executiveContext);
+    }
+    auto prefetch_time_cost = utcTime() - record_time;
+    record_time = utcTime();
+
     BlockHeader tmpHeader = block.blockHeader();
     block.clearAllReceipts();
     block.resizeTransactionReceipt(block.transactions()->size());
@@ -261,6 +340,9 @@ ExecutiveContext::Ptr BlockVerifier::parallelExecuteBlock(
         executiveContext->getState()->commit();
         return true;
     });
+    // the optimistic execution replays the writes of MemoryTable2
+    bool optimistic = m_enableOptimistic && txDag->serialTxsNumber() > 0 &&
+                      std::dynamic_pointer_cast<MemoryTableFactory2>(memoryTableFactory);
     auto initDag_time_cost = utcTime() - record_time;
     record_time = utcTime();
 
@@ -268,30 +350,38 @@ ExecutiveContext::Ptr BlockVerifier::parallelExecuteBlock(
 
     try
     {
-        tbb::atomic<bool> isWarnedTimeout(false);
-        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, m_threadNum),
-            [&](const tbb::blocked_range<unsigned int>& _r) {
-                (void)_r;
-                EnvInfo envInfo(block.blockHeader(), m_pNumberHash, 0);
-                envInfo.setPrecompiledEngine(executiveContext);
-                auto executive = createAndInitExecutive();
-                executive->setEnvInfo(envInfo);
-                executive->setState(executiveContext->getState());
-
-                while (!txDag->hasFinished())
-                {
-                    if (!isWarnedTimeout.load() && utcSteadyTime() >= parallelTimeOut)
+        if (optimistic)
+        {
+            optimisticExecute(block, parentBlockInfo, executiveContext);
+        }
+        else
+        {
+            tbb::atomic<bool> isWarnedTimeout(false);
+            tbb::parallel_for(tbb::blocked_range<unsigned int>(0, m_threadNum),
+                [&](const tbb::blocked_range<unsigned int>& _r) {
+                    (void)_r;
+                    EnvInfo envInfo(block.blockHeader(), numberHash(parentBlockInfo), 0);
+                    envInfo.setPrecompiledEngine(executiveContext);
+                    auto executive = createAndInitExecutive();
+                    executive->setEnvInfo(envInfo);
+                    executive->setState(executiveContext->getState());
+
+                    while (!txDag->hasFinished())
                     {
-                        isWarnedTimeout.store(true);
-                        BLOCKVERIFIER_LOG(WARNING)
-                            << LOG_BADGE("executeBlock") << LOG_DESC("Para execute block timeout")
-                            << LOG_KV("txNum", block.transactions()->size())
-                            << LOG_KV("blockNumber", block.blockHeader().number());
+                        if (!isWarnedTimeout.load() && utcSteadyTime() >= parallelTimeOut)
+                        {
+                            isWarnedTimeout.store(true);
+                            BLOCKVERIFIER_LOG(WARNING)
+                                << LOG_BADGE("executeBlock")
+                                << LOG_DESC("Para execute block timeout")
+                                << LOG_KV("txNum", block.transactions()->size())
+                                << LOG_KV("blockNumber", block.blockHeader().number());
+                        }
+
+                        txDag->executeUnit(executive);
                     }
-
-                    txDag->executeUnit(executive);
-                }
-            });
+                });
+        }
     }
     catch (exception& e)
     {
@@ -329,6 +419,15 @@ ExecutiveContext::Ptr BlockVerifier::parallelExecuteBlock(
     auto setStateRoot_time_cost = utcTime() - record_time;
     record_time = utcTime();
 
+    ExecutionTimeCost timeCost;
+    timeCost.initContext = initExeCtx_time_cost;
+    timeCost.prefetch = prefetch_time_cost;
+    timeCost.initDag = perpareBlock_time_cost + initDag_time_cost;
+    timeCost.execute = exe_time_cost;
+    timeCost.hash = getRootHash_time_cost + setAllReceipt_time_cost + getReceiptRoot_time_cost +
+                    setStateRoot_time_cost;
+    executiveContext->setTimeCost(timeCost);
+
     if (tmpHeader.receiptsRoot() != h256() && tmpHeader.stateRoot() != h256())
     {
         if (tmpHeader != block.blockHeader())
@@ -360,6 +459,7 @@ ExecutiveContext::Ptr BlockVerifier::parallelExecuteBlock(
                              << LOG_KV("transactionRoot", block.transactionRoot())
                              << LOG_KV("receiptRoot", block.receiptRoot())
                              << LOG_KV("initExeCtxTimeCost", initExeCtx_time_cost)
+                             << LOG_KV("prefetchTimeCost", prefetch_time_cost)
                              << LOG_KV("perpareBlockTimeCost", perpareBlock_time_cost)
                              << LOG_KV("initDagTimeCost", initDag_time_cost)
                              << LOG_KV("exeTimeCost", exe_time_cost)
@@ -371,6 +471,126 @@ ExecutiveContext::Ptr BlockVerifier::parallelExecuteBlock(
 }
 
 
+void BlockVerifier::optimisticExecute(
+    Block& block, BlockInfo const& parentBlockInfo, ExecutiveContext::Ptr executiveContext)
+{
+    auto memoryTableFactory =
+        std::dynamic_pointer_cast<MemoryTableFactory2>(executiveContext->getMemoryTableFactory());
+    auto& transactions = *block.transactions();
+
+    auto executive = createAndInitExecutive();
+    auto blockNumberHash = numberHash(parentBlockInfo);
+    EnvInfo envInfo(block.blockHeader(), blockNumberHash, 0);
+    envInfo.setPrecompiledEngine(executiveContext);
+    executive->setEnvInfo(envInfo);
+    executive->setState(executiveContext->getState());
+
+    OptimisticExecutor executor(memoryTableFactory);
+    executor.run(
+        transactions.size(),
+        [&](size_t _index) -> SpeculativeTableFactory::Ptr {
+            // the same table factory as MemoryTableFactoryFactory2, the ID is not needed
+            auto tableFactory = std::make_shared<SpeculativeTableFactory>();
+            tableFactory->setStateStorage(memoryTableFactory->stateStorage());
+            tableFactory->setBlockHash(parentBlockInfo.hash);
+            tableFactory->setBlockNum(parentBlockInfo.number);
+            auto context = std::make_shared<ExecutiveContext>();
+            m_executiveContextFactory->initExecutiveContext(
+                parentBlockInfo, parentBlockInfo.stateRoot, context, tableFactory);
+
+            auto speculativeExecutive = createAndInitExecutive();
+            EnvInfo speculativeEnvInfo(block.blockHeader(), blockNumberHash, 0);
+            speculativeEnvInfo.setPrecompiledEngine(context);
+            speculativeExecutive->setEnvInfo(speculativeEnvInfo);
+            speculativeExecutive->setState(context->getState());
+            auto receipt = execute(transactions[_index], OnOpFunc(), context, speculativeExecutive);
+            if (context->registeredNumber() > 0)
+            {
+                return nullptr;
+            }
+            block.setTransactionReceipt(_index, receipt);
+            return tableFactory;
+        },
+        [&](size_t _index) {
+            // the writes of the speculative executions are applied to the tables directly
+            executiveContext->getState()->clearAccountCache();
+            block.setTransactionReceipt(
+                _index, execute(transactions[_index], OnOpFunc(), executiveContext, executive));
+        });
+
+    BLOCKVERIFIER_LOG(DEBUG) << LOG_BADGE("executeBlock") << LOG_DESC("Optimistic execution")
+                             << LOG_KV("txNum", transactions.size())
+                             << LOG_KV("reexecuted", executor.reexecutedNumber())
+                             << LOG_KV("blockNumber", block.blockHeader().number());
+}
+
+void BlockVerifier::prefetchBlock(Block& block, ExecutiveContext::Ptr executiveContext)
+{
+    auto memoryTableFactory = executiveContext->getMemoryTableFactory();
+    auto storage = memoryTableFactory->stateStorage();
+    if (!storage)
+    {
+        return;
+    }
+
+    // parallel precompiled: the parallel tags are keys of the precompiled table
+    // contract: the account rows read by every call of the contract
+    std::map<std::string, std::set<std::string>> table2Keys;
+    for (auto const& tx : *block.transactions())
+    {
+        if (tx->isCreation())
+        {
+            continue;
+        }
+        auto precompiled = executiveContext->getPrecompiled(tx->receiveAddress());
+        if (precompiled)
+        {
+            if (!precompiled->isParallelPrecompiled())
+            {
+                continue;
+            }
+            auto tagTable = precompiled->getParallelTagTable();
+            if (tagTable.empty())
+            {
+                continue;
+            }
+            auto tags = precompiled->getParallelTag(ref(tx->data()));
+            table2Keys[tagTable].insert(tags.begin(), tags.end());
+        }
+        else
+        {
+            std::string tableName("_contract_data_" + tx->receiveAddress().hex() + "_");
+            if (g_BCOSConfig.version() >= V2_2_0)
+            {
+                tableName = std::string("c_" + tx->receiveAddress().hex());
+            }
+            auto& keys = table2Keys[tableName];
+            keys.insert(dev::storagestate::ACCOUNT_FROZEN);
+            keys.insert(dev::storagestate::ACCOUNT_CODE_HASH);
+            keys.insert(dev::storagestate::ACCOUNT_CODE);
+        }
+    }
+
+    TableKeys keys;
+    for (auto const& it : table2Keys)
+    {
+        auto table = memoryTableFactory->openTable(it.first);
+        if (!table)
+        {
+            continue;
+        }
+        for (auto const& key : it.second)
+        {
+            keys.emplace_back(table->tableInfo(), key);
+        }
+    }
+    storage->prefetch(block.blockHeader().number(), keys);
+
+    BLOCKVERIFIER_LOG(DEBUG) << LOG_BADGE("prefetchBlock") << LOG_KV("tables", table2Keys.size())
+                             << LOG_KV("keys", keys.size())
+                             << LOG_KV("blockNumber", block.blockHeader().number());
+}
+
 TransactionReceipt::Ptr BlockVerifier::executeTransaction(
     const BlockHeader& blockHeader, dev::eth::Transaction::Ptr _t)
 {
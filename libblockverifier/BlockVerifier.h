@@ -73,10 +73,13 @@ public:
     virtual ~BlockVerifier() {}
 
     ExecutiveContext::Ptr executeBlock(dev::eth::Block& block, BlockInfo const& parentBlockInfo);
-    ExecutiveContext::Ptr serialExecuteBlock(
-        dev::eth::Block& block, BlockInfo const& parentBlockInfo);
-    ExecutiveContext::Ptr parallelExecuteBlock(
-        dev::eth::Block& block, BlockInfo const& parentBlockInfo);
+    // execute the block on _stateStorage instead of the state storage of the ledger if it is set
+    ExecutiveContext::Ptr serialExecuteBlock(dev::eth::Block& block,
+        BlockInfo const& parentBlockInfo, dev::storage::Storage::Ptr _stateStorage = nullptr);
+    ExecutiveContext::Ptr parallelExecuteBlock(dev::eth::Block& block,
+        BlockInfo const& parentBlockInfo, dev::storage::Storage::Ptr _stateStorage = nullptr);
+    ExecutiveContext::Ptr executeBlockAhead(dev::eth::Block& block,
+        BlockInfo const& parentBlockInfo, dev::storage::Storage::Ptr _stateStorage) override;
 
 
     dev::eth::TransactionReceipt::Ptr executeTransaction(
@@ -107,10 +110,23 @@ public:
     dev::executive::Executive::Ptr createAndInitExecutive();
     void setEvmFlags(VMFlagType const& _evmFlags) { m_evmFlags = _evmFlags; }
 
+    // load the rows the block will touch into the cached storage with one batch read
+    void prefetchBlock(dev::eth::Block& block, ExecutiveContext::Ptr executiveContext);
+    void setEnablePrefetch(bool _enablePrefetch) { m_enablePrefetch = _enablePrefetch; }
+    // execute blocks with transactions without criticals by OptimisticExecutor instead of TxDAG
+    void setEnableOptimistic(bool _enableOptimistic) { m_enableOptimistic = _enableOptimistic; }
+
 private:
+    void optimisticExecute(dev::eth::Block& block, BlockInfo const& parentBlockInfo,
+        ExecutiveContext::Ptr executiveContext);
+    // m_pNumberHash with the hash of the parent, which may not be committed
+    NumberHashCallBackFunction numberHash(BlockInfo const& _parentBlockInfo);
+
     ExecutiveContextFactory::Ptr m_executiveContextFactory;
     NumberHashCallBackFunction m_pNumberHash;
     bool m_enableParallel;
+    bool m_enablePrefetch = true;
+    bool m_enableOptimistic = false;
     unsigned int m_threadNum = -1;
 
     std::mutex m_executingMutex;
@@ -40,6 +40,10 @@ namespace eth
 class PrecompiledContract;
 
 }  // namespace eth
+namespace storage
+{
+class Storage;
+}
 namespace blockverifier
 {
 class BlockVerifierInterface
@@ -53,6 +57,14 @@ public:
     virtual ExecutiveContext::Ptr executeBlock(
         dev::eth::Block& block, BlockInfo const& parentBlockInfo) = 0;
 
+    // execute the block on _stateStorage, which has the uncommitted state of the parent, return
+    // nullptr if it fails or is not supported
+    virtual ExecutiveContext::Ptr executeBlockAhead(dev::eth::Block&, BlockInfo const&,
+        std::shared_ptr<dev::storage::Storage>)
+    {
+        return nullptr;
+    }
+
     virtual dev::eth::TransactionReceipt::Ptr executeTransaction(
         const dev::eth::BlockHeader& blockHeader, dev::eth::Transaction::Ptr _t) = 0;
 };
@@ -41,5 +41,17 @@ struct BlockInfo
     int64_t number;
     dev::h256 stateRoot;
 };
+
+// the time costs in milliseconds of the stages of the execution of a block
+struct ExecutionTimeCost
+{
+    uint64_t initContext = 0;
+    uint64_t prefetch = 0;
+    // TxDAG::init, 0 for the serial execution
+    uint64_t initDag = 0;
+    uint64_t execute = 0;
+    // the state root, the receipt root and the hash of the tables
+    uint64_t hash = 0;
+};
 }  // namespace blockverifier
 }  // namespace dev
@@ -22,10 +22,29 @@
 
 #include "DAG.h"
 #include <libconfig/GlobalConfigure.h>
+#include <algorithm>
+#include <chrono>
 using namespace std;
 using namespace dev;
 using namespace dev::blockverifier;
 
+namespace
+{
+bool lowerPriority(std::pair<ID, ID> const& _a, std::pair<ID, ID> const& _b)
+{
+    // the earlier transaction first if the priorities are the same
+    return _a.first < _b.first || (_a.first == _b.first && _a.second > _b.second);
+}
+
+// threads of tbb are reused, so a thread keeps its queue among blocks
+size_t workerIndex()
+{
+    static std::atomic<size_t> s_workers{0};
+    static thread_local size_t t_index = s_workers.fetch_add(1);
+    return t_index;
+}
+}  // namespace
+
 DAG::~DAG()
 {
     clear();
@@ -38,6 +57,9 @@ void DAG::init(ID _maxSize)
         m_vtxs.emplace_back(make_shared<Vertex>());
     m_totalVtxs = _maxSize;
     m_totalConsume = 0;
+    size_t queueNum = std::max(std::thread::hardware_concurrency(), 1u);
+    for (size_t i = 0; i < queueNum; ++i)
+        m_queues.emplace_back(new ReadyQueue());
 }
 
 void DAG::addEdge(ID _f, ID _t)
@@ -52,92 +74,162 @@ void DAG::addEdge(ID _f, ID _t)
 
 void DAG::generate()
 {
+    // topological order
+    std::vector<ID> order;
+    std::vector<ID> inDegree;
+    order.reserve(m_vtxs.size());
+    inDegree.reserve(m_vtxs.size());
+    for (ID id = 0; id < m_vtxs.size(); ++id)
+    {
+        inDegree.push_back(m_vtxs[id]->inDegree);
+        if (inDegree[id] == 0)
+            order.push_back(id);
+    }
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        for (ID id : m_vtxs[order[i]]->outEdge)
+        {
+            if (--inDegree[id] == 0)
+                order.push_back(id);
+        }
+    }
+
+    // the priority of a vertex is the length of the critical path it starts
+    m_criticalPath = 0;
+    for (auto it = order.rbegin(); it != order.rend(); ++it)
+    {
+        auto& vtx = m_vtxs[*it];
+        ID priority = 0;
+        for (ID id : vtx->outEdge)
+            priority = std::max(priority, m_vtxs[id]->priority);
+        vtx->priority = priority + 1;
+        m_criticalPath = std::max(m_criticalPath, vtx->priority);
+    }
+
+    // the first worker takes the tops, the others steal from it
     for (ID id = 0; id < m_vtxs.size(); ++id)
     {
         if (m_vtxs[id]->inDegree == 0)
-            m_topLevel.push(id);
+            push(*m_queues[0], id);
     }
 
     // PARA_LOG(TRACE) << LOG_BADGE("DAG") << LOG_DESC("generate")
-    //                << LOG_KV("queueSize", m_topLevel.size());
+    //                << LOG_KV("criticalPath", m_criticalPath);
     // for (ID id = 0; id < m_vtxs.size(); id++)
     // printVtx(id);
 }
 
 ID DAG::waitPop(bool _needWait)
 {
-    // Note: concurrent_queue of TBB can't be used with boost::conditional_variable
-    //       the try_pop will already be false
-    std::unique_lock<std::mutex> ul(x_topLevel);
-    ID top = INVALID_ID;
-    cv_topLevel.wait_for(ul, std::chrono::milliseconds(10), [&]() {
-        auto has = m_topLevel.try_pop(top);
-        if (has)
-        {
-            return true;
-        }
-        else if (m_totalConsume >= m_totalVtxs)
+    auto& local = localQueue();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(10);
+    for (size_t spins = 0;; ++spins)
+    {
+        ID top = tryPop(local);
+        if (top != INVALID_ID)
         {
-            return true;
+            return top;
         }
-        else if (!_needWait)
+        // steal from the other workers
+        for (auto& queue : m_queues)
         {
-            return true;
+            top = tryPop(*queue);
+            if (top != INVALID_ID)
+            {
+                return top;
+            }
         }
         // process-exit related:
         // if the g_BCOSConfig.shouldExit is true (may be the storage has exceptioned)
-        // return true, will pop INVALID_ID
-        else if (g_BCOSConfig.shouldExit.load())
+        // return INVALID_ID
+        if (m_totalConsume >= m_totalVtxs || !_needWait || g_BCOSConfig.shouldExit.load())
         {
-            return true;
+            return INVALID_ID;
         }
-
-        return false;
-    });
-    return top;
+        if (spins < 64)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            return INVALID_ID;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+    }
 }
 
 ID DAG::consume(ID _id)
 {
-    ID producedNum = 0;
     ID nextId = INVALID_ID;
-    ID lastDegree = INVALID_ID;
+    ReadyQueue* local = nullptr;
     for (ID id : m_vtxs[_id]->outEdge)
     {
-        auto vtx = m_vtxs[id];
+        auto& vtx = m_vtxs[id];
+        if (vtx->inDegree.fetch_sub(1) != 1)
         {
-            lastDegree = vtx->inDegree.fetch_sub(1);
+            continue;
         }
-        if (lastDegree == 1)
+        if (nextId == INVALID_ID)
         {
-            ++producedNum;
-            if (producedNum == 1)
-            {
-                nextId = id;
-            }
-            else
-            {
-                m_topLevel.push(id);
-                cv_topLevel.notify_one();
-            }
+            nextId = id;
+            continue;
+        }
+        // keep the vertex of the highest priority for the calling thread
+        if (lowerPriority(std::make_pair(m_vtxs[nextId]->priority, nextId),
+                std::make_pair(vtx->priority, id)))
+        {
+            std::swap(nextId, id);
+        }
+        if (!local)
+        {
+            local = &localQueue();
         }
+        push(*local, id);
     }
 
-    if (m_totalConsume.fetch_add(1) + 1 == m_totalVtxs)
-    {
-        cv_topLevel.notify_all();
-    }
-    // PARA_LOG(TRACE) << LOG_BADGE("TbbCqDAG") << LOG_DESC("consumed")
-    //                << LOG_KV("queueSize", m_topLevel.size());
-    // for (ID id = 0; id < m_vtxs.size(); id++)
-    // printVtx(id);
+    m_totalConsume.fetch_add(1);
+    // PARA_LOG(TRACE) << LOG_BADGE("DAG") << LOG_DESC("consumed") << LOG_KV("id", _id)
+    //                << LOG_KV("next", nextId);
     return nextId;
 }
 
 void DAG::clear()
 {
     m_vtxs = std::vector<std::shared_ptr<Vertex>>();
-    // XXXX m_topLevel.clear();
+    m_queues = std::vector<std::unique_ptr<ReadyQueue>>();
+}
+
+ReadyQueue& DAG::localQueue()
+{
+    return *m_queues[workerIndex() % m_queues.size()];
+}
+
+void DAG::push(ReadyQueue& _queue, ID _id)
+{
+    tbb::spin_mutex::scoped_lock lock(_queue.lock);
+    _queue.heap.emplace_back(m_vtxs[_id]->priority, _id);
+    std::push_heap(_queue.heap.begin(), _queue.heap.end(), lowerPriority);
+    _queue.size = _queue.heap.size();
+}
+
+ID DAG::tryPop(ReadyQueue& _queue)
+{
+    // most queues are empty when they are stolen from, skip them without locking
+    if (_queue.size.load() == 0)
+    {
+        return INVALID_ID;
+    }
+    tbb::spin_mutex::scoped_lock lock(_queue.lock);
+    if (_queue.heap.empty())
+    {
+        return INVALID_ID;
+    }
+    std::pop_heap(_queue.heap.begin(), _queue.heap.end(), lowerPriority);
+    ID top = _queue.heap.back().second;
+    _queue.heap.pop_back();
+    _queue.size = _queue.heap.size();
+    return top;
 }
 
 void DAG::printVtx(ID _id)
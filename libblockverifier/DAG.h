@@ -24,10 +24,10 @@
 #pragma once
 #include "Common.h"
 #include <libdevcore/Guards.h>
-#include <tbb/concurrent_queue.h>
-#include <condition_variable>
+#include <tbb/spin_mutex.h>
+#include <atomic>
 #include <cstdint>
-#include <queue>
+#include <memory>
 #include <thread>
 #include <vector>
 
@@ -43,6 +43,17 @@ struct Vertex
 {
     std::atomic<ID> inDegree;
     std::vector<ID> outEdge;
+    // the number of vertexes of the longest path from this vertex to the end
+    ID priority = 0;
+};
+
+// ready vertexes of a worker, the one of the highest priority is popped first
+struct ReadyQueue
+{
+    tbb::spin_mutex lock;
+    // max heap of (priority, ID)
+    std::vector<std::pair<ID, ID>> heap;
+    std::atomic<size_t> size{0};
 };
 
 class DAG
@@ -59,29 +70,36 @@ public:
     // Add edge between vertex
     void addEdge(ID _f, ID _t);
 
-    // Generate DAG
+    // Generate DAG, compute the priority of the vertexes and queue the tops
     void generate();
 
-    // Wait until topLevel is not empty, return INVALID_ID if DAG reach the end
+    // Pop a top from the queue of the calling thread or steal one from other threads, return
+    // INVALID_ID if DAG reach the end, or no top is ready within 10ms (thread safe)
     ID waitPop(bool _needWait = true);
 
-    // Consume the top and add new top in top queue (thread safe)
+    // Consume the top, return the released vertex of the highest priority and add the other
+    // released vertexes in the queue of the calling thread (thread safe)
     ID consume(ID _id);
 
-    // Clear all data of this class (thread safe)
+    // Clear all data of this class
     void clear();
 
+    // the number of vertexes of the longest path of DAG
+    ID criticalPathLength() const { return m_criticalPath; }
+
 private:
     std::vector<std::shared_ptr<Vertex>> m_vtxs;
-    tbb::concurrent_queue<ID> m_topLevel;
+    std::vector<std::unique_ptr<ReadyQueue>> m_queues;
 
     ID m_totalVtxs = 0;
+    ID m_criticalPath = 0;
     std::atomic<ID> m_totalConsume;
 
 private:
     void printVtx(ID _id);
-    mutable std::mutex x_topLevel;
-    std::condition_variable cv_topLevel;
+    ReadyQueue& localQueue();
+    void push(ReadyQueue& _queue, ID _id);
+    ID tryPop(ReadyQueue& _queue);
 };
 
 }  // namespace blockverifier
@@ -179,62 +179,33 @@ std::shared_ptr<std::vector<std::string>> ExecutiveContext::getTxCriticals(const
 
         uint32_t selector = parallelConfigPrecompiled->getParamFunc(ref(_tx.data()));
 
-        auto config = parallelConfigPrecompiled->getParallelConfig(
+        auto config = parallelConfigPrecompiled->getCriticalConfig(
             shared_from_this(), _tx.receiveAddress(), selector, _tx.sender());
 
         if (config == nullptr)
         {
             return nullptr;
         }
-        else
+
+        // only the critical params are decoded
+        auto res = make_shared<vector<string>>();
+        ContractABI abi;
+        bool isOk =
+            abi.abiOutByFuncSelector(ref(_tx.data()).cropped(4), config->criticalTypes, *res);
+        if (!isOk)
         {
-            {  // Testing code
-                // bytesConstRef data = parallelConfigPrecompiled->getParamData(ref(_tx.data()));
-                auto res = make_shared<vector<string>>();
-
-                ABIFunc af;
-                bool isOk = af.parser(config->functionName);
-                if (!isOk)
-                {
-                    EXECUTIVECONTEXT_LOG(DEBUG)
-                        << LOG_DESC("[getTxCriticals] parser function signature failed, ")
-                        << LOG_KV("func signature", config->functionName);
-
-                    return nullptr;
-                }
-
-                auto paramTypes = af.getParamsType();
-                if (paramTypes.size() < (size_t)config->criticalSize)
-                {
-                    EXECUTIVECONTEXT_LOG(DEBUG)
-                        << LOG_DESC("[getTxCriticals] params type less than  criticalSize")
-                        << LOG_KV("func signature", config->functionName)
-                        << LOG_KV("func criticalSize", config->criticalSize)
-                        << LOG_KV("input data", toHex(_tx.data()));
-
-                    return nullptr;
-                }
-
-                paramTypes.resize((size_t)config->criticalSize);
-
-                ContractABI abi;
-                isOk = abi.abiOutByFuncSelector(ref(_tx.data()).cropped(4), paramTypes, *res);
-                if (!isOk)
-                {
-                    EXECUTIVECONTEXT_LOG(DEBUG) << LOG_DESC("[getTxCriticals] abiout failed, ")
-                                                << LOG_KV("func signature", config->functionName)
-                                                << LOG_KV("input data", toHex(_tx.data()));
-
-                    return nullptr;
-                }
-
-                for (string& critical : *res)
-                {
-                    critical += _tx.receiveAddress().hex();
-                }
-
-                return res;
-            }
+            EXECUTIVECONTEXT_LOG(DEBUG) << LOG_DESC("[getTxCriticals] abiout failed, ")
+                                        << LOG_KV("func signature", config->functionName)
+                                        << LOG_KV("input data", toHex(_tx.data()));
+
+            return nullptr;
         }
+
+        for (string& critical : *res)
+        {
+            critical += _tx.receiveAddress().hex();
+        }
+
+        return res;
     }
 }
@@ -60,7 +60,7 @@ class ExecutiveContext : public std::enable_shared_from_this<ExecutiveContext>
 public:
     typedef std::shared_ptr<ExecutiveContext> Ptr;
 
-    ExecutiveContext() : m_addressCount(0x10000) {}
+    ExecutiveContext() : m_addressCount(c_firstRegisteredAddress) {}
 
     virtual ~ExecutiveContext()
     {
@@ -74,6 +74,9 @@ public:
         Address const& address, bytesConstRef param, Address const& origin, Address const& sender);
 
     virtual Address registerPrecompiled(std::shared_ptr<precompiled::Precompiled> p);
+    // the number of precompiled contracts registered by registerPrecompiled, their addresses
+    // depend on the order of the transactions of the block
+    int registeredNumber() const { return m_addressCount - c_firstRegisteredAddress; }
 
     virtual bool isPrecompiled(Address address) const;
 
@@ -124,7 +127,12 @@ public:
     // Get transaction criticals, return nullptr if critical to all
     std::shared_ptr<std::vector<std::string>> getTxCriticals(const dev::eth::Transaction& _tx);
 
+    // set by BlockVerifier when the block has been executed
+    ExecutionTimeCost const& timeCost() const { return m_timeCost; }
+    void setTimeCost(ExecutionTimeCost const& _timeCost) { m_timeCost = _timeCost; }
+
 private:
+    static const int c_firstRegisteredAddress = 0x10000;
     tbb::concurrent_unordered_map<Address, std::shared_ptr<precompiled::Precompiled>,
         std::hash<Address>>
         m_address2Precompiled;
@@ -134,6 +142,7 @@ private:
     std::unordered_map<Address, dev::eth::PrecompiledContract> m_precompiledContract;
     std::shared_ptr<dev::storage::TableFactory> m_memoryTableFactory;
     uint64_t m_txGasLimit = 300000000;
+    ExecutionTimeCost m_timeCost;
 
     std::shared_ptr<dev::precompiled::PrecompiledExecResultFactory> m_precompiledExecResultFactory;
 };
@@ -33,6 +33,8 @@
 #include <libprecompiled/TableFactoryPrecompiled.h>
 #include <libprecompiled/extension/DagTransferPrecompiled.h>
 #include <libstorage/MemoryTableFactory.h>
+#include <libstorage/MemoryTableFactoryFactory2.h>
+#include <libstorage/StorageException.h>
 
 using namespace dev;
 using namespace dev::blockverifier;
@@ -48,8 +50,27 @@ void ExecutiveContextFactory::setPrecompiledExecResultFactory(
 void ExecutiveContextFactory::initExecutiveContext(
     BlockInfo blockInfo, h256 const& stateRoot, ExecutiveContext::Ptr context)
 {
-    auto memoryTableFactory =
-        m_tableFactoryFactory->newTableFactory(blockInfo.hash, blockInfo.number);
+    initExecutiveContext(blockInfo, stateRoot, context,
+        m_tableFactoryFactory->newTableFactory(blockInfo.hash, blockInfo.number));
+}
+
+void ExecutiveContextFactory::initExecutiveContext(BlockInfo blockInfo, h256 const& stateRoot,
+    ExecutiveContext::Ptr context, dev::storage::Storage::Ptr _stateStorage)
+{
+    auto tableFactoryFactory =
+        std::dynamic_pointer_cast<dev::storage::MemoryTableFactoryFactory2>(m_tableFactoryFactory);
+    if (!tableFactoryFactory)
+    {
+        BOOST_THROW_EXCEPTION(dev::storage::StorageException(
+            -1, "the state storage of a context is only supported by MemoryTableFactory2"));
+    }
+    initExecutiveContext(blockInfo, stateRoot, context,
+        tableFactoryFactory->newTableFactory(blockInfo.hash, blockInfo.number, _stateStorage));
+}
+
+void ExecutiveContextFactory::initExecutiveContext(BlockInfo blockInfo, h256 const& stateRoot,
+    ExecutiveContext::Ptr context, dev::storage::TableFactory::Ptr memoryTableFactory)
+{
     context->setPrecompiledExecResultFactory(m_precompiledExecResultFactory);
     auto tableFactoryPrecompiled = std::make_shared<dev::precompiled::TableFactoryPrecompiled>();
     tableFactoryPrecompiled->setMemoryTableFactory(memoryTableFactory);
@@ -81,7 +102,8 @@ void ExecutiveContextFactory::initExecutiveContext(
     context->setBlockInfo(blockInfo);
     context->setPrecompiledContract(m_precompiledContract);
     context->setState(m_stateFactoryInterface->getState(stateRoot, memoryTableFactory));
-    setTxGasLimitToContext(context);
+    auto stateStorage = memoryTableFactory->stateStorage();
+    setTxGasLimitToContext(context, stateStorage ? stateStorage : m_stateStorage);
 }
 
 void ExecutiveContextFactory::setStateStorage(dev::storage::Storage::Ptr stateStorage)
@@ -95,7 +117,8 @@ void ExecutiveContextFactory::setStateFactory(
     m_stateFactoryInterface = stateFactoryInterface;
 }
 
-void ExecutiveContextFactory::setTxGasLimitToContext(ExecutiveContext::Ptr context)
+void ExecutiveContextFactory::setTxGasLimitToContext(
+    ExecutiveContext::Ptr context, dev::storage::Storage::Ptr _stateStorage)
 {
     // get value from db
     try
@@ -111,7 +134,7 @@ void ExecutiveContextFactory::setTxGasLimitToContext(ExecutiveContext::Ptr conte
 
         auto condition = std::make_shared<dev::storage::Condition>();
         condition->EQ("key", key);
-        auto values = m_stateStorage->select(blockInfo.number, tableInfo, key, condition);
+        auto values = _stateStorage->select(blockInfo.number, tableInfo, key, condition);
         if (!values || values->size() != 1)
         {
             EXECUTIVECONTEXT_LOG(ERROR) << LOG_DESC("[setTxGasLimitToContext]Select error");
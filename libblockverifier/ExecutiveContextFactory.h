@@ -58,6 +58,13 @@ public:
 
     virtual void initExecutiveContext(
         BlockInfo blockInfo, h256 const& stateRoot, ExecutiveContext::Ptr context);
+    // the state of the context is read and written through memoryTableFactory
+    void initExecutiveContext(BlockInfo blockInfo, h256 const& stateRoot,
+        ExecutiveContext::Ptr context, dev::storage::TableFactory::Ptr memoryTableFactory);
+    // the state of the context is read from and committed to _stateStorage, which may have the
+    // uncommitted state of the parent, see OverlayStorage
+    void initExecutiveContext(BlockInfo blockInfo, h256 const& stateRoot,
+        ExecutiveContext::Ptr context, dev::storage::Storage::Ptr _stateStorage);
 
     virtual void setStateStorage(dev::storage::Storage::Ptr stateStorage);
 
@@ -81,7 +88,8 @@ private:
 
     std::shared_ptr<dev::precompiled::PrecompiledExecResultFactory> m_precompiledExecResultFactory;
 
-    void setTxGasLimitToContext(ExecutiveContext::Ptr context);
+    void setTxGasLimitToContext(
+        ExecutiveContext::Ptr context, dev::storage::Storage::Ptr _stateStorage);
     void registerUserPrecompiled(ExecutiveContext::Ptr context);
 };
 
@@ -0,0 +1,81 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+/**
+ * @brief : optimistic parallel execution of the transactions of a block
+ */
+
+#include "OptimisticExecutor.h"
+#include "Common.h"
+#include <libconfig/GlobalConfigure.h>
+#include <tbb/parallel_for.h>
+#include <boost/exception/diagnostic_information.hpp>
+#include <vector>
+
+using namespace std;
+using namespace dev;
+using namespace dev::blockverifier;
+using namespace dev::storage;
+
+void OptimisticExecutor::run(
+    size_t _txNum, SpeculateFunc const& _speculate, ExecuteFunc const& _execute)
+{
+    m_reexecuted = 0;
+    vector<SpeculativeTableFactory::Ptr> tableFactories(_txNum);
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, _txNum, 1), [&](const tbb::blocked_range<size_t>& _range) {
+            for (auto i = _range.begin(); i < _range.end(); ++i)
+            {
+                if (g_BCOSConfig.shouldExit.load())
+                {
+                    return;
+                }
+                try
+                {
+                    tableFactories[i] = _speculate(i);
+                }
+                catch (std::exception const& e)
+                {  // executed again on the table factory of the block, where it fails for real
+                    BLOCKVERIFIER_LOG(DEBUG)
+                        << LOG_BADGE("OptimisticExecutor") << LOG_DESC("speculation failed")
+                        << LOG_KV("index", i) << LOG_KV("EINFO", boost::diagnostic_information(e));
+                    tableFactories[i] = nullptr;
+                }
+            }
+        });
+
+    TableKeySet writtenKeys;
+    for (size_t i = 0; i < _txNum; ++i)
+    {
+        if (g_BCOSConfig.shouldExit.load())
+        {
+            return;
+        }
+        auto tableFactory = tableFactories[i];
+        if (tableFactory && tableFactory->validate(*m_tableFactory, writtenKeys))
+        {
+            tableFactory->apply(*m_tableFactory);
+        }
+        else
+        {
+            _execute(i);
+            ++m_reexecuted;
+        }
+        m_tableFactory->changedKeys(writtenKeys);
+        m_tableFactory->commit();
+        tableFactories[i].reset();
+    }
+}
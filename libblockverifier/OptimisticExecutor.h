@@ -0,0 +1,64 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+/**
+ * @brief : optimistic parallel execution of the transactions of a block
+ *
+ * every transaction runs speculatively in parallel on its own SpeculativeTableFactory, which holds
+ * the state at the beginning of the block. Then in block order, a transaction that read none of
+ * the keys written by the transactions before it is committed by replaying its writes on the table
+ * factory of the block, the others are aborted and executed again on it, so the rows, receipts and
+ * hashes are the same as serial execution
+ */
+
+#pragma once
+#include <libstorage/SpeculativeTableFactory.h>
+#include <functional>
+#include <memory>
+
+namespace dev
+{
+namespace blockverifier
+{
+class OptimisticExecutor
+{
+public:
+    using Ptr = std::shared_ptr<OptimisticExecutor>;
+    // run the transaction on a new SpeculativeTableFactory and keep its result, return the
+    // factory, or nullptr if the transaction must be executed again
+    using SpeculateFunc =
+        std::function<dev::storage::SpeculativeTableFactory::Ptr(size_t _index)>;
+    // execute the transaction on the table factory of the block and keep its result
+    using ExecuteFunc = std::function<void(size_t _index)>;
+
+    OptimisticExecutor(dev::storage::MemoryTableFactory2::Ptr _tableFactory)
+      : m_tableFactory(_tableFactory)
+    {}
+
+    // execute _txNum transactions, the transactions are committed to the table factory of the
+    // block one by one, nothing is left in its change log
+    void run(size_t _txNum, SpeculateFunc const& _speculate, ExecuteFunc const& _execute);
+
+    // the number of transactions executed again by the last run
+    size_t reexecutedNumber() const { return m_reexecuted; }
+
+private:
+    dev::storage::MemoryTableFactory2::Ptr m_tableFactory;
+    size_t m_reexecuted = 0;
+};
+
+}  // namespace blockverifier
+}  // namespace dev
@@ -40,9 +40,6 @@ void TxDAG::init(
     DAG_LOG(TRACE) << LOG_DESC("Begin init transaction DAG") << LOG_KV("blockHeight", _blockHeight)
                    << LOG_KV("transactionNum", _txs->size());
 
-    m_txs = _txs;
-    m_dag.init(_txs->size());
-
     // get criticals
     std::vector<std::shared_ptr<std::vector<std::string>>> txsCriticals;
     auto txsSize = _txs->size();
@@ -55,6 +52,18 @@ void TxDAG::init(
                 txsCriticals[i] = _ctx->getTxCriticals(*tx);
             }
         });
+    init(_txs, txsCriticals, _blockHeight);
+}
+
+void TxDAG::init(std::shared_ptr<dev::eth::Transactions> _txs,
+    std::vector<std::shared_ptr<std::vector<std::string>>> const& _txsCriticals,
+    int64_t _blockHeight)
+{
+    m_txs = _txs;
+    m_dag.init(_txs->size());
+    m_exeCnt = 0;
+    m_serialTxs = 0;
+    auto txsSize = _txs->size();
 
     CriticalField<string> latestCriticals;
 
@@ -65,7 +74,7 @@ void TxDAG::init(
         // Is para transaction?
         auto criticals = _ctx->getTxCriticals(tx);
 #endif
-        auto criticals = txsCriticals[id];
+        auto criticals = _txsCriticals[id];
         if (criticals)
         {
             // DAG transaction: Conflict with certain critical fields
@@ -98,6 +107,7 @@ void TxDAG::init(
 
             // set all critical to my id
             latestCriticals.setCriticalAll(id);
+            ++m_serialTxs;
         }
     }
 
@@ -106,7 +116,8 @@ void TxDAG::init(
 
     m_totalParaTxs = _txs->size();
 
-    DAG_LOG(TRACE) << LOG_DESC("End init transaction DAG") << LOG_KV("blockHeight", _blockHeight);
+    DAG_LOG(TRACE) << LOG_DESC("End init transaction DAG") << LOG_KV("blockHeight", _blockHeight)
+                   << LOG_KV("criticalPath", m_dag.criticalPathLength());
 }
 
 // Set transaction execution function
@@ -133,7 +144,6 @@ int TxDAG::executeUnit(Executive::Ptr _executive)
     }
     if (exeCnt > 0)
     {
-        Guard l(x_exeCnt);
         m_exeCnt += exeCnt;
     }
     return exeCnt;
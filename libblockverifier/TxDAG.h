@@ -63,6 +63,12 @@ public:
     void init(ExecutiveContext::Ptr _ctx, std::shared_ptr<dev::eth::Transactions> _txs,
         int64_t _blockHeight);
 
+    // Generate DAG according with the criticals of given transactions, nullptr criticals conflict
+    // with all transactions
+    void init(std::shared_ptr<dev::eth::Transactions> _txs,
+        std::vector<std::shared_ptr<std::vector<std::string>>> const& _txsCriticals,
+        int64_t _blockHeight);
+
     // Set transaction execution function
     void setTxExecuteFunc(ExecuteTxFunc const& _f);
 
@@ -85,16 +91,20 @@ public:
 
     ID haveExecuteNumber() { return m_exeCnt; }
 
+    ID criticalPathLength() { return m_dag.criticalPathLength(); }
+
+    // the number of transactions without criticals, which conflict with all transactions
+    ID serialTxsNumber() { return m_serialTxs; }
+
 private:
     ExecuteTxFunc f_executeTx;
     std::shared_ptr<dev::eth::Transactions const> m_txs;
 
     DAG m_dag;
 
-    ID m_exeCnt = 0;
+    std::atomic<ID> m_exeCnt{0};
     ID m_totalParaTxs = 0;
-
-    mutable std::mutex x_exeCnt;
+    ID m_serialTxs = 0;
 };
 
 template <typename T>
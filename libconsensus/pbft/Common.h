@@ -62,6 +62,7 @@ enum PBFTPacketType : byte
     PBFTPacketCount
 };
 
+struct PBFTMsg;
 /// PBFT message
 struct PBFTMsgPacket
 {
@@ -83,6 +84,10 @@ struct PBFTMsgPacket
     std::string endpoint;
     // the node that disconnected from this node, but the packet should reach
     std::shared_ptr<dev::h512s> forwardNodes;
+    /// the request decoded from data by the verification stage, nullptr if not decoded
+    std::shared_ptr<PBFTMsg> decodedMsg;
+    /// the time(us) the packet enters the current stage of PBFTEngine
+    uint64_t stageStartTime = 0;
 
     using Ptr = std::shared_ptr<PBFTMsgPacket>;
 
@@ -230,6 +235,8 @@ struct PBFTMsg
     bool signChecked = true;
     // the block inner the PrepareReq is empty or not
     bool isEmpty = false;
+    // the sealer whose signatures of the message have been verified, h512() if not verified
+    h512 signVerifiedBy = h512();
 
     PBFTMsg() = default;
     PBFTMsg(KeyPair const& _keyPair, int64_t const& _height, VIEWTYPE const& _view,
@@ -336,6 +343,7 @@ struct PBFTMsg
         block_hash = h256();
         sig = Signature();
         sig2 = Signature();
+        signVerifiedBy = h512();
     }
 
     /// get the hash of the fields without block_hash, sig and sig2
@@ -555,5 +563,41 @@ struct ViewChangeReq : public PBFTMsg
         sig2 = signHash(fieldsWithoutBlock(), keyPair);
     }
 };
+
+/// the number and the latency of the messages passed a stage of PBFTEngine
+class PBFTMsgStageStat
+{
+public:
+    void onLeave(uint64_t _stageStartTime)
+    {
+        auto now = utcTimeUs();
+        uint64_t latency = now > _stageStartTime ? now - _stageStartTime : 0;
+        m_count++;
+        m_totalLatency += latency;
+        auto maxLatency = m_maxLatency.load();
+        while (latency > maxLatency && !m_maxLatency.compare_exchange_weak(maxLatency, latency))
+        {
+        }
+    }
+    void onDrop() { m_dropped++; }
+
+    Json::Value toJson() const
+    {
+        Json::Value stat;
+        uint64_t count = m_count;
+        stat["count"] = Json::UInt64(count);
+        stat["dropped"] = Json::UInt64(m_dropped.load());
+        stat["avgLatencyMs"] = count == 0 ? 0 : (double)m_totalLatency / count / 1000;
+        stat["maxLatencyMs"] = (double)m_maxLatency / 1000;
+        return stat;
+    }
+
+private:
+    std::atomic<uint64_t> m_count = {0};
+    std::atomic<uint64_t> m_dropped = {0};
+    /// the latency in microseconds
+    std::atomic<uint64_t> m_totalLatency = {0};
+    std::atomic<uint64_t> m_maxLatency = {0};
+};
 }  // namespace consensus
 }  // namespace dev
@@ -26,6 +26,7 @@
 #include <libdevcore/CommonJS.h>
 #include <libethcore/CommonJS.h>
 #include <libsecurity/EncryptedLevelDB.h>
+#include <libstorage/MemoryTableFactory2.h>
 #include <libtxpool/TxPool.h>
 using namespace dev::eth;
 using namespace dev::db;
@@ -93,6 +94,22 @@ void PBFTEngine::stop()
         {
             m_messageHandler->stop();
         }
+        if (m_msgVerifier)
+        {
+            m_msgVerifier->stop();
+        }
+        {
+            std::lock_guard<std::mutex> l(x_executedAhead);
+            if (m_executedAhead)
+            {
+                m_executedAhead->stateStorage->cancel();
+                m_executedAhead = nullptr;
+            }
+        }
+        if (m_executeAheadWorker)
+        {
+            m_executeAheadWorker->stop();
+        }
         ConsensusEngineBase::stop();
     }
 }
@@ -402,13 +419,23 @@ bool PBFTEngine::checkSign(PBFTMsg const& req) const
     h512 node_id;
     if (getNodeIDByIndex(node_id, req.idx))
     {
-        Public pub_id = jsToPublic(toJS(node_id.hex()));
-        return dev::verify(pub_id, req.sig, req.block_hash) &&
-               dev::verify(pub_id, req.sig2, req.fieldsWithoutBlock());
+        // verified by the verification stage with the same sealer
+        if (req.signVerifiedBy == node_id)
+        {
+            return true;
+        }
+        return verifySign(node_id, req);
     }
     return false;
 }
 
+bool PBFTEngine::verifySign(h512 const& _nodeId, PBFTMsg const& _req) const
+{
+    Public pub_id = jsToPublic(toJS(_nodeId.hex()));
+    return dev::verify(pub_id, _req.sig, _req.block_hash) &&
+           dev::verify(pub_id, _req.sig2, _req.fieldsWithoutBlock());
+}
+
 /**
  * @brief: 1. generate commitReq according to prepare req
  *         2. broadcast the commitReq
@@ -837,14 +864,20 @@ void PBFTEngine::execBlock(Sealing& sealing, PrepareReq const& req, std::ostring
     auto noteSealing_time_cost = utcTime() - record_time;
     record_time = utcTime();
 
-    /// ignore the signature verification of the transactions have already been verified in
-    /// transation pool
-    /// the transactions that has not been verified by the txpool should be verified
-    m_txPool->verifyAndSetSenderForBlock(*sealing.block);
-    auto verifyAndSetSender_time_cost = utcTime() - record_time;
-    record_time = utcTime();
+    sealing.p_execContext = takeExecutedAhead(sealing, req);
+    bool executedAhead = (sealing.p_execContext != nullptr);
+    uint64_t verifyAndSetSender_time_cost = 0;
+    if (!executedAhead)
+    {
+        /// ignore the signature verification of the transactions have already been verified in
+        /// transation pool
+        /// the transactions that has not been verified by the txpool should be verified
+        m_txPool->verifyAndSetSenderForBlock(*sealing.block);
+        verifyAndSetSender_time_cost = utcTime() - record_time;
+        record_time = utcTime();
 
-    sealing.p_execContext = executeBlock(*sealing.block);
+        sealing.p_execContext = executeBlock(*sealing.block);
+    }
     auto exec_time_cost = utcTime() - record_time;
     PBFTENGINE_LOG(INFO)
         << LOG_DESC("execBlock") << LOG_KV("blkNum", sealing.block->header().number())
@@ -855,11 +888,152 @@ void PBFTEngine::execBlock(Sealing& sealing, PrepareReq const& req, std::ostring
         << LOG_KV("noteSealingCost", noteSealing_time_cost)
         << LOG_KV("currentCycle", m_timeManager.m_changeCycle)
         << LOG_KV("verifyAndSetSenderCost", verifyAndSetSender_time_cost)
-        << LOG_KV("execCost", exec_time_cost)
+        << LOG_KV("executedAhead", executedAhead) << LOG_KV("execCost", exec_time_cost)
         << LOG_KV("execPerTx", (float)exec_time_cost / (float)sealing.block->getTransactionSize())
         << LOG_KV("totalCost", utcTime() - start_time);
 }
 
+void PBFTEngine::executeAhead(PrepareReq::Ptr _futureReq)
+{
+    if (!m_enableExecuteAhead || _futureReq->isEmpty)
+    {
+        return;
+    }
+    /// only the next block of the prepare in consensus, which is executed and not committed
+    auto const& parentReq = m_reqCache->prepareCache();
+    if (parentReq.height != m_consensusBlockNumber || _futureReq->height != parentReq.height + 1 ||
+        !parentReq.p_execContext || !parentReq.pBlock)
+    {
+        return;
+    }
+    /// isValidPrepare checks neither the leader nor the signature of a future prepare, only
+    /// the signed prepare of the leader of the next block is worth executing
+    if (!isValidFutureLeader(*_futureReq) || !checkSign(*_futureReq))
+    {
+        PBFTENGINE_LOG(DEBUG) << LOG_DESC("executeAhead: ignore the prepare not from the leader")
+                              << LOG_KV("reqNum", _futureReq->height)
+                              << LOG_KV("reqIdx", _futureReq->idx)
+                              << LOG_KV("view", _futureReq->view)
+                              << LOG_KV("hash", _futureReq->block_hash.abridged());
+        return;
+    }
+    {
+        /// the block executed ahead on the same parent is never replaced
+        std::lock_guard<std::mutex> l(x_executedAhead);
+        if (m_executedAhead && m_executedAhead->parentHash == parentReq.block_hash)
+        {
+            return;
+        }
+    }
+    auto parentTableFactory = std::dynamic_pointer_cast<MemoryTableFactory2>(
+        parentReq.p_execContext->getMemoryTableFactory());
+    if (!parentTableFactory)
+    {
+        return;
+    }
+    auto parentNumber = parentReq.height;
+    auto blockChain = m_blockChain;
+    auto stateStorage = std::make_shared<OverlayStorage>(parentTableFactory->stateStorage(),
+        parentNumber, parentTableFactory->exportData(),
+        [blockChain, parentNumber]() { return blockChain->number() >= parentNumber; });
+
+    auto ahead = std::make_shared<ExecutedAhead>();
+    ahead->blockHash = _futureReq->block_hash;
+    ahead->parentNumber = parentNumber;
+    ahead->parentHash = parentReq.block_hash;
+    ahead->block = m_blockFactory->createBlock();
+    ahead->stateStorage = stateStorage;
+    auto promise = std::make_shared<std::promise<ExecutiveContext::Ptr>>();
+    ahead->context = promise->get_future().share();
+    {
+        std::lock_guard<std::mutex> l(x_executedAhead);
+        /// the block executed ahead on an older parent is never taken
+        if (m_executedAhead)
+        {
+            m_executedAhead->stateStorage->cancel();
+        }
+        m_executedAhead = ahead;
+    }
+
+    BlockInfo parentBlockInfo{
+        parentReq.block_hash, parentNumber, parentReq.pBlock->header().stateRoot()};
+    auto blockData = _futureReq->block;
+    auto block = ahead->block;
+    auto txPool = m_txPool;
+    auto blockVerifier = m_blockVerifier;
+    m_executeAheadWorker->enqueue([promise, block, blockData, parentBlockInfo, stateStorage,
+                                      txPool, blockVerifier]() {
+        ExecutiveContext::Ptr context = nullptr;
+        try
+        {
+            if (!stateStorage->cancelled())
+            {
+                block->decode(ref(*blockData), CheckTransaction::None, false, true);
+                if (block->blockHeader().number() == parentBlockInfo.number + 1 &&
+                    block->blockHeader().parentHash() == parentBlockInfo.hash)
+                {
+                    txPool->verifyAndSetSenderForBlock(*block);
+                    context = blockVerifier->executeBlockAhead(
+                        *block, parentBlockInfo, stateStorage);
+                }
+            }
+        }
+        catch (std::exception const& e)
+        {
+            PBFTENGINE_LOG(WARNING) << LOG_DESC("executeAhead failed")
+                                    << LOG_KV("parentNumber", parentBlockInfo.number)
+                                    << LOG_KV("EINFO", boost::diagnostic_information(e));
+        }
+        promise->set_value(context);
+    });
+    PBFTENGINE_LOG(DEBUG) << LOG_DESC("executeAhead") << LOG_KV("reqNum", _futureReq->height)
+                          << LOG_KV("hash", _futureReq->block_hash.abridged())
+                          << LOG_KV("parentHash", parentReq.block_hash.abridged())
+                          << LOG_KV("nodeIdx", nodeIdx());
+}
+
+ExecutiveContext::Ptr PBFTEngine::takeExecutedAhead(Sealing& _sealing, PrepareReq const& _req)
+{
+    ExecutedAhead::Ptr ahead;
+    {
+        std::lock_guard<std::mutex> l(x_executedAhead);
+        if (!m_executedAhead || _req.height <= m_executedAhead->parentNumber)
+        {
+            return nullptr;
+        }
+        ahead = m_executedAhead;
+        m_executedAhead = nullptr;
+    }
+    /// the block must be the one executed ahead, and its parent must be the one committed
+    if (_req.height != ahead->parentNumber + 1 || _req.block_hash != ahead->blockHash ||
+        m_blockChain->number() != ahead->parentNumber ||
+        m_blockChain->numberHash(ahead->parentNumber) != ahead->parentHash)
+    {
+        ahead->stateStorage->cancel();
+        PBFTENGINE_LOG(INFO) << LOG_DESC("takeExecutedAhead: drop the block executed ahead")
+                             << LOG_KV("reqNum", _req.height)
+                             << LOG_KV("hash", _req.block_hash.abridged())
+                             << LOG_KV("aheadHash", ahead->blockHash.abridged())
+                             << LOG_KV("parentHash", ahead->parentHash.abridged())
+                             << LOG_KV("curNum", m_blockChain->number());
+        return nullptr;
+    }
+    while (ahead->context.wait_for(std::chrono::milliseconds(10)) != std::future_status::ready)
+    {
+        if (!m_startConsensusEngine || g_BCOSConfig.shouldExit)
+        {
+            ahead->stateStorage->cancel();
+            return nullptr;
+        }
+    }
+    auto context = ahead->context.get();
+    if (context)
+    {
+        _sealing.block = ahead->block;
+    }
+    return context;
+}
+
 /// check whether the block is empty
 bool PBFTEngine::needOmit(Sealing const& sealing)
 {
@@ -908,9 +1082,21 @@ void PBFTEngine::pushValidPBFTMsgIntoQueue(NetworkException, std::shared_ptr<P2P
     }
     if (pbft_msg->packet_id <= ViewChangeReqPacket)
     {
-        m_msgQueue.push(pbft_msg);
-        /// notify to handleMsg after push new PBFTMsgPacket into m_msgQueue
-        m_signalled.notify_all();
+        if (!m_msgVerifier)
+        {
+            pushPBFTMsgIntoQueue(pbft_msg);
+            return;
+        }
+        pbft_msg->stageStartTime = utcTimeUs();
+        m_verifyQueueSize++;
+        auto self = std::weak_ptr<PBFTEngine>(shared_from_this());
+        m_msgVerifier->enqueue([self, pbft_msg]() {
+            auto pbftEngine = self.lock();
+            if (pbftEngine)
+            {
+                pbftEngine->verifyPBFTMsg(pbft_msg);
+            }
+        });
     }
     else
     {
@@ -922,6 +1108,63 @@ void PBFTEngine::pushValidPBFTMsgIntoQueue(NetworkException, std::shared_ptr<P2P
     }
 }
 
+void PBFTEngine::pushPBFTMsgIntoQueue(PBFTMsgPacket::Ptr _pbftMsg)
+{
+    _pbftMsg->stageStartTime = utcTimeUs();
+    m_msgQueue.push(_pbftMsg);
+    /// notify to handleMsg after push new PBFTMsgPacket into m_msgQueue
+    m_signalled.notify_all();
+}
+
+/**
+ * @brief: decode the received message and verify its signatures out of the work loop, so that
+ *         the work loop only checks the state of the consensus.
+ *         The message failed to decode is dropped. The message signed by a node not in the current
+ *         sealer list is still pushed into m_msgQueue without the verified mark, since the sealer
+ *         list of a future block may not be applied yet, and it is checked in the work loop.
+ */
+void PBFTEngine::verifyPBFTMsg(PBFTMsgPacket::Ptr _pbftMsg)
+{
+    std::shared_ptr<PBFTMsg> req;
+    switch (_pbftMsg->packet_id)
+    {
+    case PrepareReqPacket:
+        req = std::make_shared<PrepareReq>();
+        break;
+    case SignReqPacket:
+        req = std::make_shared<SignReq>();
+        break;
+    case CommitReqPacket:
+        req = std::make_shared<CommitReq>();
+        break;
+    default:
+        req = std::make_shared<ViewChangeReq>();
+        break;
+    }
+    bool valid = decodeToRequests(*req, ref(_pbftMsg->data));
+    if (valid)
+    {
+        auto nodeId = getSealerByIndex(req->idx);
+        if (nodeId != h512() && verifySign(nodeId, *req))
+        {
+            req->signVerifiedBy = nodeId;
+        }
+    }
+    m_verifyQueueSize--;
+    m_verifyStat.onLeave(_pbftMsg->stageStartTime);
+    if (!valid)
+    {
+        m_verifyStat.onDrop();
+        PBFTENGINE_LOG(DEBUG) << LOG_DESC("verifyPBFTMsg: drop the message failed to decode")
+                              << LOG_KV("type", std::to_string(_pbftMsg->packet_id))
+                              << LOG_KV("fromIdx", _pbftMsg->node_idx)
+                              << LOG_KV("fromIp", _pbftMsg->endpoint);
+        return;
+    }
+    _pbftMsg->decodedMsg = req;
+    pushPBFTMsgIntoQueue(_pbftMsg);
+}
+
 void PBFTEngine::onRecvPBFTMessage(dev::p2p::NetworkException _exception,
     std::shared_ptr<dev::p2p::P2PSession> _session, dev::p2p::P2PMessage::Ptr _message)
 {
@@ -930,7 +1173,7 @@ void PBFTEngine::onRecvPBFTMessage(dev::p2p::NetworkException _exception,
 
 bool PBFTEngine::handlePrepareMsg(PrepareReq::Ptr prepare_req, PBFTMsgPacket const& pbftMsg)
 {
-    bool valid = decodeToRequests(*prepare_req, ref(pbftMsg.data));
+    bool valid = decodeReceivedMsg(*prepare_req, pbftMsg);
     // set isEmpty flag for the prepareReq
     if (pbftMsg.prepareWithEmptyBlock)
     {
@@ -987,6 +1230,7 @@ bool PBFTEngine::handlePrepareMsg(PrepareReq::Ptr prepareReq, std::string const&
     {
         clearPreRawPrepare();
         m_reqCache->addFuturePrepareCache(prepareReq);
+        executeAhead(prepareReq);
         return true;
     }
     // clear preRawPrepare before addRawPrepare when enable_block_with_txs_hash
@@ -1257,7 +1501,7 @@ void PBFTEngine::reportBlockWithoutLock(Block const& block)
 bool PBFTEngine::handleSignMsg(SignReq::Ptr sign_req, PBFTMsgPacket const& pbftMsg)
 {
     Timer t;
-    bool valid = decodeToRequests(*sign_req, ref(pbftMsg.data));
+    bool valid = decodeReceivedMsg(*sign_req, pbftMsg);
     if (!valid)
     {
         return false;
@@ -1333,7 +1577,7 @@ CheckResult PBFTEngine::isValidSignReq(SignReq::Ptr req, std::ostringstream& oss
 bool PBFTEngine::handleCommitMsg(CommitReq::Ptr commit_req, PBFTMsgPacket const& pbftMsg)
 {
     Timer t;
-    bool valid = decodeToRequests(*commit_req, ref(pbftMsg.data));
+    bool valid = decodeReceivedMsg(*commit_req, pbftMsg);
     if (!valid)
     {
         return false;
@@ -1396,7 +1640,7 @@ CheckResult PBFTEngine::isValidCommitReq(CommitReq::Ptr req, std::ostringstream&
 bool PBFTEngine::handleViewChangeMsg(
     ViewChangeReq::Ptr viewChange_req, PBFTMsgPacket const& pbftMsg)
 {
-    bool valid = decodeToRequests(*viewChange_req, ref(pbftMsg.data));
+    bool valid = decodeReceivedMsg(*viewChange_req, pbftMsg);
     if (!valid)
     {
         return false;
@@ -1551,6 +1795,8 @@ void PBFTEngine::collectGarbage()
 
         m_timeManager.m_lastGarbageCollection = now;
         PBFTENGINE_LOG(DEBUG) << LOG_DESC("collectGarbage")
+                              << LOG_KV("verifyQueueSize", m_verifyQueueSize)
+                              << LOG_KV("msgQueueSize", m_msgQueue.size())
                               << LOG_KV("Timecost", 1000 * t.elapsed());
     }
 }
@@ -1619,28 +1865,28 @@ void PBFTEngine::handleMsg(PBFTMsgPacket::Ptr pbftMsg)
     {
     case PrepareReqPacket:
     {
-        PrepareReq::Ptr prepare_req = std::make_shared<PrepareReq>();
+        PrepareReq::Ptr prepare_req = receivedMsg<PrepareReq>(*pbftMsg);
         succ = handlePrepareMsg(prepare_req, *pbftMsg);
         pbft_msg = prepare_req;
         break;
     }
     case SignReqPacket:
     {
-        SignReq::Ptr req = std::make_shared<SignReq>();
+        SignReq::Ptr req = receivedMsg<SignReq>(*pbftMsg);
         succ = handleSignMsg(req, *pbftMsg);
         pbft_msg = req;
         break;
     }
     case CommitReqPacket:
     {
-        CommitReq::Ptr req = std::make_shared<CommitReq>();
+        CommitReq::Ptr req = receivedMsg<CommitReq>(*pbftMsg);
         succ = handleCommitMsg(req, *pbftMsg);
         pbft_msg = req;
         break;
     }
     case ViewChangeReqPacket:
     {
-        std::shared_ptr<ViewChangeReq> req = std::make_shared<ViewChangeReq>();
+        std::shared_ptr<ViewChangeReq> req = receivedMsg<ViewChangeReq>(*pbftMsg);
         succ = handleViewChangeMsg(req, *pbftMsg);
         pbft_msg = req;
         break;
@@ -1721,6 +1967,7 @@ void PBFTEngine::workLoop()
                     << LOG_KV("fromIdx", ret.second->node_idx) << LOG_KV("nodeIdx", nodeIdx())
                     << LOG_KV("myNode", m_keyPair.pub().abridged());
                 handleMsg(ret.second);
+                m_handleStat.onLeave(ret.second->stageStartTime);
             }
             /// to avoid of cpu problem
             else if (m_reqCache->futurePrepareCacheSize() == 0)
@@ -1779,6 +2026,11 @@ const std::string PBFTEngine::consensusStatus()
     statusObj["toView"] = VIEWTYPE(m_toView);
     /// get leader failed or not
     statusObj["leaderFailed"] = bool(m_leaderFailed);
+    /// the queue depth and the latency of the stages of the received messages
+    statusObj["verifyQueueSize"] = Json::Int64(m_verifyQueueSize.load());
+    statusObj["msgQueueSize"] = Json::UInt64(m_msgQueue.size());
+    statusObj["verifyStage"] = m_verifyStat.toJson();
+    statusObj["handleStage"] = m_handleStat.toJson();
     status.append(statusObj);
     /// get view of node id
     getAllNodesViewStatus(status);
@@ -2021,6 +2273,7 @@ bool PBFTEngine::handlePartiallyPrepare(PrepareReq::Ptr _prepareReq)
             // re-encode the block into the completed block(for pbft-backup consideration)
             _prepareReq->pBlock->encode(*_prepareReq->block);
             m_partiallyPrepareCache->addFuturePrepareCache(_prepareReq);
+            executeAhead(_prepareReq);
             return true;
         }
         // request missed txs for the future prepare
@@ -32,8 +32,10 @@
 #include <libdevcore/LevelDB.h>
 #include <libdevcore/ThreadPool.h>
 #include <libdevcore/concurrent_queue.h>
+#include <libstorage/OverlayStorage.h>
 #include <libstorage/Storage.h>
 #include <libsync/SyncStatus.h>
+#include <future>
 #include <sstream>
 
 #include <libp2p/P2PMessageFactory.h>
@@ -224,6 +226,28 @@ public:
         m_enablePrepareWithTxsHash = _enablePrepareWithTxsHash;
     }
 
+    // execute the future block on the state of the block in consensus before it is committed
+    void setEnableExecuteAhead(bool const& _enableExecuteAhead)
+    {
+        m_enableExecuteAhead = _enableExecuteAhead;
+        if (m_enableExecuteAhead && !m_executeAheadWorker)
+        {
+            m_executeAheadWorker =
+                std::make_shared<dev::ThreadPool>("PBFTAhead-" + std::to_string(m_groupId), 1);
+        }
+    }
+
+    // decode and verify the received messages on _threadNum threads before the work loop,
+    // the messages are verified in the work loop if _threadNum is 0
+    void setVerifyThreadNum(size_t const& _threadNum)
+    {
+        if (_threadNum > 0 && !m_msgVerifier)
+        {
+            m_msgVerifier = std::make_shared<dev::ThreadPool>(
+                "PBFTVerify-" + std::to_string(m_groupId), _threadNum);
+        }
+    }
+
     void stop() override;
 
     virtual void createPBFTReqCache();
@@ -300,6 +324,9 @@ protected:
     void pushValidPBFTMsgIntoQueue(dev::p2p::NetworkException exception,
         std::shared_ptr<dev::p2p::P2PSession> session, dev::p2p::P2PMessage::Ptr message,
         std::function<void(PBFTMsgPacket::Ptr)> const& _f);
+    /// decode the message and verify its signature, called by the verification stage
+    void verifyPBFTMsg(PBFTMsgPacket::Ptr _pbftMsg);
+    void pushPBFTMsgIntoQueue(PBFTMsgPacket::Ptr _pbftMsg);
 
     virtual void onRecvPBFTMessage(dev::p2p::NetworkException _exception,
         std::shared_ptr<dev::p2p::P2PSession> _session, dev::p2p::P2PMessage::Ptr _message);
@@ -332,6 +359,25 @@ protected:
 
     bool checkSign(PBFTMsg const& req) const;
     bool checkSign(IDXTYPE const& _idx, dev::h256 const& _hash, Signature const& _sig);
+    bool verifySign(dev::h512 const& _nodeId, PBFTMsg const& _req) const;
+
+    /// the request decoded by the verification stage, or an empty one to decode the packet into
+    template <class T>
+    inline std::shared_ptr<T> receivedMsg(PBFTMsgPacket const& _pbftMsg) const
+    {
+        auto req = std::dynamic_pointer_cast<T>(_pbftMsg.decodedMsg);
+        return req ? req : std::make_shared<T>();
+    }
+
+    template <class T>
+    inline bool decodeReceivedMsg(T& _req, PBFTMsgPacket const& _pbftMsg)
+    {
+        if (_pbftMsg.decodedMsg.get() == &_req)
+        {
+            return true;
+        }
+        return decodeToRequests(_req, ref(_pbftMsg.data));
+    }
 
     inline bool broadcastFilter(
         dev::network::NodeID const& nodeId, unsigned const& packetType, std::string const& key)
@@ -575,10 +621,27 @@ protected:
         return true;
     }
 
+    /// the view is reset once the parent is committed, so the prepare of the next block comes
+    /// from the leader of view 0
+    inline bool isValidFutureLeader(PrepareReq const& req) const
+    {
+        if (m_cfgErr || m_nodeNum == 0 || req.view != 0 || req.height <= 0)
+        {
+            return false;
+        }
+        return req.idx == IDXTYPE((req.height - 1) % m_nodeNum);
+    }
+
     void checkSealerList(dev::eth::Block const& block);
     /// check block
     bool checkBlock(dev::eth::Block const& block);
     void execBlock(Sealing& sealing, PrepareReq const& req, std::ostringstream& oss);
+    /// execute the future prepare on the uncommitted state of the prepare in consensus
+    void executeAhead(PrepareReq::Ptr _futureReq);
+    /// return the context of req executed ahead, nullptr if it is not executed or the parent
+    /// committed is not the one it is executed on
+    dev::blockverifier::ExecutiveContext::Ptr takeExecutedAhead(
+        Sealing& _sealing, PrepareReq const& _req);
     void changeViewForFastViewChange()
     {
         m_timeManager.changeView();
@@ -736,6 +799,28 @@ protected:
     dev::ThreadPool::Ptr m_prepareWorker;
     dev::ThreadPool::Ptr m_messageHandler;
     bool m_enablePrepareWithTxsHash = false;
+
+    // the future block executed on the uncommitted state of its parent
+    struct ExecutedAhead
+    {
+        using Ptr = std::shared_ptr<ExecutedAhead>;
+        dev::h256 blockHash;
+        int64_t parentNumber;
+        dev::h256 parentHash;
+        std::shared_ptr<dev::eth::Block> block;
+        dev::storage::OverlayStorage::Ptr stateStorage;
+        std::shared_future<dev::blockverifier::ExecutiveContext::Ptr> context;
+    };
+    bool m_enableExecuteAhead = false;
+    dev::ThreadPool::Ptr m_executeAheadWorker;
+    std::mutex x_executedAhead;
+    ExecutedAhead::Ptr m_executedAhead;
+
+    // the verification stage ahead of the work loop
+    dev::ThreadPool::Ptr m_msgVerifier;
+    std::atomic<int64_t> m_verifyQueueSize = {0};
+    PBFTMsgStageStat m_verifyStat;
+    PBFTMsgStageStat m_handleStat;
 };
 }  // namespace consensus
 }  // namespace dev
@@ -0,0 +1,83 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+/**
+ * @brief : monotonic buffer for the short-lived objects of the execution of a block
+ * @file: Arena.cpp
+ */
+
+#include "Arena.h"
+
+using namespace std;
+using namespace dev;
+
+const size_t Arena::c_defaultChunkSize;
+
+namespace
+{
+size_t padding(char* _pointer, size_t _alignment)
+{
+    auto address = reinterpret_cast<uintptr_t>(_pointer);
+    return (_alignment - address % _alignment) % _alignment;
+}
+}  // namespace
+
+void* Arena::allocate(size_t _size, size_t _alignment)
+{
+    auto& local = m_local.local();
+    ++local.allocations;
+    if (local.current)
+    {
+        auto offset = padding(local.current, _alignment);
+        if (offset + _size <= local.available)
+        {
+            auto result = local.current + offset;
+            local.current = result + _size;
+            local.available -= offset + _size;
+            return result;
+        }
+    }
+    // objects larger than a quarter of a chunk have chunks of their own, the current chunk is kept
+    auto size = _size + _alignment;
+    if (size > m_chunkSize / 4)
+    {
+        auto chunk = newChunk(local, size);
+        return chunk + padding(chunk, _alignment);
+    }
+    auto chunk = newChunk(local, m_chunkSize);
+    auto result = chunk + padding(chunk, _alignment);
+    local.current = result + _size;
+    local.available = m_chunkSize - (local.current - chunk);
+    return result;
+}
+
+uint64_t Arena::allocations() const
+{
+    uint64_t allocations = 0;
+    for (auto const& local : m_local)
+    {
+        allocations += local.allocations;
+    }
+    return allocations;
+}
+
+char* Arena::newChunk(LocalChunks& _local, size_t _size)
+{
+    _local.chunks.emplace_back(new char[_size]);
+    ++m_chunks;
+    m_memorySize += _size;
+    return _local.chunks.back().get();
+}
@@ -0,0 +1,118 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+/**
+ * @brief : monotonic buffer for the short-lived objects of the execution of a block
+ * @file: Arena.h
+ */
+
+#pragma once
+
+#include <tbb/enumerable_thread_specific.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace dev
+{
+// every thread allocates from chunks of its own, so an allocation takes no lock and touches no
+// shared counter. The memory is never reused, it is released when the arena is destroyed, and
+// every object allocated by ArenaAllocator keeps the arena alive, so an object that outlives the
+// block only delays the release
+class Arena
+{
+public:
+    using Ptr = std::shared_ptr<Arena>;
+
+    explicit Arena(size_t _chunkSize = c_defaultChunkSize) : m_chunkSize(_chunkSize) {}
+    Arena(Arena const&) = delete;
+    Arena& operator=(Arena const&) = delete;
+
+    void* allocate(size_t _size, size_t _alignment);
+
+    // the number of allocations, not thread-safe with allocate
+    uint64_t allocations() const;
+    // the number of chunks allocated from the heap
+    uint64_t chunks() const { return m_chunks; }
+    // the bytes of the chunks
+    uint64_t memorySize() const { return m_memorySize; }
+
+    static const size_t c_defaultChunkSize = 64 * 1024;
+
+private:
+    struct LocalChunks
+    {
+        std::vector<std::unique_ptr<char[]>> chunks;
+        char* current = nullptr;
+        size_t available = 0;
+        uint64_t allocations = 0;
+    };
+    char* newChunk(LocalChunks& _local, size_t _size);
+
+    size_t m_chunkSize;
+    tbb::enumerable_thread_specific<LocalChunks> m_local;
+    std::atomic<uint64_t> m_chunks{0};
+    std::atomic<uint64_t> m_memorySize{0};
+};
+
+// the allocator of the standard containers and std::allocate_shared, deallocate does nothing
+template <class T>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(Arena::Ptr _arena) : m_arena(std::move(_arena)) {}
+    template <class U>
+    ArenaAllocator(ArenaAllocator<U> const& _other) : m_arena(_other.arena())
+    {}
+
+    T* allocate(size_t _n)
+    {
+        return static_cast<T*>(m_arena->allocate(_n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T*, size_t) {}
+
+    Arena::Ptr const& arena() const { return m_arena; }
+
+private:
+    Arena::Ptr m_arena;
+};
+
+template <class T, class U>
+bool operator==(ArenaAllocator<T> const& _lhs, ArenaAllocator<U> const& _rhs)
+{
+    return _lhs.arena() == _rhs.arena();
+}
+
+template <class T, class U>
+bool operator!=(ArenaAllocator<T> const& _lhs, ArenaAllocator<U> const& _rhs)
+{
+    return !(_lhs == _rhs);
+}
+
+// std::make_shared if _arena is nullptr
+template <class T, class... Args>
+std::shared_ptr<T> allocateShared(Arena::Ptr const& _arena, Args&&... _args)
+{
+    if (!_arena)
+    {
+        return std::make_shared<T>(std::forward<Args>(_args)...);
+    }
+    return std::allocate_shared<T>(ArenaAllocator<T>(_arena), std::forward<Args>(_args)...);
+}
+}  // namespace dev
@@ -67,6 +67,12 @@ public:
         return std::make_pair(ret, item);
     }
 
+    size_t size()
+    {
+        std::lock_guard<decltype(x_mutex)> guard{x_mutex};
+        return m_queue.size();
+    }
+
 private:
     _QueueT m_queue;
     boost::mutex x_mutex;
@@ -218,6 +218,11 @@ static const std::map<Instruction, InstructionInfo> c_instructionInfo = {
     {Instruction::PUSHC, {"PUSHC", 0, 1, Tier::VeryLow}},
     {Instruction::JUMPC, {"JUMPC", 1, 0, Tier::Mid}},
     {Instruction::JUMPCI, {"JUMPCI", 2, 0, Tier::High}},
+    {Instruction::PUSHADD, {"PUSHADD", 0, 0, Tier::Special}},
+    {Instruction::PUSHMLOAD, {"PUSHMLOAD", 0, 0, Tier::Special}},
+    {Instruction::PUSHMSTORE, {"PUSHMSTORE", 0, 0, Tier::Special}},
+    {Instruction::ISZEROJUMPI, {"ISZEROJUMPI", 0, 0, Tier::Special}},
+    {Instruction::STACKRUN, {"STACKRUN", 0, 0, Tier::Special}},
 };
 
 InstructionInfo instructionInfo(Instruction _inst)
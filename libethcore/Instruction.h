@@ -175,7 +175,12 @@ enum class Instruction : uint8_t
     LOG4,         ///< Makes a log entry; 4 topics.
 
     // these are generated by the interpreter - should never be in user code
-    PUSHC = 0xac,  ///< push value from constant pool
+    PUSHADD = 0xa5,  ///< PUSH of a 64-bit value followed by ADD
+    PUSHMLOAD,       ///< PUSH of a 64-bit value followed by MLOAD
+    PUSHMSTORE,      ///< PUSH of a 64-bit value followed by MSTORE
+    ISZEROJUMPI,     ///< ISZERO, PUSH of a valid jump destination and JUMPI
+    STACKRUN,        ///< a run of DUP, SWAP and POP
+    PUSHC = 0xac,    ///< push value from constant pool
     JUMPC,         ///< alter the program counter - pre-verified
     JUMPCI,        ///< conditionally alter the program counter - pre-verified
 
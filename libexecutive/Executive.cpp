@@ -221,9 +221,9 @@ bool Executive::call(CallParameters const& _p, u256 const& _gasPrice, Address co
             {
                 bytes const& c = m_s->code(_p.codeAddress);
                 h256 codeHash = m_s->codeHash(_p.codeAddress);
-                m_ext = make_shared<ExtVM>(m_s, m_envInfo, _p.receiveAddress, _p.senderAddress,
-                    _origin, _p.apparentValue, _gasPrice, _p.data, &c, codeHash, m_depth, false,
-                    _p.staticCall);
+                m_ext = allocateShared<ExtVM>(arena(), m_s, m_envInfo, _p.receiveAddress,
+                    _p.senderAddress, _origin, _p.apparentValue, _gasPrice, _p.data, &c, codeHash,
+                    m_depth, false, _p.staticCall);
             }
         }
         // Transfer ether.
@@ -318,8 +318,9 @@ bool Executive::callRC2(CallParameters const& _p, u256 const& _gasPrice, Address
     {
         bytes const& c = m_s->code(_p.codeAddress);
         h256 codeHash = m_s->codeHash(_p.codeAddress);
-        m_ext = make_shared<ExtVM>(m_s, m_envInfo, _p.receiveAddress, _p.senderAddress, _origin,
-            _p.apparentValue, _gasPrice, _p.data, &c, codeHash, m_depth, false, _p.staticCall);
+        m_ext = allocateShared<ExtVM>(arena(), m_s, m_envInfo, _p.receiveAddress,
+            _p.senderAddress, _origin, _p.apparentValue, _gasPrice, _p.data, &c, codeHash, m_depth,
+            false, _p.staticCall);
         m_ext->setEvmFlags(m_evmFlags);
     }
     else
@@ -416,8 +417,8 @@ bool Executive::executeCreate(Address const& _sender, u256 const& _endowment, u2
     // Schedule _init execution if not empty.
     if (!_init.empty())
     {
-        m_ext = make_shared<ExtVM>(m_s, m_envInfo, m_newAddress, _sender, _origin, _endowment,
-            _gasPrice, bytesConstRef(), _init, sha3(_init), m_depth, true, false);
+        m_ext = allocateShared<ExtVM>(arena(), m_s, m_envInfo, m_newAddress, _sender, _origin,
+            _endowment, _gasPrice, bytesConstRef(), _init, sha3(_init), m_depth, true, false);
         m_ext->setEvmFlags(m_evmFlags);
     }
     return !m_ext;
@@ -672,6 +673,16 @@ void Executive::loggingException()
     }
 }
 
+Arena::Ptr Executive::arena() const
+{
+    auto context = m_envInfo.precompiledEngine();
+    if (!context || !context->getMemoryTableFactory())
+    {
+        return nullptr;
+    }
+    return context->getMemoryTableFactory()->arena();
+}
+
 void Executive::writeErrInfoToOutput(string const& errInfo)
 {
     eth::ContractABI abi;
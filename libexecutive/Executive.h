@@ -15,6 +15,7 @@
 #pragma once
 
 #include "ExecutionResult.h"
+#include <libdevcore/Arena.h>
 #include <libethcore/BlockHeader.h>
 #include <libethcore/Common.h>
 #include <libethcore/EVMFlags.h>
@@ -225,6 +226,10 @@ private:
 
     void updateGas(std::shared_ptr<dev::precompiled::PrecompiledExecResult> _callResult);
 
+    /// the arena of the block the objects of the transaction are allocated from, nullptr if the
+    /// block has no arena
+    dev::Arena::Ptr arena() const;
+
     std::shared_ptr<StateFace> m_s;  ///< The state to which this operation/transaction is applied.
     // TODO: consider changign to EnvInfo const& to avoid LastHashes copy at every CALL/CREATE
     dev::eth::EnvInfo m_envInfo;   ///< Information on the runtime environment.
@@ -160,6 +160,10 @@ public:
     /// Clear state's cache
     virtual void clear() = 0;
 
+    /// Drop the cached account data, called after the tables of accounts are written without the
+    /// state
+    virtual void clearAccountCache() {}
+
     /// Check authority
     virtual bool checkAuthority(Address const& _origin, Address const& _contract) const = 0;
 };
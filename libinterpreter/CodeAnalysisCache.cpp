@@ -0,0 +1,145 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ *
+ * @brief: cache of the analysed code of VM shared by calls and threads
+ *
+ * @file CodeAnalysisCache.cpp
+ */
+#include "CodeAnalysisCache.h"
+#include <libdevcore/Log.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+const size_t CodeAnalysisCache::c_defaultCapacity;
+const size_t CodeAnalysisCache::c_shardNum;
+const uint64_t CodeAnalysisCache::c_statusInterval;
+
+CodeAnalysisCache::CodeAnalysisCache(size_t _capacity) : m_capacity(_capacity) {}
+
+CodeAnalysis::ConstPtr CodeAnalysisCache::get(h256 const& _codeHash, size_t _codeSize)
+{
+    if (!enabled())
+    {
+        return nullptr;
+    }
+    if ((++m_queryTimes) % c_statusInterval == 0)
+    {
+        logStatus();
+    }
+    auto& codeShard = shard(_codeHash);
+    std::lock_guard<std::mutex> lock(codeShard.lock);
+    auto it = codeShard.index.find(_codeHash);
+    // the size is checked in case of a wrong code hash
+    if (it == codeShard.index.end() || it->second->second->codeSize != _codeSize)
+    {
+        return nullptr;
+    }
+    codeShard.lru.splice(codeShard.lru.begin(), codeShard.lru, it->second);
+    ++m_hitTimes;
+    return it->second->second;
+}
+
+void CodeAnalysisCache::put(h256 const& _codeHash, CodeAnalysis::ConstPtr _analysis)
+{
+    auto shardCapacity = m_capacity / c_shardNum;
+    auto memorySize = _analysis->memorySize();
+    if (memorySize > shardCapacity)
+    {
+        return;
+    }
+    auto& codeShard = shard(_codeHash);
+    std::lock_guard<std::mutex> lock(codeShard.lock);
+    auto it = codeShard.index.find(_codeHash);
+    if (it != codeShard.index.end())
+    {
+        // analysed by another thread at the same time
+        codeShard.memorySize -= it->second->second->memorySize();
+        codeShard.lru.erase(it->second);
+        codeShard.index.erase(it);
+    }
+    codeShard.lru.emplace_front(_codeHash, _analysis);
+    codeShard.index[_codeHash] = codeShard.lru.begin();
+    codeShard.memorySize += memorySize;
+    evict(codeShard, shardCapacity);
+}
+
+void CodeAnalysisCache::setCapacity(size_t _capacity)
+{
+    m_capacity = _capacity;
+    for (auto& codeShard : m_shards)
+    {
+        std::lock_guard<std::mutex> lock(codeShard.lock);
+        evict(codeShard, _capacity / c_shardNum);
+    }
+}
+
+void CodeAnalysisCache::clear()
+{
+    for (auto& codeShard : m_shards)
+    {
+        std::lock_guard<std::mutex> lock(codeShard.lock);
+        codeShard.lru.clear();
+        codeShard.index.clear();
+        codeShard.memorySize = 0;
+    }
+    m_queryTimes = 0;
+    m_hitTimes = 0;
+}
+
+size_t CodeAnalysisCache::size() const
+{
+    size_t size = 0;
+    for (auto& codeShard : m_shards)
+    {
+        std::lock_guard<std::mutex> lock(codeShard.lock);
+        size += codeShard.index.size();
+    }
+    return size;
+}
+
+size_t CodeAnalysisCache::memorySize() const
+{
+    size_t memorySize = 0;
+    for (auto& codeShard : m_shards)
+    {
+        std::lock_guard<std::mutex> lock(codeShard.lock);
+        memorySize += codeShard.memorySize;
+    }
+    return memorySize;
+}
+
+void CodeAnalysisCache::evict(Shard& _shard, size_t _capacity)
+{
+    while (_shard.memorySize > _capacity && !_shard.lru.empty())
+    {
+        auto& last = _shard.lru.back();
+        _shard.memorySize -= last.second->memorySize();
+        _shard.index.erase(last.first);
+        _shard.lru.pop_back();
+    }
+}
+
+void CodeAnalysisCache::logStatus()
+{
+    uint64_t queryTimes = m_queryTimes;
+    uint64_t hitTimes = m_hitTimes;
+    LOG(INFO) << LOG_BADGE("CodeAnalysisCache") << LOG_DESC("status")
+              << LOG_KV("size", size()) << LOG_KV("memorySize", memorySize())
+              << LOG_KV("query", queryTimes) << LOG_KV("hit", hitTimes)
+              << LOG_KV("hitRatio", queryTimes ? (double)hitTimes / queryTimes : 0);
+}
@@ -0,0 +1,114 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ *
+ * @brief: cache of the analysed code of VM shared by calls and threads
+ *
+ * @file CodeAnalysisCache.h
+ */
+#pragma once
+
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace dev
+{
+namespace eth
+{
+// the result of VM::optimize, which is never changed after it is cached
+struct CodeAnalysis
+{
+    using Ptr = std::shared_ptr<CodeAnalysis>;
+    using ConstPtr = std::shared_ptr<CodeAnalysis const>;
+
+    // the size of the original code
+    size_t codeSize = 0;
+    // the code with the optimized instructions and the extra bytes
+    bytes code;
+    // sorted JUMPDEST positions
+    std::vector<uint64_t> jumpDests;
+    // constant pool of PUSHC
+    std::vector<u256> pool;
+    // the code has superinstructions, see VM::fuseSuperinstructions
+    bool superinstructions = false;
+
+    size_t memorySize() const
+    {
+        return sizeof(CodeAnalysis) + code.capacity() + jumpDests.capacity() * sizeof(uint64_t) +
+               pool.capacity() * sizeof(u256);
+    }
+};
+
+// LRU cache of the analysed code keyed by code hash, sharded by the hash to reduce the lock
+// contention of the threads of the parallel execution
+class CodeAnalysisCache
+{
+public:
+    static CodeAnalysisCache& instance()
+    {
+        static CodeAnalysisCache s_instance;
+        return s_instance;
+    }
+
+    explicit CodeAnalysisCache(size_t _capacity = c_defaultCapacity);
+
+    // return nullptr if the code is not cached
+    CodeAnalysis::ConstPtr get(h256 const& _codeHash, size_t _codeSize);
+    void put(h256 const& _codeHash, CodeAnalysis::ConstPtr _analysis);
+
+    // memory limit in bytes, 0 disables the cache
+    void setCapacity(size_t _capacity);
+    size_t capacity() const { return m_capacity; }
+    bool enabled() const { return m_capacity > 0; }
+    void clear();
+
+    uint64_t queryTimes() const { return m_queryTimes; }
+    uint64_t hitTimes() const { return m_hitTimes; }
+    size_t size() const;
+    size_t memorySize() const;
+
+    static const size_t c_defaultCapacity = 64 * 1024 * 1024;
+
+private:
+    struct Shard
+    {
+        mutable std::mutex lock;
+        std::list<std::pair<h256, CodeAnalysis::ConstPtr>> lru;
+        std::unordered_map<h256, std::list<std::pair<h256, CodeAnalysis::ConstPtr>>::iterator>
+            index;
+        size_t memorySize = 0;
+    };
+    static const size_t c_shardNum = 16;
+    // log the status of the cache every c_statusInterval queries
+    static const uint64_t c_statusInterval = 100000;
+
+    Shard& shard(h256 const& _codeHash) { return m_shards[_codeHash[0] % c_shardNum]; }
+    void evict(Shard& _shard, size_t _capacity);
+    void logStatus();
+
+    Shard m_shards[c_shardNum];
+    std::atomic<size_t> m_capacity;
+    std::atomic<uint64_t> m_queryTimes{0};
+    std::atomic<uint64_t> m_hitTimes{0};
+};
+
+}  // namespace eth
+}  // namespace dev
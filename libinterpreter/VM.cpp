@@ -21,6 +21,7 @@
  */
 
 #include "VM.h"
+#include "VMArith.h"
 #include "interpreter.h"
 #include "libconfig/GlobalConfigure.h"
 #include "libdevcrypto/Hash.h"
@@ -153,18 +154,6 @@ uint64_t VM::memNeed(u256 const& _offset, u256 const& _size)
     return toInt63(_size ? u512(_offset) + _size : u512(0));
 }
 
-template <class S>
-S divWorkaround(S const& _a, S const& _b)
-{
-    return (S)(s512(_a) / s512(_b));
-}
-
-template <class S>
-S modWorkaround(S const& _a, S const& _b)
-{
-    return (S)(s512(_a) % s512(_b));
-}
-
 
 //
 // for decoding destinations of JUMPTO, JUMPV, JUMPSUB and JUMPSUBV
@@ -260,7 +249,12 @@ void VM::logGasMem()
 void VM::fetchInstruction()
 {
     m_OP = Instruction(m_code[m_PC]);
-    auto const metric = c_metrics[static_cast<size_t>(m_OP)];
+    meterInstruction(m_OP);
+}
+
+void VM::meterInstruction(Instruction _op)
+{
+    auto const metric = c_metrics[static_cast<size_t>(_op)];
     adjustStack(metric.num_stack_arguments, metric.num_stack_returned_items);
 
     // FEES...
@@ -269,6 +263,19 @@ void VM::fetchInstruction()
     m_copyMemSize = 0;
 }
 
+void VM::pushFused()
+{
+    meterInstruction(Instruction(m_pCode[m_PC]));
+    updateIOGas();
+
+    // PUSH1 to PUSH8, see fuseSuperinstructions
+    int numBytes = (int)m_pCode[m_PC] - (int)Instruction::PUSH1 + 1;
+    uint64_t value = 0;
+    for (++m_PC; numBytes--; ++m_PC)
+        value = (value << 8) | m_code[m_PC];
+    m_SPP[0] = value;
+}
+
 evmc_tx_context const& VM::getTxContext()
 {
     if (!m_tx_context)
@@ -597,7 +604,7 @@ void VM::interpretCases()
             updateIOGas();
 
             // pops two items and pushes their sum mod 2^256.
-            m_SPP[0] = m_SP[0] + m_SP[1];
+            m_SPP[0] = add256(m_SP[0], m_SP[1]);
         }
         NEXT
 
@@ -607,7 +614,7 @@ void VM::interpretCases()
             updateIOGas();
 
             // pops two items and pushes their product mod 2^256.
-            m_SPP[0] = m_SP[0] * m_SP[1];
+            m_SPP[0] = mul256(m_SP[0], m_SP[1]);
         }
         NEXT
 
@@ -616,7 +623,7 @@ void VM::interpretCases()
             ON_OP();
             updateIOGas();
 
-            m_SPP[0] = m_SP[0] - m_SP[1];
+            m_SPP[0] = sub256(m_SP[0], m_SP[1]);
         }
         NEXT
 
@@ -625,7 +632,7 @@ void VM::interpretCases()
             ON_OP();
             updateIOGas();
 
-            m_SPP[0] = m_SP[1] ? divWorkaround(m_SP[0], m_SP[1]) : 0;
+            m_SPP[0] = div256(m_SP[0], m_SP[1]);
         }
         NEXT
 
@@ -644,7 +651,7 @@ void VM::interpretCases()
             ON_OP();
             updateIOGas();
 
-            m_SPP[0] = m_SP[1] ? modWorkaround(m_SP[0], m_SP[1]) : 0;
+            m_SPP[0] = mod256(m_SP[0], m_SP[1]);
         }
         NEXT
 
@@ -671,7 +678,7 @@ void VM::interpretCases()
             ON_OP();
             updateIOGas();
 
-            m_SPP[0] = m_SP[0] < m_SP[1] ? 1 : 0;
+            m_SPP[0] = lt256(m_SP[0], m_SP[1]) ? 1 : 0;
         }
         NEXT
 
@@ -680,7 +687,7 @@ void VM::interpretCases()
             ON_OP();
             updateIOGas();
 
-            m_SPP[0] = m_SP[0] > m_SP[1] ? 1 : 0;
+            m_SPP[0] = lt256(m_SP[1], m_SP[0]) ? 1 : 0;
         }
         NEXT
 
@@ -707,7 +714,7 @@ void VM::interpretCases()
             ON_OP();
             updateIOGas();
 
-            m_SPP[0] = m_SP[0] == m_SP[1] ? 1 : 0;
+            m_SPP[0] = eq256(m_SP[0], m_SP[1]) ? 1 : 0;
         }
         NEXT
 
@@ -1177,6 +1184,95 @@ void VM::interpretCases()
 
             --m_SP;
         }
+        NEXT
+
+            //
+            // superinstructions, see fuseSuperinstructions
+            //
+
+            CASE(PUSHADD)
+        {
+            ON_OP();
+            pushFused();
+            meterInstruction(Instruction::ADD);
+            updateIOGas();
+
+            m_SPP[0] = add256(m_SP[0], m_SP[1]);
+        }
+        NEXT
+
+            CASE(PUSHMLOAD)
+        {
+            ON_OP();
+            pushFused();
+            meterInstruction(Instruction::MLOAD);
+            updateMem(toInt63(m_SP[0]) + 32);
+            updateIOGas();
+
+            m_SPP[0] = (u256) * (h256 const*)(m_mem.data() + (unsigned)m_SP[0]);
+        }
+        NEXT
+
+            CASE(PUSHMSTORE)
+        {
+            ON_OP();
+            pushFused();
+            meterInstruction(Instruction::MSTORE);
+            updateMem(toInt63(m_SP[0]) + 32);
+            updateIOGas();
+
+            *(h256*)&m_mem[(unsigned)m_SP[0]] = (h256)m_SP[1];
+        }
+        NEXT
+
+            CASE(ISZEROJUMPI)
+        {
+            ON_OP();
+            meterInstruction(Instruction::ISZERO);
+            updateIOGas();
+            m_SPP[0] = m_SP[0] ? 0 : 1;
+            ++m_PC;
+
+            pushFused();
+            // the destination is verified by fuseSuperinstructions
+            meterInstruction(Instruction::JUMPI);
+            updateIOGas();
+            if (m_SP[1])
+                m_PC = uint64_t(m_SP[0]);
+            else
+                ++m_PC;
+        }
+        CONTINUE
+
+        CASE(STACKRUN)
+        {
+            ON_OP();
+            for (;;)
+            {
+                auto op = Instruction(m_pCode[m_PC]);
+                meterInstruction(op);
+                updateIOGas();
+
+                // POP is done by meterInstruction
+                if (Instruction::DUP1 <= op && op <= Instruction::DUP16)
+                {
+                    unsigned n = (unsigned)op - (unsigned)Instruction::DUP1;
+                    new (m_SPP) u256(m_SP[n]);
+                }
+                else if (Instruction::SWAP1 <= op && op <= Instruction::SWAP16)
+                {
+                    unsigned n = (unsigned)op - (unsigned)Instruction::SWAP1 + 1;
+                    std::swap(m_SP[0], m_SP[n]);
+                }
+                if (m_PC + 1 >= m_codeSize)
+                    break;
+                auto next = Instruction(m_pCode[m_PC + 1]);
+                if (next != Instruction::POP &&
+                    (next < Instruction::DUP1 || next > Instruction::SWAP16))
+                    break;
+                ++m_PC;
+            }
+        }
         NEXT
 
             CASE(PUSHC)
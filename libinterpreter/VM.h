@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "CodeAnalysisCache.h"
 #include "VMConfig.h"
 #include "VMSchedule.h"
 
@@ -33,6 +34,7 @@
 #include <evmc/instructions.h>
 
 #include <boost/optional.hpp>
+#include <atomic>
 
 namespace dev
 {
@@ -51,7 +53,14 @@ public:
     VMSchedule::Ptr vmSchedule() { return m_vmSchedule; }
     uint64_t m_io_gas = 0;
 
+    // the gas, the results and the exceptions of the execution are the same with or without the
+    // superinstructions, enabled by default
+    static void setEnableSuperinstructions(bool _enable) { s_enableSuperinstructions = _enable; }
+    static bool enableSuperinstructions() { return s_enableSuperinstructions; }
+
 private:
+    static std::atomic_bool s_enableSuperinstructions;
+
     VMSchedule::Ptr m_vmSchedule = nullptr;
     evmc_context* m_context = nullptr;
     evmc_revision m_rev = EVMC_FRONTIER;
@@ -61,7 +70,7 @@ private:
     static std::array<evmc_instruction_metrics, 256> c_metrics;
     static void initMetrics();
     static u256 exp256(u256 _base, u256 _exponent);
-    void copyCode(int);
+    void copyCode(bytes& _code, int _extraBytes);
     typedef void (VM::*MemFnPtr)();
     MemFnPtr m_bounce = nullptr;
     uint64_t m_nSteps = 0;
@@ -74,8 +83,10 @@ private:
 
     uint8_t const* m_pCode = nullptr;
     size_t m_codeSize = 0;
-    // space for code
-    bytes m_code;
+    // the analysed code, which may be shared with other calls by CodeAnalysisCache
+    CodeAnalysis::ConstPtr m_analysis;
+    // code of m_analysis
+    byte const* m_code = nullptr;
 
     /// RETURNDATA buffer for memory returned from direct subcalls.
     bytes m_returnData;
@@ -85,8 +96,8 @@ private:
     u256* m_stackEnd = &m_stack[VMSchedule::stackLimit];
     size_t stackSize() { return m_stackEnd - m_SP; }
 
-    // constant pool
-    std::vector<u256> m_pool;
+    // constant pool of m_analysis
+    u256 const* m_pool = nullptr;
 
     // interpreter state
     Instruction m_OP;         // current operation
@@ -101,7 +112,8 @@ private:
 
     // initialize interpreter
     void initEntry();
-    void optimize();
+    CodeAnalysis::Ptr optimize();
+    void fuseSuperinstructions(CodeAnalysis& _analysis);
 
     // interpreter loop & switch
     void interpretCases();
@@ -125,7 +137,6 @@ private:
     void throwBufferOverrun(bigint const& _enfOfAccess);
 
     std::vector<uint64_t> m_beginSubs;
-    std::vector<uint64_t> m_jumpDests;
     int64_t verifyJumpDest(u256 const& _dest, bool _throw = true);
 
     void onOperation() {}
@@ -136,6 +147,10 @@ private:
     void updateMem(uint64_t _newMem);
     void logGasMem();
     void fetchInstruction();
+    // the stack and the gas of _op, the instructions of a superinstruction are metered one by one
+    void meterInstruction(Instruction _op);
+    // the PUSH of a superinstruction, m_PC is moved to the next instruction
+    void pushFused();
 
     uint64_t decodeJumpDest(const byte* const _code, uint64_t& _pc);
     uint64_t decodeJumpvDest(const byte* const _code, uint64_t& _pc, byte _voff);
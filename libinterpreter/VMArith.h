@@ -0,0 +1,134 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ *
+ * @brief: the arithmetic of VM with 64-bit fast paths
+ *
+ * @file VMArith.h
+ */
+#pragma once
+
+#include <libdevcore/Common.h>
+
+namespace dev
+{
+namespace eth
+{
+template <class S>
+S divWorkaround(S const& _a, S const& _b)
+{
+    return (S)(s512(_a) / s512(_b));
+}
+
+template <class S>
+S modWorkaround(S const& _a, S const& _b)
+{
+    return (S)(s512(_a) % s512(_b));
+}
+
+// most operands of contracts are counters, lengths and offsets, which fit 64 bits, the operations
+// of them are done on uint64_t, the results are the same as the 256-bit operations
+inline bool fitsUint64(u256 const& _value)
+{
+    using boost::multiprecision::limb_type;
+    return sizeof(limb_type) == sizeof(uint64_t) && _value.backend().size() == 1;
+}
+
+inline uint64_t lowUint64(u256 const& _value)
+{
+    return static_cast<uint64_t>(_value.backend().limbs()[0]);
+}
+
+inline u256 add256(u256 const& _a, u256 const& _b)
+{
+    if (fitsUint64(_a) && fitsUint64(_b))
+    {
+        uint64_t result = lowUint64(_a) + lowUint64(_b);
+        if (result >= lowUint64(_a))
+        {
+            return result;
+        }
+    }
+    return _a + _b;
+}
+
+inline u256 sub256(u256 const& _a, u256 const& _b)
+{
+    if (fitsUint64(_a) && fitsUint64(_b) && lowUint64(_a) >= lowUint64(_b))
+    {
+        return lowUint64(_a) - lowUint64(_b);
+    }
+    return _a - _b;
+}
+
+inline u256 mul256(u256 const& _a, u256 const& _b)
+{
+    uint64_t result;
+    if (fitsUint64(_a) && fitsUint64(_b) &&
+        !__builtin_mul_overflow(lowUint64(_a), lowUint64(_b), &result))
+    {
+        return result;
+    }
+    return _a * _b;
+}
+
+// division by 0 is 0
+inline u256 div256(u256 const& _a, u256 const& _b)
+{
+    if (!_b)
+    {
+        return 0;
+    }
+    if (fitsUint64(_a) && fitsUint64(_b))
+    {
+        return lowUint64(_a) / lowUint64(_b);
+    }
+    return divWorkaround(_a, _b);
+}
+
+// modulo 0 is 0
+inline u256 mod256(u256 const& _a, u256 const& _b)
+{
+    if (!_b)
+    {
+        return 0;
+    }
+    if (fitsUint64(_a) && fitsUint64(_b))
+    {
+        return lowUint64(_a) % lowUint64(_b);
+    }
+    return modWorkaround(_a, _b);
+}
+
+inline bool lt256(u256 const& _a, u256 const& _b)
+{
+    if (fitsUint64(_a) && fitsUint64(_b))
+    {
+        return lowUint64(_a) < lowUint64(_b);
+    }
+    return _a < _b;
+}
+
+inline bool eq256(u256 const& _a, u256 const& _b)
+{
+    if (fitsUint64(_a) && fitsUint64(_b))
+    {
+        return lowUint64(_a) == lowUint64(_b);
+    }
+    return _a == _b;
+}
+
+}  // namespace eth
+}  // namespace dev
@@ -39,6 +39,8 @@ namespace eth
 //
 // EVM_REPLACE_CONST_JUMP - pre-verified jumps to save runtime lookup
 //
+// superinstructions are switched at runtime, see VM::setEnableSuperinstructions
+//
 // EVM_TRACE              - provides various levels of tracing
 
 #ifndef EVM_JUMP_DISPATCH
@@ -323,11 +325,11 @@ namespace eth
         &&LOG2,                                 \
         &&LOG3,                                 \
         &&LOG4,                                 \
-        &&INVALID,                              \
-        &&INVALID,                              \
-        &&INVALID,                              \
-        &&INVALID,                              \
-        &&INVALID,                              \
+        &&PUSHADD,                              \
+        &&PUSHMLOAD,                            \
+        &&PUSHMSTORE,                           \
+        &&ISZEROJUMPI,                          \
+        &&STACKRUN,                             \
         &&INVALID,                              \
         &&INVALID,                              \
         &&PUSHC,                                \
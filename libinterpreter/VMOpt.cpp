@@ -27,6 +27,22 @@ namespace dev
 namespace eth
 {
 std::array<evmc_instruction_metrics, 256> VM::c_metrics{{}};
+std::atomic_bool VM::s_enableSuperinstructions{true};
+
+namespace
+{
+bool isSuperinstruction(Instruction _op)
+{
+    return (byte)Instruction::PUSHADD <= (byte)_op && (byte)_op <= (byte)Instruction::STACKRUN;
+}
+
+bool isStackInstruction(Instruction _op)
+{
+    return ((byte)Instruction::DUP1 <= (byte)_op && (byte)_op <= (byte)Instruction::SWAP16) ||
+           _op == Instruction::POP;
+}
+}  // namespace
+
 void VM::initMetrics()
 {
     static bool done = []() noexcept
@@ -39,26 +55,37 @@ void VM::initMetrics()
         c_metrics[uint8_t(Instruction::PUSHC)] = c_metrics[uint8_t(Instruction::PUSH1)];
         c_metrics[uint8_t(Instruction::JUMPC)] = c_metrics[uint8_t(Instruction::JUMP)];
         c_metrics[uint8_t(Instruction::JUMPCI)] = c_metrics[uint8_t(Instruction::JUMPI)];
+        // the instructions of a superinstruction are metered by its case
+        for (auto op : {Instruction::PUSHADD, Instruction::PUSHMLOAD, Instruction::PUSHMSTORE,
+                 Instruction::ISZEROJUMPI, Instruction::STACKRUN})
+        {
+            c_metrics[uint8_t(op)] = evmc_instruction_metrics{};
+        }
         return true;
     }
     ();
     (void)done;
 }
 
-void VM::copyCode(int _extraBytes)
+void VM::copyCode(bytes& _code, int _extraBytes)
 {
     // Copy code so that it can be safely modified and extend code by
     // _extraBytes zero bytes to allow reading virtual data at the end
     // of the code without bounds checks.
     auto extendedSize = m_codeSize + _extraBytes;
-    m_code.reserve(extendedSize);
-    m_code.assign(m_pCode, m_pCode + m_codeSize);
-    m_code.resize(extendedSize);
+    _code.reserve(extendedSize);
+    _code.assign(m_pCode, m_pCode + m_codeSize);
+    _code.resize(extendedSize);
 }
 
-void VM::optimize()
+CodeAnalysis::Ptr VM::optimize()
 {
-    copyCode(33);
+    auto analysis = std::make_shared<CodeAnalysis>();
+    // verifyJumpDest reads the jump destinations of m_analysis
+    m_analysis = analysis;
+    auto& code = analysis->code;
+    analysis->codeSize = m_codeSize;
+    copyCode(code, 33);
 
     size_t const nBytes = m_codeSize;
 
@@ -67,19 +94,20 @@ void VM::optimize()
     TRACE_STR(1, "Build JUMPDEST table")
     for (size_t pc = 0; pc < nBytes; ++pc)
     {
-        Instruction op = Instruction(m_code[pc]);
+        Instruction op = Instruction(code[pc]);
         TRACE_OP(2, pc, op);
 
         // make synthetic ops in user code trigger invalid instruction if run
-        if (op == Instruction::PUSHC || op == Instruction::JUMPC || op == Instruction::JUMPCI)
+        if (op == Instruction::PUSHC || op == Instruction::JUMPC || op == Instruction::JUMPCI ||
+            isSuperinstruction(op))
         {
             TRACE_OP(1, pc, op);
-            m_code[pc] = (byte)Instruction::INVALID;
+            code[pc] = (byte)Instruction::INVALID;
         }
 
         if (op == Instruction::JUMPDEST)
         {
-            m_jumpDests.push_back(pc);
+            analysis->jumpDests.push_back(pc);
         }
         else if ((byte)Instruction::PUSH1 <= (byte)op && (byte)op <= (byte)Instruction::PUSH32)
         {
@@ -93,17 +121,17 @@ void VM::optimize()
     for (size_t pc = 0; pc < nBytes; ++pc)
     {
         u256 val = 0;
-        Instruction op = Instruction(m_code[pc]);
+        Instruction op = Instruction(code[pc]);
 
         if ((byte)Instruction::PUSH1 <= (byte)op && (byte)op <= (byte)Instruction::PUSH32)
         {
             byte nPush = (byte)op - (byte)Instruction::PUSH1 + 1;
 
             // decode pushed bytes to integral value
-            val = m_code[pc + 1];
+            val = code[pc + 1];
             for (uint64_t i = pc + 2, n = nPush; --n; ++i)
             {
-                val = (val << 8) | m_code[i];
+                val = (val << 8) | code[i];
             }
 
 #if EVM_USE_CONSTANT_POOL
@@ -113,16 +141,16 @@ void VM::optimize()
             // followed by one byte count of remaining pushed bytes
             if (5 < nPush)
             {
-                uint16_t pool_off = m_pool.size();
+                uint16_t pool_off = analysis->pool.size();
                 TRACE_VAL(1, "stash", val);
                 TRACE_VAL(1, "... in pool at offset", pool_off);
-                m_pool.push_back(val);
+                analysis->pool.push_back(val);
 
                 TRACE_PRE_OPT(1, pc, op);
-                m_code[pc] = byte(op = Instruction::PUSHC);
-                m_code[pc + 3] = nPush - 2;
-                m_code[pc + 2] = pool_off & 0xff;
-                m_code[pc + 1] = pool_off >> 8;
+                code[pc] = byte(op = Instruction::PUSHC);
+                code[pc + 3] = nPush - 2;
+                code[pc + 2] = pool_off & 0xff;
+                code[pc + 1] = pool_off >> 8;
                 TRACE_POST_OPT(1, pc, op);
             }
 
@@ -134,14 +162,14 @@ void VM::optimize()
             // outer loop is N = number of bytes in code array
             // so complexity is N log M, worst case is N log N
             size_t i = pc + nPush + 1;
-            op = Instruction(m_code[i]);
+            op = Instruction(code[i]);
             if (op == Instruction::JUMP)
             {
                 TRACE_VAL(1, "Replace const JUMP with JUMPC to", val)
                 TRACE_PRE_OPT(1, i, op);
 
                 if (0 <= verifyJumpDest(val, false))
-                    m_code[i] = byte(op = Instruction::JUMPC);
+                    code[i] = byte(op = Instruction::JUMPC);
 
                 TRACE_POST_OPT(1, i, op);
             }
@@ -151,7 +179,7 @@ void VM::optimize()
                 TRACE_PRE_OPT(1, i, op);
 
                 if (0 <= verifyJumpDest(val, false))
-                    m_code[i] = byte(op = Instruction::JUMPCI);
+                    code[i] = byte(op = Instruction::JUMPCI);
 
                 TRACE_POST_OPT(1, i, op);
             }
@@ -162,6 +190,89 @@ void VM::optimize()
     }
     TRACE_STR(1, "Finished optimizations")
 #endif
+    if (enableSuperinstructions())
+    {
+        fuseSuperinstructions(*analysis);
+    }
+    return analysis;
+}
+
+// the first instruction of a sequence is replaced by the superinstruction, the others are kept, so
+// that the positions of the code are the same. The case of a superinstruction reads the original
+// instructions from m_pCode and meters them one by one, in the order of the original code. A jump
+// never lands in a sequence, which has no JUMPDEST after its first instruction
+void VM::fuseSuperinstructions(CodeAnalysis& _analysis)
+{
+    auto& code = _analysis.code;
+    _analysis.superinstructions = true;
+    // the PUSH of a 64-bit value which is not replaced by the first pass
+    auto pushSize = [&](size_t _pc) -> size_t {
+        auto op = Instruction(m_pCode[_pc]);
+        if (code[_pc] != m_pCode[_pc] || (byte)op < (byte)Instruction::PUSH1 ||
+            (byte)op > (byte)Instruction::PUSH8)
+        {
+            return 0;
+        }
+        return (byte)op - (byte)Instruction::PUSH1 + 1;
+    };
+
+    TRACE_STR(1, "Fuse superinstructions")
+    for (size_t pc = 0; pc < m_codeSize;)
+    {
+        Instruction op = Instruction(m_pCode[pc]);
+        size_t next = pc + 1;
+        if ((byte)Instruction::PUSH1 <= (byte)op && (byte)op <= (byte)Instruction::PUSH32)
+        {
+            next += (byte)op - (byte)Instruction::PUSH1 + 1;
+        }
+        if (next >= m_codeSize || code[pc] != m_pCode[pc])
+        {
+            pc = next;
+            continue;
+        }
+
+        auto nextOp = Instruction(m_pCode[next]);
+        bool nextKept = code[next] == m_pCode[next];
+        if (pushSize(pc) && nextKept && nextOp == Instruction::ADD)
+        {
+            code[pc] = (byte)Instruction::PUSHADD;
+        }
+        else if (pushSize(pc) && nextKept && nextOp == Instruction::MLOAD)
+        {
+            code[pc] = (byte)Instruction::PUSHMLOAD;
+        }
+        else if (pushSize(pc) && nextKept && nextOp == Instruction::MSTORE)
+        {
+            code[pc] = (byte)Instruction::PUSHMSTORE;
+        }
+        else if (op == Instruction::ISZERO && pushSize(next))
+        {
+            auto jump = next + 1 + pushSize(next);
+            uint64_t dest = 0;
+            for (auto i = next + 1; i < jump; ++i)
+            {
+                dest = (dest << 8) | code[i];
+            }
+            // JUMPI may be replaced by JUMPCI of the same metrics
+            if (jump < m_codeSize && Instruction(m_pCode[jump]) == Instruction::JUMPI &&
+                (code[jump] == m_pCode[jump] || code[jump] == (byte)Instruction::JUMPCI) &&
+                0 <= verifyJumpDest(dest, false))
+            {
+                code[pc] = (byte)Instruction::ISZEROJUMPI;
+                next = jump + 1;
+            }
+        }
+        else if (isStackInstruction(op) && isStackInstruction(nextOp))
+        {
+            code[pc] = (byte)Instruction::STACKRUN;
+            while (next < m_codeSize && isStackInstruction(Instruction(m_pCode[next])))
+            {
+                ++next;
+            }
+        }
+        TRACE_POST_OPT(2, pc, Instruction(code[pc]));
+        pc = next;
+    }
 }
 
 
@@ -172,7 +283,24 @@ void VM::initEntry()
 {
     m_bounce = &VM::interpretCases;
     initMetrics();
-    optimize();
+
+    // the code hash of a call is the hash of the code of the code address, init code of creation
+    // is seldom executed again and is not cached
+    auto& cache = CodeAnalysisCache::instance();
+    h256 codeHash(m_message->code_hash.bytes, h256::ConstructFromPointer);
+    bool cacheable = cache.enabled() && m_message->kind != EVMC_CREATE &&
+                     m_message->kind != EVMC_CREATE2 && codeHash != h256();
+    m_analysis = cacheable ? cache.get(codeHash, m_codeSize) : nullptr;
+    if (!m_analysis || m_analysis->superinstructions != enableSuperinstructions())
+    {
+        auto analysis = optimize();
+        if (cacheable)
+        {
+            cache.put(codeHash, analysis);
+        }
+    }
+    m_code = m_analysis->code.data();
+    m_pool = m_analysis->pool.data();
 }
 
 
@@ -42,7 +42,9 @@
 #include <libstorage/MemoryTableFactoryFactory.h>
 #include <libstorage/MemoryTableFactoryFactory2.h>
 #include <libstorage/RocksDBStorage.h>
+#include <libstorage/RowPruner.h>
 #include <libstorage/SQLStorage.h>
+#include <libstorage/StateSnapshot.h>
 #include <libstorage/ZdbStorage.h>
 #include <libstoragestate/StorageStateFactory.h>
 #include <boost/lexical_cast.hpp>
@@ -240,6 +242,16 @@ void DBInitializer::setSyncNumForCachedStorage(int64_t const& _syncNum)
     }
 }
 
+void DBInitializer::clearCachedStorage(int64_t _syncNum)
+{
+    if (m_cacheStorage)
+    {
+        m_cacheStorage->clear();
+        m_cacheStorage->setSyncNum(_syncNum);
+        DBInitializer_LOG(INFO) << LOG_BADGE("clearCachedStorage") << LOG_KV("syncNum", _syncNum);
+    }
+}
+
 void DBInitializer::initTableFactory2(
     Storage::Ptr _backend, std::shared_ptr<LedgerParamInterface> _param)
 {
@@ -261,6 +273,7 @@ void DBInitializer::initTableFactory2(
     }
 
     auto tableFactoryFactory = std::make_shared<dev::storage::MemoryTableFactoryFactory2>();
+    tableFactoryFactory->setEnableArena(_param->mutableTxParam().enableArena);
     if (_param->mutableStorageParam().binaryLog)
     {
         auto binaryLogStorage = make_shared<BinaryLogStorage>();
@@ -272,9 +285,13 @@ void DBInitializer::initTableFactory2(
         boost::filesystem::create_directories(path);
         auto binaryLogger = make_shared<BinLogHandler>(path);
         binaryLogger->setBinaryLogSize(g_BCOSConfig.c_binaryLogSize);
+        binaryLogger->setSyncPolicy(
+            binLogSyncPolicyFromString(_param->mutableStorageParam().binaryLogSync),
+            _param->mutableStorageParam().binaryLogSyncInterval);
         recoverFromBinaryLog(binaryLogger, backendStorage);
         binaryLogStorage->setBinaryLogger(binaryLogger);
-        DBInitializer_LOG(INFO) << LOG_BADGE("init BinaryLogger") << LOG_KV("BinaryLogsPath", path);
+        DBInitializer_LOG(INFO) << LOG_BADGE("init BinaryLogger") << LOG_KV("BinaryLogsPath", path)
+                                << LOG_KV("sync", _param->mutableStorageParam().binaryLogSync);
         m_storage = binaryLogStorage;
     }
     else
@@ -344,11 +361,29 @@ dev::storage::Storage::Ptr DBInitializer::initRocksDBStorage(
     }
     try
     {
+        if (_param->mutableStorageParam().enablePrune)
+        {
+            m_rowPruner =
+                std::make_shared<RowPruner>(_param->mutableStorageParam().pruneRetention);
+        }
         auto rocksdbStorage = createRocksDBStorage(_param->mutableStorageParam().path,
             g_BCOSConfig.diskEncryption.enable, _param->mutableStorageParam().binaryLog,
-            _param->mutableStorageParam().CachedStorage);
+            _param->mutableStorageParam().CachedStorage, m_rowPruner);
+        m_rocksDB = std::dynamic_pointer_cast<RocksDBStorage>(rocksdbStorage)->db();
+        if (StateSnapshotImporter::unfinished(m_rocksDB))
+        {
+            DBInitializer_LOG(ERROR) << LOG_DESC(
+                "the import of a state snapshot was interrupted, please remove the data and "
+                "restart the node");
+            BOOST_THROW_EXCEPTION(
+                OpenDBFailed() << errinfo_comment("unfinished state snapshot import"));
+        }
         return rocksdbStorage;
     }
+    catch (OpenDBFailed const&)
+    {
+        throw;
+    }
     catch (std::exception& e)
     {
         DBInitializer_LOG(ERROR) << LOG_DESC("initRocksDBStorage failed")
@@ -547,19 +582,45 @@ void DBInitializer::createStorageState()
         enableBinaryEncode = true;
     }
 #endif
+    // the binary slots are stored as they are, only rocksdb based storages support binary fields
+    bool binaryStorage = m_param->mutableStateParam().binaryStorage;
+    if (binaryStorage &&
+        (g_BCOSConfig.version() < V2_4_0 ||
+            (dev::stringCmpIgnoreCase(m_param->mutableStorageParam().type, "RocksDB") &&
+                dev::stringCmpIgnoreCase(m_param->mutableStorageParam().type, "Scalable"))))
+    {
+        DBInitializer_LOG(ERROR)
+            << LOG_DESC("Only support binary_storage with RocksDB or Scalable storage when "
+                        "supported_version is not lower than 2.4.0")
+            << LOG_KV("storage_type", m_param->mutableStorageParam().type)
+            << LOG_KV("supported_version", g_BCOSConfig.version());
+        BOOST_THROW_EXCEPTION(UnsupportedFeature() << errinfo_comment(
+                                  "Only support binary_storage with RocksDB or Scalable storage "
+                                  "when supported_version is not lower than 2.4.0"));
+    }
     auto stateFactory = std::make_shared<StorageStateFactory>(u256(0x0));
     stateFactory->enableBinaryEncode(enableBinaryEncode);
+    stateFactory->enableBinaryStorage(binaryStorage);
     m_stateFactory = stateFactory;
     DBInitializer_LOG(INFO) << LOG_DESC("createStorageState SUCC")
-                            << LOG_KV("state enable store binary", enableBinaryEncode);
+                            << LOG_KV("state enable store binary", enableBinaryEncode)
+                            << LOG_KV("binaryStorage", binaryStorage);
 }
 
 Storage::Ptr dev::ledger::createRocksDBStorage(const std::string& _dbPath,
-    bool _enableEncryption = false, bool _disableWAL = false, bool _enableCache = true)
+    bool _enableEncryption = false, bool _disableWAL = false, bool _enableCache = true,
+    RowPruner::Ptr _pruner)
 {
     boost::filesystem::create_directories(_dbPath);
 
     std::shared_ptr<BasicRocksDB> rocksDB = std::make_shared<BasicRocksDB>();
+    if (_pruner)
+    {
+        auto filter = _enableEncryption ? std::make_shared<RowCompactionFilter>(
+                                              _pruner, getDecryptHandler(), getEncryptHandler()) :
+                                          std::make_shared<RowCompactionFilter>(_pruner);
+        rocksDB->setCompactionFilter(filter);
+    }
     auto options = getRocksDBOptions();
     // any exception will cause the program to be stopped
     rocksDB->Open(options, _dbPath);
@@ -574,6 +635,15 @@ Storage::Ptr dev::ledger::createRocksDBStorage(const std::string& _dbPath,
     std::shared_ptr<RocksDBStorage> rocksdbStorage =
         std::make_shared<RocksDBStorage>(_disableWAL, !_enableCache);
     rocksdbStorage->setDB(rocksDB);
+    if (_pruner)
+    {
+        rocksdbStorage->setRowPruner(_pruner);
+        _pruner->setCurrentNumber(
+            StateSnapshotExporter::currentNumber(rocksDB, rocksdb::ReadOptions()));
+        DBInitializer_LOG(INFO) << LOG_DESC("enable pruning of tombstones")
+                                << LOG_KV("retention", _pruner->retention())
+                                << LOG_KV("pruneNumber", _pruner->pruneNumber());
+    }
     return rocksdbStorage;
 }
 
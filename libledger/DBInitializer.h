@@ -41,6 +41,7 @@ namespace storage
 {
 class BasicRocksDB;
 class BinLogHandler;
+class RowPruner;
 struct ConnectionPoolConfig;
 }  // namespace storage
 
@@ -87,6 +88,14 @@ public:
     }
 
     void setSyncNumForCachedStorage(int64_t const& _syncNum);
+    // the rocksdb of the RocksDB storage type, nullptr for other storage types
+    std::shared_ptr<dev::storage::BasicRocksDB> rocksDB() const { return m_rocksDB; }
+    // the pruner of the tombstones of the RocksDB storage, nullptr if pruning is disabled
+    std::shared_ptr<dev::storage::RowPruner> rowPruner() const { return m_rowPruner; }
+    // drop the cached rows after the backend has been replaced by a state snapshot of _syncNum
+    void clearCachedStorage(int64_t _syncNum);
+    // nullptr if the CachedStorage is disabled
+    std::shared_ptr<dev::storage::CachedStorage> cachedStorage() const { return m_cacheStorage; }
 
 protected:
     dev::GROUP_ID m_groupID = 0;
@@ -122,12 +131,16 @@ private:
 
     dev::storage::TableFactoryFactory::Ptr m_tableFactoryFactory;
     std::shared_ptr<dev::storage::CachedStorage> m_cacheStorage;
+    std::shared_ptr<dev::storage::BasicRocksDB> m_rocksDB;
+    std::shared_ptr<dev::storage::RowPruner> m_rowPruner;
 };
 int64_t getBlockNumberFromStorage(dev::storage::Storage::Ptr _storage);
 std::function<void(std::string&)> getDecryptHandler();
 std::function<void(std::string const&, std::string&)> getEncryptHandler();
-dev::storage::Storage::Ptr createRocksDBStorage(
-    const std::string& _dbPath, bool _enableEncryption, bool _disableWAL, bool _enableCache);
+// _pruner drops the tombstones of the db when rocksdb compacts keys, see RowPruner
+dev::storage::Storage::Ptr createRocksDBStorage(const std::string& _dbPath,
+    bool _enableEncryption, bool _disableWAL, bool _enableCache,
+    std::shared_ptr<dev::storage::RowPruner> _pruner = nullptr);
 dev::storage::Storage::Ptr createSQLStorage(std::shared_ptr<LedgerParamInterface> _param,
     std::shared_ptr<ChannelRPCServer> _channelRPCServer,
     std::function<void(std::exception& e)> _fatalHandler);
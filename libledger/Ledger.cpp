@@ -114,8 +114,11 @@ bool Ledger::initTxPool()
         Ledger_LOG(ERROR) << LOG_BADGE("initLedger") << LOG_DESC("initTxPool Failed");
         return false;
     }
-    m_txPool = std::make_shared<dev::txpool::TxPool>(
+    auto txPool = std::make_shared<dev::txpool::TxPool>(
         m_service, m_blockChain, protocol_id, m_param->mutableTxPoolParam().txPoolLimit);
+    txPool->setSenderLimit(m_param->mutableTxPoolParam().senderLimit);
+    txPool->setSenderWeights(m_param->mutableTxPoolParam().senderWeights);
+    m_txPool = txPool;
     m_txPool->setMaxBlockLimit(g_BCOSConfig.c_blockLimit);
     Ledger_LOG(INFO) << LOG_BADGE("initLedger") << LOG_DESC("initTxPool SUCC");
     return true;
@@ -143,6 +146,8 @@ bool Ledger::initBlockVerifier()
         std::dynamic_pointer_cast<BlockChainImp>(m_blockChain);
     blockVerifier->setNumberHash(boost::bind(&BlockChainImp::numberHash, blockChain, _1));
     blockVerifier->setEvmFlags(m_param->mutableGenesisParam().evmFlags);
+    blockVerifier->setEnablePrefetch(m_param->mutableTxParam().enablePrefetch);
+    blockVerifier->setEnableOptimistic(m_param->mutableTxParam().enableOptimistic);
 
     m_blockVerifier = blockVerifier;
     Ledger_LOG(INFO) << LOG_BADGE("initLedger") << LOG_BADGE("initBlockVerifier SUCC")
@@ -192,6 +197,7 @@ bool Ledger::initBlockChain(GenesisBlockParam& _genesisParam)
     }
 
     blockChain->setStateStorage(m_dbInitializer->storage());
+    blockChain->setEnableAsyncCommit(m_param->mutableStorageParam().asyncCommit);
     blockChain->setTableFactoryFactory(m_dbInitializer->tableFactoryFactory());
     m_blockChain = blockChain;
     bool ret = m_blockChain->checkAndBuildGenesisBlock(_genesisParam, shouldBuild);
@@ -297,6 +303,11 @@ void Ledger::initPBFTEngine(Sealer::Ptr _sealer)
     pbftEngine->setEnableTTLOptimize(m_param->mutableConsensusParam().enableTTLOptimize);
     pbftEngine->setEnablePrepareWithTxsHash(
         m_param->mutableConsensusParam().enablePrepareWithTxsHash);
+    pbftEngine->setVerifyThreadNum(m_param->mutableConsensusParam().verifyThreadNum);
+    // the overlay of the parent state is only supported by the storage state
+    pbftEngine->setEnableExecuteAhead(
+        m_param->mutableTxParam().enableExecuteAhead &&
+        dev::stringCmpIgnoreCase(m_param->mutableStateParam().type, "storage") == 0);
 }
 
 // init rotating-pbft engine
@@ -421,6 +432,20 @@ bool Ledger::initSync()
     // set the max block queue size for sync module(bytes)
     syncMaster->setMaxBlockQueueSize(m_param->mutableSyncParam().maxQueueSizeForBlockSync);
     syncMaster->setTxsStatusGossipMaxPeers(m_param->mutableSyncParam().txsStatusGossipMaxPeers);
+    // serve state snapshots to new nodes, and import a snapshot if enabled
+    if (m_dbInitializer->rocksDB())
+    {
+        auto dbInitializer = m_dbInitializer;
+        auto blockChain = std::dynamic_pointer_cast<BlockChainImp>(m_blockChain);
+        syncMaster->enableSnapshotSync(m_dbInitializer->rocksDB(), m_dbInitializer->rowPruner(),
+            m_param->mutableSyncParam().enableSnapshotSync,
+            m_param->mutableSyncParam().snapshotSyncThreshold,
+            m_param->mutableSyncParam().snapshotChunkSize,
+            [dbInitializer, blockChain](int64_t _number) {
+                dbInitializer->clearCachedStorage(_number);
+                blockChain->reloadFromStorage();
+            });
+    }
     m_sync = syncMaster;
     Ledger_LOG(INFO) << LOG_BADGE("initLedger") << LOG_DESC("initSync SUCC");
     return true;
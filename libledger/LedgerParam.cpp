@@ -29,6 +29,7 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/bind.hpp>
 #include <boost/function_output_iterator.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/property_tree/ini_parser.hpp>
 
 using namespace boost::property_tree;
@@ -65,6 +66,7 @@ void LedgerParam::parseGenesisConfig(const std::string& _genesisFile)
         LedgerParam_LOG(INFO) << LOG_BADGE("parseGenesisConfig")
                               << LOG_KV("timestamp", mutableGenesisParam().timeStamp);
         mutableStateParam().type = pt.get<std::string>("state.type", "storage");
+        mutableStateParam().binaryStorage = pt.get<bool>("state.binary_storage", false);
         // Compatibility with previous versions RC2/RC1
         mutableStorageParam().type = pt.get<std::string>("storage.type", "LevelDB");
         mutableStorageParam().topic = pt.get<std::string>("storage.topic", "DB");
@@ -108,6 +110,10 @@ blockchain::GenesisBlockParam LedgerParam::generateGenesisMark()
         s << mutableStorageParam().type << "-";
     }
     s << mutableStateParam().type << "-";
+    if (mutableStateParam().binaryStorage)
+    {
+        s << "binaryStorage-";
+    }
     if (g_BCOSConfig.version() >= V2_4_0)
     {
         LedgerParam_LOG(DEBUG) << LOG_DESC("store evmFlag")
@@ -194,8 +200,17 @@ void LedgerParam::initTxExecuteConfig(ptree const& pt)
     {
         mutableTxParam().enableParallel = false;
     }
+    mutableTxParam().enablePrefetch = pt.get<bool>("tx_execute.enable_prefetch", true);
+    mutableTxParam().enableOptimistic = pt.get<bool>("tx_execute.enable_optimistic", false);
+    mutableTxParam().enableExecuteAhead =
+        pt.get<bool>("tx_execute.enable_execute_ahead", false);
+    mutableTxParam().enableArena = pt.get<bool>("tx_execute.enable_arena", false);
     LedgerParam_LOG(INFO) << LOG_BADGE("InitTxExecuteConfig")
-                          << LOG_KV("enableParallel", mutableTxParam().enableParallel);
+                          << LOG_KV("enableParallel", mutableTxParam().enableParallel)
+                          << LOG_KV("enablePrefetch", mutableTxParam().enablePrefetch)
+                          << LOG_KV("enableOptimistic", mutableTxParam().enableOptimistic)
+                          << LOG_KV("enableExecuteAhead", mutableTxParam().enableExecuteAhead)
+                          << LOG_KV("enableArena", mutableTxParam().enableArena);
 }
 
 void LedgerParam::initTxPoolConfig(ptree const& pt)
@@ -218,6 +233,49 @@ void LedgerParam::initTxPoolConfig(ptree const& pt)
         mutableTxPoolParam().txPoolLimit = SYNC_TX_POOL_SIZE_DEFAULT;
         LedgerParam_LOG(WARNING) << LOG_BADGE("txPoolLimit") << LOG_DESC("txPoolLimit invalid");
     }
+    mutableTxPoolParam().senderLimit = pt.get<int64_t>("tx_pool.sender_limit", 0);
+    if (mutableTxPoolParam().senderLimit < 0)
+    {
+        BOOST_THROW_EXCEPTION(ForbidNegativeValue()
+                              << errinfo_comment("Please set tx_pool.sender_limit to positive !"));
+    }
+    // sender_weight.0x...=weight
+    if (auto txPoolConfig = pt.get_child_optional("tx_pool"))
+    {
+        std::string const prefix = "sender_weight.";
+        for (auto const& it : *txPoolConfig)
+        {
+            if (it.first.find(prefix) != 0)
+            {
+                continue;
+            }
+            auto address = it.first.substr(prefix.size());
+            if (!isHash<dev::Address>(address))
+            {
+                BOOST_THROW_EXCEPTION(InvalidConfiguration() << errinfo_comment(
+                                          "tx_pool." + it.first + " is not a valid address"));
+            }
+            int64_t weight = 0;
+            try
+            {
+                weight = boost::lexical_cast<int64_t>(it.second.data());
+            }
+            catch (boost::bad_lexical_cast const&)
+            {
+                BOOST_THROW_EXCEPTION(InvalidConfiguration() << errinfo_comment(
+                                          "tx_pool." + it.first + " must be an integer"));
+            }
+            if (weight <= 0)
+            {
+                BOOST_THROW_EXCEPTION(ForbidNegativeValue() << errinfo_comment(
+                                          "Please set tx_pool." + it.first + " to positive !"));
+            }
+            mutableTxPoolParam().senderWeights[dev::Address(address)] = weight;
+        }
+    }
+    LedgerParam_LOG(INFO) << LOG_BADGE("initTxPoolConfig")
+                          << LOG_KV("senderLimit", mutableTxPoolParam().senderLimit)
+                          << LOG_KV("senderWeights", mutableTxPoolParam().senderWeights.size());
 }
 
 void LedgerParam::initRPBFTConsensusIniConfig(boost::property_tree::ptree const& pt)
@@ -325,6 +383,7 @@ void LedgerParam::initConsensusIniConfig(ptree const& pt)
     {
         mutableConsensusParam().enablePrepareWithTxsHash = false;
     }
+    mutableConsensusParam().verifyThreadNum = pt.get<unsigned>("consensus.verify_thread_num", 2);
 
     LedgerParam_LOG(INFO)
         << LOG_BADGE("initConsensusIniConfig")
@@ -333,7 +392,8 @@ void LedgerParam::initConsensusIniConfig(ptree const& pt)
         << LOG_KV("enablDynamicBlockSize", mutableConsensusParam().enableDynamicBlockSize)
         << LOG_KV("blockSizeIncreaseRatio", mutableConsensusParam().blockSizeIncreaseRatio)
         << LOG_KV("enableTTLOptimize", mutableConsensusParam().enableTTLOptimize)
-        << LOG_KV("enablePrepareWithTxsHash", mutableConsensusParam().enablePrepareWithTxsHash);
+        << LOG_KV("enablePrepareWithTxsHash", mutableConsensusParam().enablePrepareWithTxsHash)
+        << LOG_KV("verifyThreadNum", mutableConsensusParam().verifyThreadNum);
     // init rpbft related configurations
     initRPBFTConsensusIniConfig(pt);
 }
@@ -504,6 +564,23 @@ void LedgerParam::initSyncConfig(ptree const& pt)
     }
     mutableSyncParam().maxQueueSizeForBlockSync *= 1024 * 1024;
 
+    // snapshot sync is only supported by the RocksDB storage, disabled by default
+    mutableSyncParam().enableSnapshotSync = pt.get<bool>("sync.enable_snapshot_sync", false);
+    mutableSyncParam().snapshotSyncThreshold =
+        pt.get<int64_t>("sync.snapshot_sync_threshold", 10000);
+    if (mutableSyncParam().snapshotSyncThreshold <= 0)
+    {
+        BOOST_THROW_EXCEPTION(InvalidConfiguration() << errinfo_comment(
+                                  "Please set sync.snapshot_sync_threshold to positive !"));
+    }
+    mutableSyncParam().snapshotChunkSize = pt.get<int64_t>("sync.snapshot_chunk_size_kb", 512);
+    if (mutableSyncParam().snapshotChunkSize <= 0)
+    {
+        BOOST_THROW_EXCEPTION(InvalidConfiguration() << errinfo_comment(
+                                  "Please set sync.snapshot_chunk_size_kb to positive !"));
+    }
+    mutableSyncParam().snapshotChunkSize *= 1024;
+
     LedgerParam_LOG(INFO)
         << LOG_BADGE("initSyncConfig")
         << LOG_KV("enableSendBlockStatusByTree", mutableSyncParam().enableSendBlockStatusByTree)
@@ -511,7 +588,10 @@ void LedgerParam::initSyncConfig(ptree const& pt)
         << LOG_KV("gossipPeers", mutableSyncParam().gossipPeers)
         << LOG_KV("syncTreeWidth", mutableSyncParam().syncTreeWidth)
         << LOG_KV("maxQueueSizeForBlockSync", mutableSyncParam().maxQueueSizeForBlockSync)
-        << LOG_KV("txsStatusGossipMaxPeers", mutableSyncParam().txsStatusGossipMaxPeers);
+        << LOG_KV("txsStatusGossipMaxPeers", mutableSyncParam().txsStatusGossipMaxPeers)
+        << LOG_KV("enableSnapshotSync", mutableSyncParam().enableSnapshotSync)
+        << LOG_KV("snapshotSyncThreshold", mutableSyncParam().snapshotSyncThreshold)
+        << LOG_KV("snapshotChunkSize", mutableSyncParam().snapshotChunkSize);
 }
 
 std::string LedgerParam::uriEncode(const std::string& keyWord)
@@ -567,6 +647,28 @@ void LedgerParam::initStorageConfig(ptree const& pt)
         scrollThresholdMultiple > 0 ? scrollThresholdMultiple * g_BCOSConfig.c_blockLimit : 2000;
 
     mutableStorageParam().maxForwardBlock = pt.get<uint>("storage.max_forward_block", 10);
+    mutableStorageParam().asyncCommit = pt.get<bool>("storage.async_commit", true);
+    mutableStorageParam().enablePrune = pt.get<bool>("storage.enable_prune", false);
+    mutableStorageParam().pruneRetention = pt.get<int64_t>("storage.prune_retention_blocks", 1000);
+    if (mutableStorageParam().pruneRetention < 0)
+    {
+        BOOST_THROW_EXCEPTION(ForbidNegativeValue() << errinfo_comment(
+                                  "Please set storage.prune_retention_blocks to positive !"));
+    }
+    mutableStorageParam().binaryLogSync = pt.get<std::string>("storage.binlog_sync", "block");
+    mutableStorageParam().binaryLogSyncInterval =
+        pt.get<uint64_t>("storage.binlog_sync_interval", 100);
+    if (mutableStorageParam().binaryLogSync != "none" &&
+        mutableStorageParam().binaryLogSync != "block" &&
+        mutableStorageParam().binaryLogSync != "group")
+    {
+        LedgerParam_LOG(ERROR) << LOG_BADGE("initStorageConfig")
+                               << LOG_DESC("invalid binlog_sync, must be none, block or group")
+                               << LOG_KV("binlogSync", mutableStorageParam().binaryLogSync);
+        BOOST_THROW_EXCEPTION(
+            InvalidConfiguration() << errinfo_comment(
+                "invalid storage.binlog_sync, must be none, block or group"));
+    }
 
     if (mutableStorageParam().maxRetry <= 1)
     {
@@ -595,7 +697,13 @@ void LedgerParam::initStorageConfig(ptree const& pt)
                           << LOG_KV("dbcharset", mutableStorageParam().dbCharset)
                           << LOG_KV("initconnections", mutableStorageParam().initConnections)
                           << LOG_KV("maxconnections", mutableStorageParam().maxConnections)
-                          << LOG_KV("scrollThreshold", mutableStorageParam().scrollThreshold);
+                          << LOG_KV("scrollThreshold", mutableStorageParam().scrollThreshold)
+                          << LOG_KV("asyncCommit", mutableStorageParam().asyncCommit)
+                          << LOG_KV("binlogSync", mutableStorageParam().binaryLogSync)
+                          << LOG_KV("binlogSyncInterval",
+                                 mutableStorageParam().binaryLogSyncInterval)
+                          << LOG_KV("enablePrune", mutableStorageParam().enablePrune)
+                          << LOG_KV("pruneRetention", mutableStorageParam().pruneRetention);
 }
 
 void LedgerParam::initEventLogFilterManagerConfig(boost::property_tree::ptree const& pt)
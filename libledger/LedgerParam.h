@@ -24,10 +24,12 @@
 #pragma once
 #include "LedgerParamInterface.h"
 #include <libblockchain/BlockChainInterface.h>
+#include <libdevcore/Address.h>
 #include <libdevcore/FixedHash.h>
 #include <libethcore/EVMFlags.h>
 #include <libethcore/Protocol.h>
 #include <boost/property_tree/ptree.hpp>
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -44,6 +46,10 @@ namespace ledger
 struct TxPoolParam
 {
     int64_t txPoolLimit = SYNC_TX_POOL_SIZE_DEFAULT;
+    /// the max number of pending transactions of a sender of weight 1, 0 means no limit
+    int64_t senderLimit = 0;
+    /// the weights of the senders when sealing and evicting transactions, the default is 1
+    std::map<dev::Address, size_t> senderWeights;
 };
 struct ConsensusParam
 {
@@ -71,6 +77,8 @@ struct ConsensusParam
     // enable optimize ttl or not
     bool enableTTLOptimize;
     bool enablePrepareWithTxsHash;
+    // the threads to decode and verify the received PBFT messages, 0 to verify in the work loop
+    unsigned verifyThreadNum = 2;
 
     bool broadcastPrepareByTree;
     unsigned treeWidth = 3;
@@ -105,6 +113,12 @@ struct SyncParam
     int64_t maxQueueSizeForBlockSync = 512 * 1024 * 1024;
     // limit the peers number the txs-status gossip to
     signed txsStatusGossipMaxPeers = 5;
+    // import the state snapshot of a peer instead of replaying blocks from the genesis block
+    bool enableSnapshotSync = false;
+    // the peer must be at least snapshotSyncThreshold blocks ahead to import its snapshot
+    int64_t snapshotSyncThreshold = 10000;
+    // bytes of a snapshot chunk (default is 512 KB)
+    int64_t snapshotChunkSize = 512 * 1024;
 };
 
 /// modification 2019.03.20: add timeStamp field to GenesisParam
@@ -128,6 +142,10 @@ struct StorageParam
     std::string type = "storage";
     std::string path = "data/";
     bool binaryLog = false;
+    // fsync policy of the binary log: none, block or group, block returns after the write
+    std::string binaryLogSync = "block";
+    // ms, only for group
+    uint64_t binaryLogSyncInterval = 100;
     bool CachedStorage = true;
     // for amop storage
     std::string topic;
@@ -148,15 +166,30 @@ struct StorageParam
     uint32_t initConnections;
     uint32_t maxConnections;
     int maxForwardBlock;
+    // write block data and tx index off the consensus thread, only for CachedStorage
+    bool asyncCommit = true;
+    // drop tombstones older than pruneRetention blocks when rocksdb compacts, only for RocksDB
+    bool enablePrune = false;
+    int64_t pruneRetention = 1000;
 };
 struct StateParam
 {
     std::string type;
+    // store the slots of contracts as 32 bytes binary, see StorageState::setBinaryStorage
+    bool binaryStorage = false;
 };
 struct TxParam
 {
     int64_t txGasLimit;
     bool enableParallel = false;
+    bool enablePrefetch = true;
+    // run transactions without criticals speculatively in parallel, see OptimisticExecutor
+    bool enableOptimistic = false;
+    // execute the future block on the uncommitted state of the block in consensus, see
+    // OverlayStorage
+    bool enableExecuteAhead = false;
+    // allocate the short-lived objects of the execution of a block from an arena, see Arena
+    bool enableArena = false;
 };
 class LedgerParam : public LedgerParamInterface
 {
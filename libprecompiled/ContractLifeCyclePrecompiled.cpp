@@ -147,6 +147,8 @@ int ContractLifeCyclePrecompiled::updateFrozenStatus(ExecutiveContext::Ptr conte
             result = table->insert(storagestate::ACCOUNT_FROZEN, entry,
                 std::make_shared<AccessOptions>(origin, false));
         }
+        // the frozen status cached by the state is out of date
+        context->getState()->clearAccountCache();
     }
 
     return result;
@@ -21,6 +21,7 @@
 
 #include "ParallelConfigPrecompiled.h"
 #include <libconfig/GlobalConfigure.h>
+#include <libethcore/ABIParser.h>
 #include <libprecompiled/EntriesPrecompiled.h>
 #include <libprecompiled/TableFactoryPrecompiled.h>
 #include <boost/algorithm/string.hpp>
@@ -143,6 +144,10 @@ void ParallelConfigPrecompiled::registerParallelFunction(
     ContractABI abi;
     abi.abiOut(data, contractAddress, functionName, criticalSize);
     uint32_t selector = getFuncSelector(functionName);
+    {
+        WriteGuard l(x_criticalConfigs);
+        m_criticalConfigs.erase(contractAddress);
+    }
 
     Table::Ptr table = openTable(context, contractAddress, origin);
     if (table && table.get())
@@ -196,6 +201,10 @@ void ParallelConfigPrecompiled::unregisterParallelFunction(
     ContractABI abi;
     abi.abiOut(data, contractAddress, functionName);
     uint32_t selector = getFuncSelector(functionName);
+    {
+        WriteGuard l(x_criticalConfigs);
+        m_criticalConfigs.erase(contractAddress);
+    }
 
     Table::Ptr table = openTable(context, contractAddress, origin);
     if (table && table.get())
@@ -243,6 +252,60 @@ ParallelConfig::Ptr ParallelConfigPrecompiled::getParallelConfig(
         {
             criticalSize = boost::lexical_cast<u256>(entry->getField(PARA_CRITICAL_SIZE));
         }
-        return make_shared<ParallelConfig>(ParallelConfig{funtionName, criticalSize});
+        return make_shared<ParallelConfig>(ParallelConfig{funtionName, criticalSize, {}});
+    }
+}
+
+ParallelConfig::Ptr ParallelConfigPrecompiled::getCriticalConfig(
+    dev::blockverifier::ExecutiveContext::Ptr context, Address const& contractAddress,
+    uint32_t selector, Address const& origin)
+{
+    {
+        ReadGuard l(x_criticalConfigs);
+        auto it = m_criticalConfigs.find(contractAddress);
+        if (it != m_criticalConfigs.end())
+        {
+            auto configIt = it->second.find(selector);
+            if (configIt != it->second.end())
+            {
+                return configIt->second;
+            }
+        }
+    }
+    // the transactions of the same function are resolved by several threads at the same time,
+    // the configs they read from the table are the same
+    auto config = getParallelConfig(context, contractAddress, selector, origin);
+    if (config)
+    {
+        config = parseCriticalConfig(config);
+    }
+    WriteGuard l(x_criticalConfigs);
+    m_criticalConfigs[contractAddress][selector] = config;
+    return config;
+}
+
+ParallelConfig::Ptr ParallelConfigPrecompiled::parseCriticalConfig(ParallelConfig::Ptr config)
+{
+    dev::eth::abi::ABIFunc af;
+    bool isOk = af.parser(config->functionName);
+    if (!isOk)
+    {
+        PRECOMPILED_LOG(DEBUG) << LOG_BADGE("PARA")
+                               << LOG_DESC("parser function signature failed")
+                               << LOG_KV("func signature", config->functionName);
+        return nullptr;
+    }
+
+    auto paramTypes = af.getParamsType();
+    if (paramTypes.size() < (size_t)config->criticalSize)
+    {
+        PRECOMPILED_LOG(DEBUG) << LOG_BADGE("PARA")
+                               << LOG_DESC("params type less than criticalSize")
+                               << LOG_KV("func signature", config->functionName)
+                               << LOG_KV("func criticalSize", config->criticalSize);
+        return nullptr;
     }
+    paramTypes.resize((size_t)config->criticalSize);
+    config->criticalTypes = std::move(paramTypes);
+    return config;
 }
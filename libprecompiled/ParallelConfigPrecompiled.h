@@ -24,7 +24,9 @@
 #include <libethcore/ABI.h>
 
 #include <libdevcore/Common.h>
+#include <libdevcore/Guards.h>
 #include <libethcore/Common.h>
+#include <unordered_map>
 
 namespace dev
 {
@@ -40,6 +42,8 @@ struct ParallelConfig
     typedef std::shared_ptr<ParallelConfig> Ptr;
     std::string functionName;
     u256 criticalSize;
+    // the ABI types of the first criticalSize params, only set by getCriticalConfig
+    std::vector<std::string> criticalTypes;
 };
 
 const std::string PARA_CONFIG_TABLE_PREFIX = "_contract_parafunc_";
@@ -71,6 +75,20 @@ public:
     /// get paralllel config, return nullptr if not found
     ParallelConfig::Ptr getParallelConfig(dev::blockverifier::ExecutiveContext::Ptr context,
         Address const& contractAddress, uint32_t selector, Address const& origin);
+
+    /// get paralllel config with the parsed criticalTypes, return nullptr if not found or the
+    /// critical params can not be decoded, the results are cached until the functions of the
+    /// contract are registered or unregistered
+    ParallelConfig::Ptr getCriticalConfig(dev::blockverifier::ExecutiveContext::Ptr context,
+        Address const& contractAddress, uint32_t selector, Address const& origin);
+
+private:
+    ParallelConfig::Ptr parseCriticalConfig(ParallelConfig::Ptr config);
+
+    // the precompiled is created for every block, so are the cached configs
+    SharedMutex x_criticalConfigs;
+    std::unordered_map<Address, std::unordered_map<uint32_t, ParallelConfig::Ptr>>
+        m_criticalConfigs;
 };
 
 }  // namespace precompiled
@@ -56,6 +56,9 @@ public:
     {
         return std::vector<std::string>();
     }
+    // the table whose keys are the parallel tags, rows of the tags are prefetched before
+    // the block is executed, empty means the tags are not table keys
+    virtual std::string getParallelTagTable() { return ""; }
 
     virtual uint32_t getParamFunc(bytesConstRef _param)
     {
@@ -32,6 +32,7 @@
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
 #include <boost/throw_exception.hpp>
+#include <set>
 
 
 using namespace dev;
@@ -42,11 +43,13 @@ using namespace dev::precompiled;
 
 const char* const TABLE_METHOD_OPT_STR = "openTable(string)";
 const char* const TABLE_METHOD_CRT_STR_STR = "createTable(string,string,string)";
+const char* const TABLE_METHOD_CRT_STR_STR4 = "createTable(string,string,string,string)";
 
 TableFactoryPrecompiled::TableFactoryPrecompiled()
 {
     name2Selector[TABLE_METHOD_OPT_STR] = getFuncSelector(TABLE_METHOD_OPT_STR);
     name2Selector[TABLE_METHOD_CRT_STR_STR] = getFuncSelector(TABLE_METHOD_CRT_STR_STR);
+    name2Selector[TABLE_METHOD_CRT_STR_STR4] = getFuncSelector(TABLE_METHOD_CRT_STR_STR4);
 }
 
 std::string TableFactoryPrecompiled::toString()
@@ -91,8 +94,10 @@ PrecompiledExecResult::Ptr TableFactoryPrecompiled::call(ExecutiveContext::Ptr c
         }
         callResult->setExecResult(abi.abiIn("", address));
     }
-    else if (func == name2Selector[TABLE_METHOD_CRT_STR_STR])
-    {  // createTable(string,string,string)
+    else if (func == name2Selector[TABLE_METHOD_CRT_STR_STR] ||
+             (func == name2Selector[TABLE_METHOD_CRT_STR_STR4] &&
+                 g_BCOSConfig.version() >= V2_4_0))
+    {  // createTable(string,string,string) or createTable(string,string,string,string)
         if (g_BCOSConfig.version() >= V2_3_0 && !checkAuthority(context, origin, sender))
         {
             PRECOMPILED_LOG(ERROR)
@@ -104,9 +109,18 @@ PrecompiledExecResult::Ptr TableFactoryPrecompiled::call(ExecutiveContext::Ptr c
         string tableName;
         string keyField;
         string valueFiled;
-        abi.abiOut(data, tableName, keyField, valueFiled);
+        string indexField;
+        if (func == name2Selector[TABLE_METHOD_CRT_STR_STR])
+        {
+            abi.abiOut(data, tableName, keyField, valueFiled);
+        }
+        else
+        {
+            abi.abiOut(data, tableName, keyField, valueFiled, indexField);
+        }
         PRECOMPILED_LOG(DEBUG) << LOG_BADGE("TableFactory") << LOG_KV("createTable", tableName)
-                               << LOG_KV("keyField", keyField) << LOG_KV("valueFiled", valueFiled);
+                               << LOG_KV("keyField", keyField) << LOG_KV("valueFiled", valueFiled)
+                               << LOG_KV("indexField", indexField);
         vector<string> fieldNameList;
         boost::split(fieldNameList, valueFiled, boost::is_any_of(","));
         boost::trim(keyField);
@@ -136,6 +150,7 @@ PrecompiledExecResult::Ptr TableFactoryPrecompiled::call(ExecutiveContext::Ptr c
                 std::string("total table field name length overflow ") +
                     std::to_string(SYS_TABLE_VALUE_FIELD_MAX_LENGTH)));
         }
+        indexField = checkIndexField(indexField, fieldNameList);
 
         tableName = precompiled::getTableName(tableName);
         if (tableName.size() > (size_t)USER_TABLE_NAME_MAX_LENGTH ||
@@ -156,8 +171,8 @@ PrecompiledExecResult::Ptr TableFactoryPrecompiled::call(ExecutiveContext::Ptr c
         }
         try
         {
-            auto table =
-                m_memoryTableFactory->createTable(tableName, keyField, valueFiled, true, origin);
+            auto table = m_memoryTableFactory->createIndexedTable(
+                tableName, keyField, valueFiled, indexField, true, origin);
             if (!table)
             {  // table already exist
                 result = CODE_TABLE_NAME_ALREADY_EXIST;
@@ -187,6 +202,34 @@ PrecompiledExecResult::Ptr TableFactoryPrecompiled::call(ExecutiveContext::Ptr c
     return callResult;
 }
 
+string TableFactoryPrecompiled::checkIndexField(
+    string const& _indexField, vector<string> const& _valueFieldList)
+{
+    if (_indexField.empty())
+    {
+        return _indexField;
+    }
+    vector<string> indexList;
+    boost::split(indexList, _indexField, boost::is_any_of(","));
+    set<string> indexSet;
+    for (auto& index : indexList)
+    {
+        boost::trim(index);
+        // only value fields are indexed, the key is scanned without an index
+        if (find(_valueFieldList.begin(), _valueFieldList.end(), index) == _valueFieldList.end())
+        {
+            BOOST_THROW_EXCEPTION(StorageException(
+                CODE_TABLE_INVALIDATE_FIELD, std::string("invalid index field:") + index));
+        }
+        if (!indexSet.insert(index).second)
+        {
+            BOOST_THROW_EXCEPTION(StorageException(
+                CODE_TABLE_DUMPLICATE_FIELD, std::string("duplicated index field:") + index));
+        }
+    }
+    return boost::join(indexList, ",");
+}
+
 h256 TableFactoryPrecompiled::hash()
 {
     return m_memoryTableFactory->hash();
@@ -34,11 +34,14 @@ namespace precompiled
 #if 0
 {
     "56004b6a": "createTable(string,string,string)",
+    "0a531dfd": "createTable(string,string,string,string)",
     "f23f63c9": "openTable(string)"
 }
 contract TableFactory {
     function openTable(string) public constant returns (Table);
     function createTable(string, string, string) public returns (int);
+    // the last parameter is the comma separated value fields of the secondary indices
+    function createTable(string, string, string, string) public returns (int);
 }
 #endif
 
@@ -68,6 +71,10 @@ public:
     h256 hash();
 
 private:
+    // trim and check the comma separated index fields, every index must be a value field
+    static std::string checkIndexField(
+        std::string const& _indexField, std::vector<std::string> const& _valueFieldList);
+
     std::shared_ptr<dev::storage::TableFactory> m_memoryTableFactory;
 };
 
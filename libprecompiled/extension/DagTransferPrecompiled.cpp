@@ -141,18 +141,19 @@ std::string DagTransferPrecompiled::toString()
     return "DagTransfer";
 }
 
-Table::Ptr DagTransferPrecompiled::openTable(
-    dev::blockverifier::ExecutiveContext::Ptr context, Address const& origin)
+std::string DagTransferPrecompiled::getParallelTagTable()
 {
-    string dagTableName;
     if (g_BCOSConfig.version() < V2_2_0)
     {
-        dagTableName = "_dag_transfer_";
-    }
-    else
-    {
-        dagTableName = precompiled::getTableName(DAG_TRANSFER);
+        return "_dag_transfer_";
     }
+    return precompiled::getTableName(DAG_TRANSFER);
+}
+
+Table::Ptr DagTransferPrecompiled::openTable(
+    dev::blockverifier::ExecutiveContext::Ptr context, Address const& origin)
+{
+    string dagTableName = getParallelTagTable();
     auto table = Precompiled::openTable(context, dagTableName);
     if (!table)
     {  //__dat_transfer__ is not exist, then create it first.
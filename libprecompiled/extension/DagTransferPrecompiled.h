@@ -51,6 +51,7 @@ public:
     // is this precompiled need parallel processing, default false.
     virtual bool isParallelPrecompiled() override { return true; }
     virtual std::vector<std::string> getParallelTag(bytesConstRef param) override;
+    virtual std::string getParallelTagTable() override;
 
 protected:
     std::shared_ptr<storage::Table> openTable(
@@ -73,7 +73,12 @@ std::shared_ptr<rocksdb::DB> BasicRocksDB::Open(const Options& options, const st
     ROCKSDB_LOG(INFO) << LOG_DESC("open rocksDB handler") << LOG_KV("path", dbname);
     boost::filesystem::create_directories(dbname);
     DB* db = nullptr;
-    auto status = DB::Open(options, dbname, &db);
+    auto dbOptions = options;
+    if (m_compactionFilter)
+    {
+        dbOptions.compaction_filter = m_compactionFilter.get();
+    }
+    auto status = DB::Open(dbOptions, dbname, &db);
     checkStatus(status, dbname);
     m_db.reset(db);
     return m_db;
@@ -93,6 +98,28 @@ Status BasicRocksDB::Get(ReadOptions const& options, std::string const& key, std
     return status;
 }
 
+std::vector<Status> BasicRocksDB::MultiGet(ReadOptions const& options,
+    std::vector<std::string> const& keys, std::vector<std::string>& values)
+{
+    assert(m_db);
+    std::vector<Slice> slices;
+    slices.reserve(keys.size());
+    for (auto const& key : keys)
+    {
+        slices.emplace_back(key);
+    }
+    auto statuses = m_db->MultiGet(options, slices, &values);
+    for (size_t i = 0; i < statuses.size(); ++i)
+    {
+        checkStatus(statuses[i]);
+        if (m_decryptHandler && !values[i].empty())
+        {
+            m_decryptHandler(values[i]);
+        }
+    }
+    return statuses;
+}
+
 Status BasicRocksDB::BatchPut(WriteBatch& batch, std::string const& key, std::string const& value)
 {
     auto status = batch.Put(Slice(std::move(key)), Slice(value));
@@ -173,3 +200,52 @@ Status BasicRocksDB::Write(WriteOptions const& options, WriteBatch& batch)
     checkStatus(status);
     return status;
 }
+
+std::shared_ptr<rocksdb::Iterator> BasicRocksDB::NewIterator(ReadOptions const& options)
+{
+    assert(m_db);
+    return std::shared_ptr<rocksdb::Iterator>(m_db->NewIterator(options));
+}
+
+Status BasicRocksDB::DeleteWithLock(
+    WriteBatch& batch, std::string const& key, tbb::spin_mutex& mutex)
+{
+    tbb::spin_mutex::scoped_lock lock(mutex);
+    auto status = batch.Delete(Slice(key));
+    checkStatus(status);
+    return status;
+}
+
+std::shared_ptr<const Snapshot> BasicRocksDB::GetSnapshot()
+{
+    assert(m_db);
+    auto db = m_db;
+    return std::shared_ptr<const Snapshot>(
+        db->GetSnapshot(), [db](const Snapshot* snapshot) { db->ReleaseSnapshot(snapshot); });
+}
+
+void BasicRocksDB::Scan(ReadOptions const& options, std::string const& begin,
+    std::string const& end, std::function<bool(std::string const&, std::string&)> const& onValue)
+{
+    auto it = NewIterator(options);
+    std::string key;
+    std::string value;
+    for (it->Seek(Slice(begin)); it->Valid(); it->Next())
+    {
+        key = it->key().ToString();
+        if (!end.empty() && key >= end)
+        {
+            break;
+        }
+        value = it->value().ToString();
+        if (m_decryptHandler && !value.empty())
+        {
+            m_decryptHandler(value);
+        }
+        if (!onValue(key, value))
+        {
+            break;
+        }
+    }
+    checkStatus(it->status());
+}
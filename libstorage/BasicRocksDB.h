@@ -22,13 +22,16 @@
 
 #pragma once
 #include <libdevcore/Common.h>
+#include <rocksdb/compaction_filter.h>
 #include <rocksdb/db.h>
 #include <rocksdb/options.h>
 #include <rocksdb/slice.h>
 #include <rocksdb/write_batch.h>
 #include <tbb/spin_mutex.h>
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #define ROCKSDB_LOG(LEVEL) LOG(LEVEL) << LOG_BADGE("ROCKSDB")
 #define DecHookFunction std::function<void(std::string&)>
@@ -56,6 +59,11 @@ public:
     virtual rocksdb::Status Get(
         rocksdb::ReadOptions const& options, std::string const& key, std::string& value);
 
+    // get values of multiple keys with one rocksdb::DB::MultiGet
+    // the statuses and values are in the same order as keys, and values are decrypted
+    virtual std::vector<rocksdb::Status> MultiGet(rocksdb::ReadOptions const& options,
+        std::vector<std::string> const& keys, std::vector<std::string>& values);
+
     // common Put interface, put the given (key, value) into batch
     virtual rocksdb::Status Put(
         rocksdb::WriteBatch& batch, std::string const& key, std::string& value);
@@ -65,9 +73,22 @@ public:
     virtual rocksdb::Status PutWithLock(rocksdb::WriteBatch& batch, std::string const& key,
         std::string const& value, tbb::spin_mutex& mutex);
 
+    // delete key in batch with lock
+    virtual rocksdb::Status DeleteWithLock(
+        rocksdb::WriteBatch& batch, std::string const& key, tbb::spin_mutex& mutex);
     virtual rocksdb::Status Write(
         rocksdb::WriteOptions const& options, rocksdb::WriteBatch& updates);
 
+    // iterate the raw key space, values returned by the iterator are not decrypted
+    virtual std::shared_ptr<rocksdb::Iterator> NewIterator(rocksdb::ReadOptions const& options);
+    // call onValue for keys in [begin, end) in order until it returns false, the empty end means
+    // no upper bound, values are decrypted
+    virtual void Scan(rocksdb::ReadOptions const& options, std::string const& begin,
+        std::string const& end,
+        std::function<bool(std::string const&, std::string&)> const& onValue);
+    // a consistent read view of the db, released when the returned pointer is destroyed
+    virtual std::shared_ptr<const rocksdb::Snapshot> GetSnapshot();
+
     virtual void setEncryptHandler(EncHookFunction const& encryptHandler)
     {
         m_encryptHandler = encryptHandler;
@@ -78,6 +99,12 @@ public:
         m_decryptHandler = decryptHandler;
     }
 
+    // applied when rocksdb compacts keys, must be set before Open, kept alive with the db
+    void setCompactionFilter(std::shared_ptr<rocksdb::CompactionFilter> compactionFilter)
+    {
+        m_compactionFilter = compactionFilter;
+    }
+
     void closeDB();
     void flush();
 
@@ -87,6 +114,7 @@ protected:
         rocksdb::WriteBatch& batch, std::string const& key, std::string const& value);
 
     std::shared_ptr<rocksdb::DB> m_db;
+    std::shared_ptr<rocksdb::CompactionFilter> m_compactionFilter;
     EncHookFunction m_encryptHandler = nullptr;
     DecHookFunction m_decryptHandler = nullptr;
 };
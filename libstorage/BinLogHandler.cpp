@@ -28,12 +28,73 @@
 #include <boost/algorithm/string/split.hpp>
 #include <boost/crc.hpp>
 #include <boost/filesystem.hpp>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace fs = boost::filesystem;
 
 using namespace dev;
 using namespace dev::storage;
 
+namespace
+{
+/// a read only mapping of a whole file, the data is empty if the file can not be mapped
+class MappedFile
+{
+public:
+    MappedFile(const std::string& path)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+        {
+            return;
+        }
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            auto data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED)
+            {
+                madvise(data, st.st_size, MADV_SEQUENTIAL);
+                m_data = bytesConstRef((const byte*)data, st.st_size);
+            }
+        }
+        close(fd);
+    }
+    ~MappedFile()
+    {
+        if (m_data.data())
+        {
+            munmap((void*)m_data.data(), m_data.size());
+        }
+    }
+    bytesConstRef data() const { return m_data; }
+
+private:
+    bytesConstRef m_data;
+};
+}  // namespace
+
+BinLogSyncPolicy dev::storage::binLogSyncPolicyFromString(const std::string& _policy)
+{
+    if (_policy == "none")
+    {
+        return BinLogSyncPolicy::None;
+    }
+    if (_policy == "block")
+    {
+        return BinLogSyncPolicy::PerBlock;
+    }
+    if (_policy == "group")
+    {
+        return BinLogSyncPolicy::Group;
+    }
+    BOOST_THROW_EXCEPTION(std::invalid_argument(
+        "Invalid binlog sync policy " + _policy + ", must be none, block or group"));
+}
+
 BinLogHandler::BinLogHandler(const std::string& path)
 {
     setBinLogStoragePath(path);
@@ -41,7 +102,16 @@ BinLogHandler::BinLogHandler(const std::string& path)
 
 BinLogHandler::~BinLogHandler()
 {
-    close(m_fd);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_signal.notify_all();
+    if (m_writer.joinable())
+    {
+        m_writer.join();
+    }
+    closeBinaryFile();
 }
 
 void BinLogHandler::setBinLogStoragePath(const std::string& path)
@@ -57,44 +127,206 @@ void BinLogHandler::setBinLogStoragePath(const std::string& path)
 
 bool BinLogHandler::writeBlocktoBinLog(int64_t num, const std::vector<TableData::Ptr>& datas)
 {
-    bytes buffer;
     auto start = utcTimeUs();
-    encodeBlock(num, datas, buffer);
-    auto end1 = utcTimeUs();
-    if (m_writtenBytesLength == 0 || m_writtenBytesLength + buffer.size() > m_binarylogSize)
-    {  // check if need to create a new file, in the case of first write or capacity limitation
-        if (m_writtenBytesLength > 0)
-        {  // close the file which has been opened
-            close(m_fd);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_writer.joinable())
+    {
+        m_writer = std::thread([this]() { writerLoop(); });
+    }
+    m_signal.wait(lock, [this]() { return m_failed || m_pending.size() < MAX_PENDING_BLOCKS; });
+    if (m_failed)
+    {
+        BINLOG_HANDLER_LOG(ERROR) << LOG_DESC("binlog writer failed") << LOG_KV("num", num);
+        return false;
+    }
+    auto seq = ++m_queuedSeq;
+    m_pending.push_back(PendingBlock{seq, num, datas});
+    m_signal.notify_all();
+    if (m_syncPolicy == BinLogSyncPolicy::PerBlock)
+    {
+        m_signal.wait(lock, [this, seq]() { return m_failed || m_syncedSeq >= seq; });
+    }
+    auto failed = m_failed;
+    auto pending = m_pending.size();
+    lock.unlock();
+    BINLOG_HANDLER_LOG(DEBUG) << LOG_DESC("queue block to binlog end") << LOG_KV("num", num)
+                              << LOG_KV("pending", pending) << LOG_KV("failed", failed)
+                              << LOG_KV("wait cost", utcTimeUs() - start);
+    return !failed;
+}
+
+bool BinLogHandler::flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_signal.wait(lock, [this]() { return m_failed || m_writtenSeq >= m_queuedSeq; });
+    return !m_failed;
+}
+
+void BinLogHandler::writerLoop()
+{
+    m_lastSync = std::chrono::steady_clock::now();
+    std::deque<PendingBlock> blocks;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            auto ready = [this]() { return m_stop || !m_pending.empty(); };
+            if (m_syncPolicy == BinLogSyncPolicy::Group && m_unsynced)
+            {  // wake up to sync the tail of the last batch even if no block comes
+                m_signal.wait_until(lock, m_lastSync + m_syncInterval, ready);
+            }
+            else
+            {
+                m_signal.wait(lock, ready);
+            }
+            if (m_pending.empty() && m_stop)
+            {
+                break;
+            }
+            blocks.swap(m_pending);
+            m_signal.notify_all();
         }
 
-        BINLOG_HANDLER_LOG(INFO) << LOG_DESC("try to open new binary file!")
-                                 << LOG_KV("file written length", m_writtenBytesLength)
-                                 << LOG_KV("buffer size", buffer.size());
-        // open binary file and write version
-        if (!initNewBinaryFile(num))
+        auto seq = blocks.empty() ? 0 : blocks.back().seq;
+        auto start = utcTimeUs();
+        bool success = blocks.empty() || writeBlocks(blocks);
+        auto end1 = utcTimeUs();
+        bool synced = false;
+        if (success && m_unsynced &&
+            (m_syncPolicy == BinLogSyncPolicy::PerBlock ||
+                (m_syncPolicy == BinLogSyncPolicy::Group &&
+                    std::chrono::steady_clock::now() >= m_lastSync + m_syncInterval)))
         {
-            return false;
+            success = syncBinaryFile();
+            synced = success;
+        }
+        if (!blocks.empty())
+        {
+            BINLOG_HANDLER_LOG(INFO)
+                << LOG_DESC("write blocks to binlog end") << LOG_KV("blocks", blocks.size())
+                << LOG_KV("last num", blocks.back().num) << LOG_KV("write cost", end1 - start)
+                << LOG_KV("sync cost", utcTimeUs() - end1)
+                << LOG_KV("binlog written size", m_writtenBytesLength);
+        }
+        blocks.clear();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!success)
+        {
+            BINLOG_HANDLER_LOG(FATAL) << LOG_DESC("binlog writer failed, stop writing");
+            m_failed = true;
+        }
+        if (seq > 0)
+        {
+            m_writtenSeq = seq;
+        }
+        if (synced || m_syncPolicy == BinLogSyncPolicy::None)
+        {
+            m_syncedSeq = m_writtenSeq;
+        }
+        m_signal.notify_all();
+        if (m_failed)
+        {
+            break;
+        }
+    }
+}
+
+bool BinLogHandler::writeBlocks(std::deque<PendingBlock>& blocks)
+{
+    // the buffer is reused across batches, every block is appended and written at once
+    auto& buffer = m_encodeBuffer;
+    buffer.clear();
+    for (auto const& block : blocks)
+    {
+        auto blockStart = buffer.size();
+        encodeBlock(block.num, block.datas, buffer);
+        if (m_writtenBytesLength == 0 || m_writtenBytesLength + buffer.size() > m_binarylogSize)
+        {  // check if need to create a new file, in the case of first write or capacity limitation
+            if (!writeBuffer(buffer.data(), blockStart))
+            {
+                return false;
+            }
+            buffer.erase(buffer.begin(), buffer.begin() + blockStart);
+            BINLOG_HANDLER_LOG(INFO) << LOG_DESC("try to open new binary file!")
+                                     << LOG_KV("file written length", m_writtenBytesLength)
+                                     << LOG_KV("buffer size", buffer.size());
+            closeBinaryFile();
+            // open binary file and write version
+            if (!initNewBinaryFile(block.num))
+            {
+                return false;
+            }
         }
     }
     // write block buffer, include block length, block buffer and CRC32
-    if (write(m_fd, (char*)&buffer[0], buffer.size()) == -1)
+    return writeBuffer(buffer.data(), buffer.size());
+}
+
+bool BinLogHandler::writeBuffer(const byte* data, size_t size)
+{
+    while (size > 0)
     {
-        BINLOG_HANDLER_LOG(ERROR) << LOG_DESC("write binary file fail!");
-        return false;
+        auto written = write(m_fd, data, size);
+        if (written == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            BINLOG_HANDLER_LOG(ERROR)
+                << LOG_DESC("write binary file fail!") << LOG_KV("errno", errno);
+            return false;
+        }
+        data += written;
+        size -= written;
+        m_writtenBytesLength += written;
+        m_unsynced = true;
     }
-    m_writtenBytesLength += buffer.size();
-    auto end2 = utcTimeUs();
-    BINLOG_HANDLER_LOG(INFO) << LOG_DESC("write block to binlog end")
-                             << LOG_KV("encode + CRC32 cost", end1 - start)
-                             << LOG_KV("write cost", end2 - end1)
-                             << LOG_KV("binlog written size", m_writtenBytesLength);
+    return true;
+}
 
+bool BinLogHandler::syncBinaryFile()
+{
+    m_lastSync = std::chrono::steady_clock::now();
+    m_unsynced = false;
+#ifdef __APPLE__
+    auto ret = fsync(m_fd);
+#else
+    auto ret = fdatasync(m_fd);
+#endif
+    if (ret == -1)
+    {
+        BINLOG_HANDLER_LOG(ERROR) << LOG_DESC("sync binary file fail!") << LOG_KV("errno", errno);
+        return false;
+    }
     return true;
 }
 
+void BinLogHandler::closeBinaryFile()
+{
+    if (m_fd == -1)
+    {
+        return;
+    }
+    if (m_unsynced && m_syncPolicy != BinLogSyncPolicy::None)
+    {
+        syncBinaryFile();
+    }
+    // release the preallocated space after the last block
+    if (ftruncate(m_fd, m_writtenBytesLength) == -1)
+    {
+        BINLOG_HANDLER_LOG(WARNING) << LOG_DESC("truncate binary file fail!")
+                                    << LOG_KV("errno", errno);
+    }
+    close(m_fd);
+    m_fd = -1;
+    m_writtenBytesLength = 0;
+}
+
 int64_t BinLogHandler::getLastBlockNum()
 {
+    flush();
     fs::path path(m_path);
     if (!fs::is_directory(path))
     {
@@ -179,6 +411,7 @@ std::shared_ptr<BlockDataMap> BinLogHandler::getMissingBlocksFromBinLog(
     {
         return binLogData;
     }
+    flush();
     fs::path path(m_path);
     if (fs::is_directory(path))
     {
@@ -230,7 +463,7 @@ std::shared_ptr<BlockDataMap> BinLogHandler::getMissingBlocksFromBinLog(
 bool BinLogHandler::initNewBinaryFile(int64_t num)
 {
     std::string filePath = m_path + std::to_string(num) + ".binlog";
-    m_fd = open(filePath.c_str(), O_CREAT | O_WRONLY, 0644);
+    m_fd = open(filePath.c_str(), O_CREAT | O_WRONLY | O_TRUNC, 0644);
     if (m_fd == -1)
     {
         BINLOG_HANDLER_LOG(ERROR) << LOG_DESC("open binary file fail!");
@@ -238,17 +471,20 @@ bool BinLogHandler::initNewBinaryFile(int64_t num)
     }
     BINLOG_HANDLER_LOG(INFO) << LOG_DESC("open binary file success!")
                              << LOG_KV("file path", filePath) << LOG_KV("fd", m_fd);
-
-    // write version
-    uint32_t version = htonl(BINLOG_VERSION);
-    if (write(m_fd, (char*)&version, sizeof(uint32_t)) == -1)
+#ifdef __linux__
+    // preallocate the whole segment without changing the file size, so appends and fdatasync do
+    // not allocate blocks, readers still see only the written length
+    if (fallocate(m_fd, FALLOC_FL_KEEP_SIZE, 0, m_binarylogSize) == -1)
     {
-        BINLOG_HANDLER_LOG(ERROR) << LOG_DESC("write binary file fail!");
-        return false;
+        BINLOG_HANDLER_LOG(WARNING) << LOG_DESC("preallocate binary file fail!")
+                                    << LOG_KV("errno", errno);
     }
-    m_writtenBytesLength = sizeof(uint32_t);
+#endif
 
-    return true;
+    // write version
+    m_writtenBytesLength = 0;
+    uint32_t version = htonl(BINLOG_VERSION);
+    return writeBuffer((const byte*)&version, sizeof(uint32_t));
 }
 
 void BinLogHandler::writeUINT32(bytes& buffer, uint32_t ui)
@@ -269,25 +505,24 @@ void BinLogHandler::writeString(bytes& buffer, const std::string& str)
     buffer.insert(buffer.end(), str.begin(), str.end());
 }
 
-uint32_t BinLogHandler::readUINT32(const bytes& buffer, uint32_t& offset)
+uint32_t BinLogHandler::readUINT32(bytesConstRef buffer, uint32_t& offset)
 {
-    uint32_t ui = ntohl(*((uint32_t*)&buffer[offset]));
+    uint32_t ui = ntohl(*((const uint32_t*)(buffer.data() + offset)));
     offset += 4;
     return ui;
 }
 
-uint64_t BinLogHandler::readUINT64(const bytes& buffer, uint32_t& offset)
+uint64_t BinLogHandler::readUINT64(bytesConstRef buffer, uint32_t& offset)
 {
-    uint64_t ui = NTOHLL(*((uint64_t*)&buffer[offset]));
+    uint64_t ui = NTOHLL(*((const uint64_t*)(buffer.data() + offset)));
     offset += 8;
     return ui;
 }
 
-void BinLogHandler::readString(const bytes& buffer, std::string& str, uint32_t& offset)
+void BinLogHandler::readString(bytesConstRef buffer, std::string& str, uint32_t& offset)
 {
     uint32_t strLen = readUINT32(buffer, offset);
-    std::string s((char*)&buffer[offset], strLen);
-    str = s;
+    str.assign((const char*)buffer.data() + offset, strLen);
     offset += strLen;
 }
 
@@ -352,6 +587,9 @@ void BinLogHandler::encodeBlock(
     int64_t num, const std::vector<TableData::Ptr>& datas, bytes& buffer)
 {
     auto start = utcTimeUs();
+    // placeholder of the length
+    auto blockStart = buffer.size();
+    writeUINT32(buffer, 0);
     // block heigth
     writeUINT64(buffer, num);
 
@@ -363,22 +601,23 @@ void BinLogHandler::encodeBlock(
     }
     auto end1 = utcTimeUs();
     // CRC32
+    auto dataStart = (char*)buffer.data() + blockStart + sizeof(uint32_t);
     boost::crc_32_type result;
-    result.process_block((char*)&buffer[0], (char*)&buffer[0] + buffer.size());
+    result.process_block(dataStart, (char*)buffer.data() + buffer.size());
     uint32_t crc32 = result.checksum();
     writeUINT32(buffer, crc32);
 
-    // insert length
-    uint32_t length = htonl(buffer.size());
-    buffer.insert(buffer.begin(), (byte*)&length, (byte*)&length + 4);
+    // fill the length
+    uint32_t length = htonl(buffer.size() - blockStart - sizeof(uint32_t));
+    memcpy(buffer.data() + blockStart, &length, sizeof(uint32_t));
     auto end2 = utcTimeUs();
     BINLOG_HANDLER_LOG(INFO) << LOG_DESC("encode block end") << LOG_KV("num", num)
-                             << LOG_KV("block binary data length", buffer.size())
+                             << LOG_KV("block binary data length", buffer.size() - blockStart)
                              << LOG_KV("CRC32", crc32) << LOG_KV("encode cost", end1 - start)
                              << LOG_KV("CRC32 cost", end2 - end1);
 }
 
-uint32_t BinLogHandler::decodeEntries(const bytes& buffer, uint32_t& offset,
+uint32_t BinLogHandler::decodeEntries(bytesConstRef buffer, uint32_t& offset,
     const std::vector<std::string>& vecField, Entries::Ptr entries)
 {
     uint32_t preOffset = offset;
@@ -388,7 +627,7 @@ uint32_t BinLogHandler::decodeEntries(const bytes& buffer, uint32_t& offset,
         Entry::Ptr entry = std::make_shared<Entry>();
         uint64_t id = readUINT64(buffer, offset);
         entry->setID(id);
-        uint8_t status = *((uint8_t*)&buffer[offset]);
+        uint8_t status = buffer[offset];
         offset++;
         entry->setStatus(status);
         /*BINLOG_HANDLER_LOG(TRACE) << LOG_DESC("entry info") << LOG_KV("idx in entries", idx)
@@ -409,14 +648,13 @@ uint32_t BinLogHandler::decodeEntries(const bytes& buffer, uint32_t& offset,
     return offset - preOffset;
 }
 
-uint32_t BinLogHandler::decodeTable(const bytes& buffer, uint32_t& offset, TableData::Ptr data)
+uint32_t BinLogHandler::decodeTable(bytesConstRef buffer, uint32_t& offset, TableData::Ptr data)
 {
     uint32_t preOffset = offset;
     // table name
-    uint8_t tableNameLen = *((uint8_t*)&buffer[offset]);
+    uint8_t tableNameLen = buffer[offset];
     offset++;
-    std::string s((char*)&buffer[offset], tableNameLen);
-    data->info->name = s;
+    data->info->name.assign((const char*)buffer.data() + offset, tableNameLen);
     offset += tableNameLen;
     // table key and fields
     std::string fields;
@@ -429,8 +667,8 @@ uint32_t BinLogHandler::decodeTable(const bytes& buffer, uint32_t& offset, Table
     return offset - preOffset;
 }
 
-DecodeBlockResult BinLogHandler::decodeBlock(const bytes& buffer, int64_t startNum, int64_t endNum,
-    int64_t& binLogNum, std::vector<TableData::Ptr>& datas)
+DecodeBlockResult BinLogHandler::decodeBlock(bytesConstRef buffer, int64_t startNum,
+    int64_t endNum, int64_t& binLogNum, std::vector<TableData::Ptr>& datas)
 {
     uint32_t offset = 0;
     binLogNum = readUINT64(buffer, offset);
@@ -501,39 +739,30 @@ bool BinLogHandler::getBinLogContext(BinLogContext& binlog)
 }
 
 bool BinLogHandler::getBlockData(
-    BinLogContext& binlog, int64_t startNum, int64_t endNum, BlockDataMap& blocksData)
+    bytesConstRef file, int64_t startNum, int64_t endNum, BlockDataMap& blocksData)
 {
-    while (binlog.offset < binlog.length)
+    size_t offset = sizeof(uint32_t);
+    while (offset < file.size())
     {
         // get block data length
-        uint32_t blockLen = 0;
-        uint32_t size =
-            binlog.file.read(reinterpret_cast<char*>(&blockLen), sizeof(uint32_t)).gcount();
-        if (size != sizeof(uint32_t))
+        if (offset + sizeof(uint32_t) > file.size())
         {
             BINLOG_HANDLER_LOG(ERROR) << LOG_DESC("read binLog error!");
             return false;
         }
-        blockLen = ntohl(blockLen);
-        BINLOG_HANDLER_LOG(INFO) << LOG_DESC("decode block") << LOG_KV("block index", binlog.offset)
+        uint32_t blockLen = ntohl(*((const uint32_t*)(file.data() + offset)));
+        BINLOG_HANDLER_LOG(INFO) << LOG_DESC("decode block") << LOG_KV("block index", offset)
                                  << LOG_KV("block data length", blockLen);
-        binlog.offset += sizeof(uint32_t);
-        if (binlog.offset + blockLen > binlog.length)
+        offset += sizeof(uint32_t);
+        if (offset + blockLen > file.size())
         {
             BINLOG_HANDLER_LOG(ERROR) << LOG_DESC("readBinLog, block data length error!");
             return false;
         }
 
-        // get block buffer, include CRC32
-        bytes buffer;
-        buffer.resize(blockLen);
-        size = binlog.file.read(reinterpret_cast<char*>(buffer.data()), buffer.size()).gcount();
-        if (size != buffer.size())
-        {
-            BINLOG_HANDLER_LOG(ERROR) << LOG_DESC("readBinLog, read error!");
-            return false;
-        }
-        binlog.offset += blockLen;
+        // block buffer include CRC32, decoded in place from the mapped file
+        auto buffer = file.cropped(offset, blockLen);
+        offset += blockLen;
         int64_t num;
         std::vector<TableData::Ptr> datas;
         DecodeBlockResult decodeRet = decodeBlock(buffer, startNum, endNum, num, datas);
@@ -556,18 +785,21 @@ bool BinLogHandler::getBlockData(
 bool BinLogHandler::readBinLog(
     const std::string& filePath, int64_t startNum, int64_t endNum, BlockDataMap& blocksData)
 {
-    BinLogContext binlog(filePath);
-    if (!binlog.file.is_open() || !getBinLogContext(binlog))
+    MappedFile binlog(filePath);
+    auto file = binlog.data();
+    if (file.size() < sizeof(BINLOG_VERSION))
     {
+        BINLOG_HANDLER_LOG(ERROR) << LOG_DESC("read binLog error!") << LOG_KV("path", filePath)
+                                  << LOG_KV("length", file.size());
         return false;
     }
-    BINLOG_HANDLER_LOG(INFO) << LOG_DESC("readBinLog start") << LOG_KV("file length", binlog.length)
-                             << LOG_KV("version", binlog.version)
-                             << LOG_KV("offset", binlog.offset);
+    uint32_t version = ntohl(*((const uint32_t*)file.data()));
+    BINLOG_HANDLER_LOG(INFO) << LOG_DESC("readBinLog start") << LOG_KV("file length", file.size())
+                             << LOG_KV("version", version);
     bool ret = false;
-    if (binlog.version == BINLOG_VERSION)
+    if (version == BINLOG_VERSION)
     {
-        ret = getBlockData(binlog, startNum, endNum, blocksData);
+        ret = getBlockData(file, startNum, endNum, blocksData);
     }
     return ret;
 }
@@ -23,7 +23,12 @@
 #include "Common.h"
 #include "Table.h"
 #include <boost/asio.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <mutex>
+#include <thread>
 
 namespace dev
 {
@@ -50,6 +55,19 @@ enum DecodeBlockResult
     BlockDataLengthError = 3,       // decode block fail because of invalid block data length
 };
 
+/// when the binlog is flushed to disk, blocks are always written by the background writer in
+/// commit order, with None or Group a block still queued in memory is lost if the process
+/// crashes, so they are opt-in and PerBlock is the default
+enum class BinLogSyncPolicy
+{
+    None,      // never fsync, writeBlocktoBinLog returns once the block is queued
+    PerBlock,  // writeBlocktoBinLog returns after the block is written and fsynced, the default
+    Group,     // fsync at most once every sync interval, writeBlocktoBinLog does not wait
+};
+
+/// parse "none", "block" or "group", throw std::invalid_argument for others
+BinLogSyncPolicy binLogSyncPolicyFromString(const std::string& _policy);
+
 struct BinLogContext
 {
     BinLogContext(const std::string& path) : version(0), length(0), offset(0)
@@ -78,7 +96,8 @@ public:
     /// set the path of binlog storage
     void setBinLogStoragePath(const std::string& path);
 
-    /// write block data to binlog before commit data in cachedStorage
+    /// write block data to binlog before commit data in cachedStorage, the block is encoded and
+    /// written by the background writer, so datas must not be modified after this call
     /// @return true : write binlog successfully
     /// @return false : something went wrong in the writing process
     bool writeBlocktoBinLog(int64_t num, const std::vector<TableData::Ptr>& datas);
@@ -91,7 +110,33 @@ public:
 
     void setBinaryLogSize(uint64_t _binarylogSize) { m_binarylogSize = _binarylogSize; }
 
+    /// set the fsync policy, _syncInterval(ms) is only used by BinLogSyncPolicy::Group
+    void setSyncPolicy(BinLogSyncPolicy _policy, uint64_t _syncInterval = 100)
+    {
+        m_syncPolicy = _policy;
+        m_syncInterval = std::chrono::milliseconds(_syncInterval);
+    }
+
+    /// wait until all queued blocks are written to the binlog file
+    /// @return false : the background writer failed
+    bool flush();
+
 private:
+    struct PendingBlock
+    {
+        uint64_t seq;
+        int64_t num;
+        std::vector<TableData::Ptr> datas;
+    };
+
+    /// the background writer, drains m_pending and writes every batch with one write call
+    void writerLoop();
+    /// encode and write a batch of blocks, rotate the binlog file if needed
+    bool writeBlocks(std::deque<PendingBlock>& blocks);
+    bool writeBuffer(const byte* data, size_t size);
+    bool syncBinaryFile();
+    /// sync if needed, release the preallocated space and close the file being written
+    void closeBinaryFile();
     /// open binary file and write version
     bool initNewBinaryFile(int64_t num);
 
@@ -105,16 +150,17 @@ private:
     /// @param buffer : [in] data buffer
     /// @param offset : [in/out] data offset in buffer, will be increased after read
     /// @return : data need to read
-    uint32_t readUINT32(const bytes& buffer, uint32_t& offset);
-    uint64_t readUINT64(const bytes& buffer, uint32_t& offset);
+    uint32_t readUINT32(bytesConstRef buffer, uint32_t& offset);
+    uint64_t readUINT64(bytesConstRef buffer, uint32_t& offset);
     /// readString
     /// @param buffer : [in] data buffer
     /// @param str : [out] data need to read
     /// @param offset : [in/out] data offset in buffer, will be increased after read
-    void readString(const bytes& buffer, std::string& str, uint32_t& offset);
+    void readString(bytesConstRef buffer, std::string& str, uint32_t& offset);
     void encodeEntries(
         const std::vector<std::string>& vecField, Entries::Ptr entries, bytes& buffer);
     void encodeTable(TableData::Ptr table, bytes& buffer);
+    /// append the block, include block length, block data and CRC32, to the end of buffer
     void encodeBlock(int64_t num, const std::vector<TableData::Ptr>& datas, bytes& buffer);
 
     /// decodeEntries/decodeTable
@@ -122,18 +168,20 @@ private:
     /// @param offset : [in/out] data offset in buffer, will be increased after read
     /// @param entries/table : [out] data read
     /// @return : buffer length read
-    uint32_t decodeEntries(const bytes& buffer, uint32_t& offset,
+    uint32_t decodeEntries(bytesConstRef buffer, uint32_t& offset,
         const std::vector<std::string>& vecField, Entries::Ptr entries);
-    uint32_t decodeTable(const bytes& buffer, uint32_t& offset, TableData::Ptr table);
+    uint32_t decodeTable(bytesConstRef buffer, uint32_t& offset, TableData::Ptr table);
     /// decodeBlock, block num in (startNum,endNum]
     /// @param buffer : [in] data buffer in a block
     /// @param num & datas : [out] tabledata in block num
-    DecodeBlockResult decodeBlock(const bytes& buffer, int64_t startNum, int64_t endNum,
+    DecodeBlockResult decodeBlock(bytesConstRef buffer, int64_t startNum, int64_t endNum,
         int64_t& binLogNum, std::vector<TableData::Ptr>& datas);
     bool getBinLogContext(BinLogContext& binlog);
+    /// decode blocks in (startNum,endNum] from the mapped binlog file, skip the version
     bool getBlockData(
-        BinLogContext& binlog, int64_t startNum, int64_t endNum, BlockDataMap& blocksData);
+        bytesConstRef file, int64_t startNum, int64_t endNum, BlockDataMap& blocksData);
     /// convert "filePath" contents to "blocksData" records with block height less than "currentNum"
+    /// the file is read through mmap
     bool readBinLog(
         const std::string& filePath, int64_t startNum, int64_t endNum, BlockDataMap& blocksData);
     /// getFirstBlockNumInBinLog
@@ -145,9 +193,28 @@ private:
     void checkBinLogSize();
 
     uint32_t m_writtenBytesLength = 0;  // length already written
-    int m_fd;                           // the file being written
+    int m_fd = -1;                      // the file being written
     std::string m_path;                 // storage path of binlog
 
+    BinLogSyncPolicy m_syncPolicy = BinLogSyncPolicy::PerBlock;
+    std::chrono::milliseconds m_syncInterval = std::chrono::milliseconds(100);
+    std::chrono::steady_clock::time_point m_lastSync;
+    bool m_unsynced = false;  // written but not fsynced, only accessed by the writer
+    bytes m_encodeBuffer;     // only accessed by the writer
+
+    /// committers append to m_pending while the writer encodes and writes the batch it swapped
+    /// out, so encoding and disk io never run on the commit path
+    std::mutex m_mutex;
+    std::condition_variable m_signal;
+    std::deque<PendingBlock> m_pending;
+    uint64_t m_queuedSeq = 0;   // seq of the last queued block
+    uint64_t m_writtenSeq = 0;  // seq of the last block written to the file
+    uint64_t m_syncedSeq = 0;   // seq of the last block fsynced
+    bool m_failed = false;
+    bool m_stop = false;
+    std::thread m_writer;
+    const size_t MAX_PENDING_BLOCKS = 16;  // committers wait when the writer falls this far behind
+
     uint32_t m_binarylogSize = 128 * 1024 * 1024;  // the max size of binlog file
     const uint32_t BINLOG_VERSION = 1;             // binlog version
 };
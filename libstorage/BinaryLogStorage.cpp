@@ -48,13 +48,96 @@ Entries::Ptr BinaryLogStorage::select(
     return nullptr;
 }
 
+std::vector<Entries::Ptr> BinaryLogStorage::selectBatch(int64_t num, const TableKeys& keys)
+{
+    if (m_backend)
+    {
+        return m_backend->selectBatch(num, keys);
+    }
+    STORAGE_LOG(FATAL) << "No backend storage, go die!";
+    BOOST_THROW_EXCEPTION(StorageException(-1, std::string("There is not a backend storage!")));
+    return std::vector<Entries::Ptr>();
+}
+
+Entries::Ptr BinaryLogStorage::scan(int64_t num, TableInfo::Ptr tableInfo, const KeyRange& range,
+    Condition::Ptr condition, size_t limit)
+{
+    if (m_backend)
+    {
+        return m_backend->scan(num, tableInfo, range, condition, limit);
+    }
+    STORAGE_LOG(FATAL) << "No backend storage, go die!";
+    BOOST_THROW_EXCEPTION(StorageException(-1, std::string("There is not a backend storage!")));
+    return Entries::Ptr();
+}
+
+void BinaryLogStorage::prefetch(int64_t num, const TableKeys& keys)
+{
+    if (m_backend)
+    {
+        m_backend->prefetch(num, keys);
+    }
+}
+
+bool BinaryLogStorage::deferCommit(int64_t num)
+{
+    if (!m_backend || !m_backend->deferCommit(num))
+    {
+        return false;
+    }
+    m_deferredNum = num;
+    m_deferredDatas.reset();
+    return true;
+}
+
+void BinaryLogStorage::cancelDefer(int64_t num)
+{
+    if (m_deferredNum == num)
+    {
+        auto deferredDatas = m_deferredDatas;
+        m_deferredNum = -1;
+        m_deferredDatas.reset();
+        // the backend persists the first part alone, so it is logged alone
+        if (m_binaryLogger && deferredDatas &&
+            !m_binaryLogger->writeBlocktoBinLog(num, *deferredDatas))
+        {
+            STORAGE_LOG(FATAL) << LOG_DESC("BinLog writeBlocktoBinLog failed");
+            BOOST_THROW_EXCEPTION(StorageException(-1, std::string("writeBlocktoBinLog failed!")));
+        }
+    }
+    if (m_backend)
+    {
+        m_backend->cancelDefer(num);
+    }
+}
+
 size_t BinaryLogStorage::commit(int64_t num, const std::vector<TableData::Ptr>& datas)
 {
     STORAGE_LOG(INFO) << "BinaryLogStorage commit: " << datas.size() << " num: " << num;
 
-    if (m_binaryLogger)
+    auto binLogDatas = &datas;
+    if (m_deferredNum == num)
+    {
+        if (!m_deferredDatas)
+        {
+            m_deferredDatas = std::make_shared<std::vector<TableData::Ptr>>(datas);
+            binLogDatas = nullptr;
+        }
+        else
+        {
+            m_deferredDatas->insert(m_deferredDatas->end(), datas.begin(), datas.end());
+            binLogDatas = m_deferredDatas.get();
+            m_deferredNum = -1;
+        }
+    }
+
+    if (m_binaryLogger && !binLogDatas)
+    {
+        STORAGE_LOG(DEBUG) << LOG_DESC("BinLog wait for the second part") << LOG_KV("num", num);
+    }
+    else if (m_binaryLogger)
     {
-        if (!m_binaryLogger->writeBlocktoBinLog(num, datas))
+        if (!m_binaryLogger->writeBlocktoBinLog(num, *binLogDatas))
         {
             STORAGE_LOG(FATAL) << LOG_DESC("BinLog writeBlocktoBinLog failed");
             BOOST_THROW_EXCEPTION(StorageException(-1, std::string("writeBlocktoBinLog failed!")));
@@ -65,6 +148,10 @@ size_t BinaryLogStorage::commit(int64_t num, const std::vector<TableData::Ptr>&
     {
         STORAGE_LOG(TRACE) << LOG_DESC("BinLog is off");
     }
+    if (binLogDatas == m_deferredDatas.get())
+    {
+        m_deferredDatas.reset();
+    }
 
     if (m_backend)
     {
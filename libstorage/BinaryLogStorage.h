@@ -40,6 +40,13 @@ public:
         Condition::Ptr condition = nullptr) override;
 
     size_t commit(int64_t num, const std::vector<TableData::Ptr>& datas) override;
+    std::vector<Entries::Ptr> selectBatch(int64_t num, const TableKeys& keys) override;
+    void prefetch(int64_t num, const TableKeys& keys) override;
+    Entries::Ptr scan(int64_t num, TableInfo::Ptr tableInfo, const KeyRange& range,
+        Condition::Ptr condition, size_t limit = 0) override;
+    // the binlog of a deferred block is written once, when its second part is committed
+    bool deferCommit(int64_t num) override;
+    void cancelDefer(int64_t num) override;
 
     void setBackend(Storage::Ptr backend) { m_backend = backend; }
     virtual void setBinaryLogger(std::shared_ptr<BinLogHandler> _logger)
@@ -51,6 +58,8 @@ public:
 private:
     Storage::Ptr m_backend;
     std::shared_ptr<BinLogHandler> m_binaryLogger = nullptr;
+    int64_t m_deferredNum = -1;
+    std::shared_ptr<std::vector<TableData::Ptr>> m_deferredDatas;
 };
 
 }  // namespace storage
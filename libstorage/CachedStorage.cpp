@@ -37,6 +37,7 @@ Cache::Cache()
 {
     m_entries = std::make_shared<Entries>();
     m_num.store(0);
+    m_referenced.store(true);
 }
 
 std::string Cache::key()
@@ -99,24 +100,145 @@ void Cache::setTableInfo(TableInfo::Ptr tableInfo)
     m_tableInfo = tableInfo;
 }
 
+bool Cache::referenced() const
+{
+    return m_referenced;
+}
+
+void Cache::setReferenced(bool referenced)
+{
+    m_referenced = referenced;
+}
+
+bool Cache::evicted() const
+{
+    return m_evicted;
+}
+
+void Cache::setEvicted(bool evicted)
+{
+    m_evicted = evicted;
+}
+
+CacheShard::CacheShard() : m_hand(m_clock.end())
+{
+    capacity.store(0);
+    queryTimes.store(0);
+    hitTimes.store(0);
+    evictTimes.store(0);
+}
+
+std::pair<Cache::Ptr, bool> CacheShard::insert(const std::string& cacheKey, Cache::Ptr cache)
+{
+    Mutex::scoped_lock lock(m_mutex);
+    auto it = m_caches.find(cacheKey);
+    if (it != m_caches.end())
+    {
+        return std::make_pair(it->second->second, false);
+    }
+
+    auto clockIt = m_clock.insert(m_hand, std::make_pair(cacheKey, cache));
+    m_caches.emplace(cacheKey, clockIt);
+    return std::make_pair(cache, true);
+}
+
+Cache::Ptr CacheShard::find(const std::string& cacheKey)
+{
+    Mutex::scoped_lock lock(m_mutex);
+    auto it = m_caches.find(cacheKey);
+    if (it != m_caches.end())
+    {
+        return it->second->second;
+    }
+    return nullptr;
+}
+
+size_t CacheShard::evict(int64_t maxCapacity, uint64_t syncNum, tbb::atomic<bool> const& running)
+{
+    Mutex::scoped_lock lock(m_mutex);
+
+    // every cache is passed at most twice, the first pass may only clear the reference bit
+    size_t scanned = 0;
+    size_t limit = m_clock.size() * 2;
+    while (capacity > maxCapacity && !m_clock.empty() && scanned < limit && running)
+    {
+        if (m_hand == m_clock.end())
+        {
+            m_hand = m_clock.begin();
+        }
+        ++scanned;
+
+        auto cache = m_hand->second;
+        if (cache->referenced())
+        {
+            cache->setReferenced(false);
+            ++m_hand;
+            continue;
+        }
+
+        // never wait for the cache lock here, the owner of the lock may be waiting for this shard
+        Cache::RWScoped cacheLock;
+        if (!cacheLock.try_acquire(*(cache->mutex()), true))
+        {
+            ++m_hand;
+            continue;
+        }
+        if (cache->num() > syncNum)
+        {  // not flushed to backend yet
+            ++m_hand;
+            continue;
+        }
+
+        int64_t totalCapacity = 0;
+        for (auto entryIt : *(cache->entries()))
+        {
+            totalCapacity += entryIt->capacity();
+        }
+        capacity.fetch_and_add(0 - totalCapacity);
+        ++evictTimes;
+
+        cache->setEmpty(true);
+        cache->setEvicted(true);
+        m_caches.erase(m_hand->first);
+        m_hand = m_clock.erase(m_hand);
+    }
+    return scanned;
+}
+
+void CacheShard::clear()
+{
+    Mutex::scoped_lock lock(m_mutex);
+    m_caches.clear();
+    m_clock.clear();
+    m_hand = m_clock.end();
+}
+
+size_t CacheShard::size()
+{
+    Mutex::scoped_lock lock(m_mutex);
+    return m_caches.size();
+}
+
+CacheShardStatus CacheShard::status()
+{
+    CacheShardStatus status;
+    status.size = size();
+    status.capacity = capacity;
+    status.queryTimes = queryTimes;
+    status.hitTimes = hitTimes;
+    status.evictTimes = evictTimes;
+    return status;
+}
+
 CachedStorage::CachedStorage(dev::GROUP_ID const& _groupID) : m_groupID(_groupID)
 {
     CACHED_STORAGE_LOG(INFO) << "Init flushStorage thread";
     m_taskThreadPool =
         std::make_shared<dev::ThreadPool>("taskPool-" + std::to_string(m_groupID), 1);
 
-    m_mruQueue =
-        std::make_shared<tbb::concurrent_queue<std::tuple<std::string, std::string, ssize_t>>>();
-    m_mru = std::make_shared<boost::multi_index_container<std::pair<std::string, std::string>,
-        boost::multi_index::indexed_by<boost::multi_index::sequenced<>,
-            boost::multi_index::hashed_unique<
-                boost::multi_index::identity<std::pair<std::string, std::string>>>>>>();
+    setShardCount(32);
     m_syncNum.store(0);
     m_commitNum.store(0);
-    m_capacity.store(0);
-
-    m_hitTimes.store(0);
-    m_queryTimes.store(0);
 
     m_running = std::make_shared<tbb::atomic<bool>>();
     m_running->store(true);
@@ -200,19 +322,155 @@ std::tuple<std::shared_ptr<Cache::RWScoped>, Cache::Ptr> CachedStorage::selectNo
             {
                 totalCapacity += it->capacity();
             }
-            touchMRU(tableInfo->name, key, totalCapacity);
+            updateCapacity(tableInfo->name, key, totalCapacity);
         }
         else
         {
             CACHED_STORAGE_LOG(FATAL) << "CachedStorage needs a backend storage.";
         }
     }
-    else
+
+    return std::make_tuple(std::get<0>(result), caches);
+}
+
+Entries::Ptr CachedStorage::scan(int64_t num, TableInfo::Ptr tableInfo, const KeyRange& range,
+    Condition::Ptr condition, size_t limit)
+{
+    if (!m_backend)
     {
-        touchMRU(tableInfo->name, key, 0);
+        CACHED_STORAGE_LOG(FATAL) << "CachedStorage needs a backend storage.";
+    }
+    if (!range.isSingle())
+    {
+        // rows of the range may only be in the caches, wait until they are committed to backend
+        std::unique_lock<Mutex> lock(x_syncNum);
+        m_syncSignal.wait(
+            lock, [this]() { return m_syncNum >= m_commitNum || !m_running->load(); });
+        lock.unlock();
+        return m_backend->scan(num, tableInfo, range, condition, limit);
     }
 
-    return std::make_tuple(std::get<0>(result), caches);
+    std::string field;
+    std::string value;
+    if (!tableInfo->enableCache)
+    {
+        return m_backend->scan(num, tableInfo, range, condition, limit);
+    }
+    if (findIndex(tableInfo, condition, field, value) &&
+        !shard(tableInfo->name, range.begin).find(tableInfo->name + "_" + range.begin))
+    {
+        // caches are evicted after they are committed, so the backend has the latest rows of the
+        // key, the cache is not filled with a partial result
+        return m_backend->scan(num, tableInfo, range, condition, limit);
+    }
+
+    auto out = std::make_shared<Entries>();
+    auto result = selectNoCondition(num, tableInfo, range.begin, condition);
+    Cache::Ptr caches = std::get<1>(result);
+    for (auto entry : *(caches->entries()))
+    {
+        if (limit > 0 && out->size() >= limit)
+        {
+            break;
+        }
+        if (condition && !condition->process(entry))
+        {
+            continue;
+        }
+        auto outEntry = std::make_shared<Entry>();
+        outEntry->copyFrom(entry);
+        out->addEntry(outEntry);
+    }
+    return out;
+}
+
+std::vector<Entries::Ptr> CachedStorage::selectBatch(int64_t num, const TableKeys& keys)
+{
+    prefetch(num, keys);
+
+    std::vector<Entries::Ptr> result;
+    result.reserve(keys.size());
+    for (auto const& key : keys)
+    {
+        result.push_back(select(num, key.first, key.second));
+    }
+    return result;
+}
+
+void CachedStorage::prefetch(int64_t num, const TableKeys& keys)
+{
+    if (!m_backend || disabled())
+    {
+        return;
+    }
+
+    // every key is prefetched once
+    std::map<std::string, size_t> sortedKeys;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        if (keys[i].first->enableCache)
+        {
+            sortedKeys.emplace(keys[i].first->name + "_" + keys[i].second, i);
+        }
+    }
+
+    size_t missed = 0;
+    auto it = sortedKeys.begin();
+    while (it != sortedKeys.end())
+    {
+        // no cache is locked while loading from backend, the backend may wait for the tbb workers
+        // which could be waiting for the locks of the caches
+        std::vector<Cache::Ptr> missedCaches;
+        TableKeys missedKeys;
+        for (size_t count = 0; it != sortedKeys.end() && count < m_prefetchBatchSize;
+             ++it, ++count)
+        {
+            auto const& key = keys[it->second];
+            auto cache = std::get<1>(touchCache(key.first, key.second, false));
+            if (cache->empty())
+            {
+                missedCaches.push_back(cache);
+                missedKeys.push_back(key);
+            }
+        }
+        if (missedKeys.empty())
+        {
+            continue;
+        }
+
+        auto backendData = m_backend->selectBatch(num, missedKeys);
+        if (backendData.size() != missedKeys.size())
+        {  // leave the caches empty, they will be loaded one by one when touched
+            CACHED_STORAGE_LOG(WARNING) << LOG_DESC("Prefetch from backend failed")
+                                        << LOG_KV("keys", missedKeys.size());
+            continue;
+        }
+        for (size_t i = 0; i < missedKeys.size(); ++i)
+        {
+            auto cache = missedCaches[i];
+            Cache::RWScoped lock(*(cache->mutex()), true);
+            // a cache is filled by loading from backend before it is written, so the cache still
+            // empty and in its shard is not changed since it was touched, otherwise the rows
+            // loaded may be stale and are dropped
+            if (!cache->empty() || cache->evicted())
+            {
+                continue;
+            }
+            cache->setEntries(backendData[i]);
+            cache->setEmpty(false);
+
+            size_t totalCapacity = 0;
+            for (auto entry : *backendData[i])
+            {
+                totalCapacity += entry->capacity();
+            }
+            updateCapacity(missedKeys[i].first->name, missedKeys[i].second, totalCapacity);
+        }
+        missed += missedKeys.size();
+    }
+
+    CACHED_STORAGE_LOG(DEBUG) << LOG_BADGE("Prefetch") << LOG_KV("num", num)
+                              << LOG_KV("keys", sortedKeys.size()) << LOG_KV("missed", missed);
 }
 
 size_t CachedStorage::commit(int64_t num, const std::vector<TableData::Ptr>& datas)
@@ -292,10 +550,9 @@ size_t CachedStorage::commit(int64_t num, const std::vector<TableData::Ptr>& dat
                                                 totalCapacity += it->capacity();
                                             }
 
-                                            touchMRU(requestData->info->name, key, totalCapacity);
+                                            updateCapacity(
+                                                requestData->info->name, key, totalCapacity);
                                         }
-
-                                        restoreCache(requestData->info, key, caches);
                                     }
 
                                     caches->setNum(num);
@@ -374,7 +631,7 @@ size_t CachedStorage::commit(int64_t num, const std::vector<TableData::Ptr>& dat
                                     }
                                 }
 
-                                touchMRU(requestData->info->name, key, change);
+                                updateCapacity(requestData->info->name, key, change);
                             }
                         });
                     tbb::parallel_for(tbb::blocked_range<size_t>(requestData->dirtyEntries->size(),
@@ -460,10 +717,8 @@ size_t CachedStorage::commit(int64_t num, const std::vector<TableData::Ptr>& dat
                         CACHED_STORAGE_LOG(TRACE) << "backend capacity: " << commitData->info->name
                                                   << "-" << key << ", capacity: " << totalCapacity;
 #endif
-                        touchMRU(commitData->info->name, key, totalCapacity);
+                        updateCapacity(commitData->info->name, key, totalCapacity);
                     }
-
-                    restoreCache(commitData->info, key, caches);
                 }
 
                 caches->entries()->addEntry(cacheEntry);
@@ -474,7 +729,7 @@ size_t CachedStorage::commit(int64_t num, const std::vector<TableData::Ptr>& dat
             STORAGE_LOG(TRACE) << "new cached: " << commitData->info->name << "-" << key
                                << ", capacity: " << cacheEntry->capacity();
 #endif
-            touchMRU(commitData->info->name, key, cacheEntry->capacity());
+            updateCapacity(commitData->info->name, key, cacheEntry->capacity());
         }
     }
 
@@ -486,63 +741,124 @@ size_t CachedStorage::commit(int64_t num, const std::vector<TableData::Ptr>& dat
         task->num = num;
         task->datas = commitDatas;
 
-        auto backend = m_backend;
-        auto self = std::weak_ptr<CachedStorage>(
-            std::dynamic_pointer_cast<CachedStorage>(shared_from_this()));
-
-        m_commitNum.store(num);
-
-        if (!disabled())
         {
-            m_taskThreadPool->enqueue([task, self]() {
-                auto storage = self.lock();
-                if (storage)
+            Guard l(m_commitMutex);
+            if (m_deferredNum == num)
+            {
+                if (!m_deferredTask)
                 {
-                    storage->commitBackend(task);
+                    CACHED_STORAGE_LOG(DEBUG) << "Hold the first part of block: " << num;
+                    m_deferredTask = task;
+                    m_commitNum.store(num);
+                    return total;
                 }
-            });
+                // the deferred parts write disjoint keys, so they can be merged directly
+                m_deferredTask->datas->insert(
+                    m_deferredTask->datas->end(), commitDatas->begin(), commitDatas->end());
+                task = m_deferredTask;
+                m_deferredTask.reset();
+                m_deferredNum = -1;
+            }
+        }
+        submitTask(task);
+    }
+    else
+    {
+        STORAGE_LOG(INFO) << "No backend storage, skip commit...";
 
-            STORAGE_LOG(INFO) << "Submited block task: " << num
-                              << ", current syncd block: " << m_syncNum;
+        setSyncNum(num);
+    }
+    return total;
+}
 
-            uint64_t waitCount = 0;
-            while (((size_t)(m_commitNum - m_syncNum) > m_maxForwardBlock) && m_running->load())
-            {
-                CACHED_STORAGE_LOG(INFO)
-                    << "Current block number: " << m_commitNum
-                    << " greater than syncd block number: " << m_syncNum << ", waiting...";
+void CachedStorage::submitTask(Task::Ptr task)
+{
+    auto num = task->num;
 
-                if (waitCount < 5)
-                {
-                    std::this_thread::yield();
-                }
-                else
-                {
-                    std::this_thread::sleep_for(
-                        std::chrono::milliseconds((waitCount < 100 ? waitCount : 100) * 50));
-                }
+    auto self = std::weak_ptr<CachedStorage>(
+        std::dynamic_pointer_cast<CachedStorage>(shared_from_this()));
+
+    m_commitNum.store(num);
 
-                ++waitCount;
+    if (!disabled())
+    {
+        m_taskThreadPool->enqueue([task, self]() {
+            auto storage = self.lock();
+            if (storage)
+            {
+                storage->commitBackend(task);
             }
-        }
-        else
+        });
+
+        STORAGE_LOG(INFO) << "Submited block task: " << num
+                          << ", current syncd block: " << m_syncNum;
+
+        uint64_t waitCount = 0;
+        while (((size_t)(m_commitNum - m_syncNum) > m_maxForwardBlock) && m_running->load())
         {
-            if (!commitBackend(task))
+            CACHED_STORAGE_LOG(INFO)
+                << "Current block number: " << m_commitNum
+                << " greater than syncd block number: " << m_syncNum << ", waiting...";
+
+            if (waitCount < 5)
             {
-                m_running->store(false);
-                m_taskThreadPool->stop();
-                raise(SIGTERM);
-                BOOST_THROW_EXCEPTION(StorageException(-1, std::string("backend DB dead!")));
+                std::this_thread::yield();
             }
+            else
+            {
+                std::this_thread::sleep_for(
+                    std::chrono::milliseconds((waitCount < 100 ? waitCount : 100) * 50));
+            }
+
+            ++waitCount;
         }
     }
     else
     {
-        STORAGE_LOG(INFO) << "No backend storage, skip commit...";
+        if (!commitBackend(task))
+        {
+            m_running->store(false);
+            notifySync();
+            m_taskThreadPool->stop();
+            raise(SIGTERM);
+            BOOST_THROW_EXCEPTION(StorageException(-1, std::string("backend DB dead!")));
+        }
+    }
+}
 
-        setSyncNum(num);
+bool CachedStorage::deferCommit(int64_t num)
+{
+    if (!m_backend || disabled())
+    {
+        return false;
+    }
+    Guard l(m_commitMutex);
+    if (m_deferredNum >= 0)
+    {
+        return false;
+    }
+    m_deferredNum = num;
+    return true;
+}
+
+void CachedStorage::cancelDefer(int64_t num)
+{
+    Task::Ptr task;
+    {
+        Guard l(m_commitMutex);
+        if (m_deferredNum != num)
+        {
+            return;
+        }
+        task = m_deferredTask;
+        m_deferredTask.reset();
+        m_deferredNum = -1;
+    }
+    if (task)
+    {
+        CACHED_STORAGE_LOG(WARNING) << "Submit the first part of block alone: " << num;
+        submitTask(task);
     }
-    return total;
 }
 
 void CachedStorage::setBackend(Storage::Ptr backend)
@@ -567,6 +883,7 @@ void CachedStorage::stop()
     }
     STORAGE_LOG(INFO) << "Stopping flushStorage thread";
     m_running->store(false);
+    notifySync();
     m_taskThreadPool->stop();
 
     if (m_clearThread)
@@ -586,9 +903,10 @@ void CachedStorage::stop()
 
 void CachedStorage::clear()
 {
-    RWMutexScoped lockCache(m_cachesMutex, true);
-
-    m_caches.clear();
+    for (auto& shard : m_shards)
+    {
+        shard->clear();
+    }
 }
 
 int64_t CachedStorage::syncNum()
@@ -598,7 +916,20 @@ int64_t CachedStorage::syncNum()
 
 void CachedStorage::setSyncNum(int64_t syncNum)
 {
-    m_syncNum.store(syncNum);
+    {
+        Guard l(x_syncNum);
+        m_syncNum.store(syncNum);
+    }
+    m_syncSignal.notify_all();
+}
+
+void CachedStorage::notifySync()
+{
+    {
+        // the waiters check m_running under the lock, so the wakeup is never lost
+        Guard l(x_syncNum);
+    }
+    m_syncSignal.notify_all();
 }
 
 void CachedStorage::setMaxCapacity(int64_t maxCapacity)
@@ -611,6 +942,33 @@ void CachedStorage::setMaxForwardBlock(size_t maxForwardBlock)
     m_maxForwardBlock = maxForwardBlock;
 }
 
+void CachedStorage::setShardCount(size_t shardCount)
+{
+    size_t count = 1;
+    while (count < shardCount)
+    {
+        count <<= 1;
+    }
+
+    m_shards.clear();
+    m_shards.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        m_shards.push_back(std::make_shared<CacheShard>());
+    }
+}
+
+std::vector<CacheShardStatus> CachedStorage::shardStatus()
+{
+    std::vector<CacheShardStatus> status;
+    status.reserve(m_shards.size());
+    for (auto& shard : m_shards)
+    {
+        status.push_back(shard->status());
+    }
+    return status;
+}
+
 void CachedStorage::startClearThread()
 {
     std::weak_ptr<CachedStorage> self(std::dynamic_pointer_cast<CachedStorage>(shared_from_this()));
@@ -634,112 +992,52 @@ void CachedStorage::startClearThread()
     });
 }
 
-void CachedStorage::touchMRU(const std::string& table, const std::string& key, ssize_t capacity)
+CacheShard& CachedStorage::shard(const std::string& table, const std::string& key)
 {
-    if (disabled())
-    {
-        return;
-    }
-
-    m_mruQueue->push(std::make_tuple(table, key, capacity));
-}
-
-void CachedStorage::updateMRU(const std::string& table, const std::string& key, ssize_t capacity)
-{
-    if (capacity != 0)
-    {
-        updateCapacity(capacity);
-    }
-
-    auto r = m_mru->push_back(std::make_pair(table, key));
-    if (!r.second)
-    {
-        m_mru->relocate(m_mru->end(), r.first);
-    }
+    // same as table + "_" + key, without building the cache key
+    std::hash<std::string> hasher;
+    size_t seed = hasher(table);
+    seed ^= hasher(key) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    return *m_shards[seed & (m_shards.size() - 1)];
 }
 
 std::tuple<std::shared_ptr<Cache::RWScoped>, Cache::Ptr, bool> CachedStorage::touchCache(
     TableInfo::Ptr tableInfo, const std::string& key, bool write)
 {
-    bool hit = true;
-
-    ++m_queryTimes;
+    auto& cacheShard = shard(tableInfo->name, key);
+    ++cacheShard.queryTimes;
 
-    auto cache = std::make_shared<Cache>();
     auto cacheKey = tableInfo->name + "_" + key;
-
-    bool inserted = false;
-    {
-        RWMutexScoped lockCache(m_cachesMutex, false);
-
-        auto result = m_caches.insert(std::make_pair(cacheKey, cache));
-
-        cache = result.first->second;
-        inserted = result.second;
-    }
-
-    auto cacheLock = std::make_shared<Cache::RWScoped>(*(cache->mutex()), write);
-    if (inserted)
+    bool hit = true;
+    while (true)
     {
-        hit = false;
-
+        auto cache = std::make_shared<Cache>();
         cache->setKey(key);
         cache->setTableInfo(tableInfo);
-    }
-    else
-    {
-        RWMutexScoped lockCache(m_cachesMutex, false);
 
-        auto result = m_caches.insert(std::make_pair(cacheKey, cache));
-        if (!result.second && cache != result.first->second)
+        auto result = cacheShard.insert(cacheKey, cache);
+        cache = result.first;
+        if (result.second)
         {
-            cache = result.first->second;
-            cacheLock.reset();
-            cacheLock = std::make_shared<Cache::RWScoped>(*(cache->mutex()), write);
+            hit = false;
         }
-    }
-
-    if (hit)
-    {
-        ++m_hitTimes;
-    }
-
-    return std::make_tuple(cacheLock, cache, true);
-}
-
-void CachedStorage::restoreCache(TableInfo::Ptr table, const std::string& key, Cache::Ptr cache)
-{
-    /*
-     If the checkAndClear() run ahead of commit() at same key, commit() may flush data to the
-     cache object which erased in m_caches, the data will lost, to avoid this, re-insert the
-     data into the m_caches
-     */
-
-    RWMutexScoped lockCache(m_cachesMutex, false);
-
-    auto cacheKey = table->name + "_" + key;
-    auto result = m_caches.insert(std::make_pair(cacheKey, cache));
-    if (!result.second && result.first->second != cache)
-    {
-        CACHED_STORAGE_LOG(FATAL) << "Restore cache fail! Cache not equal: " << cacheKey << " "
-                                  << result.first->second << " " << cache;
-
-        exit(1);
-    }
-}
 
-void CachedStorage::removeCache(const std::string& table, const std::string& key)
-{
-    auto cacheKey = table + "_" + key;
-    RWMutexScoped lockCache(m_cachesMutex, true);
-
-    auto c = m_caches.unsafe_erase(cacheKey);
-
-    if (c != 1)
-    {
-        CACHED_STORAGE_LOG(FATAL) << "Can not remove cache: " << table << "-" << key;
-
-        exit(1);
+        auto cacheLock = std::make_shared<Cache::RWScoped>(*(cache->mutex()), write);
+        /*
+         checkAndClear() may evict the cache before the lock is acquired, the data written to an
+         evicted cache will lost, so touch again to get the cache which is in the shard. Eviction
+         needs the write lock of the cache, the cache returned can not be evicted until the lock
+         is released.
+         */
+        if (!cache->evicted())
+        {
+            cache->setReferenced(true);
+            if (hit)
+            {
+                ++cacheShard.hitTimes;
+            }
+            return std::make_tuple(cacheLock, cache, true);
+        }
     }
 }
 
@@ -777,6 +1075,7 @@ bool CachedStorage::commitBackend(Task::Ptr task)
     catch (std::exception& e)
     {  // stop() commit thread to exit
         m_running->store(false);
+        notifySync();
         m_taskThreadPool->stop();
         raise(SIGTERM);
         STORAGE_LOG(ERROR) << "Stop commit thread. Fail to commit data: " << e.what();
@@ -787,117 +1086,92 @@ bool CachedStorage::commitBackend(Task::Ptr task)
 
 void CachedStorage::checkAndClear()
 {
-    uint64_t count = 0;
-    // calculate and calculate m_capacity with all elements of m_mruQueue
-    // since inner loop will break once m_mruQueue is empty, here use while(true)
-    while (true)
-    {
-        std::tuple<std::string, std::string, ssize_t> mru;
-        auto result = m_mruQueue->try_pop(mru);
-        if (!result)
-        {
-            break;
-        }
-        updateMRU(std::get<0>(mru), std::get<1>(mru), std::get<2>(mru));
-        ++count;
-    }
-
-    CACHED_STORAGE_LOG(DEBUG) << "CheckAndClear pop: " << count << " elements";
-
     TIME_RECORD("Check and clear");
 
-    bool needClear = false;
-    size_t clearTimes = 0;
-
-    auto currentCapacity = m_capacity.load();
+    auto currentCapacity = capacity();
+    if (m_syncNum == 0 || currentCapacity <= m_maxCapacity)
+    {
+        return;
+    }
 
-    size_t clearCount = 0;
-    size_t clearThrough = 0;
-    do
+    // every shard is evicted on its own, shards are cleared in parallel
+    auto maxShardCapacity = m_maxCapacity / (int64_t)m_shards.size();
+    auto syncNum = m_syncNum.load();
+    uint64_t lastEvictTimes = 0;
+    for (auto& shard : m_shards)
     {
-        needClear = false;
-        if (m_syncNum > 0)
-        {
-            if (m_capacity > m_maxCapacity && !m_mru->empty())
+        lastEvictTimes += shard->evictTimes;
+    }
+    tbb::atomic<size_t> clearThrough = 0;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_shards.size()),
+        [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i < range.end(); ++i)
             {
-                needClear = true;
+                clearThrough += m_shards[i]->evict(maxShardCapacity, syncNum, *m_running);
             }
-        }
-
-        if (needClear)
-        {
-            for (auto it = m_mru->begin(); it != m_mru->end() && m_running->load();)
-            {
-                if (m_capacity <= (int64_t)m_maxCapacity || m_mru->empty())
-                {
-                    break;
-                }
-
-                ++clearThrough;
-
-                auto tableInfo = std::make_shared<TableInfo>();
-                tableInfo->name = it->first;
+        });
 
-                auto result = touchCache(tableInfo, it->second, true);
-                auto cache = std::get<1>(result);
-                if (std::get<2>(result))
-                {  // FIXME: if always true, simplify this
-                    if (m_syncNum > 0 && (cache->num() <= m_syncNum))
-                    {
-                        int64_t totalCapacity = 0;
-                        for (auto entryIt : *(cache->entries()))
-                        {
-                            totalCapacity += entryIt->capacity();
-                        }
+    auto status = shardStatus();
+    size_t size = 0;
+    uint64_t queryTimes = 0;
+    uint64_t hitTimes = 0;
+    uint64_t evictTimes = 0;
+    for (auto const& it : status)
+    {
+        size += it.size;
+        queryTimes += it.queryTimes;
+        hitTimes += it.hitTimes;
+        evictTimes += it.evictTimes;
+    }
 
-                        ++clearCount;
-                        updateCapacity(0 - totalCapacity);
+    CACHED_STORAGE_LOG(INFO) << "Clear finished, total: " << evictTimes - lastEvictTimes
+                             << " entries, "
+                             << "through: " << clearThrough << " entries, "
+                             << readableCapacity(currentCapacity - capacity())
+                             << ", Current total entries: " << size
+                             << ", total capacaity: " << readableCapacity(capacity());
 
-                        cache->setEmpty(true);
-                        removeCache(it->first, it->second);
-                        it = m_mru->erase(it);
-                    }
-                    else
-                    {
-                        break;
-                    }
-                }
-                else
-                {
-                    ++it;
-                }
-            }
-            ++clearTimes;
-        }
-    } while (needClear && m_running->load());
-
-    if (clearThrough > 0)
+    std::stringstream shards;
+    for (size_t i = 0; i < status.size(); ++i)
     {
-        CACHED_STORAGE_LOG(INFO) << "Clear finished, total: " << clearCount << " entries, "
-                                 << "through: " << clearThrough << " entries, "
-                                 << readableCapacity(currentCapacity - m_capacity)
-                                 << ", Current total entries: " << m_caches.size()
-                                 << ", Current total mru entries: " << m_mru->size()
-                                 << ", total capacaity: " << readableCapacity(m_capacity);
+        shards << "Shard " << i << ": size " << status[i].size << ", capacity "
+               << readableCapacity(status[i].capacity) << ", hit " << status[i].hitTimes << "/"
+               << status[i].queryTimes << ", evict " << status[i].evictTimes << "\n";
+    }
+    CACHED_STORAGE_LOG(DEBUG)
+        << "Cache Status: \n\n"
+        << "\n---------------------------------------------------------------------\n"
+        << "Total query: " << queryTimes << "\n"
+        << "Total cache hit: " << hitTimes << "\n"
+        << "Total cache miss: " << queryTimes - hitTimes << "\n"
+        << "Total hit ratio: " << std::setiosflags(std::ios::fixed) << std::setprecision(4)
+        << ((double)hitTimes / queryTimes) * 100 << "%"
+        << "\n\n"
+        << "Cache capacity: " << readableCapacity(capacity()) << "\n"
+        << "Cache size: " << size << "\n\n"
+        << shards.str()
+        << "---------------------------------------------------------------------\n";
+}
 
-        CACHED_STORAGE_LOG(DEBUG)
-            << "Cache Status: \n\n"
-            << "\n---------------------------------------------------------------------\n"
-            << "Total query: " << m_queryTimes << "\n"
-            << "Total cache hit: " << m_hitTimes << "\n"
-            << "Total cache miss: " << m_queryTimes - m_hitTimes << "\n"
-            << "Total hit ratio: " << std::setiosflags(std::ios::fixed) << std::setprecision(4)
-            << ((double)m_hitTimes / m_queryTimes) * 100 << "%"
-            << "\n\n"
-            << "Cache capacity: " << readableCapacity(m_capacity) << "\n"
-            << "Cache size: " << m_mru->size()
-            << "\n---------------------------------------------------------------------\n";
+void CachedStorage::updateCapacity(
+    const std::string& table, const std::string& key, ssize_t capacity)
+{
+    if (disabled() || capacity == 0)
+    {
+        return;
     }
+
+    shard(table, key).capacity.fetch_and_add(capacity);
 }
 
-void CachedStorage::updateCapacity(ssize_t capacity)
+int64_t CachedStorage::capacity()
 {
-    m_capacity.fetch_and_add(capacity);
+    int64_t total = 0;
+    for (auto& shard : m_shards)
+    {
+        total += shard->capacity;
+    }
+    return total;
 }
 
 std::string CachedStorage::readableCapacity(size_t num)
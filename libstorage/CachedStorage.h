@@ -25,15 +25,13 @@
 #include "Table.h"
 #include <libdevcore/FixedHash.h>
 #include <libdevcore/ThreadPool.h>
-#include <tbb/concurrent_queue.h>
 #include <tbb/concurrent_unordered_map.h>
 #include <tbb/spin_mutex.h>
 #include <tbb/spin_rw_mutex.h>
-#include <boost/multi_index/hashed_index.hpp>
-#include <boost/multi_index/identity.hpp>
-#include <boost/multi_index/sequenced_index.hpp>
-#include <boost/multi_index_container.hpp>
+#include <condition_variable>
+#include <list>
 #include <mutex>
+#include <unordered_map>
 
 namespace dev
 {
@@ -63,12 +61,21 @@ public:
     virtual bool empty();
     virtual void setEmpty(bool empty);
 
+    // the reference bit of CLOCK, set on every touch and cleared by the clock hand
+    virtual bool referenced() const;
+    virtual void setReferenced(bool referenced);
+    // set with the write lock held when the cache is evicted from its shard
+    virtual bool evicted() const;
+    virtual void setEvicted(bool evicted);
+
 private:
     RWMutex m_mutex;
 
     TableInfo::Ptr m_tableInfo;
 
     bool m_empty = true;
+    bool m_evicted = false;
+    tbb::atomic<bool> m_referenced;
     std::string m_key;
     Entries::Ptr m_entries;
     // int64_t m_num;
@@ -84,6 +91,50 @@ public:
     std::shared_ptr<std::vector<TableData::Ptr> > datas;
 };
 
+struct CacheShardStatus
+{
+    size_t size = 0;
+    int64_t capacity = 0;
+    uint64_t queryTimes = 0;
+    uint64_t hitTimes = 0;
+    uint64_t evictTimes = 0;
+};
+
+// one shard of CachedStorage, caches of a shard are evicted by the CLOCK algorithm
+class CacheShard
+{
+public:
+    typedef std::shared_ptr<CacheShard> Ptr;
+    typedef tbb::spin_mutex Mutex;
+
+    CacheShard();
+
+    // return the cache of cacheKey, cache is inserted if cacheKey does not exist
+    std::pair<Cache::Ptr, bool> insert(const std::string& cacheKey, Cache::Ptr cache);
+    // return the cache of cacheKey, nullptr if cacheKey does not exist
+    Cache::Ptr find(const std::string& cacheKey);
+    // evict flushed caches until the capacity of this shard is not greater than maxCapacity,
+    // caches locked by others are skipped, return the number of caches scanned
+    size_t evict(int64_t maxCapacity, uint64_t syncNum, tbb::atomic<bool> const& running);
+    void clear();
+    size_t size();
+    CacheShardStatus status();
+
+    tbb::atomic<int64_t> capacity;
+    tbb::atomic<uint64_t> queryTimes;
+    tbb::atomic<uint64_t> hitTimes;
+    tbb::atomic<uint64_t> evictTimes;
+
+private:
+    typedef std::list<std::pair<std::string, Cache::Ptr> > Clock;
+
+    Mutex m_mutex;
+    std::unordered_map<std::string, Clock::iterator> m_caches;
+    // all caches of this shard in a ring, the new cache is inserted just behind the hand
+    Clock m_clock;
+    Clock::iterator m_hand;
+};
+
 class CachedStorage : public Storage
 {
 public:
@@ -106,6 +157,18 @@ public:
     size_t commit(int64_t num, const std::vector<TableData::Ptr>& datas) override;
     bool onlyCommitDirty() override { return true; }
 
+    std::vector<Entries::Ptr> selectBatch(int64_t num, const TableKeys& keys) override;
+    // load the missed keys from backend with selectBatch, hit keys are skipped
+    void prefetch(int64_t num, const TableKeys& keys) override;
+    // a single key is read from the cache if it is cached, otherwise the backend reads it with
+    // the index if it can, a range of keys is read from the backend after it has all blocks
+    Entries::Ptr scan(int64_t num, TableInfo::Ptr tableInfo, const KeyRange& range,
+        Condition::Ptr condition, size_t limit = 0) override;
+    // the backend task of the first commit(num) is held and submitted with the second one
+    bool deferCommit(int64_t num) override;
+    // the held task of block num is submitted alone
+    void cancelDefer(int64_t num) override;
+
     void setBackend(Storage::Ptr backend);
     void init();
     void stop() override;
@@ -117,6 +180,9 @@ public:
     void setClearInterval(int64_t clearInterval) { m_clearInterval = clearInterval; }
     void setMaxCapacity(int64_t maxCapacity);
     void setMaxForwardBlock(size_t maxForwardBlock);
+    // must be called before the storage is used, shardCount is rounded up to a power of 2
+    void setShardCount(size_t shardCount);
+    std::vector<CacheShardStatus> shardStatus();
 
     void startClearThread();
     dev::GROUP_ID groupID() const { return m_groupID; }
@@ -125,55 +191,51 @@ protected:
     dev::GROUP_ID m_groupID = 0;
 
 private:
-    void touchMRU(const std::string& table, const std::string& key, ssize_t capacity);
-    void updateMRU(const std::string& table, const std::string& key, ssize_t capacity);
+    CacheShard& shard(const std::string& table, const std::string& key);
     std::tuple<std::shared_ptr<Cache::RWScoped>, Cache::Ptr, bool> touchCache(
         TableInfo::Ptr table, const std::string& key, bool write = false);
-    void restoreCache(TableInfo::Ptr table, const std::string& key, Cache::Ptr cache);
-
-    void removeCache(const std::string& table, const std::string& key);
 
     bool disabled();
 
     bool commitBackend(Task::Ptr task);
+    // submit the task to the commit thread, and wait if the backend falls too far behind
+    void submitTask(Task::Ptr task);
+
+    // wake up the range scans waiting for the backend, after m_running is changed
+    void notifySync();
 
     void checkAndClear();
 
-    void updateCapacity(ssize_t capacity);
+    void updateCapacity(const std::string& table, const std::string& key, ssize_t capacity);
+    int64_t capacity();
     std::string readableCapacity(size_t num);
 
-    tbb::concurrent_unordered_map<std::string, Cache::Ptr> m_caches;
-    RWMutex m_cachesMutex;
+    std::vector<CacheShard::Ptr> m_shards;
 
     Mutex m_commitMutex;
+    // the block whose commit is split, and the held task of its first part
+    int64_t m_deferredNum = -1;
+    Task::Ptr m_deferredTask;
 
-    std::shared_ptr<boost::multi_index_container<std::pair<std::string, std::string>,
-        boost::multi_index::indexed_by<boost::multi_index::sequenced<>,
-            boost::multi_index::hashed_unique<
-                boost::multi_index::identity<std::pair<std::string, std::string> > > > > >
-        m_mru;
-    std::shared_ptr<tbb::concurrent_queue<std::tuple<std::string, std::string, ssize_t> > >
-        m_mruQueue;
-
-    // boost::multi_index
     Storage::Ptr m_backend;
 
 
     tbb::atomic<uint64_t> m_syncNum;
     tbb::atomic<uint64_t> m_commitNum;
-    tbb::atomic<int64_t> m_capacity;
+    // signaled when m_syncNum is updated, range scans wait on it for the commits in flight
+    Mutex x_syncNum;
+    std::condition_variable m_syncSignal;
 
     // config
     uint64_t m_maxForwardBlock = 10;
     int64_t m_maxCapacity = 256 * 1024 * 1024;  // default 256MB for cache
     uint64_t m_clearInterval = 1000;
+    // keys are locked and loaded from backend in batches of this size when prefetching
+    size_t m_prefetchBatchSize = 1024;
 
     dev::ThreadPool::Ptr m_taskThreadPool;
     std::shared_ptr<std::thread> m_clearThread;
 
-    tbb::atomic<uint64_t> m_hitTimes;
-    tbb::atomic<uint64_t> m_queryTimes;
-
     std::shared_ptr<tbb::atomic<bool> > m_running;
 };
 
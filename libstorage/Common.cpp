@@ -32,10 +32,9 @@ bool dev::storage::isHashField(const std::string& _key)
     {
         if (g_BCOSConfig.version() < RC3_VERSION)
         {
-            return ((_key.substr(0, 1) != "_" && _key.substr(_key.size() - 1, 1) != "_") ||
-                    (_key == STATUS));
+            return ((_key.front() != '_' && _key.back() != '_') || (_key == STATUS));
         }
-        return ((_key.substr(0, 1) != "_" && _key.substr(_key.size() - 1, 1) != "_"));
+        return (_key.front() != '_' && _key.back() != '_');
     }
     return false;
 }
@@ -28,6 +28,7 @@
 #include <libdevcore/FixedHash.h>
 #include <libdevcrypto/Hash.h>
 #include <libprecompiled/Common.h>
+#include <tbb/parallel_for.h>
 #include <tbb/parallel_sort.h>
 #include <boost/exception/diagnostic_information.hpp>
 #include <boost/lexical_cast.hpp>
@@ -41,6 +42,60 @@ using namespace dev;
 using namespace dev::storage;
 using namespace dev::precompiled;
 
+namespace
+{
+// append the hash fields and the status of an entry to the data to be hashed
+void appendHashData(bytes& _data, Entry::Ptr _entry)
+{
+    for (auto& fieldIt : *(_entry))
+    {
+        if (isHashField(fieldIt.first))
+        {
+            _data.insert(_data.end(), fieldIt.first.begin(), fieldIt.first.end());
+            _data.insert(_data.end(), fieldIt.second.begin(), fieldIt.second.end());
+        }
+    }
+    char status = (char)_entry->getStatus();
+    _data.insert(_data.end(), &status, &status + sizeof(status));
+}
+
+// sort entries in the order of EntryLessNoLock, the ID and key of every entry are read once
+// instead of locking the entry in every comparison
+void sortEntries(Entries::Ptr _entries, TableInfo::Ptr _tableInfo)
+{
+    struct SortKey
+    {
+        uint64_t id;
+        std::string key;
+        Entry::Ptr entry;
+    };
+    std::vector<SortKey> sortKeys;
+    sortKeys.reserve(_entries->size());
+    for (size_t i = 0; i < _entries->size(); ++i)
+    {
+        auto entry = (*_entries)[i];
+        sortKeys.push_back(SortKey{entry->getID(), entry->getField(_tableInfo->key), entry});
+    }
+    EntryLessNoLock less(_tableInfo);
+    tbb::parallel_sort(
+        sortKeys.begin(), sortKeys.end(), [&less](const SortKey& lhs, const SortKey& rhs) {
+            if (lhs.id != rhs.id)
+            {
+                return lhs.id < rhs.id;
+            }
+            if (lhs.key != rhs.key)
+            {
+                return lhs.key < rhs.key;
+            }
+            return less(lhs.entry, rhs.entry);
+        });
+    for (size_t i = 0; i < sortKeys.size(); ++i)
+    {
+        (*_entries)[i] = sortKeys[i].entry;
+    }
+}
+}  // namespace
+
 void prepareExit(const std::string& _key)
 {
     STORAGE_LOG(ERROR) << LOG_BADGE("MemoryTable2 prepare to exit") << LOG_KV("key", _key);
@@ -92,12 +147,19 @@ Entries::Ptr MemoryTable2::selectNoLock(const std::string& key, Condition::Ptr c
 {
     try
     {
-        auto entries = std::make_shared<Entries>();
+        auto entries = allocateShared<Entries>(m_arena);
         condition->EQ(m_tableInfo->key, key);
         if (m_remoteDB)
         {
-            // query remoteDB anyway
-            Entries::Ptr dbEntries = m_remoteDB->select(m_blockNum, m_tableInfo, key, condition);
+            // query remoteDB anyway, dirty entries replace db entries one by one and new entries
+            // are appended, so at most offset + count db entries are needed
+            size_t limit = 0;
+            if (condition->getOffset() >= 0 && condition->getCount() >= 0)
+            {
+                limit = (size_t)condition->getOffset() + (size_t)condition->getCount();
+            }
+            Entries::Ptr dbEntries =
+                m_remoteDB->scan(m_blockNum, m_tableInfo, KeyRange::single(key), condition, limit);
             if (!dbEntries)
             {
                 return entries;
@@ -128,7 +190,7 @@ Entries::Ptr MemoryTable2::selectNoLock(const std::string& key, Condition::Ptr c
         }
         if (condition->getOffset() >= 0 && condition->getCount() >= 0)
         {
-            Entries::Ptr resultEntries = std::make_shared<Entries>();
+            Entries::Ptr resultEntries = allocateShared<Entries>(m_arena);
             proccessLimit(condition, entries, resultEntries);
             return resultEntries;
         }
@@ -162,34 +224,7 @@ int MemoryTable2::update(
         checkField(entry);
 
         auto entries = selectNoLock(key, condition);
-        std::vector<Change::Record> records;
-
-        for (size_t i = 0; i < entries->size(); ++i)
-        {
-            Entry::Ptr updateEntry = entries->get(i);
-
-            // if id not equals to zero and not in the m_dirty, must be new dirty entry
-            if (updateEntry->getID() != 0 && m_dirty.find(updateEntry->getID()) == m_dirty.end())
-            {
-                m_dirty.insert(std::make_pair(updateEntry->getID(), updateEntry));
-            }
-
-            for (auto& it : *(entry))
-            {
-                // _id_ always got initialized value 0 from Entry::Entry()
-                // no need to update _id_ while updating entry
-                if (it.first != ID_FIELD && it.first != m_tableInfo->key)
-                {
-                    records.emplace_back(updateEntry->getTempIndex(), it.first,
-                        updateEntry->getField(it.first), updateEntry->getID());
-                    updateEntry->setField(it.first, it.second);
-                }
-            }
-        }
-
-        m_recorder(shared_from_this(), Change::Update, key, records);
-
-        m_isDirty = true;
+        updateEntries(key, entry, entries);
         return entries->size();
     }
     catch (std::invalid_argument& e)
@@ -256,6 +291,44 @@ int MemoryTable2::insert(const std::string& key, Entry::Ptr entry, AccessOptions
     return 0;
 }
 
+int MemoryTable2::upsert(const std::string& key, Entry::Ptr entry, AccessOptions::Ptr options)
+{
+    try
+    {
+        if (options->check && !checkAuthority(options->origin))
+        {
+            STORAGE_LOG(WARNING) << LOG_BADGE("MemoryTable2")
+                                 << LOG_DESC("upsert permission denied")
+                                 << LOG_KV("origin", options->origin.hex()) << LOG_KV("key", key);
+            return storage::CODE_NO_AUTHORIZED;
+        }
+
+        checkField(entry);
+
+        auto entries = selectNoLock(key, newCondition());
+        if (entries->size() == 0u)
+        {
+            return insert(key, entry, options, false);
+        }
+        updateEntries(key, entry, entries);
+        return entries->size();
+    }
+    catch (std::invalid_argument& e)
+    {
+        BOOST_THROW_EXCEPTION(e);
+    }
+    catch (std::exception& e)
+    {
+        STORAGE_LOG(ERROR) << LOG_BADGE("MemoryTable2")
+                           << LOG_DESC("Access MemoryTable2 failed for")
+                           << LOG_KV("msg", boost::diagnostic_information(e));
+        m_remoteDB->stop();
+        prepareExit(key);
+    }
+
+    return 0;
+}
+
 int MemoryTable2::remove(
     const std::string& key, Condition::Ptr condition, AccessOptions::Ptr options)
 {
@@ -305,6 +378,38 @@ int MemoryTable2::remove(
     return 0;
 }
 
+void MemoryTable2::updateEntries(const std::string& key, Entry::Ptr entry, Entries::Ptr entries)
+{
+    std::vector<Change::Record> records;
+
+    for (size_t i = 0; i < entries->size(); ++i)
+    {
+        Entry::Ptr updateEntry = entries->get(i);
+
+        // if id not equals to zero and not in the m_dirty, must be new dirty entry
+        if (updateEntry->getID() != 0 && m_dirty.find(updateEntry->getID()) == m_dirty.end())
+        {
+            m_dirty.insert(std::make_pair(updateEntry->getID(), updateEntry));
+        }
+
+        for (auto& it : *(entry))
+        {
+            // _id_ always got initialized value 0 from Entry::Entry()
+            // no need to update _id_ while updating entry
+            if (it.first != ID_FIELD && it.first != m_tableInfo->key)
+            {
+                records.emplace_back(updateEntry->getTempIndex(), it.first,
+                    updateEntry->getField(it.first), updateEntry->getID());
+                updateEntry->setField(it.first, it.second);
+            }
+        }
+    }
+
+    m_recorder(shared_from_this(), Change::Update, key, records);
+
+    m_isDirty = true;
+}
+
 dev::h256 MemoryTable2::hash()
 {
     if (m_isDirty)
@@ -474,10 +579,8 @@ dev::storage::TableData::Ptr MemoryTable2::dump()
         if (m_tableInfo->enableConsensus)
         {
             TIME_RECORD("Sort data");
-            tbb::parallel_sort(m_tableData->dirtyEntries->begin(), m_tableData->dirtyEntries->end(),
-                EntryLessNoLock(m_tableInfo));
-            tbb::parallel_sort(m_tableData->newEntries->begin(), m_tableData->newEntries->end(),
-                EntryLessNoLock(m_tableInfo));
+            sortEntries(m_tableData->dirtyEntries, m_tableInfo);
+            sortEntries(m_tableData->newEntries, m_tableInfo);
             TIME_RECORD("Calc hash");
 
             bytes allData;
@@ -485,32 +588,12 @@ dev::storage::TableData::Ptr MemoryTable2::dump()
 
             for (size_t i = 0; i < m_tableData->dirtyEntries->size(); ++i)
             {
-                auto entry = (*m_tableData->dirtyEntries)[i];
-                for (auto& fieldIt : *(entry))
-                {
-                    if (isHashField(fieldIt.first))
-                    {
-                        allData.insert(allData.end(), fieldIt.first.begin(), fieldIt.first.end());
-                        allData.insert(allData.end(), fieldIt.second.begin(), fieldIt.second.end());
-                    }
-                }
-                char status = (char)entry->getStatus();
-                allData.insert(allData.end(), &status, &status + sizeof(status));
+                appendHashData(allData, (*m_tableData->dirtyEntries)[i]);
             }
 
             for (size_t i = 0; i < m_tableData->newEntries->size(); ++i)
             {
-                auto entry = (*m_tableData->newEntries)[i];
-                for (auto& fieldIt : *(entry))
-                {
-                    if (isHashField(fieldIt.first))
-                    {
-                        allData.insert(allData.end(), fieldIt.first.begin(), fieldIt.first.end());
-                        allData.insert(allData.end(), fieldIt.second.begin(), fieldIt.second.end());
-                    }
-                }
-                char status = (char)entry->getStatus();
-                allData.insert(allData.end(), &status, &status + sizeof(status));
+                appendHashData(allData, (*m_tableData->newEntries)[i]);
             }
 
             if (allData.empty())
@@ -55,6 +55,10 @@ public:
     int remove(const std::string& key, Condition::Ptr condition,
         AccessOptions::Ptr options = std::make_shared<AccessOptions>()) override;
 
+    // select the key once for both the update and the insert
+    int upsert(const std::string& key, Entry::Ptr entry,
+        AccessOptions::Ptr options = std::make_shared<AccessOptions>()) override;
+
     h256 hash() override;
 
     void clear() override { m_dirty.clear(); }
@@ -86,6 +90,7 @@ public:
 
 private:
     Entries::Ptr selectNoLock(const std::string& key, Condition::Ptr condition);
+    void updateEntries(const std::string& key, Entry::Ptr entry, Entries::Ptr entries);
     dev::storage::TableData::Ptr dumpWithoutOptimize();
 
     tbb::concurrent_unordered_map<std::string, Entries::Ptr> m_newEntries;
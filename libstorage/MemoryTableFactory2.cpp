@@ -56,6 +56,16 @@ MemoryTableFactory2::MemoryTableFactory2()
 
 void MemoryTableFactory2::init()
 {
+    loadID();
+}
+
+void MemoryTableFactory2::loadID()
+{
+    if (m_IDLoaded)
+    {
+        return;
+    }
+    m_IDLoaded = true;
     auto table = openTable(SYS_CURRENT_STATE, false);
     auto condition = table->newCondition();
     condition->EQ(SYS_KEY, SYS_KEY_CURRENT_ID);
@@ -100,6 +110,11 @@ Table::Ptr MemoryTableFactory2::openTable(const std::string& tableName, bool aut
         tableInfo->key = entry->getField("key_field");
         std::string valueFields = entry->getField("value_field");
         boost::split(tableInfo->fields, valueFields, boost::is_any_of(","));
+        auto indexFields = entry->find("index_field");
+        if (indexFields != entry->end() && !indexFields->second.empty())
+        {
+            boost::split(tableInfo->indices, indexFields->second, boost::is_any_of(","));
+        }
     }
     tableInfo->fields.emplace_back(STATUS);
     tableInfo->fields.emplace_back(tableInfo->key);
@@ -112,6 +127,7 @@ Table::Ptr MemoryTableFactory2::openTable(const std::string& tableName, bool aut
     memoryTable->setBlockHash(m_blockHash);
     memoryTable->setBlockNum(m_blockNum);
     memoryTable->setTableInfo(tableInfo);
+    memoryTable->setArena(m_arena);
 
     // authority flag
     if (authorityFlag)
@@ -149,6 +165,14 @@ Table::Ptr MemoryTableFactory2::openTable(const std::string& tableName, bool aut
 Table::Ptr MemoryTableFactory2::createTable(const std::string& tableName,
     const std::string& keyField, const std::string& valueField, bool authorityFlag,
     Address const& _origin, bool isPara)
+{
+    return createIndexedTable(
+        tableName, keyField, valueField, "", authorityFlag, _origin, isPara);
+}
+
+Table::Ptr MemoryTableFactory2::createIndexedTable(const std::string& tableName,
+    const std::string& keyField, const std::string& valueField, const std::string& indexField,
+    bool authorityFlag, Address const& _origin, bool isPara)
 {
     auto sysTable = openTable(SYS_TABLES, authorityFlag);
     // To make sure the table exists
@@ -167,6 +191,11 @@ Table::Ptr MemoryTableFactory2::createTable(const std::string& tableName,
         tableEntry->setField("table_name", tableName);
         tableEntry->setField("key_field", keyField);
         tableEntry->setField("value_field", valueField);
+        if (!indexField.empty())
+        {
+            // indices must be declared with the table, rows written before are not indexed
+            tableEntry->setField("index_field", indexField);
+        }
         auto result = sysTable->insert(
             tableName, tableEntry, std::make_shared<AccessOptions>(_origin, authorityFlag));
         if (result == storage::CODE_NO_AUTHORIZED)
@@ -243,6 +272,28 @@ h256 MemoryTableFactory2::hash()
     return m_hash;
 }
 
+Table::Ptr MemoryTableFactory2::openedTable(const std::string& tableName)
+{
+    RecursiveGuard l(x_name2Table);
+    auto it = m_name2Table.find(tableName);
+    if (it != m_name2Table.end())
+    {
+        return it->second;
+    }
+    return nullptr;
+}
+
+void MemoryTableFactory2::changedKeys(TableKeySet& _keys)
+{
+    for (auto& change : getChangeLog())
+    {
+        if (change.kind != Change::Select)
+        {
+            _keys.insert(std::make_pair(change.table->tableInfo()->name, change.key));
+        }
+    }
+}
+
 std::vector<Change>& MemoryTableFactory2::getChangeLog()
 {
     return s_changeLog.local();
@@ -263,10 +314,8 @@ void MemoryTableFactory2::rollback(size_t _savepoint)
     }
 }
 
-void MemoryTableFactory2::commitDB(dev::h256 const&, int64_t _blockNumber)
+vector<TableData::Ptr> MemoryTableFactory2::exportData()
 {
-    auto start_time = utcTime();
-    auto record_time = utcTime();
     vector<dev::storage::TableData::Ptr> datas;
 
     for (auto& dbIt : m_name2Table)
@@ -282,6 +331,15 @@ void MemoryTableFactory2::commitDB(dev::h256 const&, int64_t _blockNumber)
             datas.push_back(tableData);
         }
     }
+    return datas;
+}
+
+void MemoryTableFactory2::commitDB(dev::h256 const&, int64_t _blockNumber)
+{
+    auto start_time = utcTime();
+    auto record_time = utcTime();
+    loadID();
+    auto datas = exportData();
     tbb::parallel_sort(datas.begin(), datas.end(),
         [](const dev::storage::TableData::Ptr& lhs, const dev::storage::TableData::Ptr& rhs) {
             return lhs->info->name < rhs->info->name;
@@ -29,6 +29,7 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/thread/tss.hpp>
 #include <memory>
+#include <set>
 #include <type_traits>
 
 namespace dev
@@ -40,6 +41,8 @@ class ExecutiveContext;
 namespace storage
 {
 const uint64_t ENTRY_ID_START = 100000;
+// table name and key
+using TableKeySet = std::set<std::pair<std::string, std::string> >;
 class MemoryTableFactory2 : public TableFactory
 {
 public:
@@ -53,18 +56,44 @@ public:
     virtual Table::Ptr createTable(const std::string& tableName, const std::string& keyField,
         const std::string& valueField, bool authorityFlag = true,
         Address const& _origin = Address(), bool isPara = true) override;
+    virtual Table::Ptr createIndexedTable(const std::string& tableName,
+        const std::string& keyField, const std::string& valueField, const std::string& indexField,
+        bool authorityFlag = true, Address const& _origin = Address(),
+        bool isPara = true) override;
 
-    virtual uint64_t ID() { return m_ID; };
+    virtual uint64_t ID()
+    {
+        loadID();
+        return m_ID;
+    };
+    // reserve IDs for entries committed to storage without the factory, return the first one
+    virtual uint64_t reserveIDs(size_t count)
+    {
+        loadID();
+        auto first = m_ID + 1;
+        m_ID += count;
+        return first;
+    }
     virtual h256 hash() override;
     virtual size_t savepoint() override;
     virtual void commit() override;
     virtual void rollback(size_t _savepoint) override;
     virtual void commitDB(h256 const& _blockHash, int64_t _blockNumber) override;
+    // the dumps of the changed tables, the IDs of the new entries are assigned by commitDB
+    virtual std::vector<TableData::Ptr> exportData();
+    // the table if it has been opened, nullptr otherwise
+    virtual Table::Ptr openedTable(const std::string& tableName);
+    // add the keys changed by the calling thread since the last commit to _keys
+    virtual void changedKeys(TableKeySet& _keys);
 
 private:
     void setAuthorizedAddress(storage::TableInfo::Ptr _tableInfo);
     std::vector<Change>& getChangeLog();
+    // the ID is loaded by init, or on the first use if init is not called, which is the case of
+    // the factory executing a block before its parent is committed, see OverlayStorage
+    void loadID();
     uint64_t m_ID = 1;
+    bool m_IDLoaded = false;
     // this map can't be changed, hash() need ordered data
     tbb::concurrent_unordered_map<std::string, Table::Ptr> m_name2Table;
     tbb::enumerable_thread_specific<std::vector<Change> > s_changeLog;
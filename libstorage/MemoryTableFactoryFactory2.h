@@ -35,20 +35,36 @@ class MemoryTableFactoryFactory2 : public TableFactoryFactory
 public:
     TableFactory::Ptr newTableFactory(const dev::h256& hash, int64_t number) override
     {
-        MemoryTableFactory2::Ptr tableFactory = std::make_shared<MemoryTableFactory2>();
-        tableFactory->setStateStorage(m_stroage);
-        tableFactory->setBlockHash(hash);
-        tableFactory->setBlockNum(number);
+        auto tableFactory = newTableFactory(hash, number, m_stroage);
         // TODO: check if need handle exception
         tableFactory->init();
 
         return tableFactory;
     }
 
+    // the factory reading and committing _storage, the ID is loaded on its first use, so the
+    // factory can be created before the parent block is committed to _storage
+    MemoryTableFactory2::Ptr newTableFactory(
+        const dev::h256& hash, int64_t number, dev::storage::Storage::Ptr _storage)
+    {
+        MemoryTableFactory2::Ptr tableFactory = std::make_shared<MemoryTableFactory2>();
+        tableFactory->setStateStorage(_storage);
+        tableFactory->setBlockHash(hash);
+        tableFactory->setBlockNum(number);
+        if (m_enableArena)
+        {
+            tableFactory->setArena(std::make_shared<Arena>());
+        }
+        return tableFactory;
+    }
+
     void setStorage(dev::storage::Storage::Ptr storage) { m_stroage = storage; }
+    // every table factory has an arena, which is released with the factory after the commit
+    void setEnableArena(bool _enableArena) { m_enableArena = _enableArena; }
 
 private:
     dev::storage::Storage::Ptr m_stroage;
+    bool m_enableArena = false;
 };
 
 }  // namespace storage
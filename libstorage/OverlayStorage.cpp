@@ -0,0 +1,224 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+/** @file OverlayStorage.cpp
+ */
+
+#include "OverlayStorage.h"
+#include "Common.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+using namespace std;
+using namespace dev;
+using namespace dev::storage;
+
+namespace
+{
+// the tables written by BlockChainImp::commitBlock
+bool isChainTable(string const& _tableName)
+{
+    return _tableName == SYS_CURRENT_STATE || _tableName == SYS_NUMBER_2_HASH ||
+           _tableName == SYS_TX_HASH_2_BLOCK || _tableName == SYS_HASH_2_BLOCK ||
+           _tableName == SYS_BLOCK_2_NONCES;
+}
+}  // namespace
+
+OverlayStorage::OverlayStorage(Storage::Ptr _backend, int64_t _parentNumber,
+    std::vector<TableData::Ptr> const& _parentData, std::function<bool()> _parentCommitted)
+  : m_backend(_backend), m_parentNumber(_parentNumber), m_parentCommitted(_parentCommitted)
+{
+    auto overlay = std::dynamic_pointer_cast<OverlayStorage>(_backend);
+    if (overlay)
+    {
+        m_backend = overlay->backend();
+    }
+    for (auto const& tableData : _parentData)
+    {
+        auto& keys = m_parentData[tableData->info->name];
+        auto const& keyField = tableData->info->key;
+        for (size_t i = 0; i < tableData->dirtyEntries->size(); ++i)
+        {
+            auto entry = std::make_shared<Entry>();
+            entry->copyFrom(tableData->dirtyEntries->get(i));
+            keys[entry->getField(keyField)].dirtyEntries.push_back(entry);
+        }
+        for (size_t i = 0; i < tableData->newEntries->size(); ++i)
+        {
+            keys[tableData->newEntries->get(i)->getField(keyField)].inserted = true;
+        }
+    }
+}
+
+Entries::Ptr OverlayStorage::select(
+    int64_t num, TableInfo::Ptr tableInfo, const std::string& key, Condition::Ptr condition)
+{
+    if (!parentCommitted())
+    {
+        if (isChainTable(tableInfo->name))
+        {
+            waitForParent();
+            return m_backend->select(num, tableInfo, key, condition);
+        }
+        auto tableIt = m_parentData.find(tableInfo->name);
+        if (tableIt != m_parentData.end())
+        {
+            auto keyIt = tableIt->second.find(key);
+            if (keyIt != tableIt->second.end())
+            {
+                if (!keyIt->second.inserted)
+                {
+                    return merge(num, tableInfo, key, condition, keyIt->second);
+                }
+                waitForParent();
+            }
+        }
+    }
+    return m_backend->select(num, tableInfo, key, condition);
+}
+
+Entries::Ptr OverlayStorage::merge(int64_t num, TableInfo::Ptr tableInfo, const std::string& key,
+    Condition::Ptr condition, KeyData const& keyData)
+{
+    // all rows of the key, the condition is checked after the dirty rows are merged
+    Condition::Ptr keyCondition = nullptr;
+    if (condition)
+    {
+        keyCondition = std::make_shared<Condition>();
+        keyCondition->EQ(tableInfo->key, key);
+    }
+    auto backendEntries = m_backend->select(num, tableInfo, key, keyCondition);
+    std::vector<Entry::Ptr> rows(backendEntries->begin(), backendEntries->end());
+    for (auto const& dirtyEntry : keyData.dirtyEntries)
+    {
+        auto id = dirtyEntry->getID();
+        auto rowIt = std::find_if(rows.begin(), rows.end(),
+            [id](Entry::Ptr const& _row) { return _row->getID() == id; });
+        // the rows of the backend may be shared with its cache
+        auto row = std::make_shared<Entry>();
+        if (rowIt != rows.end())
+        {
+            row->copyFrom(*rowIt);
+            for (auto fieldIt : *dirtyEntry)
+            {
+                row->setField(fieldIt.first, fieldIt.second);
+            }
+            row->setStatus(dirtyEntry->getStatus());
+            row->setNum(m_parentNumber);
+            *rowIt = row;
+            continue;
+        }
+        // the backend rows are filtered by status, keep the rows ordered by ID
+        row->copyFrom(dirtyEntry);
+        row->setNum(m_parentNumber);
+        rowIt = std::lower_bound(rows.begin(), rows.end(), row,
+            [](Entry::Ptr const& _lhs, Entry::Ptr const& _rhs) {
+                return _lhs->getID() < _rhs->getID();
+            });
+        rows.insert(rowIt, row);
+    }
+
+    auto entries = std::make_shared<Entries>();
+    for (auto const& row : rows)
+    {
+        if (condition && !condition->process(row))
+        {
+            continue;
+        }
+        entries->addEntry(row);
+    }
+    return entries;
+}
+
+size_t OverlayStorage::commit(int64_t num, const std::vector<TableData::Ptr>& datas)
+{
+    // the block on the overlay is committed after the parent
+    waitForParent();
+    return m_backend->commit(num, datas);
+}
+
+Entries::Ptr OverlayStorage::scan(int64_t num, TableInfo::Ptr tableInfo, const KeyRange& range,
+    Condition::Ptr condition, size_t limit)
+{
+    if (parentCommitted())
+    {
+        return m_backend->scan(num, tableInfo, range, condition, limit);
+    }
+    if (range.isSingle())
+    {
+        // select the merged rows of the key
+        return Storage::scan(num, tableInfo, range, condition, limit);
+    }
+    if (isChainTable(tableInfo->name) || m_parentData.count(tableInfo->name))
+    {
+        waitForParent();
+    }
+    return m_backend->scan(num, tableInfo, range, condition, limit);
+}
+
+void OverlayStorage::prefetch(int64_t num, const TableKeys& keys)
+{
+    // the rows of the backend are read anyway
+    m_backend->prefetch(num, keys);
+}
+
+bool OverlayStorage::deferCommit(int64_t num)
+{
+    return m_backend->deferCommit(num);
+}
+
+void OverlayStorage::cancelDefer(int64_t num)
+{
+    m_backend->cancelDefer(num);
+}
+
+bool OverlayStorage::onlyCommitDirty()
+{
+    return m_backend->onlyCommitDirty();
+}
+
+void OverlayStorage::stop()
+{
+    m_backend->stop();
+}
+
+bool OverlayStorage::parentCommitted()
+{
+    if (m_committed)
+    {
+        return true;
+    }
+    if (m_parentCommitted())
+    {
+        m_committed = true;
+        return true;
+    }
+    return false;
+}
+
+void OverlayStorage::waitForParent()
+{
+    auto start = utcSteadyTime();
+    while (!parentCommitted() && !m_cancelled)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    STORAGE_LOG(TRACE) << LOG_BADGE("OverlayStorage") << LOG_DESC("wait for parent")
+                       << LOG_KV("parentNumber", m_parentNumber)
+                       << LOG_KV("cancelled", m_cancelled.load())
+                       << LOG_KV("timeCost", utcSteadyTime() - start);
+}
@@ -0,0 +1,95 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+/** @file OverlayStorage.h
+ *
+ *  the state after a block that is executed but not committed yet, so that the next block can be
+ *  executed while the parent block is in consensus and committed
+ *
+ *  a row changed by the parent is read from the backend and replaced by the dirty row of the
+ *  parent by ID, the same as CachedStorage::commit does. The IDs of the rows the parent inserts
+ *  are assigned by MemoryTableFactory2::commitDB, and the chain tables are written by
+ *  BlockChainImp::commitBlock after the execution, so the reads of these keys wait until the parent
+ *  is committed and are served by the backend. Once the parent is committed, all reads go to the
+ *  backend, and so do the commits
+ */
+#pragma once
+
+#include "Storage.h"
+#include <atomic>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace dev
+{
+namespace storage
+{
+class OverlayStorage : public Storage
+{
+public:
+    typedef std::shared_ptr<OverlayStorage> Ptr;
+
+    // _parentData is the dump of the tables of the parent, see MemoryTableFactory2::exportData,
+    // the dirty rows are copied. _parentCommitted returns true once the parent is in _backend. If
+    // _backend is an OverlayStorage, its backend is used, its parent is committed before this one
+    OverlayStorage(Storage::Ptr _backend, int64_t _parentNumber,
+        std::vector<TableData::Ptr> const& _parentData, std::function<bool()> _parentCommitted);
+    virtual ~OverlayStorage() {}
+
+    Entries::Ptr select(int64_t num, TableInfo::Ptr tableInfo, const std::string& key,
+        Condition::Ptr condition = nullptr) override;
+    size_t commit(int64_t num, const std::vector<TableData::Ptr>& datas) override;
+    Entries::Ptr scan(int64_t num, TableInfo::Ptr tableInfo, const KeyRange& range,
+        Condition::Ptr condition, size_t limit = 0) override;
+    void prefetch(int64_t num, const TableKeys& keys) override;
+    bool deferCommit(int64_t num) override;
+    void cancelDefer(int64_t num) override;
+    bool onlyCommitDirty() override;
+    void stop() override;
+
+    // the waiting reads return the rows of the backend instead of waiting for a parent that will
+    // not be committed, the rows read must not be used, MemoryTable2 exits on exceptions
+    void cancel() { m_cancelled = true; }
+    bool cancelled() const { return m_cancelled; }
+    bool parentCommitted();
+    int64_t parentNumber() const { return m_parentNumber; }
+    Storage::Ptr backend() const { return m_backend; }
+
+private:
+    struct KeyData
+    {
+        // copies of the dirty rows of the parent
+        std::vector<Entry::Ptr> dirtyEntries;
+        // the parent inserts rows of the key
+        bool inserted = false;
+    };
+
+    Entries::Ptr merge(int64_t num, TableInfo::Ptr tableInfo, const std::string& key,
+        Condition::Ptr condition, KeyData const& keyData);
+    void waitForParent();
+
+    Storage::Ptr m_backend;
+    int64_t m_parentNumber;
+    std::function<bool()> m_parentCommitted;
+    std::atomic_bool m_committed = {false};
+    std::atomic_bool m_cancelled = {false};
+    // table name to the keys changed by the parent
+    std::unordered_map<std::string, std::unordered_map<std::string, KeyData>> m_parentData;
+};
+
+}  // namespace storage
+}  // namespace dev
@@ -21,13 +21,9 @@
 
 #include "RocksDBStorage.h"
 #include "BasicRocksDB.h"
+#include "RowCodec.h"
 #include "StorageException.h"
 #include "Table.h"
-#include "boost/archive/binary_iarchive.hpp"
-#include "boost/archive/binary_oarchive.hpp"
-#include "boost/serialization/map.hpp"
-#include "boost/serialization/serialization.hpp"
-#include "boost/serialization/vector.hpp"
 #include "rocksdb/db.h"
 #include "rocksdb/options.h"
 #include "rocksdb/slice.h"
@@ -38,6 +34,7 @@
 #include <libdevcore/RLP.h>
 #include <tbb/parallel_for.h>
 #include <memory>
+#include <set>
 #include <thread>
 
 using namespace std;
@@ -66,40 +63,14 @@ Entries::Ptr RocksDBStorage::select(
         Entries::Ptr entries = make_shared<Entries>();
         if (!s.IsNotFound())
         {
-            vector<map<string, string>> res;
-            stringstream ss(value);
-            boost::archive::binary_iarchive ia(ss);
-            ia >> res;
-            for (auto it = res.begin(); it != res.end(); ++it)
-            {  // TODO: use tbb parallel_for
-                Entry::Ptr entry = make_shared<Entry>();
-                for (auto valueIt = it->begin(); valueIt != it->end(); ++valueIt)
-                {
-                    if (valueIt->first == ID_FIELD)
-                    {
-                        entry->setID(valueIt->second);
-                    }
-                    else if (valueIt->first == NUM_FIELD)
-                    {
-                        entry->setNum(valueIt->second);
-                    }
-                    else if (valueIt->first == STATUS)
-                    {
-                        entry->setStatus(valueIt->second);
-                    }
-                    else
-                    {
-                        entry->setField(valueIt->first, valueIt->second);
-                    }
-                }
-
+            decodeEntries(value, [&](Entry::Ptr entry) {
                 if (entry->getStatus() == Entry::Status::NORMAL &&
                     (!condition || condition->process(entry)))
                 {
                     entry->setDirty(false);
                     entries->addEntry(entry);
                 }
-            }
+            });
         }
 
         return entries;
@@ -120,6 +91,128 @@ Entries::Ptr RocksDBStorage::select(
     return Entries::Ptr();
 }
 
+vector<Entries::Ptr> RocksDBStorage::selectBatch(int64_t, const TableKeys& keys)
+{
+    try
+    {
+        vector<string> entryKeys;
+        entryKeys.reserve(keys.size());
+        for (auto const& key : keys)
+        {
+            entryKeys.emplace_back(key.first->name);
+            entryKeys.back().append("_").append(key.second);
+        }
+
+        vector<string> values;
+        auto statuses = m_db->MultiGet(ReadOptions(), entryKeys, values);
+
+        vector<Entries::Ptr> result(keys.size());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, keys.size()),
+            [&](const tbb::blocked_range<size_t>& range) {
+                for (size_t i = range.begin(); i < range.end(); ++i)
+                {
+                    auto entries = make_shared<Entries>();
+                    if (!statuses[i].IsNotFound())
+                    {
+                        decodeEntries(values[i], [&](Entry::Ptr entry) {
+                            if (entry->getStatus() == Entry::Status::NORMAL)
+                            {
+                                entry->setDirty(false);
+                                entries->addEntry(entry);
+                            }
+                        });
+                    }
+                    result[i] = entries;
+                }
+            });
+        return result;
+    }
+    catch (DatabaseNeedRetry const& e)
+    {
+        STORAGE_ROCKSDB_LOG(WARNING) << LOG_DESC("Query rocksdb exception, need to retry again ")
+                                     << LOG_KV("msg", boost::diagnostic_information(e));
+    }
+    catch (exception& e)
+    {
+        STORAGE_ROCKSDB_LOG(ERROR) << LOG_DESC("Batch query rocksdb exception")
+                                   << LOG_KV("msg", boost::diagnostic_information(e));
+
+        BOOST_THROW_EXCEPTION(e);
+    }
+
+    return vector<Entries::Ptr>();
+}
+
+Entries::Ptr RocksDBStorage::scan(int64_t num, TableInfo::Ptr tableInfo, const KeyRange& range,
+    Condition::Ptr condition, size_t limit)
+{
+    try
+    {
+        auto entries = make_shared<Entries>();
+        auto match = [&](Entry::Ptr entry) {
+            return entry->getStatus() == Entry::Status::NORMAL &&
+                   (!condition || condition->process(entry));
+        };
+        string field;
+        string value;
+        if (range.isSingle() && !findIndex(tableInfo, condition, field, value))
+        {
+            return Storage::scan(num, tableInfo, range, condition, limit);
+        }
+        auto onEntry = [&](Entry::Ptr entry) {
+            if ((limit == 0 || entries->size() < limit) && match(entry))
+            {
+                entry->setDirty(false);
+                entries->addEntry(entry);
+            }
+        };
+        if (range.isSingle())
+        {
+            // index keys of the same value are ordered by ID, the same order as rows of the key
+            auto prefix = indexKeyPrefix(tableInfo->name, range.begin, field, value);
+            auto prefixEnd = prefix;
+            ++prefixEnd.back();
+            m_db->Scan(ReadOptions(), prefix, prefixEnd, [&](const string&, string& data) {
+                decodeEntries(data, onEntry);
+                return limit == 0 || entries->size() < limit;
+            });
+            return entries;
+        }
+
+        auto prefix = tableInfo->name + "_";
+        // '`' is the byte after '_', so the empty end stops at the end of the table
+        auto end = range.end.empty() ? tableInfo->name + "`" : prefix + range.end;
+        auto onValue = [&](const string& entryKey, string& data) {
+            auto key = entryKey.substr(prefix.size());
+            decodeEntries(data, [&](Entry::Ptr entry) {
+                // tables whose name starts with this prefix share the key space, skip their rows
+                auto keyField = entry->find(tableInfo->key);
+                if (keyField != entry->end() && keyField->second == key)
+                {
+                    onEntry(entry);
+                }
+            });
+            return limit == 0 || entries->size() < limit;
+        };
+        m_db->Scan(ReadOptions(), prefix + range.begin, end, onValue);
+        return entries;
+    }
+    catch (DatabaseNeedRetry const& e)
+    {
+        STORAGE_ROCKSDB_LOG(WARNING) << LOG_DESC("Scan rocksdb exception, need to retry again ")
+                                     << LOG_KV("msg", boost::diagnostic_information(e));
+    }
+    catch (exception& e)
+    {
+        STORAGE_ROCKSDB_LOG(ERROR) << LOG_DESC("Scan rocksdb exception")
+                                   << LOG_KV("msg", boost::diagnostic_information(e));
+
+        BOOST_THROW_EXCEPTION(e);
+    }
+
+    return Entries::Ptr();
+}
+
 size_t RocksDBStorage::commit(int64_t num, const vector<TableData::Ptr>& datas)
 {
     try
@@ -149,12 +242,13 @@ size_t RocksDBStorage::commit(int64_t num, const vector<TableData::Ptr>& datas)
                     for (const auto& it : *key2value)
                     {
                         string entryKey = tableInfo->name + "_" + it.first;
-                        stringstream ss;
-                        boost::archive::binary_oarchive oa(ss);
-                        oa << it.second;
+                        if (!tableInfo->indices.empty())
                         {
-                            m_db->PutWithLock(batch, entryKey, ss.str(), m_writeBatchMutex);
+                            updateIndices(batch, tableInfo, it.first, entryKey, it.second);
                         }
+                        string value;
+                        encodeRows(it.second, value, m_rowFormat);
+                        m_db->PutWithLock(batch, entryKey, value, m_writeBatchMutex);
                     }
                 }
             });
@@ -167,6 +261,10 @@ size_t RocksDBStorage::commit(int64_t num, const vector<TableData::Ptr>& datas)
         options.disableWAL = m_disableWAL;
 
         m_db->Write(options, batch);
+        if (m_pruner)
+        {
+            m_pruner->setCurrentNumber(num);
+        }
         auto writeDB_time_cost = utcTime();
         STORAGE_ROCKSDB_LOG(DEBUG)
             << LOG_BADGE("Commit") << LOG_DESC("Write to db")
@@ -191,6 +289,51 @@ size_t RocksDBStorage::commit(int64_t num, const vector<TableData::Ptr>& datas)
     return 0;
 }
 
+void RocksDBStorage::updateIndices(WriteBatch& batch, TableInfo::Ptr tableInfo,
+    const string& key, const string& entryKey, const Rows& rows)
+{
+    // this exception has already been catched in commit function
+    string oldValue;
+    auto s = m_db->Get(ReadOptions(), entryKey, oldValue);
+    if (!s.ok() && !s.IsNotFound())
+    {
+        BOOST_THROW_EXCEPTION(StorageException(-1, "Query rocksdb exception:" + s.ToString()));
+    }
+    set<string> staleKeys;
+    if (!s.IsNotFound())
+    {
+        Rows oldRows;
+        decodeRows(oldValue, oldRows);
+        for (auto const& row : oldRows)
+        {
+            for (auto& staleKey : rowIndexKeys(tableInfo, key, row))
+            {
+                staleKeys.insert(move(staleKey));
+            }
+        }
+    }
+    for (auto const& row : rows)
+    {
+        auto indexKeys = rowIndexKeys(tableInfo, key, row);
+        if (indexKeys.empty())
+        {
+            continue;
+        }
+        // the index is covering, the row is read from the index without reading the key
+        string value;
+        encodeRows(Rows{row}, value, RowFormat::V1);
+        for (auto const& newKey : indexKeys)
+        {
+            staleKeys.erase(newKey);
+            m_db->PutWithLock(batch, newKey, value, m_writeBatchMutex);
+        }
+    }
+    for (auto const& staleKey : staleKeys)
+    {
+        m_db->DeleteWithLock(batch, staleKey, m_writeBatchMutex);
+    }
+}
+
 void RocksDBStorage::processEntries(int64_t num,
     shared_ptr<map<string, vector<map<string, string>>>> key2value, TableInfo::Ptr tableInfo,
     Entries::Ptr entries, bool isDirtyEntries)
@@ -232,9 +375,7 @@ void RocksDBStorage::processEntries(int64_t num,
                 else
                 {
                     vector<map<string, string>> res;
-                    stringstream ss(value);
-                    boost::archive::binary_iarchive ia(ss);
-                    ia >> res;
+                    decodeRows(value, res);
                     it = key2value->emplace(key, move(res)).first;
                 }
             }
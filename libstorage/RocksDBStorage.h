@@ -20,6 +20,8 @@
  */
 #pragma once
 
+#include "RowCodec.h"
+#include "RowPruner.h"
 #include "Storage.h"
 #include <json/json.h>
 #include <libdevcore/FixedHash.h>
@@ -30,6 +32,7 @@
 namespace rocksdb
 {
 class DB;
+class WriteBatch;
 }
 namespace dev
 {
@@ -49,12 +52,23 @@ public:
     Entries::Ptr select(int64_t num, TableInfo::Ptr tableInfo, const std::string& key,
         Condition::Ptr condition) override;
     size_t commit(int64_t num, const std::vector<TableData::Ptr>& datas) override;
+    std::vector<Entries::Ptr> selectBatch(int64_t num, const TableKeys& keys) override;
+    // rows of a single key are read from the index if the condition matches an index with EQ
+    Entries::Ptr scan(int64_t num, TableInfo::Ptr tableInfo, const KeyRange& range,
+        Condition::Ptr condition, size_t limit = 0) override;
 
     void setDB(std::shared_ptr<BasicRocksDB> db) { m_db = db; }
+    std::shared_ptr<BasicRocksDB> db() const { return m_db; }
+    // values of both formats can always be read, this only decides how rows are written
+    void setRowFormat(RowFormat _format) { m_rowFormat = _format; }
+    // the pruner of the compaction filter of the db, advanced by commit
+    void setRowPruner(RowPruner::Ptr _pruner) { m_pruner = _pruner; }
+    RowPruner::Ptr rowPruner() const { return m_pruner; }
 
 private:
     bool m_disableWAL = false;
     bool m_shouldCompleteDirty = false;
+    RowFormat m_rowFormat = RowFormat::V1;
     void processEntries(int64_t num,
         std::shared_ptr<std::map<std::string, std::vector<std::map<std::string, std::string>>>>
             key2value,
@@ -65,7 +79,12 @@ private:
             key2value,
         TableInfo::Ptr tableInfo, Entries::Ptr entries);
 
+    // write the index keys of the new rows of key and delete the index keys of its old rows
+    void updateIndices(rocksdb::WriteBatch& batch, TableInfo::Ptr tableInfo,
+        const std::string& key, const std::string& entryKey, const Rows& rows);
+
     std::shared_ptr<BasicRocksDB> m_db;
+    RowPruner::Ptr m_pruner;
     tbb::spin_mutex m_writeBatchMutex;
 };
 
@@ -0,0 +1,380 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+/** @file RowCodec.cpp
+ */
+
+#include "RowCodec.h"
+#include "StorageException.h"
+#include "boost/archive/binary_iarchive.hpp"
+#include "boost/archive/binary_oarchive.hpp"
+#include "boost/serialization/map.hpp"
+#include "boost/serialization/serialization.hpp"
+#include "boost/serialization/vector.hpp"
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <sstream>
+
+using namespace std;
+using namespace dev;
+using namespace dev::storage;
+
+namespace
+{
+void putVarint(string& _out, uint64_t _value)
+{
+    while (_value >= 0x80)
+    {
+        _out.push_back(static_cast<char>((_value & 0x7f) | 0x80));
+        _value >>= 7;
+    }
+    _out.push_back(static_cast<char>(_value));
+}
+
+class RowReader
+{
+public:
+    RowReader(string const& _value) : m_pos(_value.data()), m_end(_value.data() + _value.size())
+    {}
+
+    uint8_t getByte()
+    {
+        check(1);
+        return static_cast<uint8_t>(*m_pos++);
+    }
+
+    uint64_t getVarint()
+    {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7)
+        {
+            uint8_t b = getByte();
+            value |= static_cast<uint64_t>(b & 0x7f) << shift;
+            if (!(b & 0x80))
+            {
+                return value;
+            }
+        }
+        BOOST_THROW_EXCEPTION(StorageException(-1, "Decode row failed: varint overflow"));
+    }
+
+    const char* getBytes(size_t _size)
+    {
+        check(_size);
+        auto pos = m_pos;
+        m_pos += _size;
+        return pos;
+    }
+
+    bool finished() const { return m_pos == m_end; }
+
+private:
+    void check(size_t _size)
+    {
+        if (static_cast<size_t>(m_end - m_pos) < _size)
+        {
+            BOOST_THROW_EXCEPTION(StorageException(-1, "Decode row failed: unexpected end"));
+        }
+    }
+
+    const char* m_pos;
+    const char* m_end;
+};
+
+// read the header of a v1 value, the column names are returned as views into _value
+void decodeColumns(RowReader& _reader, vector<pair<const char*, size_t>>& _columns)
+{
+    if (_reader.getByte() != ROW_CODEC_MAGIC ||
+        _reader.getByte() != static_cast<uint8_t>(RowFormat::V1))
+    {
+        BOOST_THROW_EXCEPTION(StorageException(-1, "Decode row failed: unsupported version"));
+    }
+    auto columnCount = _reader.getVarint();
+    _columns.reserve(columnCount);
+    for (uint64_t i = 0; i < columnCount; ++i)
+    {
+        auto size = _reader.getVarint();
+        _columns.emplace_back(_reader.getBytes(size), size);
+    }
+}
+
+void decodeLegacyRows(string const& _value, Rows& _rows)
+{
+    stringstream ss(_value);
+    boost::archive::binary_iarchive ia(ss);
+    ia >> _rows;
+}
+
+void setEntryField(Entry::Ptr _entry, string const& _key, string const& _value)
+{
+    if (_key == ID_FIELD)
+    {
+        _entry->setID(_value);
+    }
+    else if (_key == NUM_FIELD)
+    {
+        _entry->setNum(_value);
+    }
+    else if (_key == STATUS)
+    {
+        _entry->setStatus(_value);
+    }
+    else
+    {
+        _entry->setField(_key, _value);
+    }
+}
+}  // namespace
+
+RowFormat dev::storage::rowFormat(string const& _value)
+{
+    if (_value.empty() || static_cast<uint8_t>(_value[0]) == ROW_CODEC_MAGIC)
+    {
+        return RowFormat::V1;
+    }
+    return RowFormat::Legacy;
+}
+
+void dev::storage::encodeRows(Rows const& _rows, string& _out, RowFormat _format)
+{
+    _out.clear();
+    if (_format == RowFormat::Legacy)
+    {
+        stringstream ss;
+        boost::archive::binary_oarchive oa(ss);
+        oa << _rows;
+        _out = ss.str();
+        return;
+    }
+
+    // every row of a key belongs to the same table, so the column set is almost always shared
+    vector<string const*> columns;
+    map<string, size_t> columnIndex;
+    size_t valueSize = 0;
+    for (auto const& row : _rows)
+    {
+        for (auto const& field : row)
+        {
+            if (columnIndex.emplace(field.first, columns.size()).second)
+            {
+                columns.push_back(&field.first);
+            }
+            valueSize += field.second.size() + 2;
+        }
+    }
+
+    _out.reserve(valueSize + columns.size() * 16 + 8);
+    _out.push_back(static_cast<char>(ROW_CODEC_MAGIC));
+    _out.push_back(static_cast<char>(RowFormat::V1));
+    putVarint(_out, columns.size());
+    for (auto column : columns)
+    {
+        putVarint(_out, column->size());
+        _out.append(*column);
+    }
+    putVarint(_out, _rows.size());
+    for (auto const& row : _rows)
+    {
+        for (auto column : columns)
+        {
+            auto it = row.find(*column);
+            if (it == row.end())
+            {
+                putVarint(_out, 0);
+                continue;
+            }
+            putVarint(_out, it->second.size() + 1);
+            _out.append(it->second);
+        }
+    }
+}
+
+void dev::storage::decodeRows(string const& _value, Rows& _rows)
+{
+    _rows.clear();
+    if (_value.empty())
+    {
+        return;
+    }
+    if (rowFormat(_value) == RowFormat::Legacy)
+    {
+        decodeLegacyRows(_value, _rows);
+        return;
+    }
+
+    RowReader reader(_value);
+    vector<pair<const char*, size_t>> columns;
+    decodeColumns(reader, columns);
+    auto rowCount = reader.getVarint();
+    _rows.resize(rowCount);
+    for (auto& row : _rows)
+    {
+        for (auto const& column : columns)
+        {
+            auto size = reader.getVarint();
+            if (size == 0)
+            {
+                continue;
+            }
+            auto data = reader.getBytes(size - 1);
+            row.emplace_hint(
+                row.end(), string(column.first, column.second), string(data, size - 1));
+        }
+    }
+    if (!reader.finished())
+    {
+        BOOST_THROW_EXCEPTION(StorageException(-1, "Decode row failed: trailing bytes"));
+    }
+}
+
+void dev::storage::decodeEntries(
+    string const& _value, function<void(Entry::Ptr)> const& _onEntry)
+{
+    if (_value.empty())
+    {
+        return;
+    }
+    if (rowFormat(_value) == RowFormat::Legacy)
+    {
+        Rows rows;
+        decodeLegacyRows(_value, rows);
+        for (auto const& row : rows)
+        {
+            auto entry = make_shared<Entry>();
+            entry->reserveFields(row.size());
+            for (auto const& field : row)
+            {
+                setEntryField(entry, field.first, field.second);
+            }
+            _onEntry(entry);
+        }
+        return;
+    }
+
+    RowReader reader(_value);
+    vector<pair<const char*, size_t>> columns;
+    decodeColumns(reader, columns);
+
+    // the reserved columns are resolved once per value instead of once per field
+    enum ColumnKind : uint8_t
+    {
+        Normal,
+        ID,
+        Num,
+        Status
+    };
+    vector<ColumnKind> kinds;
+    vector<string> names;
+    kinds.reserve(columns.size());
+    names.reserve(columns.size());
+    for (auto const& column : columns)
+    {
+        names.emplace_back(column.first, column.second);
+        auto const& name = names.back();
+        kinds.push_back(name == ID_FIELD ? ID :
+                                           name == NUM_FIELD ? Num :
+                                                               name == STATUS ? Status : Normal);
+    }
+    auto normalColumns = (size_t)std::count(kinds.begin(), kinds.end(), Normal);
+
+    auto rowCount = reader.getVarint();
+    for (uint64_t i = 0; i < rowCount; ++i)
+    {
+        auto entry = make_shared<Entry>();
+        entry->reserveFields(normalColumns);
+        for (size_t j = 0; j < columns.size(); ++j)
+        {
+            auto size = reader.getVarint();
+            if (size == 0)
+            {
+                continue;
+            }
+            auto data = reader.getBytes(size - 1);
+            if (kinds[j] == Normal)
+            {
+                entry->setField(names[j], reinterpret_cast<const byte*>(data), size - 1);
+            }
+            else
+            {
+                setEntryField(entry, names[j], string(data, size - 1));
+            }
+        }
+        _onEntry(entry);
+    }
+    if (!reader.finished())
+    {
+        BOOST_THROW_EXCEPTION(StorageException(-1, "Decode row failed: trailing bytes"));
+    }
+}
+
+void dev::storage::appendOrderedKey(string& _out, string const& _part)
+{
+    for (auto c : _part)
+    {
+        _out.push_back(c);
+        if (c == '\0')
+        {
+            _out.push_back('\xff');
+        }
+    }
+    _out.push_back('\0');
+    _out.push_back('\x01');
+}
+
+string dev::storage::indexKeyPrefix(
+    string const& _table, string const& _key, string const& _field, string const& _value)
+{
+    string prefix(1, INDEX_KEY_PREFIX);
+    prefix.reserve(_table.size() + _key.size() + _field.size() + _value.size() + 32);
+    appendOrderedKey(prefix, _table);
+    appendOrderedKey(prefix, _key);
+    appendOrderedKey(prefix, _field);
+    appendOrderedKey(prefix, _value);
+    return prefix;
+}
+
+string dev::storage::indexKey(string const& _table, string const& _key, string const& _field,
+    string const& _value, uint64_t _id)
+{
+    auto key = indexKeyPrefix(_table, _key, _field, _value);
+    for (int shift = 56; shift >= 0; shift -= 8)
+    {
+        key.push_back(static_cast<char>((_id >> shift) & 0xff));
+    }
+    return key;
+}
+
+vector<string> dev::storage::rowIndexKeys(
+    TableInfo::Ptr _tableInfo, string const& _key, Row const& _row)
+{
+    vector<string> indexKeys;
+    auto status = _row.find(STATUS);
+    auto id = _row.find(ID_FIELD);
+    if ((status != _row.end() && status->second != "0") || id == _row.end())
+    {
+        return indexKeys;
+    }
+    auto rowID = boost::lexical_cast<uint64_t>(id->second);
+    for (auto const& field : _tableInfo->indices)
+    {
+        auto it = _row.find(field);
+        if (it != _row.end())
+        {
+            indexKeys.push_back(indexKey(_tableInfo->name, _key, field, it->second, rowID));
+        }
+    }
+    return indexKeys;
+}
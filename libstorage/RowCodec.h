@@ -0,0 +1,110 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+/** @file RowCodec.h
+ *
+ *  the row format of RocksDBStorage, the value of a key is all rows of the key
+ *
+ *  v1 layout (all integers are LEB128 varints):
+ *  | magic(0xfb) | version | columnCount | [len|column]... | rowCount |
+ *  | row0: [len+1|value]... for every column, 0 means the column is absent | row1 ... |
+ *
+ *  the legacy layout is a boost::archive::binary_oarchive of
+ *  std::vector<std::map<std::string, std::string>>, which always starts with the length of
+ *  "serialization::archive", so the magic byte can never be the first byte of a legacy value
+ *
+ *  secondary index layout, the value of an index key is the v1 encoding of the indexed row:
+ *  | 0x00 | table | key | field | value | ID |
+ *  strings are escaped by appendOrderedKey and ID is 8 bytes big endian, so index keys sort by
+ *  table, key, field, value and then ID, the order is bytewise, so the index only answers EQ
+ *
+ *  the key space of RocksDBStorage:
+ *  | 0x00 ... | index keys, derived from the rows, not table rows |
+ *  | 0x01 ... | marker keys, such as the snapshot import marker |
+ *  | table_key | row keys, table names never start with 0x00 or 0x01 |
+ */
+#pragma once
+
+#include "Table.h"
+#include <libdevcore/Common.h>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace dev
+{
+namespace storage
+{
+typedef std::map<std::string, std::string> Row;
+typedef std::vector<Row> Rows;
+
+enum class RowFormat : uint8_t
+{
+    Legacy = 0,
+    V1 = 1,
+};
+
+const uint8_t ROW_CODEC_MAGIC = 0xfb;
+
+const char INDEX_KEY_PREFIX = '\x00';
+const char MARKER_KEY_PREFIX = '\x01';
+
+// whether _key is an index key, see indexKeyPrefix
+inline bool isIndexKey(std::string const& _key)
+{
+    return !_key.empty() && _key[0] == INDEX_KEY_PREFIX;
+}
+
+// whether _key is a row key "table_key", neither an index key nor a marker key
+inline bool isRowKey(std::string const& _key)
+{
+    return !_key.empty() && uint8_t(_key[0]) > uint8_t(MARKER_KEY_PREFIX);
+}
+
+// return the format of the encoded value, the empty value is treated as V1
+RowFormat rowFormat(std::string const& _value);
+
+// encode rows with the given format
+void encodeRows(Rows const& _rows, std::string& _out, RowFormat _format = RowFormat::V1);
+
+// decode rows of any format, throw StorageException if the value is malformed
+void decodeRows(std::string const& _value, Rows& _rows);
+
+// decode rows of any format into Entry objects without building intermediate maps
+// V1 values are decoded straight from the input buffer, _onEntry is called for every row
+void decodeEntries(
+    std::string const& _value, std::function<void(Entry::Ptr)> const& _onEntry);
+
+// append _part with 0x00 escaped as 0x00 0xff and terminated by 0x00 0x01, the byte order of
+// the encoded keys is the same as the order of their parts
+void appendOrderedKey(std::string& _out, std::string const& _part);
+
+// the prefix of all index keys of rows whose field is _value
+std::string indexKeyPrefix(std::string const& _table, std::string const& _key,
+    std::string const& _field, std::string const& _value);
+
+// the index key of row _id, see indexKeyPrefix
+std::string indexKey(std::string const& _table, std::string const& _key,
+    std::string const& _field, std::string const& _value, uint64_t _id);
+
+// the index keys of a row of _key, only NORMAL rows are indexed, a row without the field of an
+// index never matches EQ of the field, so it is not in the index
+std::vector<std::string> rowIndexKeys(
+    TableInfo::Ptr _tableInfo, std::string const& _key, Row const& _row);
+
+}  // namespace storage
+}  // namespace dev
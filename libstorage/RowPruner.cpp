@@ -0,0 +1,136 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+/** @file RowPruner.cpp
+ */
+
+#include "RowPruner.h"
+#include "Common.h"
+#include <boost/lexical_cast.hpp>
+
+using namespace std;
+using namespace dev;
+using namespace dev::storage;
+
+void RowPruner::setCurrentNumber(int64_t _number)
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_currentNumber = _number;
+    if (m_pins == 0)
+    {
+        m_pruneNumber = max(m_currentNumber - m_retention, int64_t(-1));
+    }
+}
+
+int64_t RowPruner::pin()
+{
+    lock_guard<mutex> lock(m_mutex);
+    ++m_pins;
+    return m_pruneNumber.load();
+}
+
+void RowPruner::unpin()
+{
+    lock_guard<mutex> lock(m_mutex);
+    if (m_pins > 0 && --m_pins == 0)
+    {
+        m_pruneNumber = max(m_currentNumber - m_retention, int64_t(-1));
+    }
+}
+
+bool RowPruner::prune(
+    string const& _key, string const& _value, int64_t _pruneNumber, string& _pruned)
+{
+    // index keys only have NORMAL rows and marker keys have no rows
+    if (_pruneNumber < 0 || !isRowKey(_key))
+    {
+        return false;
+    }
+    Rows rows;
+    try
+    {
+        decodeRows(_value, rows);
+    }
+    catch (exception const&)
+    {  // not rows of a table, keep it
+        return false;
+    }
+    Rows kept;
+    kept.reserve(rows.size());
+    for (auto& row : rows)
+    {
+        auto status = row.find(STATUS);
+        auto num = row.find(NUM_FIELD);
+        if (status != row.end() && status->second != "0" && num != row.end() &&
+            boost::lexical_cast<int64_t>(num->second) <= _pruneNumber)
+        {
+            continue;
+        }
+        kept.push_back(move(row));
+    }
+    if (kept.size() == rows.size())
+    {
+        return false;
+    }
+    _pruned.clear();
+    if (!kept.empty())
+    {
+        encodeRows(kept, _pruned, rowFormat(_value));
+    }
+    return true;
+}
+
+bool RowCompactionFilter::Filter(int, rocksdb::Slice const& _key,
+    rocksdb::Slice const& _existingValue, string* _newValue, bool* _valueChanged) const
+{
+    auto pruneNumber = m_pruner->pruneNumber();
+    if (pruneNumber < 0)
+    {
+        return false;
+    }
+    try
+    {
+        auto value = _existingValue.ToString();
+        if (m_decryptHandler && !value.empty())
+        {
+            m_decryptHandler(value);
+        }
+        string pruned;
+        if (!RowPruner::prune(_key.ToString(), value, pruneNumber, pruned))
+        {
+            return false;
+        }
+        if (pruned.empty())
+        {  // remove the key
+            return true;
+        }
+        if (m_encryptHandler)
+        {
+            m_encryptHandler(pruned, *_newValue);
+        }
+        else
+        {
+            *_newValue = move(pruned);
+        }
+        *_valueChanged = true;
+    }
+    catch (exception const& e)
+    {  // never fail the compaction, keep the value
+        STORAGE_LOG(WARNING) << LOG_BADGE("RowCompactionFilter") << LOG_DESC("prune failed")
+                             << LOG_KV("error", e.what());
+    }
+    return false;
+}
@@ -0,0 +1,101 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+/** @file RowPruner.h
+ *
+ *  garbage collection of the tombstones of RocksDBStorage
+ *
+ *  commit of RocksDBStorage rewrites all rows of a key, rows removed by Table::remove are kept
+ *  with _status_ DELETED and the _num_ of the block that removed them. Tombstones are never read,
+ *  select, scan and the indices skip them, so a tombstone older than the retention window
+ *  (_num_ + retention <= current block number) is dropped when rocksdb compacts its key, and a
+ *  key that only has such tombstones is removed. The state hash is computed from the change set
+ *  of a block, so pruning never changes consensus
+ *
+ *  a reader of a rocksdb snapshot that must read the same values again, e.g. the state snapshot
+ *  exporter, pins the prune number while the snapshot is held and prunes the values it reads with
+ *  the pinned number, so compaction never changes what the reader sees
+ */
+#pragma once
+
+#include "RowCodec.h"
+#include <rocksdb/compaction_filter.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace dev
+{
+namespace storage
+{
+class RowPruner
+{
+public:
+    using Ptr = std::shared_ptr<RowPruner>;
+
+    RowPruner(int64_t _retention) : m_retention(_retention) {}
+
+    // called after the block _number is committed
+    void setCurrentNumber(int64_t _number);
+    // tombstones whose _num_ is not greater than the prune number can be dropped, -1 if nothing
+    // can be dropped yet
+    int64_t pruneNumber() const { return m_pruneNumber.load(); }
+    // keep the prune number unchanged until unpin, pins nest
+    // @return the pinned prune number
+    int64_t pin();
+    void unpin();
+    int64_t retention() const { return m_retention; }
+
+    // drop the tombstones of the rows of _key
+    // @return false if nothing is dropped, _pruned is the empty string if all rows are dropped
+    static bool prune(std::string const& _key, std::string const& _value, int64_t _pruneNumber,
+        std::string& _pruned);
+
+private:
+    int64_t m_retention;
+    std::mutex m_mutex;
+    int64_t m_currentNumber = -1;
+    size_t m_pins = 0;
+    std::atomic<int64_t> m_pruneNumber = {-1};
+};
+
+// applies RowPruner when rocksdb compacts keys, values are decrypted and encrypted again if disk
+// encryption is enabled
+class RowCompactionFilter : public rocksdb::CompactionFilter
+{
+public:
+    RowCompactionFilter(RowPruner::Ptr _pruner,
+        std::function<void(std::string&)> const& _decryptHandler = nullptr,
+        std::function<void(std::string const&, std::string&)> const& _encryptHandler = nullptr)
+      : m_pruner(_pruner), m_decryptHandler(_decryptHandler), m_encryptHandler(_encryptHandler)
+    {}
+
+    bool Filter(int _level, rocksdb::Slice const& _key, rocksdb::Slice const& _existingValue,
+        std::string* _newValue, bool* _valueChanged) const override;
+    // snapshots are protected by RowPruner::pin
+    bool IgnoreSnapshots() const override { return true; }
+    const char* Name() const override { return "RowCompactionFilter"; }
+
+private:
+    RowPruner::Ptr m_pruner;
+    std::function<void(std::string&)> m_decryptHandler;
+    std::function<void(std::string const&, std::string&)> m_encryptHandler;
+};
+
+}  // namespace storage
+}  // namespace dev
@@ -0,0 +1,256 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+/** @file SpeculativeTableFactory.cpp
+ */
+
+#include "SpeculativeTableFactory.h"
+#include "StorageException.h"
+
+using namespace std;
+using namespace dev;
+using namespace dev::storage;
+
+namespace
+{
+Entry::Ptr copyEntry(Entry::Ptr _entry)
+{
+    auto entry = make_shared<Entry>();
+    entry->copyFrom(_entry);
+    return entry;
+}
+
+Condition::Ptr copyCondition(Condition::Ptr _condition)
+{
+    return make_shared<Condition>(*_condition);
+}
+
+void checkResult(int _result, int _expected, string const& _tableName, string const& _key)
+{
+    if (_result != _expected)
+    {
+        STORAGE_LOG(ERROR) << LOG_BADGE("SpeculativeTableFactory")
+                           << LOG_DESC("replay result mismatch") << LOG_KV("table", _tableName)
+                           << LOG_KV("key", _key) << LOG_KV("result", _result)
+                           << LOG_KV("expected", _expected);
+        BOOST_THROW_EXCEPTION(StorageException(-1, "replay result mismatch of " + _tableName));
+    }
+}
+}  // namespace
+
+Table::Ptr SpeculativeTableFactory::openTable(
+    const std::string& tableName, bool authorityFlag, bool isPara)
+{
+    auto it = m_tables.find(tableName);
+    if (it != m_tables.end())
+    {
+        return it->second;
+    }
+    // the table info and the authorized addresses are read by MemoryTableFactory2::openTable
+    recordRead(SYS_TABLES, tableName);
+    recordRead(SYS_ACCESS_TABLE, tableName);
+    auto table = MemoryTableFactory2::openTable(tableName, authorityFlag, isPara);
+    if (!table)
+    {
+        return nullptr;
+    }
+    Operation operation;
+    operation.kind = Operation::Open;
+    operation.tableName = tableName;
+    operation.authorityFlag = authorityFlag;
+    operation.isPara = isPara;
+    operation.authorizedAddress = table->tableInfo()->authorizedAddress;
+    m_operations.push_back(operation);
+
+    auto speculativeTable = make_shared<SpeculativeTable>(table, this);
+    m_tables.insert(make_pair(tableName, speculativeTable));
+    return speculativeTable;
+}
+
+void SpeculativeTableFactory::rollback(size_t _savepoint)
+{
+    MemoryTableFactory2::rollback(_savepoint);
+    Operation operation;
+    operation.kind = Operation::Rollback;
+    operation.savepoint = _savepoint;
+    m_operations.push_back(operation);
+}
+
+void SpeculativeTableFactory::recordInsert(std::string const& _tableName, std::string const& _key,
+    Entry::Ptr _entry, AccessOptions::Ptr _options, int _result)
+{
+    Operation operation;
+    operation.kind = Operation::Insert;
+    operation.tableName = _tableName;
+    operation.key = _key;
+    operation.entry = _entry;
+    operation.options = _options;
+    operation.result = _result;
+    m_operations.push_back(operation);
+}
+
+void SpeculativeTableFactory::recordUpdate(std::string const& _tableName, std::string const& _key,
+    Entry::Ptr _entry, Condition::Ptr _condition, AccessOptions::Ptr _options, int _result)
+{
+    Operation operation;
+    operation.kind = Operation::Update;
+    operation.tableName = _tableName;
+    operation.key = _key;
+    operation.entry = _entry;
+    operation.condition = _condition;
+    operation.options = _options;
+    operation.result = _result;
+    m_operations.push_back(operation);
+}
+
+void SpeculativeTableFactory::recordRemove(std::string const& _tableName, std::string const& _key,
+    Condition::Ptr _condition, AccessOptions::Ptr _options, int _result)
+{
+    Operation operation;
+    operation.kind = Operation::Remove;
+    operation.tableName = _tableName;
+    operation.key = _key;
+    operation.condition = _condition;
+    operation.options = _options;
+    operation.result = _result;
+    m_operations.push_back(operation);
+}
+
+bool SpeculativeTableFactory::validate(
+    MemoryTableFactory2& _base, TableKeySet const& _writtenKeys) const
+{
+    for (auto& key : m_readKeys)
+    {
+        if (_writtenKeys.count(key))
+        {
+            return false;
+        }
+    }
+    // an open table is returned as it is, whatever the authority flag of the later opener
+    for (auto& operation : m_operations)
+    {
+        if (operation.kind != Operation::Open)
+        {
+            continue;
+        }
+        auto table = _base.openedTable(operation.tableName);
+        if (table && table->tableInfo()->authorizedAddress != operation.authorizedAddress)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SpeculativeTableFactory::apply(TableFactory& _base) const
+{
+    std::map<std::string, Table::Ptr> tables;
+    for (auto& operation : m_operations)
+    {
+        if (operation.kind == Operation::Open)
+        {
+            auto table =
+                _base.openTable(operation.tableName, operation.authorityFlag, operation.isPara);
+            if (!table)
+            {
+                BOOST_THROW_EXCEPTION(
+                    StorageException(-1, "replay open table failed: " + operation.tableName));
+            }
+            tables[operation.tableName] = table;
+            continue;
+        }
+        if (operation.kind == Operation::Rollback)
+        {
+            _base.rollback(operation.savepoint);
+            continue;
+        }
+
+        auto it = tables.find(operation.tableName);
+        if (it == tables.end())
+        {
+            BOOST_THROW_EXCEPTION(
+                StorageException(-1, "replay write to unopened table: " + operation.tableName));
+        }
+        int result = 0;
+        switch (operation.kind)
+        {
+        case Operation::Insert:
+            result = it->second->insert(operation.key, copyEntry(operation.entry),
+                make_shared<AccessOptions>(*operation.options));
+            break;
+        case Operation::Update:
+            result = it->second->update(operation.key, copyEntry(operation.entry),
+                copyCondition(operation.condition), make_shared<AccessOptions>(*operation.options));
+            break;
+        case Operation::Remove:
+            result = it->second->remove(operation.key, copyCondition(operation.condition),
+                make_shared<AccessOptions>(*operation.options));
+            break;
+        default:
+            break;
+        }
+        checkResult(result, operation.result, operation.tableName, operation.key);
+    }
+}
+
+Entries::ConstPtr SpeculativeTable::select(const std::string& key, Condition::Ptr condition)
+{
+    m_factory->recordRead(m_tableInfo->name, key);
+    return m_table->select(key, condition);
+}
+
+int SpeculativeTable::update(
+    const std::string& key, Entry::Ptr entry, Condition::Ptr condition, AccessOptions::Ptr options)
+{
+    m_factory->recordRead(m_tableInfo->name, key);
+    auto entryCopy = copyEntry(entry);
+    auto conditionCopy = copyCondition(condition);
+    auto result = m_table->update(key, entry, condition, options);
+    // a denied write changes nothing
+    if (result != CODE_NO_AUTHORIZED)
+    {
+        m_factory->recordUpdate(m_tableInfo->name, key, entryCopy, conditionCopy,
+            make_shared<AccessOptions>(*options), result);
+    }
+    return result;
+}
+
+int SpeculativeTable::insert(
+    const std::string& key, Entry::Ptr entry, AccessOptions::Ptr options, bool needSelect)
+{
+    auto entryCopy = copyEntry(entry);
+    auto result = m_table->insert(key, entry, options, needSelect);
+    if (result != CODE_NO_AUTHORIZED)
+    {
+        m_factory->recordInsert(
+            m_tableInfo->name, key, entryCopy, make_shared<AccessOptions>(*options), result);
+    }
+    return result;
+}
+
+int SpeculativeTable::remove(
+    const std::string& key, Condition::Ptr condition, AccessOptions::Ptr options)
+{
+    m_factory->recordRead(m_tableInfo->name, key);
+    auto conditionCopy = copyCondition(condition);
+    auto result = m_table->remove(key, condition, options);
+    if (result != CODE_NO_AUTHORIZED)
+    {
+        m_factory->recordRemove(m_tableInfo->name, key, conditionCopy,
+            make_shared<AccessOptions>(*options), result);
+    }
+    return result;
+}
@@ -0,0 +1,136 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+/** @file SpeculativeTableFactory.h
+ *
+ *  a transaction of a block runs speculatively on its own SpeculativeTableFactory, which reads the
+ *  state at the beginning of the block from the storage. The factory records the keys the
+ *  transaction reads and logs the tables it opens and the writes it makes, including the
+ *  rollbacks. If none of the keys read has been written by the transactions before it in the
+ *  block, the transaction reads the same rows on the factory of the block, so replaying the log on
+ *  that factory gives the same rows, change log and hash as executing the transaction on it
+ *
+ *  writes are replayed with copies of the entries and conditions taken when they are made, so a
+ *  caller must not change an entry after passing it to a table
+ */
+#pragma once
+
+#include "MemoryTableFactory2.h"
+#include <map>
+#include <vector>
+
+namespace dev
+{
+namespace storage
+{
+class SpeculativeTableFactory : public MemoryTableFactory2
+{
+public:
+    typedef std::shared_ptr<SpeculativeTableFactory> Ptr;
+
+    Table::Ptr openTable(
+        const std::string& tableName, bool authorityFlag = true, bool isPara = true) override;
+    void rollback(size_t _savepoint) override;
+
+    TableKeySet const& readKeys() const { return m_readKeys; }
+    // false if a key read has been written in _writtenKeys or a table opened is open in _base with
+    // other authorized addresses, the transaction must be executed again on _base
+    bool validate(MemoryTableFactory2& _base, TableKeySet const& _writtenKeys) const;
+    // replay the tables opened and the writes on _base, the change log of _base must be empty
+    void apply(TableFactory& _base) const;
+
+    // called by the tables of the factory
+    void recordRead(std::string const& _tableName, std::string const& _key)
+    {
+        m_readKeys.insert(std::make_pair(_tableName, _key));
+    }
+    void recordInsert(std::string const& _tableName, std::string const& _key, Entry::Ptr _entry,
+        AccessOptions::Ptr _options, int _result);
+    void recordUpdate(std::string const& _tableName, std::string const& _key, Entry::Ptr _entry,
+        Condition::Ptr _condition, AccessOptions::Ptr _options, int _result);
+    void recordRemove(std::string const& _tableName, std::string const& _key,
+        Condition::Ptr _condition, AccessOptions::Ptr _options, int _result);
+
+private:
+    struct Operation
+    {
+        enum Kind
+        {
+            Open,
+            Insert,
+            Update,
+            Remove,
+            Rollback
+        };
+        Kind kind;
+        std::string tableName;
+        // Open
+        bool authorityFlag = true;
+        bool isPara = true;
+        std::vector<Address> authorizedAddress;
+        // Insert, Update and Remove
+        std::string key;
+        Entry::Ptr entry;
+        Condition::Ptr condition;
+        AccessOptions::Ptr options;
+        int result = 0;
+        // Rollback
+        size_t savepoint = 0;
+    };
+
+    std::map<std::string, Table::Ptr> m_tables;
+    TableKeySet m_readKeys;
+    std::vector<Operation> m_operations;
+};
+
+// the table returned by SpeculativeTableFactory, records the accesses of a MemoryTable2
+class SpeculativeTable : public Table
+{
+public:
+    SpeculativeTable(Table::Ptr _table, SpeculativeTableFactory* _factory)
+      : m_table(_table), m_factory(_factory)
+    {
+        m_tableInfo = _table->tableInfo();
+    }
+
+    Entry::Ptr newEntry() override { return m_table->newEntry(); }
+    Condition::Ptr newCondition() override { return m_table->newCondition(); }
+    Entries::ConstPtr select(const std::string& key, Condition::Ptr condition) override;
+    int update(const std::string& key, Entry::Ptr entry, Condition::Ptr condition,
+        AccessOptions::Ptr options = std::make_shared<AccessOptions>()) override;
+    int insert(const std::string& key, Entry::Ptr entry,
+        AccessOptions::Ptr options = std::make_shared<AccessOptions>(),
+        bool needSelect = true) override;
+    int remove(const std::string& key, Condition::Ptr condition,
+        AccessOptions::Ptr options = std::make_shared<AccessOptions>()) override;
+    bool checkAuthority(Address const& _origin) const override
+    {
+        return m_table->checkAuthority(_origin);
+    }
+    h256 hash() override { return m_table->hash(); }
+    void clear() override { m_table->clear(); }
+    dev::storage::TableData::Ptr dump() override { return m_table->dump(); }
+    void rollback(const Change& _change) override { m_table->rollback(_change); }
+    bool empty() override { return m_table->empty(); }
+
+private:
+    Table::Ptr m_table;
+    // the factory owns the table
+    SpeculativeTableFactory* m_factory;
+};
+
+}  // namespace storage
+}  // namespace dev
@@ -0,0 +1,498 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+/** @file StateSnapshot.cpp
+ */
+
+#include "StateSnapshot.h"
+#include "Common.h"
+#include "RowCodec.h"
+#include "StorageException.h"
+#include <libdevcore/RLP.h>
+#include <libdevcrypto/Hash.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include <set>
+
+using namespace std;
+using namespace dev;
+using namespace dev::storage;
+
+namespace
+{
+const string SNAPSHOT_IMPORT_KEY = string(1, MARKER_KEY_PREFIX) + "snapshot_import";
+const string CURRENT_NUMBER_KEY = SYS_CURRENT_STATE + "_" + SYS_KEY_CURRENT_NUMBER;
+
+// the value field of the first row of a system table key, empty if not found
+string systemValue(
+    shared_ptr<BasicRocksDB> _db, rocksdb::ReadOptions const& _options, string const& _key)
+{
+    string value;
+    _db->Get(_options, _key, value);
+    Rows rows;
+    decodeRows(value, rows);
+    for (auto const& row : rows)
+    {
+        auto it = row.find(SYS_VALUE);
+        if (it != row.end())
+        {
+            return it->second;
+        }
+    }
+    return "";
+}
+
+bytes encodeChunk(vector<pair<string, string>> const& _rows)
+{
+    RLPStream s(_rows.size());
+    for (auto const& row : _rows)
+    {
+        s.appendList(2) << row.first << row.second;
+    }
+    return s.out();
+}
+}  // namespace
+
+bytes SnapshotManifest::encode() const
+{
+    RLPStream s(3);
+    s << number << blockHash;
+    s.appendList(chunks.size());
+    for (auto const& chunk : chunks)
+    {
+        s.appendList(5) << chunk.begin << chunk.end << chunk.keys << chunk.size << chunk.hash;
+    }
+    return s.out();
+}
+
+SnapshotManifest::Ptr SnapshotManifest::decode(bytesConstRef _data)
+{
+    auto manifest = make_shared<SnapshotManifest>();
+    try
+    {
+        RLP rlp(_data);
+        if (!rlp.isList() || rlp.itemCount() != 3)
+        {
+            BOOST_THROW_EXCEPTION(StorageException(-1, "invalid snapshot manifest"));
+        }
+        manifest->number = rlp[0].toInt<int64_t>();
+        manifest->blockHash = rlp[1].toHash<h256>();
+        for (auto const& item : rlp[2])
+        {
+            if (item.itemCount() != 5)
+            {
+                BOOST_THROW_EXCEPTION(StorageException(-1, "invalid snapshot chunk"));
+            }
+            SnapshotChunk chunk;
+            chunk.begin = item[0].toString();
+            chunk.end = item[1].toString();
+            chunk.keys = item[2].toInt<uint64_t>();
+            chunk.size = item[3].toInt<uint64_t>();
+            chunk.hash = item[4].toHash<h256>();
+            manifest->chunks.push_back(chunk);
+        }
+    }
+    catch (StorageException const&)
+    {
+        throw;
+    }
+    catch (std::exception const& e)
+    {
+        BOOST_THROW_EXCEPTION(
+            StorageException(-1, string("invalid snapshot manifest: ") + e.what()));
+    }
+
+    auto const& chunks = manifest->chunks;
+    if (manifest->number <= 0 || chunks.empty() || !chunks.back().end.empty())
+    {
+        BOOST_THROW_EXCEPTION(StorageException(-1, "invalid snapshot manifest: no chunk"));
+    }
+    for (size_t i = 0; i + 1 < chunks.size(); ++i)
+    {
+        if (chunks[i].end.empty() || chunks[i].end <= chunks[i].begin ||
+            chunks[i].end != chunks[i + 1].begin)
+        {
+            BOOST_THROW_EXCEPTION(
+                StorageException(-1, "invalid snapshot manifest: chunks are not adjacent"));
+        }
+    }
+    return manifest;
+}
+
+h256 SnapshotManifest::hash() const
+{
+    return sha3(encode());
+}
+
+uint64_t SnapshotManifest::size() const
+{
+    uint64_t size = 0;
+    for (auto const& chunk : chunks)
+    {
+        size += chunk.size;
+    }
+    return size;
+}
+
+int64_t StateSnapshotExporter::currentNumber(
+    shared_ptr<BasicRocksDB> _db, rocksdb::ReadOptions const& _options)
+{
+    auto value = systemValue(_db, _options, CURRENT_NUMBER_KEY);
+    return value.empty() ? -1 : boost::lexical_cast<int64_t>(value);
+}
+
+bool StateSnapshotExporter::exportValue(
+    string const& _key, string& _value, int64_t _pruneNumber)
+{
+    if (isIndexKey(_key))
+    {  // rebuilt by the importer
+        return false;
+    }
+    string pruned;
+    if (!RowPruner::prune(_key, _value, _pruneNumber, pruned))
+    {
+        return true;
+    }
+    _value = move(pruned);
+    return !_value.empty();
+}
+
+SnapshotManifest::Ptr StateSnapshotExporter::prepare()
+{
+    // pinned before anything is read, compaction never drops what the snapshot exports
+    auto pruneNumber = m_pruner ? m_pruner->pin() : int64_t(-1);
+    try
+    {
+        return doPrepare(pruneNumber);
+    }
+    catch (...)
+    {
+        if (m_pruner)
+        {
+            m_pruner->unpin();
+        }
+        throw;
+    }
+}
+
+SnapshotManifest::Ptr StateSnapshotExporter::doPrepare(int64_t _pruneNumber)
+{
+    auto start = utcTime();
+    auto snapshot = m_db->GetSnapshot();
+    rocksdb::ReadOptions options;
+    options.snapshot = snapshot.get();
+
+    auto manifest = make_shared<SnapshotManifest>();
+    manifest->number = currentNumber(m_db, options);
+    if (manifest->number <= 0)
+    {
+        BOOST_THROW_EXCEPTION(StorageException(-1, "no block to export"));
+    }
+    manifest->blockHash = h256(systemValue(
+        m_db, options, SYS_NUMBER_2_HASH + "_" + to_string(manifest->number)));
+
+    vector<pair<string, string>> rows;
+    size_t size = 0;
+    auto addChunk = [&](string const& _end) {
+        SnapshotChunk chunk;
+        auto data = encodeChunk(rows);
+        chunk.begin = rows.front().first;
+        chunk.end = _end;
+        chunk.keys = rows.size();
+        chunk.size = data.size();
+        chunk.hash = sha3(data);
+        manifest->chunks.push_back(chunk);
+        rows.clear();
+        size = 0;
+    };
+    // the index keys sort before all other keys
+    m_db->Scan(options, string(1, MARKER_KEY_PREFIX), "", [&](string const& _key, string& _value) {
+        if (!exportValue(_key, _value, _pruneNumber))
+        {
+            return true;
+        }
+        if (size >= m_chunkSize)
+        {
+            addChunk(_key);
+        }
+        size += _key.size() + _value.size();
+        rows.emplace_back(_key, move(_value));
+        return true;
+    });
+    if (!rows.empty())
+    {
+        addChunk("");
+    }
+
+    {
+        lock_guard<mutex> lock(m_mutex);
+        if (m_pinned)
+        {  // the previous snapshot
+            m_pruner->unpin();
+        }
+        m_pinned = bool(m_pruner);
+        m_pruneNumber = _pruneNumber;
+        m_snapshot = snapshot;
+        m_manifest = manifest;
+        m_manifestHash = manifest->hash();
+    }
+    STORAGE_LOG(INFO) << LOG_BADGE("StateSnapshot") << LOG_DESC("prepare snapshot")
+                      << LOG_KV("number", manifest->number)
+                      << LOG_KV("blockHash", manifest->blockHash.abridged())
+                      << LOG_KV("chunks", manifest->chunks.size())
+                      << LOG_KV("size", manifest->size()) << LOG_KV("timeCost", utcTime() - start);
+    return manifest;
+}
+
+SnapshotManifest::Ptr StateSnapshotExporter::manifest()
+{
+    lock_guard<mutex> lock(m_mutex);
+    return m_manifest;
+}
+
+shared_ptr<bytes> StateSnapshotExporter::chunk(h256 const& _manifestHash, size_t _index)
+{
+    shared_ptr<const rocksdb::Snapshot> snapshot;
+    SnapshotChunk chunk;
+    int64_t pruneNumber = -1;
+    {
+        lock_guard<mutex> lock(m_mutex);
+        if (!m_manifest || m_manifestHash != _manifestHash || _index >= m_manifest->chunks.size())
+        {
+            return nullptr;
+        }
+        snapshot = m_snapshot;
+        chunk = m_manifest->chunks[_index];
+        pruneNumber = m_pruneNumber;
+    }
+
+    rocksdb::ReadOptions options;
+    options.snapshot = snapshot.get();
+    vector<pair<string, string>> rows;
+    rows.reserve(chunk.keys);
+    m_db->Scan(options, chunk.begin, chunk.end, [&](string const& _key, string& _value) {
+        if (exportValue(_key, _value, pruneNumber))
+        {
+            rows.emplace_back(_key, move(_value));
+        }
+        return true;
+    });
+    return make_shared<bytes>(encodeChunk(rows));
+}
+
+void StateSnapshotExporter::release()
+{
+    lock_guard<mutex> lock(m_mutex);
+    if (m_pinned)
+    {
+        m_pruner->unpin();
+        m_pinned = false;
+    }
+    m_pruneNumber = -1;
+    m_snapshot.reset();
+    m_manifest.reset();
+    m_manifestHash = h256();
+}
+
+void StateSnapshotImporter::begin(SnapshotManifest const& _manifest)
+{
+    rocksdb::WriteBatch batch;
+    auto value = _manifest.hash().hex();
+    m_db->Put(batch, SNAPSHOT_IMPORT_KEY, value);
+    rocksdb::WriteOptions options;
+    options.sync = true;
+    m_db->Write(options, batch);
+    lock_guard<mutex> lock(m_mutex);
+    m_firstKey = _manifest.chunks.empty() ? "" : _manifest.chunks.front().begin;
+    m_currentNumber.clear();
+}
+
+void StateSnapshotImporter::deleteStaleKeys(rocksdb::WriteBatch& _batch, string const& _begin,
+    string const& _end, set<string> const& _keys)
+{
+    m_db->Scan(rocksdb::ReadOptions(), _begin, _end, [&](string const& _key, string&) {
+        if (_key != SNAPSHOT_IMPORT_KEY && _key != CURRENT_NUMBER_KEY && !_keys.count(_key))
+        {
+            _batch.Delete(_key);
+        }
+        return true;
+    });
+}
+
+bool StateSnapshotImporter::importChunk(SnapshotChunk const& _chunk, bytesConstRef _data)
+{
+    if (sha3(_data) != _chunk.hash)
+    {
+        STORAGE_LOG(WARNING) << LOG_BADGE("StateSnapshot") << LOG_DESC("chunk hash mismatch")
+                             << LOG_KV("expected", _chunk.hash.abridged());
+        return false;
+    }
+    rocksdb::WriteBatch batch;
+    string currentNumber;
+    set<string> keys;
+    try
+    {
+        RLP rlp(_data);
+        if (!rlp.isList() || rlp.itemCount() != _chunk.keys)
+        {
+            return false;
+        }
+        for (auto const& item : rlp)
+        {
+            if (item.itemCount() != 2)
+            {
+                return false;
+            }
+            auto key = item[0].toString();
+            auto value = item[1].toString();
+            if (key < _chunk.begin || (!_chunk.end.empty() && key >= _chunk.end) ||
+                key == SNAPSHOT_IMPORT_KEY || isIndexKey(key))
+            {
+                return false;
+            }
+            if (key == CURRENT_NUMBER_KEY)
+            {  // written by finish
+                currentNumber = value;
+                continue;
+            }
+            m_db->Put(batch, key, value);
+            keys.insert(move(key));
+        }
+    }
+    catch (std::exception const& e)
+    {
+        STORAGE_LOG(WARNING) << LOG_BADGE("StateSnapshot") << LOG_DESC("invalid chunk")
+                             << LOG_KV("error", e.what());
+        return false;
+    }
+    // the range of the chunk ends up with exactly the keys of the snapshot
+    deleteStaleKeys(batch, _chunk.begin, _chunk.end, keys);
+    m_db->Write(rocksdb::WriteOptions(), batch);
+    if (!currentNumber.empty())
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_currentNumber = currentNumber;
+    }
+    return true;
+}
+
+void StateSnapshotImporter::finish()
+{
+    string currentNumber;
+    string firstKey;
+    {
+        lock_guard<mutex> lock(m_mutex);
+        currentNumber = m_currentNumber;
+        firstKey = m_firstKey;
+    }
+    if (currentNumber.empty())
+    {
+        BOOST_THROW_EXCEPTION(StorageException(-1, "the snapshot has no current number"));
+    }
+    rocksdb::WriteBatch batch;
+    if (!firstKey.empty())
+    {  // the keys before the first chunk, including the index keys of the old state
+        deleteStaleKeys(batch, "", firstKey, set<string>());
+        m_db->Write(rocksdb::WriteOptions(), batch);
+        batch.Clear();
+    }
+    // the import is redone if the node stops before the mark is removed
+    rebuildIndices();
+    m_db->Put(batch, CURRENT_NUMBER_KEY, currentNumber);
+    batch.Delete(SNAPSHOT_IMPORT_KEY);
+    rocksdb::WriteOptions options;
+    options.sync = true;
+    m_db->Write(options, batch);
+    STORAGE_LOG(INFO) << LOG_BADGE("StateSnapshot") << LOG_DESC("import finished");
+}
+
+void StateSnapshotImporter::rebuildIndices()
+{
+    vector<TableInfo::Ptr> tables;
+    auto sysPrefix = SYS_TABLES + "_";
+    // '`' is the byte after '_', see RocksDBStorage::scan
+    m_db->Scan(rocksdb::ReadOptions(), sysPrefix, SYS_TABLES + "`",
+        [&](string const& _key, string& _value) {
+            Rows rows;
+            decodeRows(_value, rows);
+            for (auto const& row : rows)
+            {
+                auto status = row.find(STATUS);
+                auto name = row.find("table_name");
+                auto keyField = row.find("key_field");
+                auto indexField = row.find("index_field");
+                if ((status != row.end() && status->second != "0") || name == row.end() ||
+                    name->second != _key.substr(sysPrefix.size()) || keyField == row.end() ||
+                    indexField == row.end() || indexField->second.empty())
+                {
+                    continue;
+                }
+                auto tableInfo = make_shared<TableInfo>();
+                tableInfo->name = name->second;
+                tableInfo->key = keyField->second;
+                boost::split(tableInfo->indices, indexField->second, boost::is_any_of(","));
+                tables.push_back(tableInfo);
+            }
+            return true;
+        });
+
+    size_t indexKeys = 0;
+    rocksdb::WriteBatch batch;
+    for (auto const& tableInfo : tables)
+    {
+        auto prefix = tableInfo->name + "_";
+        m_db->Scan(rocksdb::ReadOptions(), prefix, tableInfo->name + "`",
+            [&](string const& _key, string& _value) {
+                auto key = _key.substr(prefix.size());
+                Rows rows;
+                decodeRows(_value, rows);
+                for (auto const& row : rows)
+                {
+                    // tables whose name starts with this prefix share the key space
+                    auto keyField = row.find(tableInfo->key);
+                    if (keyField == row.end() || keyField->second != key)
+                    {
+                        continue;
+                    }
+                    // the same value as RocksDBStorage::updateIndices writes
+                    string value;
+                    encodeRows(Rows{row}, value, RowFormat::V1);
+                    for (auto const& indexKey : rowIndexKeys(tableInfo, key, row))
+                    {
+                        auto indexValue = value;
+                        m_db->Put(batch, indexKey, indexValue);
+                        ++indexKeys;
+                    }
+                }
+                if (batch.Count() >= c_indexBatchSize)
+                {
+                    m_db->Write(rocksdb::WriteOptions(), batch);
+                    batch.Clear();
+                }
+                return true;
+            });
+    }
+    m_db->Write(rocksdb::WriteOptions(), batch);
+    STORAGE_LOG(INFO) << LOG_BADGE("StateSnapshot") << LOG_DESC("rebuild indices")
+                      << LOG_KV("tables", tables.size()) << LOG_KV("indexKeys", indexKeys);
+}
+
+bool StateSnapshotImporter::unfinished(shared_ptr<BasicRocksDB> _db)
+{
+    string value;
+    _db->Get(rocksdb::ReadOptions(), SNAPSHOT_IMPORT_KEY, value);
+    return !value.empty();
+}
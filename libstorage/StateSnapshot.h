@@ -0,0 +1,154 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+/** @file StateSnapshot.h
+ *
+ *  export and import the rows of a RocksDBStorage at block N, the index keys are derived from
+ *  the rows, they are not exported and the importer rebuilds them in finish()
+ *
+ *  the exporter reads a rocksdb snapshot, so the exported keys are consistent at the block
+ *  recorded in _sys_current_state_ of the same snapshot. The key space is split into chunks of
+ *  about chunkSize bytes, the manifest lists the key range and sha3 of every chunk:
+ *  manifest: RLP[number, blockHash, [[begin, end, keys, size, hash]...]]
+ *  chunk:    RLP[[key, value]...], values are plain text even if disk encryption is enabled
+ *
+ *  the importer verifies every chunk against the manifest and writes chunks in any order from any
+ *  thread, local keys that are not in the snapshot are deleted range by range, so the db is not
+ *  cleared up front and keeps serving the genesis block during the import. The current number is
+ *  held back until finish(), and a marker key is kept in the db during the import, so a crashed
+ *  import is never taken as a synced state
+ */
+#pragma once
+
+#include "BasicRocksDB.h"
+#include "RowPruner.h"
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace dev
+{
+namespace storage
+{
+struct SnapshotChunk
+{
+    std::string begin;  // the first key of the chunk
+    std::string end;    // the first key after the chunk, empty for the last chunk
+    uint64_t keys = 0;
+    uint64_t size = 0;  // bytes of the encoded chunk
+    h256 hash;          // sha3 of the encoded chunk
+};
+
+struct SnapshotManifest
+{
+    using Ptr = std::shared_ptr<SnapshotManifest>;
+
+    int64_t number = 0;
+    h256 blockHash;
+    std::vector<SnapshotChunk> chunks;
+
+    bytes encode() const;
+    // throw StorageException if the manifest is malformed, or chunks are not adjacent
+    static Ptr decode(bytesConstRef _data);
+    h256 hash() const;
+    uint64_t size() const;
+};
+
+class StateSnapshotExporter
+{
+public:
+    using Ptr = std::shared_ptr<StateSnapshotExporter>;
+
+    StateSnapshotExporter(std::shared_ptr<BasicRocksDB> _db, size_t _chunkSize = 512 * 1024)
+      : m_db(_db), m_chunkSize(_chunkSize)
+    {}
+    ~StateSnapshotExporter() { release(); }
+
+    // the pruner of the compaction filter of the db, the prune number is pinned while a snapshot
+    // is held and exported rows are pruned with it, so chunks read later match the manifest
+    void setRowPruner(RowPruner::Ptr _pruner) { m_pruner = _pruner; }
+
+    // take a new snapshot and split it into chunks, the previous snapshot is released
+    SnapshotManifest::Ptr prepare();
+    // the manifest of the current snapshot, nullptr if no snapshot is prepared
+    SnapshotManifest::Ptr manifest();
+    // the encoded chunk of the snapshot whose manifest hash is _manifestHash,
+    // nullptr if the snapshot has been released or _index is out of range
+    std::shared_ptr<bytes> chunk(h256 const& _manifestHash, size_t _index);
+    // release the snapshot, so rocksdb can compact the old versions
+    void release();
+
+    // the block number stored in the table _sys_current_state_, -1 if not found
+    static int64_t currentNumber(
+        std::shared_ptr<BasicRocksDB> _db, rocksdb::ReadOptions const& _options);
+
+private:
+    SnapshotManifest::Ptr doPrepare(int64_t _pruneNumber);
+    // drop the tombstones of _value pruned by _pruneNumber
+    // @return false if all rows of _key are dropped, the key is not exported
+    static bool exportValue(std::string const& _key, std::string& _value, int64_t _pruneNumber);
+
+    std::shared_ptr<BasicRocksDB> m_db;
+    size_t m_chunkSize;
+    RowPruner::Ptr m_pruner;
+
+    std::mutex m_mutex;
+    std::shared_ptr<const rocksdb::Snapshot> m_snapshot;
+    SnapshotManifest::Ptr m_manifest;
+    h256 m_manifestHash;
+    bool m_pinned = false;
+    int64_t m_pruneNumber = -1;
+};
+
+class StateSnapshotImporter
+{
+public:
+    using Ptr = std::shared_ptr<StateSnapshotImporter>;
+
+    StateSnapshotImporter(std::shared_ptr<BasicRocksDB> _db) : m_db(_db) {}
+
+    // mark the db as being imported
+    void begin(SnapshotManifest const& _manifest);
+    // verify and write the chunk, thread safe
+    // @return false if the chunk does not match its hash in the manifest or is malformed
+    bool importChunk(SnapshotChunk const& _chunk, bytesConstRef _data);
+    // rebuild the indices, write the current number and remove the mark, all chunks must have
+    // been imported
+    void finish();
+
+    // whether the db has an import that was not finished
+    static bool unfinished(std::shared_ptr<BasicRocksDB> _db);
+
+private:
+    void deleteStaleKeys(rocksdb::WriteBatch& _batch, std::string const& _begin,
+        std::string const& _end, std::set<std::string> const& _keys);
+    // index keys are not in the snapshot, write them from the rows of the tables with indices
+    void rebuildIndices();
+
+    static const int c_indexBatchSize = 10000;
+
+    std::shared_ptr<BasicRocksDB> m_db;
+    std::mutex m_mutex;
+    std::string m_firstKey;
+    std::string m_currentNumber;
+};
+
+}  // namespace storage
+}  // namespace dev
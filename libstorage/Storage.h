@@ -20,6 +20,7 @@
  */
 #pragma once
 
+#include "StorageException.h"
 #include "Table.h"
 #include <libdevcore/FixedHash.h>
 #include <libethcore/Protocol.h>
@@ -28,6 +29,54 @@ namespace dev
 {
 namespace storage
 {
+typedef std::vector<std::pair<TableInfo::Ptr, std::string>> TableKeys;
+
+// keys of a table in [begin, end), the empty end means no upper bound
+// keys are strings compared bytewise, numeric keys are not in numeric order ("10" < "9"), keys
+// must be zero padded to the same width to range scan them in numeric order
+struct KeyRange
+{
+    KeyRange() = default;
+    KeyRange(std::string const& _begin, std::string const& _end) : begin(_begin), end(_end) {}
+
+    // the range only contains _key
+    static KeyRange single(std::string const& _key) { return KeyRange(_key, _key + '\0'); }
+    bool isSingle() const
+    {
+        return end.size() == begin.size() + 1 && end.back() == '\0' &&
+               end.compare(0, begin.size(), begin) == 0;
+    }
+
+    std::string begin;
+    std::string end;
+};
+
+// find the first index of the table that the condition matches with EQ
+// the index is ordered bytewise, the numeric GT/GE/LT/LE of Condition are never answered by it
+inline bool findIndex(TableInfo::Ptr _tableInfo, Condition::Ptr _condition, std::string& _field,
+    std::string& _value)
+{
+    if (!_condition)
+    {
+        return false;
+    }
+    for (auto const& index : _tableInfo->indices)
+    {
+        for (auto it = _condition->begin(); it != _condition->end(); ++it)
+        {
+            auto const& range = it->second;
+            if (it->first == index && range.left.first && range.right.first &&
+                range.left.second == range.right.second)
+            {
+                _field = index;
+                _value = range.left.second;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 class Storage : public std::enable_shared_from_this<Storage>
 {
 public:
@@ -38,6 +87,44 @@ public:
     virtual Entries::Ptr select(int64_t num, TableInfo::Ptr tableInfo, const std::string& key,
         Condition::Ptr condition = nullptr) = 0;
     virtual size_t commit(int64_t num, const std::vector<TableData::Ptr>& datas) = 0;
+    // select all rows of every key, the result is in the same order as keys
+    virtual std::vector<Entries::Ptr> selectBatch(int64_t num, const TableKeys& keys)
+    {
+        std::vector<Entries::Ptr> result;
+        result.reserve(keys.size());
+        for (auto const& key : keys)
+        {
+            auto condition = std::make_shared<Condition>();
+            condition->EQ(key.first->key, key.second);
+            result.push_back(select(num, key.first, key.second, condition));
+        }
+        return result;
+    }
+    // select rows of keys in range which match the condition, ordered by key and then by ID,
+    // at most limit rows are returned if limit is not 0, only single key ranges are supported
+    // by default
+    virtual Entries::Ptr scan(int64_t num, TableInfo::Ptr tableInfo, const KeyRange& range,
+        Condition::Ptr condition, size_t limit = 0)
+    {
+        if (!range.isSingle())
+        {
+            BOOST_THROW_EXCEPTION(StorageException(-1, "Range scan is not supported"));
+        }
+        auto entries = select(num, tableInfo, range.begin, condition);
+        if (entries && limit > 0 && entries->size() > limit)
+        {
+            entries->resize(limit);
+        }
+        return entries;
+    }
+    // load keys that will be touched soon into the cache, only work for cached storage
+    virtual void prefetch(int64_t, const TableKeys&) {}
+    // split the commit of block num in two parts, the first commit(num) is visible at once and
+    // the second commit(num) persists both parts together, return false if not supported
+    virtual bool deferCommit(int64_t) { return false; }
+    // give up the deferred commit of block num if its second part never comes, the first part
+    // committed is persisted alone
+    virtual void cancelDefer(int64_t) {}
     // Dicide if CachedStorage can commit modified part of Entries
     virtual bool onlyCommitDirty() { return false; };
 
@@ -34,6 +34,7 @@
 #include <tbb/pipeline.h>
 #include <tbb/tbb_thread.h>
 #include <boost/lexical_cast.hpp>
+#include <algorithm>
 
 using namespace dev::storage;
 using namespace std;
@@ -78,11 +79,47 @@ void Entry::setID(const std::string& id)
     m_dirty = true;
 }
 
+Entry::Fields::iterator Entry::findField(const std::string& key) const
+{
+    auto it = std::lower_bound(m_data->m_fields.begin(), m_data->m_fields.end(), key,
+        [](const Fields::value_type& field, const std::string& name) {
+            return field.first < name;
+        });
+    if (it != m_data->m_fields.end() && it->first == key)
+    {
+        return it;
+    }
+    return m_data->m_fields.end();
+}
+
+void Entry::setFieldValue(const std::string& key, const char* value, size_t size)
+{
+    auto& fields = m_data->m_fields;
+    auto it = std::lower_bound(fields.begin(), fields.end(), key,
+        [](const Fields::value_type& field, const std::string& name) {
+            return field.first < name;
+        });
+
+    if (it != fields.end() && it->first == key)
+    {
+        m_capacity -= (key.size() + it->second.size());
+        it->second.assign(value, size);
+    }
+    else
+    {
+        fields.emplace(it, key, std::string(value, size));
+    }
+    m_capacity += (key.size() + size);
+
+    assert(m_capacity >= 0);
+    m_dirty = true;
+}
+
 dev::bytesConstRef Entry::getFieldConst(const std::string& key) const
 {
     RWMutexScoped lock(m_data->m_mutex, false);
 
-    auto it = m_data->m_fields.find(key);
+    auto it = findField(key);
 
     if (it != m_data->m_fields.end())
     {
@@ -97,7 +134,7 @@ std::string Entry::getField(const std::string& key) const
 {
     RWMutexScoped lock(m_data->m_mutex, false);
 
-    auto it = m_data->m_fields.find(key);
+    auto it = findField(key);
 
     if (it != m_data->m_fields.end())
     {
@@ -112,7 +149,7 @@ vector<byte> Entry::getFieldBytes(const std::string& key) const
 {
     RWMutexScoped lock(m_data->m_mutex, false);
 
-    auto it = m_data->m_fields.find(key);
+    auto it = findField(key);
 
     if (it != m_data->m_fields.end())
     {
@@ -128,45 +165,21 @@ void Entry::setField(const std::string& key, const std::string& value)
 {
     auto lock = checkRef();
 
-    auto it = m_data->m_fields.find(key);
-
-    if (it != m_data->m_fields.end())
-    {
-        m_capacity -= (key.size() + it->second.size());
-        it->second = value;
-        m_capacity += (key.size() + value.size());
-    }
-    else
-    {
-        m_data->m_fields.insert(std::make_pair(key, value));
-        m_capacity += (key.size() + value.size());
-    }
-
-    assert(m_capacity >= 0);
-    m_dirty = true;
+    setFieldValue(key, value.data(), value.size());
 }
 
 void Entry::setField(const std::string& key, const byte* value, size_t size)
 {
     auto lock = checkRef();
 
-    auto it = m_data->m_fields.find(key);
+    setFieldValue(key, (const char*)value, size);
+}
 
-    if (it != m_data->m_fields.end())
-    {
-        m_capacity -= (key.size() + it->second.size());
-        it->second.assign((char*)value, (char*)value + size);
-        m_capacity += (key.size() + size);
-    }
-    else
-    {
-        m_data->m_fields.emplace(key, std::string((char*)value, size));
-        // m_data->m_fields.insert(std::make_pair(key, std::string(value, size)));
-        m_capacity += (key.size() + size);
-    }
+void Entry::reserveFields(size_t count)
+{
+    auto lock = checkRef();
 
-    assert(m_capacity >= 0);
-    m_dirty = true;
+    m_data->m_fields.reserve(count);
 }
 
 size_t Entry::getTempIndex() const
@@ -183,17 +196,17 @@ void Entry::setTempIndex(size_t index)
     m_tempIndex = index;
 }
 
-std::map<std::string, std::string>::const_iterator Entry::find(const std::string& key) const
+Entry::Fields::const_iterator Entry::find(const std::string& key) const
 {
-    return m_data->m_fields.find(key);
+    return findField(key);
 }
 
-std::map<std::string, std::string>::const_iterator Entry::begin() const
+Entry::Fields::const_iterator Entry::begin() const
 {
     return m_data->m_fields.begin();
 }
 
-std::map<std::string, std::string>::const_iterator Entry::end() const
+Entry::Fields::const_iterator Entry::end() const
 {
     return m_data->m_fields.end();
 }
@@ -714,7 +727,7 @@ bool Condition::process(Entry::Ptr entry)
 
         if (!m_conditions.empty())
         {
-            for (auto it : m_conditions)
+            for (auto const& it : m_conditions)
             {
                 if (!isHashField(it.first))
                 {
@@ -844,7 +857,7 @@ TableInfo::Ptr dev::storage::getSysTableInfo(const string& tableName)
     else if (tableName == SYS_TABLES)
     {
         tableInfo->key = "table_name";
-        tableInfo->fields = vector<string>{"key_field", "value_field"};
+        tableInfo->fields = vector<string>{"key_field", "value_field", "index_field"};
     }
     else if (tableName == SYS_ACCESS_TABLE)
     {
@@ -19,6 +19,7 @@
 
 #include "Common.h"
 #include <libdevcore/Address.h>
+#include <libdevcore/Arena.h>
 #include <libdevcore/FixedHash.h>
 #include <libdevcore/Guards.h>
 #include <tbb/concurrent_unordered_map.h>
@@ -60,6 +61,11 @@ struct AccessOptions : public std::enable_shared_from_this<AccessOptions>
 
 class Entry : public std::enable_shared_from_this<Entry>
 {
+public:
+    // fields sorted by name, a row only has a few fields, so a flat vector is smaller and faster
+    // than a map, and most field names fit in the small string buffer of std::string
+    typedef std::vector<std::pair<std::string, std::string>> Fields;
+
 private:
     typedef tbb::spin_rw_mutex RWMutex;
     typedef tbb::spin_rw_mutex::scoped_lock RWMutexScoped;
@@ -71,10 +77,13 @@ private:
         EntryData(){};
 
         ssize_t m_refCount = 0;
-        std::map<std::string, std::string> m_fields;
+        Fields m_fields;
         RWMutex m_mutex;
     };
 
+    Fields::iterator findField(const std::string& key) const;
+    void setFieldValue(const std::string& key, const char* value, size_t size);
+
     std::shared_ptr<RWMutexScoped> checkRef();
 
     uint64_t m_ID = 0;
@@ -111,14 +120,16 @@ public:
 
     virtual void setField(const std::string& key, const std::string& value);
     virtual void setField(const std::string& key, const byte* value, size_t size);
+    // reserve the slots of a row decoded field by field, so the fields are not moved on growth
+    virtual void reserveFields(size_t count);
 
     virtual size_t getTempIndex() const;
     virtual void setTempIndex(size_t index);
 
-    virtual std::map<std::string, std::string>::const_iterator find(const std::string& key) const;
+    virtual Fields::const_iterator find(const std::string& key) const;
 
-    virtual std::map<std::string, std::string>::const_iterator begin() const;
-    virtual std::map<std::string, std::string>::const_iterator end() const;
+    virtual Fields::const_iterator begin() const;
+    virtual Fields::const_iterator end() const;
 
     virtual size_t size() const;
 
@@ -321,8 +332,8 @@ public:
 
     virtual ~Table() = default;
 
-    virtual Entry::Ptr newEntry() { return std::make_shared<Entry>(); }
-    virtual Condition::Ptr newCondition() { return std::make_shared<Condition>(); }
+    virtual Entry::Ptr newEntry() { return allocateShared<Entry>(m_arena); }
+    virtual Condition::Ptr newCondition() { return allocateShared<Condition>(m_arena); }
     virtual Entries::ConstPtr select(const std::string& key, Condition::Ptr condition) = 0;
     virtual int update(const std::string& key, Entry::Ptr entry, Condition::Ptr condition,
         AccessOptions::Ptr options = std::make_shared<AccessOptions>()) = 0;
@@ -330,6 +341,17 @@ public:
         AccessOptions::Ptr options = std::make_shared<AccessOptions>(), bool needSelect = true) = 0;
     virtual int remove(const std::string& key, Condition::Ptr condition,
         AccessOptions::Ptr options = std::make_shared<AccessOptions>()) = 0;
+    // update all rows of the key, or insert the entry if the key has no row
+    virtual int upsert(const std::string& key, Entry::Ptr entry,
+        AccessOptions::Ptr options = std::make_shared<AccessOptions>())
+    {
+        auto entries = select(key, newCondition());
+        if (entries->size() == 0u)
+        {
+            return insert(key, entry, options);
+        }
+        return update(key, entry, newCondition(), options);
+    }
     virtual bool checkAuthority(Address const& _origin) const = 0;
     virtual h256 hash() = 0;
     virtual void clear() = 0;
@@ -350,6 +372,8 @@ public:
     virtual TableInfo::Ptr tableInfo() { return m_tableInfo; }
     virtual void setTableInfo(TableInfo::Ptr tableInfo) { m_tableInfo = tableInfo; }
     virtual size_t cacheSize() { return 0; }
+    // the new entries, conditions and selected entries are allocated from _arena
+    void setArena(Arena::Ptr _arena) { m_arena = _arena; }
 
 protected:
     std::function<void(Ptr, Change::Kind, std::string const&, std::vector<Change::Record>&)>
@@ -358,6 +382,7 @@ protected:
     TableInfo::Ptr m_tableInfo;
     h256 m_blockHash;
     int64_t m_blockNum = 0;
+    Arena::Ptr m_arena;
 };
 
 // Block execution time construction by TableFactoryFactory
@@ -373,6 +398,14 @@ public:
     virtual Table::Ptr createTable(const std::string& tableName, const std::string& keyField,
         const std::string& valueField, bool authorityFlag, Address const& _origin = Address(),
         bool isPara = true) = 0;
+    // indexField is the comma separated fields of the secondary indices, see TableInfo::indices,
+    // a table factory without indices creates the table without them
+    virtual Table::Ptr createIndexedTable(const std::string& tableName,
+        const std::string& keyField, const std::string& valueField, const std::string&,
+        bool authorityFlag, Address const& _origin = Address(), bool isPara = true)
+    {
+        return createTable(tableName, keyField, valueField, authorityFlag, _origin, isPara);
+    }
 
     virtual h256 hash() = 0;
     virtual size_t savepoint() = 0;
@@ -387,11 +420,15 @@ public:
     }
     virtual void setBlockHash(h256 const& blockHash) { m_blockHash = blockHash; }
     virtual void setBlockNum(int64_t blockNum) { m_blockNum = blockNum; }
+    // the arena of the short-lived objects of the block, nullptr if they are allocated from heap
+    Arena::Ptr arena() const { return m_arena; }
+    void setArena(Arena::Ptr _arena) { m_arena = _arena; }
 
 protected:
     std::shared_ptr<Storage> m_stateStorage;
     h256 m_blockHash = h256(0);
     int64_t m_blockNum = 0;
+    Arena::Ptr m_arena;
 };
 
 class TableFactoryFactory : public std::enable_shared_from_this<TableFactoryFactory>
@@ -0,0 +1,75 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+/**
+ * @brief : decoded code of contracts keyed by code hash
+ * @file: CodeCache.cpp
+ */
+
+#include "CodeCache.h"
+
+using namespace std;
+using namespace dev;
+using namespace dev::storagestate;
+
+const size_t CodeCache::c_defaultCapacity;
+
+CodeCache::CodePtr CodeCache::get(h256 const& _codeHash) const
+{
+    ++m_queryTimes;
+    ReadGuard l(x_codes);
+    auto it = m_codes.find(_codeHash);
+    if (it == m_codes.end())
+    {
+        return nullptr;
+    }
+    ++m_hitTimes;
+    return it->second;
+}
+
+void CodeCache::put(h256 const& _codeHash, CodePtr _code)
+{
+    if (_code->size() > m_capacity)
+    {
+        return;
+    }
+    WriteGuard l(x_codes);
+    if (!m_codes.insert(make_pair(_codeHash, _code)).second)
+    {
+        return;
+    }
+    m_order.push_back(_codeHash);
+    m_memorySize += _code->size();
+    while (m_memorySize > m_capacity)
+    {
+        auto it = m_codes.find(m_order.front());
+        m_memorySize -= it->second->size();
+        m_codes.erase(it);
+        m_order.pop_front();
+    }
+}
+
+size_t CodeCache::size() const
+{
+    ReadGuard l(x_codes);
+    return m_codes.size();
+}
+
+size_t CodeCache::memorySize() const
+{
+    ReadGuard l(x_codes);
+    return m_memorySize;
+}
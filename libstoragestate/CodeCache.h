@@ -0,0 +1,69 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+/**
+ * @brief : decoded code of contracts keyed by code hash
+ * @file: CodeCache.h
+ */
+
+#pragma once
+
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/Guards.h>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+
+namespace dev
+{
+namespace storagestate
+{
+// the code of a code hash never changes, so the cache is shared by the states of all blocks of a
+// ledger and is never invalidated, the oldest code is evicted when it is full
+class CodeCache
+{
+public:
+    using Ptr = std::shared_ptr<CodeCache>;
+    using CodePtr = std::shared_ptr<bytes const>;
+
+    explicit CodeCache(size_t _capacity = c_defaultCapacity) : m_capacity(_capacity) {}
+
+    // return nullptr if the code is not cached
+    CodePtr get(h256 const& _codeHash) const;
+    void put(h256 const& _codeHash, CodePtr _code);
+
+    size_t size() const;
+    size_t memorySize() const;
+    uint64_t queryTimes() const { return m_queryTimes; }
+    uint64_t hitTimes() const { return m_hitTimes; }
+
+    // memory limit of the code in bytes
+    static const size_t c_defaultCapacity = 32 * 1024 * 1024;
+
+private:
+    size_t m_capacity;
+    mutable SharedMutex x_codes;
+    std::unordered_map<h256, CodePtr> m_codes;
+    // insertion order for eviction
+    std::deque<h256> m_order;
+    size_t m_memorySize = 0;
+    mutable std::atomic<uint64_t> m_queryTimes{0};
+    mutable std::atomic<uint64_t> m_hitTimes{0};
+};
+}  // namespace storagestate
+}  // namespace dev
@@ -25,6 +25,7 @@
 #include "StorageState.h"
 #include "libdevcrypto/Hash.h"
 #include "libethcore/Exceptions.h"
+#include "libstorage/StorageException.h"
 #include "libstorage/Table.h"
 
 using namespace dev;
@@ -33,6 +34,66 @@ using namespace dev::storagestate;
 using namespace dev::storage;
 using namespace dev::executive;
 
+namespace
+{
+u256 decodeU256(std::string const& _value)
+{
+    return u256(_value);
+}
+
+h256 decodeH256(std::string const& _value)
+{
+    return h256(fromHex(_value));
+}
+
+bool decodeBool(std::string const& _value)
+{
+    return _value == "true";
+}
+
+using boost::multiprecision::limb_type;
+
+// 32 bytes big endian, the slots are in the same order as the numbers, the limbs are copied
+// directly because toBigEndian shifts the whole u256 for every byte
+std::string encodeSlot(u256 const& _slot)
+{
+    std::string slot(h256::size, '\0');
+    auto const& backend = _slot.backend();
+    for (size_t i = 0; i < backend.size(); ++i)
+    {
+        auto limb = backend.limbs()[i];
+        for (size_t j = 0; j < sizeof(limb_type); ++j)
+        {
+            slot[h256::size - 1 - i * sizeof(limb_type) - j] = char(limb >> (8 * j));
+        }
+    }
+    return slot;
+}
+
+u256 decodeSlot(bytesConstRef _slot)
+{
+    if (_slot.size() != h256::size)
+    {
+        BOOST_THROW_EXCEPTION(StorageException(-1, "invalid binary storage value"));
+    }
+    u256 slot;
+    auto& backend = slot.backend();
+    backend.resize(h256::size / sizeof(limb_type), h256::size / sizeof(limb_type));
+    for (size_t i = 0; i < backend.size(); ++i)
+    {
+        limb_type limb = 0;
+        auto begin = _slot.data() + h256::size - (i + 1) * sizeof(limb_type);
+        for (size_t j = 0; j < sizeof(limb_type); ++j)
+        {
+            limb = (limb << 8) | begin[j];
+        }
+        backend.limbs()[i] = limb;
+    }
+    backend.normalize();
+    return slot;
+}
+}  // namespace
+
 bool StorageState::addressInUse(Address const& _address) const
 {
     auto table = getTable(_address);
@@ -58,29 +119,17 @@ bool StorageState::accountNonemptyAndExisting(Address const& _address) const
 
 bool StorageState::addressHasCode(Address const& _address) const
 {
-    auto table = getTable(_address);
-    if (table)
-    {
-        auto entries = table->select(ACCOUNT_CODE_HASH, table->newCondition());
-        if (entries->size() != 0u)
-        {
-            auto codeHash = h256(fromHex(entries->get(0)->getField(STORAGE_VALUE)));
-            return codeHash != EmptySHA3;
-        }
-    }
-    return false;
+    return codeHash(_address) != EmptySHA3;
 }
 
 u256 StorageState::balance(Address const& _address) const
 {
     auto table = getTable(_address);
-    if (table)
+    u256 balance;
+    if (table && readField(_address, table, ACCOUNT_BALANCE, &AccountCache::balance, decodeU256,
+                     balance))
     {
-        auto entries = table->select(ACCOUNT_BALANCE, table->newCondition());
-        if (entries->size() != 0u)
-        {
-            return u256(entries->get(0)->getField(STORAGE_VALUE));
-        }
+        return balance;
     }
     return 0;
 }
@@ -94,16 +143,13 @@ void StorageState::addBalance(Address const& _address, u256 const& _amount)
     auto table = getTable(_address);
     if (table)
     {
-        auto entries = table->select(ACCOUNT_BALANCE, table->newCondition());
-        if (entries->size() != 0u)
+        u256 balance;
+        if (readField(
+                _address, table, ACCOUNT_BALANCE, &AccountCache::balance, decodeU256, balance))
         {
-            auto option = std::make_shared<AccessOptions>(Address(), false);
-            auto entry = entries->get(0);
-            auto balance = u256(entry->getField(STORAGE_VALUE));
             balance += _amount;
-            Entry::Ptr updateEntry = table->newEntry();
-            updateEntry->setField(STORAGE_VALUE, balance.str());
-            table->update(ACCOUNT_BALANCE, updateEntry, table->newCondition(), option);
+            writeField(
+                _address, table, ACCOUNT_BALANCE, &AccountCache::balance, balance, balance.str());
         }
     }
     else
@@ -117,18 +163,15 @@ void StorageState::subBalance(Address const& _address, u256 const& _amount)
     auto table = getTable(_address);
     if (table)
     {
-        auto entries = table->select(ACCOUNT_BALANCE, table->newCondition());
-        if (entries->size() != 0u)
+        u256 balance;
+        if (readField(
+                _address, table, ACCOUNT_BALANCE, &AccountCache::balance, decodeU256, balance))
         {
-            auto entry = entries->get(0);
-            auto balance = u256(entry->getField(STORAGE_VALUE));
             if (balance < _amount)
                 BOOST_THROW_EXCEPTION(NotEnoughCash());
             balance -= _amount;
-            Entry::Ptr updateEntry = table->newEntry();
-            auto option = std::make_shared<AccessOptions>(Address(), false);
-            updateEntry->setField(STORAGE_VALUE, balance.str());
-            table->update(ACCOUNT_BALANCE, updateEntry, table->newCondition(), option);
+            writeField(
+                _address, table, ACCOUNT_BALANCE, &AccountCache::balance, balance, balance.str());
         }
     }
     else
@@ -142,16 +185,12 @@ void StorageState::setBalance(Address const& _address, u256 const& _amount)
     auto table = getTable(_address);
     if (table)
     {
-        auto entries = table->select(ACCOUNT_BALANCE, table->newCondition());
-        if (entries->size() != 0u)
+        u256 balance;
+        if (readField(
+                _address, table, ACCOUNT_BALANCE, &AccountCache::balance, decodeU256, balance))
         {
-            auto entry = entries->get(0);
-            auto balance = u256(entry->getField(STORAGE_VALUE));
-            balance = _amount;
-            auto option = std::make_shared<AccessOptions>(Address(), false);
-            Entry::Ptr updateEntry = table->newEntry();
-            updateEntry->setField(STORAGE_VALUE, balance.str());
-            table->update(ACCOUNT_BALANCE, updateEntry, table->newCondition(), option);
+            writeField(
+                _address, table, ACCOUNT_BALANCE, &AccountCache::balance, _amount, _amount.str());
         }
     }
     else
@@ -181,10 +220,21 @@ u256 StorageState::storage(Address const& _address, u256 const& _key)
     auto table = getTable(_address);
     if (table)
     {
-        auto entries = table->select(_key.str(), table->newCondition());
-        if (entries->size() != 0u)
+        if (m_binaryStorage)
         {
-            return u256(entries->get(0)->getField(STORAGE_VALUE));
+            auto entries = table->select(encodeSlot(_key), table->newCondition());
+            if (entries->size() != 0u)
+            {
+                return decodeSlot(entries->get(0)->getFieldConst(STORAGE_VALUE));
+            }
+        }
+        else
+        {
+            auto entries = table->select(_key.str(), table->newCondition());
+            if (entries->size() != 0u)
+            {
+                return u256(entries->get(0)->getField(STORAGE_VALUE));
+            }
         }
     }
     return u256(0);
@@ -196,20 +246,20 @@ void StorageState::setStorage(Address const& _address, u256 const& _location, u2
     if (table)
     {
         auto option = std::make_shared<AccessOptions>(Address(), false);
-        auto entries = table->select(_location.str(), table->newCondition());
-        if (entries->size() == 0u)
+        auto entry = table->newEntry();
+        if (m_binaryStorage)
         {
-            auto entry = table->newEntry();
-            entry->setField(STORAGE_KEY, _location.str());
-            entry->setField(STORAGE_VALUE, _value.str());
-            table->insert(_location.str(), entry, option);
+            auto key = encodeSlot(_location);
+            entry->setField(STORAGE_KEY, key);
+            entry->setField(STORAGE_VALUE, encodeSlot(_value));
+            table->upsert(key, entry, option);
         }
         else
         {
-            auto entry = table->newEntry();
-            entry->setField(STORAGE_KEY, _location.str());
+            auto key = _location.str();
+            entry->setField(STORAGE_KEY, key);
             entry->setField(STORAGE_VALUE, _value.str());
-            table->update(_location.str(), entry, table->newCondition(), option);
+            table->upsert(key, entry, option);
         }
     }
 }
@@ -232,9 +282,13 @@ void StorageState::setCode(Address const& _address, bytes&& _code)
             entry->setField(STORAGE_VALUE, toHex(_code));
         }
         table->update(ACCOUNT_CODE, entry, table->newCondition(), option);
-        entry = table->newEntry();
-        entry->setField(STORAGE_VALUE, toHex(sha3(_code)));
-        table->update(ACCOUNT_CODE_HASH, entry, table->newCondition(), option);
+        auto codeHash = sha3(_code);
+        writeField(
+            _address, table, ACCOUNT_CODE_HASH, &AccountCache::codeHash, codeHash, toHex(codeHash));
+        if (m_codeCache)
+        {
+            m_codeCache->put(codeHash, std::make_shared<bytes const>(std::move(_code)));
+        }
     }
 }
 
@@ -265,22 +319,38 @@ void StorageState::kill(Address _address)
 
 bytes const StorageState::code(Address const& _address) const
 {
-    if (codeHash(_address) == EmptySHA3)
+    auto hash = codeHash(_address);
+    if (hash == EmptySHA3)
         return NullBytes;
+    if (m_codeCache)
+    {
+        auto code = m_codeCache->get(hash);
+        if (code)
+        {
+            return *code;
+        }
+    }
     auto table = getTable(_address);
     if (table)
     {
         auto entries = table->select(ACCOUNT_CODE, table->newCondition());
         if (entries->size() != 0u)
         {
+            bytes code;
             if (m_enableBinary)
             {  // >= v2.4.0 and rocksdb
-                return entries->get(0)->getFieldBytes(STORAGE_VALUE);
+                code = entries->get(0)->getFieldBytes(STORAGE_VALUE);
             }
             else
             {
-                return fromHex(entries->get(0)->getField(STORAGE_VALUE));
+                code = fromHex(entries->get(0)->getField(STORAGE_VALUE));
+            }
+            // only the code matches the hash is shared with other accounts and blocks
+            if (m_codeCache && sha3(code) == hash)
+            {
+                m_codeCache->put(hash, std::make_shared<bytes const>(code));
             }
+            return code;
         }
     }
     return NullBytes;
@@ -289,13 +359,11 @@ bytes const StorageState::code(Address const& _address) const
 h256 StorageState::codeHash(Address const& _address) const
 {
     auto table = getTable(_address);
-    if (table)
+    h256 codeHash;
+    if (table && readField(_address, table, ACCOUNT_CODE_HASH, &AccountCache::codeHash,
+                     decodeH256, codeHash))
     {
-        auto entries = table->select(ACCOUNT_CODE_HASH, table->newCondition());
-        if (entries->size() != 0u)
-        {
-            return h256(fromHex(entries->get(0)->getField(STORAGE_VALUE)));
-        }
+        return codeHash;
     }
     return EmptySHA3;
 }
@@ -303,22 +371,14 @@ h256 StorageState::codeHash(Address const& _address) const
 bool StorageState::frozen(Address const& _contract) const
 {
     auto table = getTable(_contract);
-    if (table)
+    bool frozen = false;
+    if (table &&
+        !readField(_contract, table, ACCOUNT_FROZEN, &AccountCache::frozen, decodeBool, frozen))
     {
-        auto entries = table->select(ACCOUNT_FROZEN, table->newCondition());
-        if (entries->size() != 0u)
-        {
-            return (entries->get(0)->getField(STORAGE_VALUE) == "true");
-        }
-        else
-        {
-            return false;
-        }
-    }
-    else
-    {
-        return false;
+        // most contracts are never frozen, the row is inserted by ContractLifeCyclePrecompiled
+        cacheField(_contract, &AccountCache::frozen, false, false);
     }
+    return frozen;
 }
 
 size_t StorageState::codeSize(Address const& _address) const
@@ -336,16 +396,11 @@ void StorageState::incNonce(Address const& _address)
     auto table = getTable(_address);
     if (table)
     {
-        auto entries = table->select(ACCOUNT_NONCE, table->newCondition());
-        if (entries->size() != 0u)
+        u256 nonce;
+        if (readField(_address, table, ACCOUNT_NONCE, &AccountCache::nonce, decodeU256, nonce))
         {
-            auto entry = entries->get(0);
-            auto nonce = u256(entry->getField(STORAGE_VALUE));
             ++nonce;
-            Entry::Ptr updateEntry = table->newEntry();
-            auto option = std::make_shared<AccessOptions>(Address(), false);
-            updateEntry->setField(STORAGE_VALUE, nonce.str());
-            table->update(ACCOUNT_NONCE, updateEntry, table->newCondition(), option);
+            writeField(_address, table, ACCOUNT_NONCE, &AccountCache::nonce, nonce, nonce.str());
         }
     }
     else
@@ -357,10 +412,8 @@ void StorageState::setNonce(Address const& _address, u256 const& _newNonce)
     auto table = getTable(_address);
     if (table)
     {
-        auto entry = table->newEntry();
-        auto option = std::make_shared<AccessOptions>(Address(), false);
-        entry->setField(STORAGE_VALUE, _newNonce.str());
-        table->update(ACCOUNT_NONCE, entry, table->newCondition(), option);
+        writeField(
+            _address, table, ACCOUNT_NONCE, &AccountCache::nonce, _newNonce, _newNonce.str());
     }
     else
         createAccount(_address, _newNonce);
@@ -369,14 +422,11 @@ void StorageState::setNonce(Address const& _address, u256 const& _newNonce)
 u256 StorageState::getNonce(Address const& _address) const
 {
     auto table = getTable(_address);
-    if (table)
+    u256 nonce;
+    if (table &&
+        readField(_address, table, ACCOUNT_NONCE, &AccountCache::nonce, decodeU256, nonce))
     {
-        auto entries = table->select(ACCOUNT_NONCE, table->newCondition());
-        if (entries->size() != 0u)
-        {
-            auto entry = entries->get(0);
-            return u256(entry->getField(STORAGE_VALUE));
-        }
+        return nonce;
     }
     return m_accountStartNonce;
 }
@@ -432,11 +482,18 @@ size_t StorageState::savepoint() const
 void StorageState::rollback(size_t _savepoint)
 {
     m_memoryTableFactory->rollback(_savepoint);
+    clearAccountCache();
 }
 
 void StorageState::clear()
 {
-    // m_cache.clear();
+    clearAccountCache();
+}
+
+void StorageState::clearAccountCache()
+{
+    WriteGuard l(x_accountCache);
+    m_accountCache.clear();
 }
 
 bool StorageState::checkAuthority(Address const& _origin, Address const& _contract) const
@@ -482,6 +539,10 @@ void StorageState::createAccount(Address const& _address, u256 const& _nonce, u2
     entry->setField(STORAGE_KEY, ACCOUNT_ALIVE);
     entry->setField(STORAGE_VALUE, "true");
     table->insert(ACCOUNT_ALIVE, entry);
+    cacheField(_address, &AccountCache::balance, _amount, true);
+    cacheField(_address, &AccountCache::codeHash, EmptySHA3, true);
+    cacheField(_address, &AccountCache::nonce, _nonce, true);
+    cacheField(_address, &AccountCache::frozen, false, true);
 }
 
 inline storage::Table::Ptr StorageState::getTable(Address const& _address) const
@@ -493,3 +554,50 @@ inline storage::Table::Ptr StorageState::getTable(Address const& _address) const
     }
     return m_memoryTableFactory->openTable(tableName);
 }
+
+template <typename T>
+bool StorageState::readField(Address const& _address, Table::Ptr const& _table,
+    std::string const& _key, CachedField<T> _field, T (*_decode)(std::string const&),
+    T& _value) const
+{
+    {
+        ReadGuard l(x_accountCache);
+        auto it = m_accountCache.find(_address);
+        if (it != m_accountCache.end() && (it->second.*_field))
+        {
+            _value = *(it->second.*_field);
+            return true;
+        }
+    }
+    auto entries = _table->select(_key, _table->newCondition());
+    if (entries->size() == 0u)
+    {
+        return false;
+    }
+    _value = _decode(entries->get(0)->getField(STORAGE_VALUE));
+    cacheField(_address, _field, _value, false);
+    return true;
+}
+
+template <typename T>
+void StorageState::writeField(Address const& _address, Table::Ptr const& _table,
+    std::string const& _key, CachedField<T> _field, T const& _value, std::string const& _encoded)
+{
+    auto entry = _table->newEntry();
+    auto option = std::make_shared<AccessOptions>(Address(), false);
+    entry->setField(STORAGE_VALUE, _encoded);
+    _table->update(_key, entry, _table->newCondition(), option);
+    cacheField(_address, _field, _value, true);
+}
+
+template <typename T>
+void StorageState::cacheField(
+    Address const& _address, CachedField<T> _field, T const& _value, bool _overwrite) const
+{
+    WriteGuard l(x_accountCache);
+    auto& field = m_accountCache[_address].*_field;
+    if (_overwrite || !field)
+    {
+        field = _value;
+    }
+}
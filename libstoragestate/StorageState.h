@@ -23,10 +23,14 @@
  */
 
 #pragma once
+#include "CodeCache.h"
 #include "libexecutive/StateFace.h"
+#include <libdevcore/Guards.h>
 #include <libstorage/MemoryTableFactory.h>
 #include <tbb/concurrent_unordered_map.h>
+#include <boost/optional.hpp>
 #include <string>
+#include <unordered_map>
 
 namespace dev
 {
@@ -172,19 +176,59 @@ public:
     /// Clear state's cache
     void clear() override;
 
+    /// Drop the cached account data of the block
+    void clearAccountCache() override;
+
     bool checkAuthority(Address const& _origin, Address const& _contract) const override;
 
     void setMemoryTableFactory(std::shared_ptr<dev::storage::TableFactory> _memoryTableFactory)
     {
         m_memoryTableFactory = _memoryTableFactory;
+        clearAccountCache();
     }
 
+    /// Set the code cache shared by the states of the ledger
+    void setCodeCache(CodeCache::Ptr _codeCache) { m_codeCache = _codeCache; }
+
+    /// Store the slots of contracts as 32 bytes binary keys and values instead of decimal strings,
+    /// the state hash differs, so all nodes of a chain must use the same encoding
+    void setBinaryStorage(bool _binaryStorage) { m_binaryStorage = _binaryStorage; }
+
 private:
+    // the fields of an account read or written in the block
+    struct AccountCache
+    {
+        boost::optional<h256> codeHash;
+        boost::optional<bool> frozen;
+        boost::optional<u256> nonce;
+        boost::optional<u256> balance;
+    };
+    template <typename T>
+    using CachedField = boost::optional<T> AccountCache::*;
+
     void createAccount(Address const& _address, u256 const& _nonce, u256 const& _amount = u256(0));
     std::shared_ptr<dev::storage::Table> getTable(Address const& _address) const;
+    // read the field from the cache or the table, return false if the account has no such field
+    template <typename T>
+    bool readField(Address const& _address, std::shared_ptr<dev::storage::Table> const& _table,
+        std::string const& _key, CachedField<T> _field, T (*_decode)(std::string const&),
+        T& _value) const;
+    template <typename T>
+    void writeField(Address const& _address, std::shared_ptr<dev::storage::Table> const& _table,
+        std::string const& _key, CachedField<T> _field, T const& _value,
+        std::string const& _encoded);
+    // the value read from the table does not replace the value written by other threads
+    template <typename T>
+    void cacheField(
+        Address const& _address, CachedField<T> _field, T const& _value, bool _overwrite) const;
+
     u256 m_accountStartNonce;
     std::shared_ptr<dev::storage::TableFactory> m_memoryTableFactory;
     bool m_enableBinary = false;
+    bool m_binaryStorage = false;
+    CodeCache::Ptr m_codeCache;
+    mutable SharedMutex x_accountCache;
+    mutable std::unordered_map<Address, AccountCache> m_accountCache;
 };
 }  // namespace storagestate
 }  // namespace dev
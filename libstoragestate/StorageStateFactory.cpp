@@ -33,5 +33,7 @@ std::shared_ptr<StateFace> StorageStateFactory::getState(
 {
     auto storageState = make_shared<StorageState>(m_accountStartNonce, m_enableBinary);
     storageState->setMemoryTableFactory(_factory);
+    storageState->setCodeCache(m_codeCache);
+    storageState->setBinaryStorage(m_binaryStorage);
     return storageState;
 }
@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include "CodeCache.h"
 #include <libexecutive/StateFactoryInterface.h>
 
 namespace dev
@@ -38,10 +39,14 @@ public:
     std::shared_ptr<dev::executive::StateFace> getState(
         h256 const& _root, std::shared_ptr<dev::storage::TableFactory> _factory) override;
     void enableBinaryEncode(bool _enableBinaryEncode) { m_enableBinary = _enableBinaryEncode; }
+    void enableBinaryStorage(bool _binaryStorage) { m_binaryStorage = _binaryStorage; }
 
 private:
     u256 m_accountStartNonce;
     bool m_enableBinary = false;
+    bool m_binaryStorage = false;
+    // shared by the states of all blocks
+    CodeCache::Ptr m_codeCache = std::make_shared<CodeCache>();
 };
 }  // namespace storagestate
 }  // namespace dev
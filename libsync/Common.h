@@ -79,6 +79,10 @@ enum SyncPacketType : byte
     ReqBlocskPacket = 0x03,
     TxsStatusPacket = 0x04,
     TxsRequestPacekt = 0x05,
+    SnapshotManifestReqPacket = 0x06,
+    SnapshotManifestPacket = 0x07,
+    SnapshotChunkReqPacket = 0x08,
+    SnapshotChunkPacket = 0x09,
     PacketCount
 };
 
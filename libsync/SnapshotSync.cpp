@@ -0,0 +1,586 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+/**
+ * @brief : fast state sync of a new node from the state snapshot of a peer
+ */
+
+#include "SnapshotSync.h"
+#include <libdevcrypto/Common.h>
+#include <libethcore/Block.h>
+#include <set>
+#include <thread>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::sync;
+using namespace dev::p2p;
+using namespace dev::storage;
+
+SnapshotSync::SnapshotSync(std::shared_ptr<dev::p2p::P2PInterface> _service,
+    std::shared_ptr<dev::blockchain::BlockChainInterface> _blockChain,
+    std::shared_ptr<SyncMasterStatus> _syncStatus, std::shared_ptr<BasicRocksDB> _db,
+    PROTOCOL_ID const& _protocolId, NodeID const& _nodeId, size_t _chunkSize)
+  : m_service(_service),
+    m_blockChain(_blockChain),
+    m_syncStatus(_syncStatus),
+    m_db(_db),
+    m_protocolId(_protocolId),
+    m_groupId(dev::eth::getGroupAndProtocol(_protocolId).first),
+    m_nodeId(_nodeId),
+    m_exporter(std::make_shared<StateSnapshotExporter>(_db, _chunkSize))
+{
+    // one thread prepares the snapshot while the other serves chunks
+    m_serveWorker = std::make_shared<dev::ThreadPool>("SnapshotS-" + std::to_string(m_groupId), 2);
+}
+
+void SnapshotSync::stop()
+{
+    if (m_serveWorker)
+    {
+        m_serveWorker->stop();
+    }
+    if (m_importPool)
+    {
+        m_importPool->stop();
+    }
+}
+
+void SnapshotSync::setEnableImport(bool _enableImport, int64_t _threshold)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_enableImport = _enableImport;
+    m_threshold = _threshold;
+    m_state = _enableImport ? State::Idle : State::Disabled;
+    if (_enableImport && !m_importPool)
+    {
+        auto threads = std::max(2u, std::thread::hardware_concurrency() / 2);
+        m_importPool =
+            std::make_shared<dev::ThreadPool>("SnapshotI-" + std::to_string(m_groupId), threads);
+    }
+}
+
+bool SnapshotSync::importing() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // once the import has begun the db is not at the genesis block any more
+    return m_state == State::RequestManifest || m_state == State::Downloading ||
+           (m_state == State::Idle && m_importer);
+}
+
+bool SnapshotSync::maintain()
+{
+    releaseIdleSnapshot();
+    int64_t importedNumber = -1;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto now = utcSteadyTime();
+        if (m_state == State::Idle && m_importingChunks == 0)
+        {
+            requestManifest();
+        }
+        else if (m_state == State::RequestManifest &&
+                 now - m_requestTime > c_snapshotManifestTimeout)
+        {
+            restart("request manifest timeout");
+        }
+        else if (m_state == State::Downloading)
+        {
+            for (auto it = m_requestedChunks.begin(); it != m_requestedChunks.end();)
+            {
+                if (now - it->second <= c_snapshotChunkTimeout)
+                {
+                    ++it;
+                    continue;
+                }
+                // request the chunk again
+                m_pendingChunks.push_back(it->first);
+                it = m_requestedChunks.erase(it);
+                ++m_retries;
+            }
+            requestChunks();
+            if (m_importedChunks == m_manifest->chunks.size())
+            {
+                finish();
+                if (m_state == State::Finished)
+                {
+                    importedNumber = m_manifest->number;
+                }
+            }
+        }
+    }
+    if (importedNumber >= 0 && m_onImported)
+    {
+        m_onImported(importedNumber);
+    }
+    return importing();
+}
+
+void SnapshotSync::onPacket(SyncMsgPacket::Ptr _packet, P2PMessage::Ptr)
+{
+    try
+    {
+        RLP const& rlp = _packet->rlp();
+        auto peer = _packet->nodeId;
+        switch (_packet->packetType)
+        {
+        case SnapshotManifestReqPacket:
+            enqueueServe(peer, [peer](SnapshotSync& _sync) { _sync.serveManifest(peer); });
+            break;
+        case SnapshotChunkReqPacket:
+        {
+            if (rlp.itemCount() != 2)
+            {
+                BOOST_THROW_EXCEPTION(BadRLP() << errinfo_comment("chunk request"));
+            }
+            auto manifestHash = rlp[0].toHash<h256>();
+            auto index = rlp[1].toInt<uint64_t>();
+            enqueueServe(peer, [peer, manifestHash, index](SnapshotSync& _sync) {
+                _sync.serveChunk(peer, manifestHash, index);
+            });
+            break;
+        }
+        case SnapshotManifestPacket:
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            onManifest(peer, rlp);
+            break;
+        }
+        case SnapshotChunkPacket:
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            onChunk(peer, rlp);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    catch (std::exception const& e)
+    {
+        SYNC_LOG(WARNING) << LOG_BADGE("Snapshot") << LOG_DESC("Invalid snapshot packet")
+                          << LOG_KV("packetType", int(_packet->packetType))
+                          << LOG_KV("peer", _packet->nodeId.abridged())
+                          << LOG_KV("errorInfo", boost::diagnostic_information(e));
+    }
+}
+
+void SnapshotSync::enqueueServe(
+    NodeID const& _peer, std::function<void(SnapshotSync&)> const& _serve)
+{
+    // every request reads the db, so a peer can not queue unbounded work
+    if (++m_serveRequests > c_maxSnapshotServeRequests)
+    {
+        --m_serveRequests;
+        SYNC_LOG(DEBUG) << LOG_BADGE("Snapshot") << LOG_DESC("Too many snapshot requests, drop")
+                        << LOG_KV("peer", _peer.abridged());
+        return;
+    }
+    auto self = std::weak_ptr<SnapshotSync>(shared_from_this());
+    m_serveWorker->enqueue([self, _serve]() {
+        auto snapshotSync = self.lock();
+        if (snapshotSync)
+        {
+            ScopeGuard release([snapshotSync]() { --snapshotSync->m_serveRequests; });
+            _serve(*snapshotSync);
+        }
+    });
+}
+
+void SnapshotSync::serveManifest(NodeID const& _peer)
+{
+    try
+    {
+        SnapshotManifest::Ptr manifest;
+        {
+            // the snapshot is shared by all joining nodes until it is too old
+            std::lock_guard<std::mutex> lock(m_prepareMutex);
+            manifest = m_exporter->manifest();
+            if (!manifest || utcSteadyTime() - m_preparedTime > c_snapshotLifetime)
+            {
+                manifest = m_exporter->prepare();
+                m_preparedTime = utcSteadyTime();
+            }
+            m_lastServeTime = utcSteadyTime();
+        }
+        auto blockRLP = m_blockChain->getBlockRLPByNumber(manifest->number);
+        if (!blockRLP)
+        {
+            SYNC_LOG(WARNING) << LOG_BADGE("Snapshot") << LOG_DESC("The snapshot block not found")
+                              << LOG_KV("number", manifest->number);
+            return;
+        }
+        SyncSnapshotManifestPacket packet;
+        packet.encode(manifest->encode(), *blockRLP);
+        send(_peer, packet);
+        SYNC_LOG(INFO) << LOG_BADGE("Snapshot") << LOG_DESC("Send snapshot manifest")
+                       << LOG_KV("number", manifest->number)
+                       << LOG_KV("chunks", manifest->chunks.size())
+                       << LOG_KV("size", manifest->size()) << LOG_KV("peer", _peer.abridged());
+    }
+    catch (std::exception const& e)
+    {
+        SYNC_LOG(WARNING) << LOG_BADGE("Snapshot") << LOG_DESC("Prepare snapshot failed")
+                          << LOG_KV("peer", _peer.abridged())
+                          << LOG_KV("errorInfo", boost::diagnostic_information(e));
+    }
+}
+
+void SnapshotSync::serveChunk(NodeID const& _peer, h256 const& _manifestHash, uint64_t _index)
+{
+    m_lastServeTime = utcSteadyTime();
+    auto chunk = m_exporter->chunk(_manifestHash, _index);
+    SyncSnapshotChunkPacket packet;
+    packet.encode(_manifestHash, _index, chunk ? ref(*chunk) : bytesConstRef());
+    send(_peer, packet);
+    if (chunk)
+    {
+        ++m_servedChunks;
+        m_servedBytes += chunk->size();
+    }
+    SYNC_LOG(DEBUG) << LOG_BADGE("Snapshot") << LOG_DESC("Send snapshot chunk")
+                    << LOG_KV("index", _index) << LOG_KV("size", chunk ? chunk->size() : 0)
+                    << LOG_KV("peer", _peer.abridged());
+}
+
+void SnapshotSync::releaseIdleSnapshot()
+{
+    std::unique_lock<std::mutex> lock(m_prepareMutex, std::try_to_lock);
+    if (!lock.owns_lock() || !m_exporter->manifest() ||
+        utcSteadyTime() - m_lastServeTime <= c_snapshotLifetime)
+    {
+        return;
+    }
+    m_exporter->release();
+    SYNC_LOG(INFO) << LOG_BADGE("Snapshot") << LOG_DESC("Release idle snapshot")
+                   << LOG_KV("servedChunks", m_servedChunks)
+                   << LOG_KV("servedBytes", m_servedBytes);
+}
+
+void SnapshotSync::requestManifest()
+{
+    if (!m_importer && m_blockChain->number() != 0)
+    {
+        m_state = State::Disabled;
+        SYNC_LOG(INFO) << LOG_BADGE("Snapshot")
+                       << LOG_DESC("Not at the genesis block, disable snapshot import")
+                       << LOG_KV("number", m_blockChain->number());
+        return;
+    }
+    int64_t maxPeerNumber = 0;
+    NodeID peer;
+    m_syncStatus->foreachPeerRandom(
+        [&maxPeerNumber, &peer](std::shared_ptr<SyncPeerStatus> _p) {
+            if (_p->number > maxPeerNumber)
+            {
+                maxPeerNumber = _p->number;
+                peer = _p->nodeId;
+            }
+            return true;
+        });
+    if (maxPeerNumber < m_threshold)
+    {
+        return;
+    }
+    m_peer = peer;
+    m_state = State::RequestManifest;
+    m_requestTime = utcSteadyTime();
+    SyncSnapshotManifestReqPacket packet;
+    packet.encode();
+    send(m_peer, packet);
+    SYNC_LOG(INFO) << LOG_BADGE("Snapshot") << LOG_DESC("Request snapshot manifest")
+                   << LOG_KV("peerNumber", maxPeerNumber) << LOG_KV("peer", m_peer.abridged());
+}
+
+void SnapshotSync::onManifest(NodeID const& _peer, RLP const& _rlp)
+{
+    if (m_state != State::RequestManifest || _peer != m_peer)
+    {
+        return;
+    }
+    try
+    {
+        if (_rlp.itemCount() != 2)
+        {
+            BOOST_THROW_EXCEPTION(BadRLP() << errinfo_comment("manifest packet"));
+        }
+        auto manifest = SnapshotManifest::decode(_rlp[0].toBytesConstRef());
+        auto block = std::make_shared<Block>(_rlp[1].toBytes(), CheckTransaction::None, false);
+        if (block->blockHeader().number() != manifest->number ||
+            block->blockHeader().hash() != manifest->blockHash)
+        {
+            restart("the block does not match the manifest");
+            return;
+        }
+        // one peer must not dictate the whole state, the block is checked before anything is
+        // written to the db
+        auto sealers = m_blockChain->sealerList();
+        if (block->blockHeader().sealerList() != sealers || block->sigList()->empty())
+        {
+            if (m_importer)
+            {
+                restart("the block can not be verified");
+                return;
+            }
+            // the sealers have changed since the genesis block, or the consensus does not sign
+            // blocks, replay the blocks instead
+            m_state = State::Disabled;
+            SYNC_LOG(WARNING) << LOG_BADGE("Snapshot")
+                              << LOG_DESC("The snapshot block can not be verified, disable import")
+                              << LOG_KV("number", manifest->number)
+                              << LOG_KV("sealers", block->blockHeader().sealerList().size())
+                              << LOG_KV("signatures", block->sigList()->size())
+                              << LOG_KV("peer", _peer.abridged());
+            return;
+        }
+        if (!checkBlockSign(*block, sealers))
+        {
+            restart("the block is not signed by the sealers");
+            return;
+        }
+        m_manifest = manifest;
+        m_manifestHash = manifest->hash();
+        if (!m_importer)
+        {
+            m_importer = std::make_shared<StateSnapshotImporter>(m_db);
+        }
+        m_importer->begin(*manifest);
+    }
+    catch (std::exception const& e)
+    {
+        restart("invalid manifest: " + boost::diagnostic_information(e));
+        return;
+    }
+
+    m_pendingChunks.clear();
+    for (size_t i = 0; i < m_manifest->chunks.size(); ++i)
+    {
+        m_pendingChunks.push_back(i);
+    }
+    m_requestedChunks.clear();
+    m_importedChunks = 0;
+    m_importedBytes = 0;
+    m_startTime = utcSteadyTime();
+    m_state = State::Downloading;
+    SYNC_LOG(INFO) << LOG_BADGE("Snapshot") << LOG_DESC("Start importing snapshot")
+                   << LOG_KV("number", m_manifest->number)
+                   << LOG_KV("chunks", m_manifest->chunks.size())
+                   << LOG_KV("size", m_manifest->size()) << LOG_KV("peer", m_peer.abridged());
+    requestChunks();
+}
+
+void SnapshotSync::onChunk(NodeID const& _peer, RLP const& _rlp)
+{
+    if (m_state != State::Downloading || _peer != m_peer || _rlp.itemCount() != 3 ||
+        _rlp[0].toHash<h256>() != m_manifestHash)
+    {
+        return;
+    }
+    auto index = _rlp[1].toInt<uint64_t>();
+    auto it = m_requestedChunks.find(index);
+    if (it == m_requestedChunks.end())
+    {  // a chunk that timed out and has been requested again
+        return;
+    }
+    m_requestedChunks.erase(it);
+    auto data = _rlp[2].toBytesConstRef();
+    if (data.empty())
+    {
+        restart("the snapshot has been released by the peer");
+        return;
+    }
+
+    ++m_importingChunks;
+    auto chunkData = std::make_shared<bytes>(data.toBytes());
+    auto chunk = m_manifest->chunks[index];
+    auto importer = m_importer;
+    auto manifestHash = m_manifestHash;
+    auto self = std::weak_ptr<SnapshotSync>(shared_from_this());
+    m_importPool->enqueue([self, importer, chunk, chunkData, manifestHash, index]() {
+        auto snapshotSync = self.lock();
+        if (!snapshotSync)
+        {
+            return;
+        }
+        bool ok = false;
+        try
+        {
+            ok = importer->importChunk(chunk, ref(*chunkData));
+        }
+        catch (std::exception const& e)
+        {
+            LOG(ERROR) << LOG_BADGE("SYNC") << LOG_BADGE("Snapshot")
+                       << LOG_DESC("Import snapshot chunk failed") << LOG_KV("index", index)
+                       << LOG_KV("errorInfo", boost::diagnostic_information(e));
+        }
+        snapshotSync->onChunkImported(manifestHash, index, chunk.size, ok);
+    });
+    requestChunks();
+}
+
+void SnapshotSync::onChunkImported(
+    h256 const& _manifestHash, size_t _index, uint64_t _size, bool _ok)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        --m_importingChunks;
+        if (_manifestHash != m_manifestHash)
+        {
+            return;
+        }
+        if (_ok)
+        {
+            ++m_importedChunks;
+            m_importedBytes += _size;
+        }
+        else
+        {
+            SYNC_LOG(WARNING) << LOG_BADGE("Snapshot") << LOG_DESC("Invalid snapshot chunk")
+                              << LOG_KV("index", _index) << LOG_KV("peer", m_peer.abridged());
+            ++m_retries;
+            m_pendingChunks.push_back(_index);
+            requestChunks();
+        }
+    }
+    if (m_onNotifyWorker)
+    {
+        m_onNotifyWorker();
+    }
+}
+
+void SnapshotSync::requestChunks()
+{
+    // the chunks being imported are held in memory, so they are limited too
+    auto now = utcSteadyTime();
+    while (!m_pendingChunks.empty() && m_requestedChunks.size() < c_maxSnapshotChunkRequests &&
+           m_importingChunks < c_maxSnapshotChunkRequests)
+    {
+        auto index = m_pendingChunks.front();
+        m_pendingChunks.pop_front();
+        m_requestedChunks[index] = now;
+        SyncSnapshotChunkReqPacket packet;
+        packet.encode(m_manifestHash, index);
+        send(m_peer, packet);
+    }
+}
+
+void SnapshotSync::restart(std::string const& _reason)
+{
+    SYNC_LOG(WARNING) << LOG_BADGE("Snapshot") << LOG_DESC("Restart snapshot import")
+                      << LOG_KV("reason", _reason) << LOG_KV("state", stateName(m_state))
+                      << LOG_KV("peer", m_peer.abridged());
+    // the chunks being imported are dropped by the manifest hash, and the next manifest is
+    // requested after they are finished
+    m_state = State::Idle;
+    m_manifest.reset();
+    m_manifestHash = h256();
+    m_pendingChunks.clear();
+    m_requestedChunks.clear();
+    ++m_retries;
+}
+
+void SnapshotSync::finish()
+{
+    try
+    {
+        m_importer->finish();
+    }
+    catch (std::exception const& e)
+    {
+        restart("finish import failed: " + boost::diagnostic_information(e));
+        return;
+    }
+    m_state = State::Finished;
+    m_finishTime = utcSteadyTime();
+    auto timeCost = m_finishTime - m_startTime;
+    SYNC_LOG(INFO) << LOG_BADGE("Snapshot") << LOG_DESC("Snapshot imported")
+                   << LOG_KV("number", m_manifest->number)
+                   << LOG_KV("chunks", m_manifest->chunks.size())
+                   << LOG_KV("size", m_importedBytes) << LOG_KV("retries", m_retries)
+                   << LOG_KV("timeCost", timeCost)
+                   << LOG_KV("bytesPerSecond", timeCost ? m_importedBytes * 1000 / timeCost : 0);
+}
+
+bool SnapshotSync::checkBlockSign(Block const& _block, h512s const& _sealers)
+{
+    // more than f signatures, at least one of them is from an honest sealer
+    auto minSigners = (_sealers.size() - 1) / 3 + 1;
+    auto hash = _block.blockHeader().hash();
+    std::set<size_t> signers;
+    for (auto const& sign : *_block.sigList())
+    {
+        if (sign.first >= _sealers.size())
+        {
+            return false;
+        }
+        auto index = sign.first.convert_to<size_t>();
+        if (!dev::verify(_sealers[index], sign.second, hash))
+        {
+            return false;
+        }
+        signers.insert(index);
+    }
+    return signers.size() >= minSigners;
+}
+
+Json::Value SnapshotSync::status() const
+{
+    Json::Value status;
+    status["servedChunks"] = (Json::UInt64)m_servedChunks;
+    status["servedBytes"] = (Json::UInt64)m_servedBytes;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    status["state"] = stateName(m_state);
+    status["retries"] = (Json::UInt64)m_retries;
+    if (!m_manifest)
+    {
+        return status;
+    }
+    status["peer"] = toHex(m_peer);
+    status["number"] = (Json::Int64)m_manifest->number;
+    status["chunks"] = (Json::UInt64)m_manifest->chunks.size();
+    status["bytes"] = (Json::UInt64)m_manifest->size();
+    status["importedChunks"] = (Json::UInt64)m_importedChunks;
+    status["importedBytes"] = (Json::UInt64)m_importedBytes;
+    auto elapsed = (m_state == State::Finished ? m_finishTime : utcSteadyTime()) - m_startTime;
+    status["elapsedMs"] = (Json::UInt64)elapsed;
+    status["bytesPerSecond"] = (Json::UInt64)(elapsed ? m_importedBytes * 1000 / elapsed : 0);
+    return status;
+}
+
+void SnapshotSync::send(NodeID const& _peer, SyncMsgPacket& _packet)
+{
+    m_service->asyncSendMessageByNodeID(
+        _peer, _packet.toMessage(m_protocolId), CallbackFuncWithSession(), Options());
+}
+
+std::string SnapshotSync::stateName(State _state)
+{
+    switch (_state)
+    {
+    case State::Idle:
+        return "idle";
+    case State::RequestManifest:
+        return "requestManifest";
+    case State::Downloading:
+        return "downloading";
+    case State::Finished:
+        return "finished";
+    default:
+        return "disabled";
+    }
+}
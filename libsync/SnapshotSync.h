@@ -0,0 +1,163 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+/**
+ * @brief : fast state sync of a new node from the state snapshot of a peer
+ *
+ *  joining node                                 serving node
+ *  SnapshotManifestReq               ------->   snapshot its RocksDB at its current block N
+ *                                    <-------   SnapshotManifest [manifest, block N]
+ *  SnapshotChunkReq [hash, index]    ------->   c_maxSnapshotChunkRequests requests in flight
+ *                                    <-------   SnapshotChunk [hash, index, chunk]
+ *
+ *  the block N must match the block hash of the manifest and be signed by more than f of the
+ *  sealers this node knows, and every chunk must match its sha3 in the manifest, chunks are
+ *  imported on a thread pool in parallel. If the sealers of block N are not the known ones, or the
+ *  block carries no signatures, the import is disabled and blocks are replayed instead. The state
+ *  itself is trusted to the serving group member: the state root of a block header only covers
+ *  the change set of the block, so the imported state can not be checked against block N. After
+ *  the import the node replays blocks from N + 1 by the normal block sync, which verifies their
+ *  signatures against the sealers of the imported state
+ */
+
+#pragma once
+#include "Common.h"
+#include "SyncMsgPacket.h"
+#include "SyncStatus.h"
+#include <json/json.h>
+#include <libblockchain/BlockChainInterface.h>
+#include <libdevcore/ThreadPool.h>
+#include <libp2p/P2PInterface.h>
+#include <libstorage/StateSnapshot.h>
+#include <deque>
+#include <map>
+#include <mutex>
+
+namespace dev
+{
+namespace sync
+{
+static size_t const c_maxSnapshotChunkRequests = 8;
+static uint64_t const c_snapshotManifestTimeout = 60 * 1000;  // ms, the peer may be preparing
+static uint64_t const c_snapshotChunkTimeout = 10 * 1000;     // ms
+static uint64_t const c_snapshotLifetime = 10 * 60 * 1000;    // ms, since the last served request
+// requests queued or being served, the others are dropped and requested again by the peers
+static size_t const c_maxSnapshotServeRequests = 4 * c_maxSnapshotChunkRequests;
+
+class SnapshotSync : public std::enable_shared_from_this<SnapshotSync>
+{
+public:
+    using Ptr = std::shared_ptr<SnapshotSync>;
+    enum class State
+    {
+        Idle,             ///< waiting for peers far enough ahead
+        RequestManifest,  ///< the manifest has been requested
+        Downloading,      ///< downloading and importing chunks
+        Finished,         ///< the snapshot has been imported
+        Disabled          ///< the import is disabled or the node is not at the genesis block
+    };
+
+    SnapshotSync(std::shared_ptr<dev::p2p::P2PInterface> _service,
+        std::shared_ptr<dev::blockchain::BlockChainInterface> _blockChain,
+        std::shared_ptr<SyncMasterStatus> _syncStatus,
+        std::shared_ptr<dev::storage::BasicRocksDB> _db, PROTOCOL_ID const& _protocolId,
+        NodeID const& _nodeId, size_t _chunkSize);
+    virtual ~SnapshotSync() { stop(); }
+    void stop();
+
+    // import a snapshot instead of replaying blocks if this node is at the genesis block when the
+    // peers are at least _threshold blocks ahead
+    void setEnableImport(bool _enableImport, int64_t _threshold);
+    // called with the number of the snapshot after it is imported, before any block is replayed
+    void onImported(std::function<void(int64_t)> const& _f) { m_onImported = _f; }
+    void onNotifyWorker(std::function<void()> const& _f) { m_onNotifyWorker = _f; }
+    // see StateSnapshotExporter::setRowPruner
+    void setRowPruner(dev::storage::RowPruner::Ptr _pruner) { m_exporter->setRowPruner(_pruner); }
+
+    // drive the import and release the served snapshot when idle, called by the sync worker
+    // @return true if the import is in progress, the block download must be suspended
+    bool maintain();
+    bool importing() const;
+    void onPacket(SyncMsgPacket::Ptr _packet, dev::p2p::P2PMessage::Ptr _msg);
+    // progress and throughput of the import and the serving side
+    Json::Value status() const;
+
+private:
+    // serving side
+    void serveManifest(NodeID const& _peer);
+    void serveChunk(NodeID const& _peer, h256 const& _manifestHash, uint64_t _index);
+    void releaseIdleSnapshot();
+    // queue the request to m_serveWorker unless too many requests are queued
+    void enqueueServe(NodeID const& _peer, std::function<void(SnapshotSync&)> const& _serve);
+
+    // joining side, called with m_mutex held
+    void onManifest(NodeID const& _peer, RLP const& _rlp);
+    void onChunk(NodeID const& _peer, RLP const& _rlp);
+    void requestManifest();
+    void requestChunks();
+    void restart(std::string const& _reason);
+    void finish();
+    // whether more than f of _sealers signed the block
+    static bool checkBlockSign(dev::eth::Block const& _block, dev::h512s const& _sealers);
+    // called by the import pool
+    void onChunkImported(h256 const& _manifestHash, size_t _index, uint64_t _size, bool _ok);
+
+    void send(NodeID const& _peer, SyncMsgPacket& _packet);
+    static std::string stateName(State _state);
+
+    std::shared_ptr<dev::p2p::P2PInterface> m_service;
+    std::shared_ptr<dev::blockchain::BlockChainInterface> m_blockChain;
+    std::shared_ptr<SyncMasterStatus> m_syncStatus;
+    std::shared_ptr<dev::storage::BasicRocksDB> m_db;
+    PROTOCOL_ID m_protocolId;
+    GROUP_ID m_groupId;
+    NodeID m_nodeId;
+    std::function<void(int64_t)> m_onImported;
+    std::function<void()> m_onNotifyWorker;
+
+    // serving side
+    dev::storage::StateSnapshotExporter::Ptr m_exporter;
+    dev::ThreadPool::Ptr m_serveWorker;
+    std::mutex m_prepareMutex;
+    uint64_t m_preparedTime = 0;
+    std::atomic<uint64_t> m_lastServeTime = {0};
+    std::atomic<size_t> m_serveRequests = {0};
+    std::atomic<uint64_t> m_servedChunks = {0};
+    std::atomic<uint64_t> m_servedBytes = {0};
+
+    // joining side
+    bool m_enableImport = false;
+    int64_t m_threshold = 0;
+    dev::ThreadPool::Ptr m_importPool;
+    mutable std::mutex m_mutex;
+    State m_state = State::Disabled;
+    NodeID m_peer;
+    uint64_t m_requestTime = 0;
+    dev::storage::SnapshotManifest::Ptr m_manifest;
+    h256 m_manifestHash;
+    dev::storage::StateSnapshotImporter::Ptr m_importer;
+    std::deque<size_t> m_pendingChunks;
+    std::map<size_t, uint64_t> m_requestedChunks;  // chunk index => request time
+    size_t m_importingChunks = 0;
+    size_t m_importedChunks = 0;
+    uint64_t m_importedBytes = 0;
+    uint64_t m_startTime = 0;
+    uint64_t m_finishTime = 0;
+    uint64_t m_retries = 0;
+};
+
+}  // namespace sync
+}  // namespace dev
@@ -94,11 +94,38 @@ string const SyncMaster::syncInfo() const
     });
 
     syncInfo["peers"] = peersInfo;
+    if (m_snapshotSync)
+    {
+        syncInfo["snapshotSync"] = m_snapshotSync->status();
+    }
     Json::FastWriter fastWriter;
     std::string statusStr = fastWriter.write(syncInfo);
     return statusStr;
 }
 
+void SyncMaster::enableSnapshotSync(std::shared_ptr<dev::storage::BasicRocksDB> _db,
+    dev::storage::RowPruner::Ptr _pruner, bool _enableImport, int64_t _threshold,
+    size_t _chunkSize, std::function<void(int64_t)> const& _onImported)
+{
+    m_snapshotSync = std::make_shared<SnapshotSync>(
+        m_service, m_blockChain, m_syncStatus, _db, m_protocolId, m_nodeId, _chunkSize);
+    m_snapshotSync->setRowPruner(_pruner);
+    m_snapshotSync->setEnableImport(_enableImport, _threshold);
+    m_snapshotSync->onImported(_onImported);
+    m_snapshotSync->onNotifyWorker([&]() { m_signalled.notify_all(); });
+    auto snapshotSync = std::weak_ptr<SnapshotSync>(m_snapshotSync);
+    m_msgEngine->onSnapshotPacket([snapshotSync](SyncMsgPacket::Ptr _packet, P2PMessage::Ptr _msg) {
+        auto sync = snapshotSync.lock();
+        if (sync)
+        {
+            sync->onPacket(_packet, _msg);
+        }
+    });
+    SYNC_LOG(INFO) << LOG_BADGE("Snapshot") << LOG_DESC("enableSnapshotSync")
+                   << LOG_KV("enableImport", _enableImport) << LOG_KV("threshold", _threshold)
+                   << LOG_KV("chunkSize", _chunkSize);
+}
+
 void SyncMaster::start()
 {
     startWorking();
@@ -120,6 +147,10 @@ void SyncMaster::stop()
     {
         m_downloadBlockProcessor->stop();
     }
+    if (m_snapshotSync)
+    {
+        m_snapshotSync->stop();
+    }
     if (m_sendBlockProcessor)
     {
         m_sendBlockProcessor->stop();
@@ -146,6 +177,11 @@ void SyncMaster::doWork()
     m_downloadBlockProcessor->enqueue([this]() {
         try
         {
+            // blocks are replayed after the state snapshot is imported
+            if (m_snapshotSync && m_snapshotSync->maintain())
+            {
+                return;
+            }
             // flush downloaded buffer into downloading queue
             maintainDownloadingQueueBuffer();
             // Not Idle do
@@ -208,7 +244,8 @@ void SyncMaster::noteSealingBlockNumber(int64_t _number)
 
 bool SyncMaster::isSyncing() const
 {
-    return m_syncStatus->state != SyncState::Idle;
+    return m_syncStatus->state != SyncState::Idle ||
+           (m_snapshotSync && m_snapshotSync->importing());
 }
 
 // is my number is far smaller than max block number of this block chain
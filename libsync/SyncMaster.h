@@ -25,6 +25,7 @@
 #include "DownloadingTxsQueue.h"
 #include "GossipBlockStatus.h"
 #include "RspBlockReq.h"
+#include "SnapshotSync.h"
 #include "SyncInterface.h"
 #include "SyncMsgEngine.h"
 #include "SyncStatus.h"
@@ -129,6 +130,14 @@ public:
         m_syncTrans->setTxsStatusGossipMaxPeers(_txsStatusGossipMaxPeers);
     }
 
+    // serve state snapshots of _db to new nodes, and import a snapshot instead of replaying
+    // blocks if _enableImport and this node is at least _threshold blocks behind from genesis
+    // _onImported is called with the number of the imported snapshot, _pruner is the pruner of
+    // the compaction filter of _db, nullptr if pruning is disabled
+    void enableSnapshotSync(std::shared_ptr<dev::storage::BasicRocksDB> _db,
+        dev::storage::RowPruner::Ptr _pruner, bool _enableImport, int64_t _threshold,
+        size_t _chunkSize, std::function<void(int64_t)> const& _onImported);
+
     virtual ~SyncMaster() { stop(); };
     /// start blockSync
     virtual void start() override;
@@ -265,6 +274,9 @@ private:
     /// Message handler of p2p
     std::shared_ptr<SyncMsgEngine> m_msgEngine;
 
+    /// state snapshot sync, nullptr if the storage is not RocksDB
+    SnapshotSync::Ptr m_snapshotSync = nullptr;
+
     dev::ThreadPool::Ptr m_downloadBlockProcessor = nullptr;
     dev::ThreadPool::Ptr m_sendBlockProcessor = nullptr;
 
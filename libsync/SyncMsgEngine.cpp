@@ -144,6 +144,12 @@ bool SyncMsgEngine::interpret(
                 }
             });
             break;
+        case SnapshotManifestReqPacket:
+        case SnapshotManifestPacket:
+        case SnapshotChunkReqPacket:
+        case SnapshotChunkPacket:
+            onPeerSnapshot(_packet, _msg);
+            break;
         default:
             return false;
         }
@@ -302,6 +308,26 @@ void SyncMsgEngine::onPeerRequestBlocks(SyncMsgPacket const& _packet)
     }
 }
 
+void SyncMsgEngine::onPeerSnapshot(SyncMsgPacket::Ptr _packet, dev::p2p::P2PMessage::Ptr _msg)
+{
+    if (!m_onSnapshotPacket)
+    {
+        SYNC_ENGINE_LOG(DEBUG) << LOG_BADGE("Snapshot") << LOG_DESC("Snapshot sync is disabled")
+                               << LOG_KV("packetType", int(_packet->packetType))
+                               << LOG_KV("peer", _packet->nodeId.abridged());
+        return;
+    }
+    if (!checkGroupPacket(*_packet))
+    {
+        SYNC_ENGINE_LOG(WARNING) << LOG_BADGE("Snapshot")
+                                 << LOG_DESC("Drop unknown peer snapshot packet")
+                                 << LOG_KV("packetType", int(_packet->packetType))
+                                 << LOG_KV("fromNodeId", _packet->nodeId.abridged());
+        return;
+    }
+    m_onSnapshotPacket(_packet, _msg);
+}
+
 void DownloadBlocksContainer::batchAndSend(BlockPtr _block)
 {
     // TODO: thread safe
@@ -79,6 +79,12 @@ public:
 
     void onNotifyWorker(std::function<void()> const& _f) { m_onNotifyWorker = _f; }
     void onNotifySyncTrans(std::function<void()> const& _f) { m_onNotifySyncTrans = _f; }
+    // state snapshot packets of group members are passed to _f, the message keeps the rlp alive
+    void onSnapshotPacket(
+        std::function<void(SyncMsgPacket::Ptr, dev::p2p::P2PMessage::Ptr)> const& _f)
+    {
+        m_onSnapshotPacket = _f;
+    }
 
 private:
     bool checkSession(std::shared_ptr<dev::p2p::P2PSession> _session);
@@ -98,6 +104,7 @@ protected:
         std::shared_ptr<SyncMsgPacket> _packet, dev::h512 const& _peer, dev::p2p::P2PMessage::Ptr);
     void onReceiveTxsRequest(std::shared_ptr<SyncMsgPacket> _txsReqPacket, dev::h512 const& _peer,
         dev::p2p::P2PMessage::Ptr);
+    void onPeerSnapshot(SyncMsgPacket::Ptr _packet, dev::p2p::P2PMessage::Ptr _msg);
 
 
 protected:
@@ -115,6 +122,8 @@ protected:
     h256 m_genesisHash;
     std::function<void()> m_onNotifyWorker = nullptr;
     std::function<void()> m_onNotifySyncTrans = nullptr;
+    std::function<void(SyncMsgPacket::Ptr, dev::p2p::P2PMessage::Ptr)> m_onSnapshotPacket =
+        nullptr;
 
     std::shared_ptr<dev::ThreadPool> m_txsWorker;
     std::shared_ptr<dev::ThreadPool> m_txsSender;
@@ -159,4 +159,29 @@ void SyncTxsReqPacket::encode(std::shared_ptr<std::vector<dev::h256>> _requested
 {
     m_rlpStream.clear();
     prep(m_rlpStream, packetType, 1).append(*_requestedTxs);
+}
+
+void SyncSnapshotManifestReqPacket::encode()
+{
+    m_rlpStream.clear();
+    prep(m_rlpStream, packetType, 0);
+}
+
+void SyncSnapshotManifestPacket::encode(bytes const& _manifest, bytes const& _blockRLP)
+{
+    m_rlpStream.clear();
+    prep(m_rlpStream, packetType, 2) << _manifest << _blockRLP;
+}
+
+void SyncSnapshotChunkReqPacket::encode(h256 const& _manifestHash, uint64_t _index)
+{
+    m_rlpStream.clear();
+    prep(m_rlpStream, packetType, 2) << _manifestHash << _index;
+}
+
+void SyncSnapshotChunkPacket::encode(
+    h256 const& _manifestHash, uint64_t _index, bytesConstRef _chunk)
+{
+    m_rlpStream.clear();
+    prep(m_rlpStream, packetType, 3) << _manifestHash << _index << _chunk;
 }
\ No newline at end of file
@@ -125,5 +125,36 @@ public:
     void encode(std::shared_ptr<std::vector<dev::h256>> _requestedTxs);
 };
 
+// state snapshot packets, see SnapshotSync
+class SyncSnapshotManifestReqPacket : public SyncMsgPacket
+{
+public:
+    SyncSnapshotManifestReqPacket() { packetType = SnapshotManifestReqPacket; }
+    void encode();
+};
+
+class SyncSnapshotManifestPacket : public SyncMsgPacket
+{
+public:
+    SyncSnapshotManifestPacket() { packetType = SnapshotManifestPacket; }
+    // the encoded manifest and the block of the snapshot
+    void encode(bytes const& _manifest, bytes const& _blockRLP);
+};
+
+class SyncSnapshotChunkReqPacket : public SyncMsgPacket
+{
+public:
+    SyncSnapshotChunkReqPacket() { packetType = SnapshotChunkReqPacket; }
+    void encode(h256 const& _manifestHash, uint64_t _index);
+};
+
+class SyncSnapshotChunkPacket : public SyncMsgPacket
+{
+public:
+    SyncSnapshotChunkPacket() { packetType = SnapshotChunkPacket; }
+    // the empty chunk means the snapshot has been released by the peer
+    void encode(h256 const& _manifestHash, uint64_t _index, bytesConstRef _chunk);
+};
+
 }  // namespace sync
 }  // namespace dev
@@ -28,6 +28,10 @@ namespace txpool
 {
 bool CommonTransactionNonceCheck::isNonceOk(dev::eth::Transaction const& _trans, bool needInsert)
 {
+    if (!needInsert && !mayContain(_trans.nonce()))
+    {
+        return true;
+    }
     UpgradableGuard l(m_lock);
     {
         const auto& key = _trans.nonce();
@@ -50,6 +54,49 @@ bool CommonTransactionNonceCheck::isNonceOk(dev::eth::Transaction const& _trans,
     return false;
 }
 
+void CommonTransactionNonceCheck::checkNonces(
+    Transactions const& _transactions, std::vector<bool>& _ok, bool needInsert)
+{
+    if (!needInsert)
+    {
+        // only the nonces that may be in the cache are checked under the lock
+        std::vector<size_t> candidates;
+        for (size_t i = 0; i < _transactions.size(); i++)
+        {
+            if (_ok[i] && mayContain(_transactions[i]->nonce()))
+            {
+                candidates.push_back(i);
+            }
+        }
+        if (candidates.empty())
+        {
+            return;
+        }
+        ReadGuard l(m_lock);
+        for (auto i : candidates)
+        {
+            if (m_cache.count(_transactions[i]->nonce()))
+            {
+                LOG(TRACE) << LOG_DESC("CommonTransactionNonceCheck: checkNonces: duplicated nonce")
+                           << LOG_KV("transHash", _transactions[i]->sha3().abridged());
+                _ok[i] = false;
+            }
+        }
+        return;
+    }
+    WriteGuard l(m_lock);
+    for (size_t i = 0; i < _transactions.size(); i++)
+    {
+        // the duplicated nonces of the same batch are refused too
+        if (_ok[i] && !m_cache.insert(_transactions[i]->nonce()).second)
+        {
+            LOG(TRACE) << LOG_DESC("CommonTransactionNonceCheck: checkNonces: duplicated nonce")
+                       << LOG_KV("transHash", _transactions[i]->sha3().abridged());
+            _ok[i] = false;
+        }
+    }
+}
+
 void CommonTransactionNonceCheck::delCache(dev::eth::NonceKeyType const& key)
 {
     UpgradableGuard l(m_lock);
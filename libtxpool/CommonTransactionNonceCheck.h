@@ -42,8 +42,16 @@ public:
     virtual void delCache(dev::eth::Transactions const& _transactions);
     virtual void insertCache(dev::eth::Transaction const& _transaction);
     virtual bool isNonceOk(dev::eth::Transaction const& _trans, bool needInsert = false);
+    /// check the nonces of the transactions whose flags of _ok are set under one lock, the flags of
+    /// the duplicated ones are cleared, the nonces of the others are inserted if needInsert
+    virtual void checkNonces(dev::eth::Transactions const& _transactions, std::vector<bool>& _ok,
+        bool needInsert = false);
 
 protected:
+    /// return false if the nonce is not in the cache for sure, so the lock of the cache is not
+    /// needed to check the nonce
+    virtual bool mayContain(dev::eth::NonceKeyType const&) const { return true; }
+
     mutable SharedMutex m_lock;
     std::unordered_set<dev::eth::NonceKeyType> m_cache;
 };
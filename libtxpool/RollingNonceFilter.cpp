@@ -0,0 +1,162 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+
+/**
+ * @brief : the bloom filter of the nonces of the latest blocks
+ * @file: RollingNonceFilter.cpp
+ */
+#include "RollingNonceFilter.h"
+#include <algorithm>
+
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::txpool;
+
+const size_t BlockedBloomFilter::c_wordsPerBlock;
+const size_t BlockedBloomFilter::c_bitsPerKey;
+const int64_t RollingNonceFilter::c_segmentBlocks;
+const size_t RollingNonceFilter::c_defaultSegmentBits;
+
+namespace
+{
+// the finalizer of splitmix64
+uint64_t mix(uint64_t _value)
+{
+    _value = (_value ^ (_value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    _value = (_value ^ (_value >> 27)) * 0x94d049bb133111ebULL;
+    return _value ^ (_value >> 31);
+}
+}  // namespace
+
+BlockedBloomFilter::BlockedBloomFilter(size_t _bits)
+  : m_words(std::max((_bits + c_wordsPerBlock * 64 - 1) / (c_wordsPerBlock * 64), (size_t)1) *
+            c_wordsPerBlock),
+    m_blocks(m_words.size() / c_wordsPerBlock)
+{
+    clear();
+}
+
+void BlockedBloomFilter::insert(uint64_t _hash)
+{
+    auto words = &m_words[(_hash % m_blocks) * c_wordsPerBlock];
+    // the bits in the block are taken from another hash, 9 bits a position
+    auto positions = mix(_hash);
+    for (size_t i = 0; i < c_bitsPerKey; i++, positions >>= 9)
+    {
+        auto bit = positions & 511;
+        words[bit >> 6].fetch_or((uint64_t)1 << (bit & 63), std::memory_order_relaxed);
+    }
+}
+
+bool BlockedBloomFilter::mayContain(uint64_t _hash) const
+{
+    auto words = &m_words[(_hash % m_blocks) * c_wordsPerBlock];
+    auto positions = mix(_hash);
+    for (size_t i = 0; i < c_bitsPerKey; i++, positions >>= 9)
+    {
+        auto bit = positions & 511;
+        if (!(words[bit >> 6].load(std::memory_order_relaxed) & ((uint64_t)1 << (bit & 63))))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void BlockedBloomFilter::clear()
+{
+    for (auto& word : m_words)
+    {
+        word.store(0, std::memory_order_relaxed);
+    }
+}
+
+RollingNonceFilter::RollingNonceFilter(int64_t _blockLimit, size_t _segmentBits)
+{
+    // one more segment than the blocks kept, the segment reused is expired in time
+    auto segments = std::max(_blockLimit, (int64_t)0) / c_segmentBlocks + 2;
+    for (int64_t i = 0; i < segments; i++)
+    {
+        m_segments.push_back(std::make_shared<Segment>(_segmentBits));
+    }
+}
+
+uint64_t RollingNonceFilter::hash(NonceKeyType const& _nonce)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < 4; i++)
+    {
+        value = mix(value ^ (uint64_t)((_nonce >> (64 * i)) & u256(~(uint64_t)0)));
+    }
+    return value;
+}
+
+void RollingNonceFilter::insert(int64_t _blockNumber, std::vector<NonceKeyType> const& _nonces)
+{
+    auto& segment = *m_segments[(_blockNumber / c_segmentBlocks) % m_segments.size()];
+    // the segment may keep the blocks not expired if the block limit is enlarged, the nonces of
+    // them are kept too
+    segment.maxBlock = std::max(segment.maxBlock, _blockNumber);
+    for (auto const& nonce : _nonces)
+    {
+        segment.filter.insert(hash(nonce));
+    }
+}
+
+void RollingNonceFilter::expire(int64_t _startBlock)
+{
+    for (auto& segment : m_segments)
+    {
+        if (segment->maxBlock >= 0 && segment->maxBlock < _startBlock)
+        {
+            segment->filter.clear();
+            segment->maxBlock = -1;
+        }
+    }
+}
+
+void RollingNonceFilter::clear()
+{
+    for (auto& segment : m_segments)
+    {
+        segment->filter.clear();
+        segment->maxBlock = -1;
+    }
+}
+
+bool RollingNonceFilter::mayContain(NonceKeyType const& _nonce) const
+{
+    auto nonceHash = hash(_nonce);
+    for (auto const& segment : m_segments)
+    {
+        if (segment->filter.mayContain(nonceHash))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t RollingNonceFilter::bytes() const
+{
+    size_t size = 0;
+    for (auto const& segment : m_segments)
+    {
+        size += segment->filter.bytes();
+    }
+    return size;
+}
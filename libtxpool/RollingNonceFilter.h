@@ -0,0 +1,96 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+
+/**
+ * @brief : the bloom filter of the nonces of the latest blocks
+ * @file: RollingNonceFilter.h
+ */
+#pragma once
+#include <libethcore/Common.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace dev
+{
+namespace txpool
+{
+/**
+ * the bits of a key are set in one block of 512 bits, which is a cache line, and the bits are
+ * atomic, so the filter is queried without lock and with one cache miss at most
+ */
+class BlockedBloomFilter
+{
+public:
+    static const size_t c_wordsPerBlock = 8;
+    /// the number of bits set for a key
+    static const size_t c_bitsPerKey = 4;
+
+    /// _bits is rounded up to a multiple of the block size
+    explicit BlockedBloomFilter(size_t _bits);
+
+    void insert(uint64_t _hash);
+    /// false if the key is not inserted for sure
+    bool mayContain(uint64_t _hash) const;
+    void clear();
+    size_t bytes() const { return m_words.size() * sizeof(uint64_t); }
+
+private:
+    std::vector<std::atomic<uint64_t>> m_words;
+    size_t m_blocks;
+};
+
+/**
+ * the nonces of the latest blocks kept in segments, every segment is a bloom filter of the nonces
+ * of c_segmentBlocks successive blocks, so the nonces of the expired blocks are dropped by
+ * resetting the segments rather than rebuilding the filter. A segment is reset only when all its
+ * blocks expire, so a nonce of the blocks not expired is never missed.
+ * The filter is queried by many threads without lock, and updated by one thread at a time.
+ */
+class RollingNonceFilter
+{
+public:
+    using Ptr = std::shared_ptr<RollingNonceFilter>;
+    static const int64_t c_segmentBlocks = 64;
+    /// 128KB a segment, a segment holds about 100 thousand nonces with 1% false positive
+    static const size_t c_defaultSegmentBits = 1 << 20;
+
+    /// _blockLimit : the number of the latest blocks whose nonces are kept
+    RollingNonceFilter(int64_t _blockLimit, size_t _segmentBits = c_defaultSegmentBits);
+
+    void insert(int64_t _blockNumber, std::vector<dev::eth::NonceKeyType> const& _nonces);
+    /// reset the segments of the blocks before _startBlock
+    void expire(int64_t _startBlock);
+    void clear();
+    /// false if the nonce is not in the blocks not expired for sure
+    bool mayContain(dev::eth::NonceKeyType const& _nonce) const;
+    size_t bytes() const;
+
+    static uint64_t hash(dev::eth::NonceKeyType const& _nonce);
+
+private:
+    struct Segment
+    {
+        explicit Segment(size_t _bits) : filter(_bits) {}
+        BlockedBloomFilter filter;
+        /// the latest block inserted since the last reset, -1 if none
+        int64_t maxBlock = -1;
+    };
+    std::vector<std::shared_ptr<Segment>> m_segments;
+};
+}  // namespace txpool
+}  // namespace dev
@@ -0,0 +1,246 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+
+/**
+ * @brief : the pending transactions of the txPool grouped by the senders
+ * @file: SenderLanes.cpp
+ */
+#include "SenderLanes.h"
+#include <algorithm>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::txpool;
+
+const size_t SenderLanes::c_defaultShards;
+const size_t SenderLanes::c_traverseChunkSize;
+
+SenderLanes::SenderLanes(size_t _shards)
+{
+    for (size_t i = 0; i < std::max(_shards, (size_t)1); i++)
+    {
+        m_shards.push_back(std::make_shared<Shard>());
+    }
+}
+
+void SenderLanes::setWeights(std::map<Address, size_t> const& _weights)
+{
+    WriteGuard l(x_weights);
+    m_weights = _weights;
+}
+
+size_t SenderLanes::weight(Address const& _sender) const
+{
+    ReadGuard l(x_weights);
+    auto it = m_weights.find(_sender);
+    if (it == m_weights.end())
+    {
+        return 1;
+    }
+    return std::max(it->second, (size_t)1);
+}
+
+ImportResult SenderLanes::insert(Transaction::Ptr const& _tx)
+{
+    auto sender = _tx->sender();
+    auto txHash = _tx->sha3();
+    auto senderWeight = weight(sender);
+    auto& shard = *m_shards[shardIndex(sender)];
+    WriteGuard l(shard.lock);
+    auto it = shard.lanes.find(sender);
+    if (it == shard.lanes.end())
+    {
+        it = shard.lanes.emplace(sender, Lane()).first;
+        it->second.weight = senderWeight;
+    }
+    auto& lane = it->second;
+    if (lane.index.count(txHash))
+    {
+        return ImportResult::AlreadyKnown;
+    }
+    if (m_senderLimit > 0 && lane.queue.size() >= m_senderLimit * lane.weight)
+    {
+        return ImportResult::TransactionPoolIsFull;
+    }
+    if (!lane.queue.empty())
+    {
+        shard.loads.erase(std::make_pair(lane.load(), sender));
+    }
+    auto sequence = ++m_sequence;
+    lane.queue.emplace(sequence, _tx);
+    lane.index.emplace(txHash, sequence);
+    shard.loads.emplace(lane.load(), sender);
+    return ImportResult::Success;
+}
+
+bool SenderLanes::erase(Transaction::Ptr const& _tx)
+{
+    auto sender = _tx->sender();
+    auto& shard = *m_shards[shardIndex(sender)];
+    WriteGuard l(shard.lock);
+    auto it = shard.lanes.find(sender);
+    if (it == shard.lanes.end())
+    {
+        return false;
+    }
+    auto& lane = it->second;
+    auto indexIt = lane.index.find(_tx->sha3());
+    if (indexIt == lane.index.end())
+    {
+        return false;
+    }
+    shard.loads.erase(std::make_pair(lane.load(), sender));
+    lane.queue.erase(indexIt->second);
+    lane.index.erase(indexIt);
+    if (lane.queue.empty())
+    {
+        shard.lanes.erase(it);
+    }
+    else
+    {
+        shard.loads.emplace(lane.load(), sender);
+    }
+    return true;
+}
+
+size_t SenderLanes::size(Address const& _sender) const
+{
+    auto const& shard = *m_shards[shardIndex(_sender)];
+    ReadGuard l(shard.lock);
+    auto it = shard.lanes.find(_sender);
+    if (it == shard.lanes.end())
+    {
+        return 0;
+    }
+    return it->second.queue.size();
+}
+
+void SenderLanes::clear()
+{
+    for (auto& shard : m_shards)
+    {
+        WriteGuard l(shard->lock);
+        shard->lanes.clear();
+        shard->loads.clear();
+    }
+}
+
+Transaction::Ptr SenderLanes::evictionCandidate(Address const& _sender) const
+{
+    double heaviestLoad = (double)(size(_sender) + 1) / weight(_sender);
+    size_t heaviestShard = m_shards.size();
+    Address heaviest;
+    for (size_t i = 0; i < m_shards.size(); i++)
+    {
+        ReadGuard l(m_shards[i]->lock);
+        auto const& loads = m_shards[i]->loads;
+        if (!loads.empty() && loads.rbegin()->first > heaviestLoad)
+        {
+            heaviestLoad = loads.rbegin()->first;
+            heaviest = loads.rbegin()->second;
+            heaviestShard = i;
+        }
+    }
+    if (heaviestShard == m_shards.size())
+    {
+        return nullptr;
+    }
+    ReadGuard l(m_shards[heaviestShard]->lock);
+    auto const& lanes = m_shards[heaviestShard]->lanes;
+    auto it = lanes.find(heaviest);
+    if (it == lanes.end())
+    {
+        return nullptr;
+    }
+    return it->second.queue.rbegin()->second;
+}
+
+void SenderLanes::forEach(std::function<bool(Transaction::Ptr const&)> const& _f) const
+{
+    // the transactions copied from a lane, the next chunk starts after the last visited one
+    struct Cursor
+    {
+        Address sender;
+        size_t shard;
+        size_t weight;
+        uint64_t last = 0;
+        std::vector<std::pair<uint64_t, Transaction::Ptr>> chunk;
+        size_t next = 0;
+        bool exhausted = false;
+    };
+    auto copy = [](Lane const& _lane, Cursor& _cursor, size_t _max) {
+        _cursor.chunk.clear();
+        _cursor.next = 0;
+        for (auto it = _lane.queue.upper_bound(_cursor.last);
+             it != _lane.queue.end() && _cursor.chunk.size() < _max; ++it)
+        {
+            _cursor.chunk.push_back(*it);
+        }
+    };
+    auto fetch = [&](Cursor& _cursor) {
+        ReadGuard l(m_shards[_cursor.shard]->lock);
+        auto const& lanes = m_shards[_cursor.shard]->lanes;
+        auto it = lanes.find(_cursor.sender);
+        if (it == lanes.end())
+        {
+            return false;
+        }
+        copy(it->second, _cursor, c_traverseChunkSize);
+        return !_cursor.chunk.empty();
+    };
+    // only the transactions of the first round are copied at first
+    std::vector<Cursor> cursors;
+    for (size_t i = 0; i < m_shards.size(); i++)
+    {
+        ReadGuard l(m_shards[i]->lock);
+        for (auto const& item : m_shards[i]->lanes)
+        {
+            Cursor cursor;
+            cursor.sender = item.first;
+            cursor.shard = i;
+            cursor.weight = item.second.weight;
+            copy(item.second, cursor, std::min(cursor.weight, c_traverseChunkSize));
+            cursors.push_back(std::move(cursor));
+        }
+    }
+    std::sort(cursors.begin(), cursors.end(), [](Cursor const& _a, Cursor const& _b) {
+        return _a.chunk.front().first < _b.chunk.front().first;
+    });
+    while (!cursors.empty())
+    {
+        for (auto& cursor : cursors)
+        {
+            for (size_t i = 0; i < cursor.weight; i++)
+            {
+                if (cursor.next == cursor.chunk.size() && !fetch(cursor))
+                {
+                    cursor.exhausted = true;
+                    break;
+                }
+                cursor.last = cursor.chunk[cursor.next].first;
+                if (!_f(cursor.chunk[cursor.next++].second))
+                {
+                    return;
+                }
+            }
+        }
+        cursors.erase(std::remove_if(cursors.begin(), cursors.end(),
+                          [](Cursor const& _cursor) { return _cursor.exhausted; }),
+            cursors.end());
+    }
+}
@@ -0,0 +1,108 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+
+/**
+ * @brief : the pending transactions of the txPool grouped by the senders
+ * @file: SenderLanes.h
+ */
+#pragma once
+#include <libdevcore/Guards.h>
+#include <libethcore/Common.h>
+#include <libethcore/Transaction.h>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <set>
+#include <unordered_map>
+
+namespace dev
+{
+namespace txpool
+{
+/**
+ * every sender has a lane of its pending transactions in the order of insertion, the lanes are
+ * partitioned by the senders. A sender of weight w:
+ *  1. can keep w times the sender limit of pending transactions
+ *  2. is given w transactions in a round of sealing
+ *  3. has a load of (pending transactions / w), the lane of the heaviest load is evicted first
+ */
+class SenderLanes
+{
+public:
+    using Ptr = std::shared_ptr<SenderLanes>;
+    static const size_t c_defaultShards = 16;
+    /// the max number of transactions copied from a lane at a time when traversed
+    static const size_t c_traverseChunkSize = 32;
+
+    explicit SenderLanes(size_t _shards = c_defaultShards);
+
+    /// the max number of pending transactions of a sender of weight 1, 0 means no limit
+    void setSenderLimit(size_t _limit) { m_senderLimit = _limit; }
+    /// the senders not set are of weight 1, the lanes created before keep their weights
+    void setWeights(std::map<Address, size_t> const& _weights);
+    size_t weight(Address const& _sender) const;
+
+    /**
+     * @brief : append the transaction to the lane of its sender
+     * @return ImportResult : AlreadyKnown if the transaction exists, TransactionPoolIsFull if the
+     * lane reaches the limit of the sender
+     */
+    dev::eth::ImportResult insert(dev::eth::Transaction::Ptr const& _tx);
+    /// return false if the transaction doesn't exist
+    bool erase(dev::eth::Transaction::Ptr const& _tx);
+    /// the number of pending transactions of the sender
+    size_t size(Address const& _sender) const;
+    void clear();
+
+    /// the newest transaction of the heaviest lane, if the lane is heavier than the lane of
+    /// _sender with one more transaction, or nullptr
+    dev::eth::Transaction::Ptr evictionCandidate(Address const& _sender) const;
+
+    /// visit the transactions in rounds until _f returns false, in a round every lane gives its
+    /// next w transactions, the lanes are ordered by their first transactions, no lock is held
+    /// when _f is called
+    void forEach(std::function<bool(dev::eth::Transaction::Ptr const&)> const& _f) const;
+
+private:
+    struct Lane
+    {
+        size_t weight = 1;
+        std::map<uint64_t, dev::eth::Transaction::Ptr> queue;
+        /// the sequences of the transactions
+        std::unordered_map<h256, uint64_t> index;
+        double load() const { return (double)queue.size() / weight; }
+    };
+    struct Shard
+    {
+        mutable SharedMutex lock;
+        std::unordered_map<Address, Lane> lanes;
+        /// the lanes ordered by the loads
+        std::set<std::pair<double, Address>> loads;
+    };
+    size_t shardIndex(Address const& _sender) const
+    {
+        return std::hash<Address>()(_sender) % m_shards.size();
+    }
+
+    std::vector<std::shared_ptr<Shard>> m_shards;
+    std::atomic<uint64_t> m_sequence = {0};
+    std::atomic<size_t> m_senderLimit = {0};
+    mutable SharedMutex x_weights;
+    std::map<Address, size_t> m_weights;
+};
+}  // namespace txpool
+}  // namespace dev
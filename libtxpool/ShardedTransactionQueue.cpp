@@ -0,0 +1,145 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+
+/**
+ * @brief : the pending transactions of the txPool partitioned by the transaction hash
+ * @file: ShardedTransactionQueue.cpp
+ */
+#include "ShardedTransactionQueue.h"
+#include <queue>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::txpool;
+
+const size_t ShardedTransactionQueue::c_defaultShards;
+const size_t ShardedTransactionQueue::c_traverseChunkSize;
+
+ShardedTransactionQueue::ShardedTransactionQueue(size_t _shards)
+{
+    for (size_t i = 0; i < std::max(_shards, (size_t)1); i++)
+    {
+        m_shards.push_back(std::make_shared<Shard>());
+    }
+}
+
+bool ShardedTransactionQueue::insert(Transaction::Ptr const& _tx)
+{
+    auto txHash = _tx->sha3();
+    auto& txsShard = shard(txHash);
+    WriteGuard l(txsShard.lock);
+    if (txsShard.index.count(txHash))
+    {
+        return false;
+    }
+    auto sequence = ++m_sequence;
+    txsShard.queue.emplace(sequence, _tx);
+    txsShard.index.emplace(txHash, sequence);
+    ++m_size;
+    return true;
+}
+
+Transaction::Ptr ShardedTransactionQueue::erase(h256 const& _txHash)
+{
+    auto& txsShard = shard(_txHash);
+    WriteGuard l(txsShard.lock);
+    auto it = txsShard.index.find(_txHash);
+    if (it == txsShard.index.end())
+    {
+        return nullptr;
+    }
+    auto queueIt = txsShard.queue.find(it->second);
+    auto tx = queueIt->second;
+    txsShard.queue.erase(queueIt);
+    txsShard.index.erase(it);
+    --m_size;
+    return tx;
+}
+
+Transaction::Ptr ShardedTransactionQueue::find(h256 const& _txHash) const
+{
+    auto& txsShard = shard(_txHash);
+    ReadGuard l(txsShard.lock);
+    auto it = txsShard.index.find(_txHash);
+    if (it == txsShard.index.end())
+    {
+        return nullptr;
+    }
+    return txsShard.queue.at(it->second);
+}
+
+void ShardedTransactionQueue::clear()
+{
+    for (auto& txsShard : m_shards)
+    {
+        WriteGuard l(txsShard->lock);
+        m_size -= txsShard->queue.size();
+        txsShard->queue.clear();
+        txsShard->index.clear();
+    }
+}
+
+void ShardedTransactionQueue::forEach(std::function<bool(Transaction::Ptr const&)> const& _f) const
+{
+    // the transactions copied from a shard, the next chunk starts after the last visited one
+    struct Cursor
+    {
+        uint64_t last = 0;
+        std::vector<std::pair<uint64_t, Transaction::Ptr>> chunk;
+        size_t next = 0;
+    };
+    std::vector<Cursor> cursors(m_shards.size());
+    auto fetch = [&](size_t _shard) {
+        auto& cursor = cursors[_shard];
+        cursor.chunk.clear();
+        cursor.next = 0;
+        ReadGuard l(m_shards[_shard]->lock);
+        auto const& queue = m_shards[_shard]->queue;
+        for (auto it = queue.upper_bound(cursor.last);
+             it != queue.end() && cursor.chunk.size() < c_traverseChunkSize; ++it)
+        {
+            cursor.chunk.push_back(*it);
+        }
+        return !cursor.chunk.empty();
+    };
+    // the sequences of the next transactions of the shards
+    using Head = std::pair<uint64_t, size_t>;
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+    for (size_t i = 0; i < m_shards.size(); i++)
+    {
+        if (fetch(i))
+        {
+            heads.emplace(cursors[i].chunk.front().first, i);
+        }
+    }
+    while (!heads.empty())
+    {
+        auto i = heads.top().second;
+        heads.pop();
+        auto& cursor = cursors[i];
+        cursor.last = cursor.chunk[cursor.next].first;
+        if (!_f(cursor.chunk[cursor.next].second))
+        {
+            return;
+        }
+        if (++cursor.next < cursor.chunk.size() || fetch(i))
+        {
+            heads.emplace(cursor.chunk[cursor.next].first, i);
+        }
+    }
+}
@@ -0,0 +1,81 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+
+/**
+ * @brief : the pending transactions of the txPool partitioned by the transaction hash
+ * @file: ShardedTransactionQueue.h
+ */
+#pragma once
+#include <libdevcore/Guards.h>
+#include <libethcore/Transaction.h>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <unordered_map>
+
+namespace dev
+{
+namespace txpool
+{
+/**
+ * every shard has its own lock, index and queue, the transactions of a shard are ordered by the
+ * sequence assigned on insertion, and the shards are merged by the sequences when traversed, so
+ * the transactions are visited in the order of insertion without a global lock
+ */
+class ShardedTransactionQueue
+{
+public:
+    using Ptr = std::shared_ptr<ShardedTransactionQueue>;
+    static const size_t c_defaultShards = 16;
+    /// the max number of transactions copied from a shard at a time when traversed
+    static const size_t c_traverseChunkSize = 128;
+
+    explicit ShardedTransactionQueue(size_t _shards = c_defaultShards);
+
+    /// insert the transaction at the end of the queue, return false if it exists
+    bool insert(dev::eth::Transaction::Ptr const& _tx);
+    /// return the erased transaction, or nullptr if it doesn't exist
+    dev::eth::Transaction::Ptr erase(h256 const& _txHash);
+    /// return nullptr if the transaction doesn't exist
+    dev::eth::Transaction::Ptr find(h256 const& _txHash) const;
+    bool count(h256 const& _txHash) const { return find(_txHash) != nullptr; }
+    size_t size() const { return m_size; }
+    void clear();
+
+    /// visit the transactions in the order of insertion until _f returns false, no lock is held
+    /// when _f is called, so the transactions inserted during the traversal may be visited too
+    void forEach(std::function<bool(dev::eth::Transaction::Ptr const&)> const& _f) const;
+
+private:
+    struct Shard
+    {
+        mutable SharedMutex lock;
+        std::map<uint64_t, dev::eth::Transaction::Ptr> queue;
+        /// the sequences of the transactions
+        std::unordered_map<h256, uint64_t> index;
+    };
+    Shard& shard(h256 const& _txHash) const
+    {
+        return *m_shards[std::hash<h256>()(_txHash) % m_shards.size()];
+    }
+
+    std::vector<std::shared_ptr<Shard>> m_shards;
+    std::atomic<uint64_t> m_sequence = {0};
+    std::atomic<size_t> m_size = {0};
+};
+}  // namespace txpool
+}  // namespace dev
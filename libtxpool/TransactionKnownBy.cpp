@@ -0,0 +1,110 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+
+/**
+ * @brief : the peers that know the transactions
+ * @file: TransactionKnownBy.cpp
+ */
+#include "TransactionKnownBy.h"
+
+using namespace std;
+using namespace dev;
+using namespace dev::txpool;
+
+const size_t TransactionKnownBy::c_defaultShards;
+
+TransactionKnownBy::TransactionKnownBy(size_t _shards)
+{
+    for (size_t i = 0; i < std::max(_shards, (size_t)1); i++)
+    {
+        m_shards.push_back(std::make_shared<Shard>());
+    }
+}
+
+size_t TransactionKnownBy::nodeIndex(h512 const& _nodeId)
+{
+    {
+        ReadGuard l(x_nodes);
+        auto it = m_nodes.find(_nodeId);
+        if (it != m_nodes.end())
+        {
+            return it->second;
+        }
+    }
+    WriteGuard l(x_nodes);
+    auto index = m_nodes.size();
+    return m_nodes.emplace(_nodeId, index).first->second;
+}
+
+void TransactionKnownBy::set(h256 const& _txHash, h512 const& _nodeId)
+{
+    set(_txHash, nodeIndex(_nodeId));
+}
+
+void TransactionKnownBy::set(h256 const& _txHash, size_t _index)
+{
+    auto& knownByShard = shard(_txHash);
+    WriteGuard l(knownByShard.lock);
+    auto& nodes = knownByShard.knownBy[_txHash];
+    if (nodes.size() <= _index)
+    {
+        nodes.resize(_index + 1);
+    }
+    nodes.set(_index);
+}
+
+bool TransactionKnownBy::isKnownBy(h256 const& _txHash, h512 const& _nodeId) const
+{
+    size_t index;
+    {
+        ReadGuard l(x_nodes);
+        auto it = m_nodes.find(_nodeId);
+        if (it == m_nodes.end())
+        {
+            return false;
+        }
+        index = it->second;
+    }
+    auto& knownByShard = shard(_txHash);
+    ReadGuard l(knownByShard.lock);
+    auto it = knownByShard.knownBy.find(_txHash);
+    return it != knownByShard.knownBy.end() && index < it->second.size() && it->second[index];
+}
+
+bool TransactionKnownBy::isKnownBySomeone(h256 const& _txHash) const
+{
+    auto& knownByShard = shard(_txHash);
+    ReadGuard l(knownByShard.lock);
+    auto it = knownByShard.knownBy.find(_txHash);
+    return it != knownByShard.knownBy.end() && it->second.any();
+}
+
+void TransactionKnownBy::erase(h256 const& _txHash)
+{
+    auto& knownByShard = shard(_txHash);
+    WriteGuard l(knownByShard.lock);
+    knownByShard.knownBy.erase(_txHash);
+}
+
+void TransactionKnownBy::clear()
+{
+    for (auto& knownByShard : m_shards)
+    {
+        WriteGuard l(knownByShard->lock);
+        knownByShard->knownBy.clear();
+    }
+}
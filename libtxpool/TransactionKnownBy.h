@@ -0,0 +1,79 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+
+/**
+ * @brief : the peers that know the transactions
+ * @file: TransactionKnownBy.h
+ */
+#pragma once
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/Guards.h>
+#include <boost/dynamic_bitset.hpp>
+#include <unordered_map>
+
+namespace dev
+{
+namespace txpool
+{
+/**
+ * every node is given an index when it's seen the first time, the nodes that know a transaction
+ * are kept as a bitset of the indexes, the bitsets are partitioned by the transaction hash
+ */
+class TransactionKnownBy
+{
+public:
+    using Ptr = std::shared_ptr<TransactionKnownBy>;
+    static const size_t c_defaultShards = 16;
+
+    explicit TransactionKnownBy(size_t _shards = c_defaultShards);
+
+    void set(h256 const& _txHash, h512 const& _nodeId);
+    template <typename T>
+    void set(T const& _txsHash, h512 const& _nodeId)
+    {
+        auto index = nodeIndex(_nodeId);
+        for (auto const& txHash : _txsHash)
+        {
+            set(txHash, index);
+        }
+    }
+    bool isKnownBy(h256 const& _txHash, h512 const& _nodeId) const;
+    bool isKnownBySomeone(h256 const& _txHash) const;
+    void erase(h256 const& _txHash);
+    void clear();
+
+private:
+    struct Shard
+    {
+        mutable SharedMutex lock;
+        std::unordered_map<h256, boost::dynamic_bitset<>> knownBy;
+    };
+    Shard& shard(h256 const& _txHash) const
+    {
+        return *m_shards[std::hash<h256>()(_txHash) % m_shards.size()];
+    }
+    void set(h256 const& _txHash, size_t _index);
+    /// the index of the node, the node is given a new index if it's not seen before
+    size_t nodeIndex(h512 const& _nodeId);
+
+    std::vector<std::shared_ptr<Shard>> m_shards;
+    /// the nodes are never removed, there are a few of them in a group
+    mutable SharedMutex x_nodes;
+    std::unordered_map<h512, size_t> m_nodes;
+};
+}  // namespace txpool
+}  // namespace dev
@@ -23,6 +23,7 @@
 
 #include "TransactionNonceCheck.h"
 #include <libdevcore/Common.h>
+#include <tbb/parallel_for.h>
 
 using namespace dev;
 using namespace dev::eth;
@@ -128,42 +129,33 @@ void TransactionNonceCheck::updateCache(bool _rebuild)
                 << LOG_DESC("updateCache") << LOG_KV("rebuild", _rebuild)
                 << LOG_KV("startBlk", m_startblk) << LOG_KV("endBlk", m_endblk)
                 << LOG_KV("prestartBlk", prestartblk) << LOG_KV("preEndBlk", preendblk);
+            auto nonceFilter = m_nonceFilter;
             if (_rebuild)
             {
                 m_cache.clear();
+                /// the checks without lock keep using the old filter until the new one is filled
+                nonceFilter = std::make_shared<RollingNonceFilter>(m_maxBlockLimit);
                 preendblk = 0;
+                // decoding the nonces of the blocks is the most of the time to rebuild
+                prefetchNonces(std::max(preendblk + 1, m_startblk), m_endblk);
             }
             else
             {
                 /// erase the expired nonces
-                for (auto i = prestartblk; i < m_startblk; i++)
-                {
-                    auto nonce_vec = getNonceAndUpdateCache(i, false);
-                    if (nonce_vec)
-                    {
-                        for (auto& nonce : *nonce_vec)
-                        {
-                            m_cache.erase(nonce);
-                        }
-                    }
-                    /// erase the expired nonces from cache since it can't be touched forever
-                    if (m_blockNonceCache.count(i))
-                    {
-                        m_blockNonceCache.erase(i);
-                    }
-                }
+                expireNonces(prestartblk, m_startblk);
             }
             /// insert the nonces of a new block
             for (auto i = std::max(preendblk + 1, m_startblk); i <= m_endblk; i++)
             {
-                auto nonce_vec = getNonceAndUpdateCache(i);
-                for (auto& nonce : *nonce_vec)
-                {
-                    m_cache.insert(nonce);
-                }
+                insertNonces(*nonceFilter, i, getNonceAndUpdateCache(i));
             }  // for
+            if (_rebuild)
+            {
+                std::atomic_store(&m_nonceFilter, nonceFilter);
+            }
             NONCECHECKER_LOG(DEBUG)
                 << LOG_DESC("updateCache") << LOG_KV("cacheSize", m_cache.size())
+                << LOG_KV("filterBytes", m_nonceFilter->bytes())
                 << LOG_KV("costTime", timer.elapsed() * 1000);
         }
         catch (...)
@@ -175,5 +167,112 @@ void TransactionNonceCheck::updateCache(bool _rebuild)
         }
     }
 }  // fun
+
+void TransactionNonceCheck::updateCache(Block const& _committedBlock)
+{
+    auto blockNumber = _committedBlock.blockHeader().number();
+    bool rebuild = false;
+    {
+        WriteGuard l(m_lock);
+        try
+        {
+            if (blockNumber == m_endblk + 1)
+            {
+                m_blockNumber = blockNumber;
+                m_endblk = blockNumber;
+                int64_t startblk = 0;
+                if (blockNumber > m_maxBlockLimit)
+                {
+                    startblk = blockNumber - m_maxBlockLimit;
+                }
+                /// the nonces of the expired blocks are cached, the blockchain is not read
+                expireNonces(m_startblk, startblk);
+                m_startblk = startblk;
+                auto nonceVec = _committedBlock.getAllNonces();
+                if (m_blockNonceCache.size() < m_maxBlockLimit)
+                {
+                    m_blockNonceCache[blockNumber] = nonceVec;
+                }
+                insertNonces(*m_nonceFilter, blockNumber, nonceVec);
+                NONCECHECKER_LOG(TRACE)
+                    << LOG_DESC("updateCache with the committed block")
+                    << LOG_KV("blockNumber", blockNumber) << LOG_KV("startBlk", m_startblk)
+                    << LOG_KV("cacheSize", m_cache.size());
+                return;
+            }
+        }
+        catch (...)
+        {
+            // should not happen as exceptions
+            NONCECHECKER_LOG(WARNING)
+                << LOG_DESC("updateCache: update nonce cache with the committed block failed")
+                << LOG_KV("blockNumber", blockNumber)
+                << LOG_KV("EINFO", boost::current_exception_diagnostic_information());
+            rebuild = true;
+        }
+    }
+    /// the block is not the next one of the cache, or the cache is broken by the failure
+    updateCache(rebuild);
+}
+
+void TransactionNonceCheck::prefetchNonces(int64_t _startBlock, int64_t _endBlock)
+{
+    if (_endBlock < _startBlock)
+    {
+        return;
+    }
+    std::vector<std::shared_ptr<NonceVec>> nonces(_endBlock - _startBlock + 1);
+    tbb::parallel_for(tbb::blocked_range<int64_t>(_startBlock, _endBlock + 1),
+        [&](const tbb::blocked_range<int64_t>& _r) {
+            for (auto i = _r.begin(); i != _r.end(); i++)
+            {
+                if (!m_blockNonceCache.count(i))
+                {
+                    nonces[i - _startBlock] = m_blockChain->getNonces(i);
+                }
+            }
+        });
+    for (auto i = _startBlock; i <= _endBlock; i++)
+    {
+        auto const& nonceVec = nonces[i - _startBlock];
+        if (nonceVec && m_blockNonceCache.size() < m_maxBlockLimit)
+        {
+            m_blockNonceCache[i] = nonceVec;
+        }
+    }
+}
+
+void TransactionNonceCheck::expireNonces(int64_t _fromBlock, int64_t _toBlock)
+{
+    for (auto i = _fromBlock; i < _toBlock; i++)
+    {
+        auto nonce_vec = getNonceAndUpdateCache(i, false);
+        if (nonce_vec)
+        {
+            for (auto& nonce : *nonce_vec)
+            {
+                m_cache.erase(nonce);
+            }
+        }
+        /// erase the expired nonces from cache since it can't be touched forever
+        m_blockNonceCache.erase(i);
+    }
+    m_nonceFilter->expire(_toBlock);
+}
+
+void TransactionNonceCheck::insertNonces(RollingNonceFilter& _nonceFilter, int64_t _blockNumber,
+    std::shared_ptr<NonceVec> const& _nonces)
+{
+    if (!_nonces)
+    {
+        return;
+    }
+    /// the filter is updated first, a nonce in m_cache is always in the filter
+    _nonceFilter.insert(_blockNumber, *_nonces);
+    for (auto& nonce : *_nonces)
+    {
+        m_cache.insert(nonce);
+    }
+}
 }  // namespace txpool
 }  // namespace dev
@@ -23,6 +23,7 @@
 
 #pragma once
 #include "CommonTransactionNonceCheck.h"
+#include "RollingNonceFilter.h"
 #include <libblockchain/BlockChainInterface.h>
 #include <boost/timer.hpp>
 #include <thread>
@@ -44,12 +45,16 @@ public:
     TransactionNonceCheck(std::shared_ptr<dev::blockchain::BlockChainInterface> const& _blockChain)
       : CommonTransactionNonceCheck(), m_blockChain(_blockChain)
     {
+        m_nonceFilter = std::make_shared<RollingNonceFilter>(m_maxBlockLimit);
         init();
     }
     ~TransactionNonceCheck() {}
     void init();
     bool ok(dev::eth::Transaction const& _transaction);
     void updateCache(bool _rebuild = false);
+    /// update the cache with the nonces of the committed block, the blockchain is read only if
+    /// the block doesn't follow the latest block of the cache
+    void updateCache(dev::eth::Block const& _committedBlock);
     unsigned const& maxBlockLimit() const { return m_maxBlockLimit; }
     void setBlockLimit(unsigned const& limit) { m_maxBlockLimit = limit; }
 
@@ -58,7 +63,20 @@ public:
     std::shared_ptr<dev::txpool::NonceVec> getNonceAndUpdateCache(
         int64_t const& blockNumber, bool const& update = true);
 
+protected:
+    bool mayContain(dev::eth::NonceKeyType const& _nonce) const override
+    {
+        return std::atomic_load(&m_nonceFilter)->mayContain(_nonce);
+    }
+
 private:
+    /// load the nonces of the blocks in [_startBlock, _endBlock] into m_blockNonceCache in parallel
+    void prefetchNonces(int64_t _startBlock, int64_t _endBlock);
+    /// erase the nonces of the blocks in [_fromBlock, _toBlock) from the cache
+    void expireNonces(int64_t _fromBlock, int64_t _toBlock);
+    void insertNonces(RollingNonceFilter& _nonceFilter, int64_t _blockNumber,
+        std::shared_ptr<NonceVec> const& _nonces);
+
     std::shared_ptr<dev::blockchain::BlockChainInterface> m_blockChain;
     std::vector<NonceVec> nonce_vec;
     /// cache the block nonce to in case of accessing the DB to get nonces of given block frequently
@@ -66,6 +84,9 @@ private:
     /// value: all the nonces of a given block
     /// we cache at most m_maxBlockLimit entries(occuppy about 32KB)
     std::map<int64_t, std::shared_ptr<NonceVec> > m_blockNonceCache;
+    /// the nonces of m_cache are checked against the filter without lock first, the nonces not
+    /// in the filter are not in m_cache for sure, a rebuilt filter is swapped in atomically
+    RollingNonceFilter::Ptr m_nonceFilter;
 
     int64_t m_startblk;
     int64_t m_endblk;
@@ -39,41 +39,99 @@ namespace txpool
 // import transaction to the txPool
 std::pair<h256, Address> TxPool::submit(Transaction::Ptr _tx)
 {
-    m_submitPool->enqueue([this, _tx]() {
-        try
+    // the transaction is shared with the submit thread after pushed into m_txsCache
+    auto ret = std::make_pair(_tx->sha3(), toAddress(_tx->from(), _tx->nonce()));
+    m_txsCache->push(_tx);
+    // at most one import task is enqueued, which imports all the cached transactions in batches
+    if (!m_importingTxsCache.exchange(true))
+    {
+        m_submitPool->enqueue([this]() { importSubmittedTxs(); });
+    }
+    return ret;
+}
+
+void TxPool::importSubmittedTxs()
+{
+    while (true)
+    {
+        auto txs = std::make_shared<Transactions>();
+        Transaction::Ptr tx;
+        while (txs->size() < m_maxSubmitBatchSize && m_txsCache->try_pop(tx))
         {
-            // RequestNotBelongToTheGroup: 10004
-            ImportResult verifyRet = ImportResult::NotBelongToTheGroup;
-            if (isSealerOrObserver())
+            txs->push_back(tx);
+        }
+        if (txs->empty())
+        {
+            m_importingTxsCache = false;
+            // the transactions pushed before the flag is cleared have no import task enqueued
+            if (m_txsCache->empty() || m_importingTxsCache.exchange(true))
             {
-                // check sync status failed
-                if (m_syncStatusChecker && !m_syncStatusChecker())
-                {
-                    TXPOOL_LOG(WARNING)
-                        << LOG_DESC("submitTransaction async failed for checkSyncStatus failed")
-                        << LOG_KV("groupId", m_groupId);
-                    verifyRet = ImportResult::TransactionRefused;
-                }
-                // check sync status succ
-                else
-                {
-                    verifyRet = import(_tx);
-                    if (ImportResult::Success == verifyRet)
-                    {
-                        return;
-                    }
-                }
+                return;
             }
-            notifyReceipt(_tx, verifyRet);
+            continue;
+        }
+        try
+        {
+            importSubmittedBatch(txs);
         }
         catch (std::exception const& e)
         {
-            TXPOOL_LOG(WARNING) << LOG_DESC("submit tx failed")
-                                << LOG_KV("tx", _tx->sha3().abridged())
+            TXPOOL_LOG(WARNING) << LOG_DESC("submit txs failed") << LOG_KV("txs", txs->size())
                                 << LOG_KV("errorInfo", boost::diagnostic_information(e));
         }
-    });
-    return std::make_pair(_tx->sha3(), toAddress(_tx->from(), _tx->nonce()));
+    }
+}
+
+void TxPool::importSubmittedBatch(std::shared_ptr<Transactions> _txs)
+{
+    std::shared_ptr<std::vector<ImportResult>> results;
+    try
+    {
+        if (!isSealerOrObserver())
+        {
+            // RequestNotBelongToTheGroup: 10004
+            results = std::make_shared<std::vector<ImportResult>>(
+                _txs->size(), ImportResult::NotBelongToTheGroup);
+        }
+        // check sync status failed
+        else if (m_syncStatusChecker && !m_syncStatusChecker())
+        {
+            TXPOOL_LOG(WARNING)
+                << LOG_DESC("submitTransaction async failed for checkSyncStatus failed")
+                << LOG_KV("groupId", m_groupId) << LOG_KV("txs", _txs->size());
+            results = std::make_shared<std::vector<ImportResult>>(
+                _txs->size(), ImportResult::TransactionRefused);
+        }
+        // check sync status succ
+        else
+        {
+            results = batchImport(_txs);
+        }
+    }
+    catch (std::exception const& e)
+    {
+        TXPOOL_LOG(WARNING) << LOG_DESC("importSubmittedBatch failed")
+                            << LOG_KV("txs", _txs->size())
+                            << LOG_KV("errorInfo", boost::diagnostic_information(e));
+        // refuse every transaction of the batch, except those inserted before the failure,
+        // which are notified when they are committed
+        results = std::make_shared<std::vector<ImportResult>>(
+            _txs->size(), ImportResult::TransactionRefused);
+        for (size_t i = 0; i < _txs->size(); i++)
+        {
+            if (m_txsQueue->count((*_txs)[i]->sha3()))
+            {
+                (*results)[i] = ImportResult::Success;
+            }
+        }
+    }
+    for (size_t i = 0; i < _txs->size(); i++)
+    {
+        if ((*results)[i] != ImportResult::Success)
+        {
+            notifyReceipt((*_txs)[i], (*results)[i]);
+        }
+    }
 }
 
 // create receipt
@@ -215,23 +273,24 @@ bool TxPool::isSealerOrObserver()
 ImportResult TxPool::import(Transaction::Ptr _tx, IfDropped)
 {
     _tx->setImportTime(u256(utcTime()));
-    UpgradableGuard l(m_lock);
-    /// check the txpool size
-    if (m_txsQueue.size() >= m_limit)
-    {
-        return ImportResult::TransactionPoolIsFull;
-    }
     /// check the verify result(nonce && signature check)
     ImportResult verify_ret = verify(_tx);
     if (verify_ret == ImportResult::Success)
     {
+        // the size of the txPool is checked on insertion, which needs the sender to evict
+        verify_ret = insert(_tx);
+        // release the nonce inserted into the txpool nonce cache by verify
+        if (verify_ret == ImportResult::TransactionPoolIsFull)
         {
-            UpgradeGuard ul(l);
-            if (insert(_tx))
-            {
-                m_txpoolNonceChecker->insertCache(*_tx);
-            }
+            m_txpoolNonceChecker->delCache(_tx->nonce());
+            return verify_ret;
         }
+        // the same transaction is imported by another thread
+        if (verify_ret != ImportResult::Success)
+        {
+            return verify_ret;
+        }
+        m_txpoolNonceChecker->insertCache(*_tx);
         {
             WriteGuard txsLock(x_txsHashFilter);
             m_txsHashFilter->insert(_tx->sha3());
@@ -241,6 +300,151 @@ ImportResult TxPool::import(Transaction::Ptr _tx, IfDropped)
     return verify_ret;
 }
 
+/**
+ * @brief : the admission pipeline of the transactions, including:
+ *  1. verify the fields and recover the senders of the transactions in parallel
+ *  2. check the nonces of the transactions against the committed nonces under one read lock
+ *  3. check the transactions against the txPool and insert them into the shards of the txPool
+ */
+std::shared_ptr<std::vector<ImportResult>> TxPool::batchImport(std::shared_ptr<Transactions> _txs)
+{
+    auto results =
+        std::make_shared<std::vector<ImportResult>>(_txs->size(), ImportResult::Success);
+    auto recordTime = utcTime();
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, _txs->size()), [&](const tbb::blocked_range<size_t>& _r) {
+            for (size_t i = _r.begin(); i != _r.end(); i++)
+            {
+                (*results)[i] = verifyTransaction((*_txs)[i]);
+            }
+        });
+    auto verifyTimeCost = utcTime() - recordTime;
+    recordTime = utcTime();
+
+    /// check nonce
+    std::vector<bool> ok(_txs->size());
+    for (size_t i = 0; i < _txs->size(); i++)
+    {
+        ok[i] = ((*results)[i] == ImportResult::Success);
+    }
+    m_txNonceCheck->checkNonces(*_txs, ok, false);
+    for (size_t i = 0; i < _txs->size(); i++)
+    {
+        if (!ok[i] && (*results)[i] == ImportResult::Success)
+        {
+            (*results)[i] = ImportResult::TransactionNonceCheckFail;
+        }
+    }
+    auto nonceCheckTimeCost = utcTime() - recordTime;
+    recordTime = utcTime();
+
+    h256Hash batchTxs;
+    {
+        ReadGuard l(x_dropped);
+        for (size_t i = 0; i < _txs->size(); i++)
+        {
+            if ((*results)[i] != ImportResult::Success)
+            {
+                continue;
+            }
+            h256 txHash = (*_txs)[i]->sha3();
+            if (m_txsQueue->count(txHash) || !batchTxs.insert(txHash).second)
+            {
+                (*results)[i] = ImportResult::AlreadyKnown;
+                ok[i] = false;
+            }
+            /// the transaction has been dropped before
+            else if (m_dropped.count(txHash))
+            {
+                (*results)[i] = ImportResult::AlreadyInChain;
+                ok[i] = false;
+            }
+        }
+    }
+    /// nonce related to txpool must be checked at the last, since this will insert nonce of the
+    /// valid transactions into the txpool nonce cache
+    m_txpoolNonceChecker->checkNonces(*_txs, ok, true);
+    std::vector<dev::h256> importedTxs;
+    Transactions refusedTxs;
+    auto importTime = u256(utcTime());
+    for (size_t i = 0; i < _txs->size(); i++)
+    {
+        if ((*results)[i] != ImportResult::Success)
+        {
+            continue;
+        }
+        if (!ok[i])
+        {
+            (*results)[i] = ImportResult::TxPoolNonceCheckFail;
+        }
+        else
+        {
+            (*_txs)[i]->setImportTime(importTime);
+            (*results)[i] = insert((*_txs)[i]);
+            if ((*results)[i] == ImportResult::Success)
+            {
+                importedTxs.push_back((*_txs)[i]->sha3());
+            }
+            else if ((*results)[i] == ImportResult::TransactionPoolIsFull)
+            {
+                refusedTxs.push_back((*_txs)[i]);
+            }
+            // the same transaction imported by another thread has the same nonce, which is kept
+        }
+    }
+    if (!refusedTxs.empty())
+    {
+        m_txpoolNonceChecker->delCache(refusedTxs);
+    }
+    if (!importedTxs.empty())
+    {
+        {
+            WriteGuard txsLock(x_txsHashFilter);
+            m_txsHashFilter->insert(importedTxs.begin(), importedTxs.end());
+        }
+        m_onReady();
+    }
+    TXPOOL_LOG(DEBUG) << LOG_DESC("batchImport") << LOG_KV("txs", _txs->size())
+                      << LOG_KV("imported", importedTxs.size())
+                      << LOG_KV("verifyTimeCost", verifyTimeCost)
+                      << LOG_KV("nonceCheckTimeCost", nonceCheckTimeCost)
+                      << LOG_KV("insertTimeCost", utcTime() - recordTime);
+    return results;
+}
+
+ImportResult TxPool::verifyTransaction(Transaction::Ptr _tx)
+{
+    h256 txHash = _tx->sha3();
+    if (_tx->nonce() == Invalid256)
+    {
+        return ImportResult::TransactionNonceCheckFail;
+    }
+    if (false == m_txNonceCheck->isBlockLimitOk(*_tx))
+    {
+        return ImportResult::BlockLimitCheckFailed;
+    }
+    try
+    {
+        /// check transaction signature
+        _tx->sender();
+    }
+    catch (std::exception& e)
+    {
+        TXPOOL_LOG(ERROR) << "[Verify] invalid signature, tx = " << txHash.abridged();
+        return ImportResult::Malformed;
+    }
+    /// check chainId and groupId
+    if (false == _tx->checkChainId(u256(g_BCOSConfig.chainId())))
+    {
+        return ImportResult::InvalidChainId;
+    }
+    if (false == _tx->checkGroupId(u256(m_groupId)))
+    {
+        return ImportResult::InvalidGroupId;
+    }
+    return ImportResult::Success;
+}
+
 void TxPool::verifyAndSetSenderForBlock(dev::eth::Block& block)
 {
     auto trans_num = block.getTransactionSize();
@@ -251,13 +455,10 @@ void TxPool::verifyAndSetSenderForBlock(dev::eth::Block& block)
                 h256 txHash = (*block.transactions())[i]->sha3();
 
                 /// force sender for the transaction
-                ReadGuard l(m_lock);
-                auto p_tx = m_txsHash.find(txHash);
-                l.unlock();
-
-                if (p_tx != m_txsHash.end())
+                auto tx = m_txsQueue->find(txHash);
+                if (tx)
                 {
-                    block.setSenderForTransaction(i, (*(p_tx->second))->sender());
+                    block.setSenderForTransaction(i, tx->sender());
                 }
                 /// verify the transaction
                 else
@@ -270,15 +471,10 @@ void TxPool::verifyAndSetSenderForBlock(dev::eth::Block& block)
 
 bool TxPool::txExists(dev::h256 const& txHash)
 {
-    ReadGuard l(m_lock);
     /// can't submit to the transaction pull, return false
-    if (m_txsQueue.size() >= m_limit)
-        return true;
-    if (m_txsHash.count(txHash))
-    {
+    if (m_txsQueue->size() >= m_limit)
         return true;
-    }
-    return false;
+    return m_txsQueue->count(txHash);
 }
 
 /**
@@ -297,14 +493,20 @@ ImportResult TxPool::verify(Transaction::Ptr trans, IfDropped _drop_policy)
 {
     /// check whether this transaction has been existed
     h256 tx_hash = trans->sha3();
-    if (m_txsHash.count(tx_hash))
+    if (m_txsQueue->count(tx_hash))
     {
         TXPOOL_LOG(TRACE) << LOG_DESC("Verify: already known tx")
                           << LOG_KV("hash", tx_hash.abridged());
         return ImportResult::AlreadyKnown;
     }
     /// the transaction has been dropped before
-    if (m_dropped.count(tx_hash) && _drop_policy == IfDropped::Ignore)
+    bool dropped = false;
+    if (_drop_policy == IfDropped::Ignore)
+    {
+        ReadGuard l(x_dropped);
+        dropped = m_dropped.count(tx_hash);
+    }
+    if (dropped)
     {
         TXPOOL_LOG(TRACE) << LOG_DESC("Verify: already dropped tx: ")
                           << LOG_KV("hash", tx_hash.abridged());
@@ -361,21 +563,13 @@ struct TxCallback
 bool TxPool::removeTrans(h256 const& _txHash, bool _needTriggerCallback,
     std::shared_ptr<dev::eth::Block> _block, size_t _index)
 {
-    Transaction::Ptr transaction = nullptr;
     // remove transaction from txPool
-    std::unordered_map<h256, TransactionQueue::iterator>::iterator p_tx;
+    Transaction::Ptr transaction = m_txsQueue->erase(_txHash);
+    if (!transaction)
     {
-        p_tx = m_txsHash.find(_txHash);
-        if (p_tx == m_txsHash.end())
-        {
-            return true;
-        }
-        transaction = *(p_tx->second);
-        m_txsQueue.erase(p_tx->second);
-        m_txsHash.erase(p_tx);
-
-        // m_delTransactions.unsafe_erase(_txHash);
+        return true;
     }
+    m_senderLanes->erase(transaction);
     // call transaction callback
     if (_needTriggerCallback && transaction->rpcCallback())
     {
@@ -412,16 +606,50 @@ bool TxPool::removeTrans(h256 const& _txHash, bool _needTriggerCallback,
 /**
  * @brief : insert the newest transaction into the transaction queue
  * @param _tx: the give transaction queue can be inserted to the transaction queue
+ * @return ImportResult : TransactionPoolIsFull if the txPool is full and no transaction can be
+ * evicted for _tx, or the lane of the sender reaches its limit
+ */
+ImportResult TxPool::insert(Transaction::Ptr _tx)
+{
+    if (m_txsQueue->size() >= m_limit && !evict(_tx->sender()))
+    {
+        return ImportResult::TransactionPoolIsFull;
+    }
+    auto ret = m_senderLanes->insert(_tx);
+    if (ret != ImportResult::Success)
+    {
+        return ret;
+    }
+    if (!m_txsQueue->insert(_tx))
+    {
+        m_senderLanes->erase(_tx);
+        return ImportResult::AlreadyKnown;
+    }
+    return ImportResult::Success;
+}
+
+/**
+ * @brief : make room for a transaction of _sender when the txPool is full, the newest transaction
+ * of the heaviest lane is evicted, which is the least likely to be sealed since the lanes are
+ * sealed in turn. The sender of the evicted transaction is notified that it's refused
  */
-bool TxPool::insert(Transaction::Ptr _tx)
+bool TxPool::evict(Address const& _sender)
 {
-    h256 tx_hash = _tx->sha3();
-    if (m_txsHash.count(tx_hash))
+    auto tx = m_senderLanes->evictionCandidate(_sender);
+    if (!tx)
     {
         return false;
     }
-    TransactionQueue::iterator p_tx = m_txsQueue.emplace(_tx).first;
-    m_txsHash[tx_hash] = p_tx;
+    TXPOOL_LOG(DEBUG) << LOG_DESC("evict transaction") << LOG_KV("hash", tx->sha3().abridged())
+                      << LOG_KV("sender", tx->sender().abridged())
+                      << LOG_KV("pending", m_senderLanes->size(tx->sender()));
+    removeTrans(tx->sha3());
+    m_txpoolNonceChecker->delCache(tx->nonce());
+    removeTransactionKnowBy(tx->sha3());
+    {
+        WriteGuard l(x_txsHashFilter);
+        m_txsHashFilter->erase(tx->sha3());
+    }
     return true;
 }
 
@@ -431,24 +659,19 @@ bool TxPool::insert(Transaction::Ptr _tx)
  */
 bool TxPool::drop(h256 const& _txHash)
 {
-    bool succ = false;
     /// drop transactions
+    if (!m_txsQueue->count(_txHash))
+        return false;
     {
-        UpgradableGuard l(m_lock);
-        if (!m_txsHash.count(_txHash))
-            return false;
-        UpgradeGuard ul(l);
+        WriteGuard l(x_dropped);
         if (m_dropped.size() < m_limit)
             m_dropped.insert(_txHash);
         else
             m_dropped.clear();
-        succ = removeTrans(_txHash);
     }
+    bool succ = removeTrans(_txHash);
     /// drop information of transactions
-    {
-        WriteGuard l(x_transactionKnownBy);
-        removeTransactionKnowBy(_txHash);
-    }
+    removeTransactionKnowBy(_txHash);
     return succ;
 }
 
@@ -466,7 +689,6 @@ bool TxPool::removeBlockKnowTrans(Block const& block)
 {
     if (block.getTransactionSize() == 0)
         return true;
-    WriteGuard l(x_transactionKnownBy);
     for (auto const& trans : *block.transactions())
     {
         removeTransactionKnowBy(trans->sha3());
@@ -481,7 +703,6 @@ bool TxPool::dropTransactions(std::shared_ptr<Block> block, bool)
     bool succ = true;
     {
         WriteGuard wl(x_invalidTxs);
-        WriteGuard l(m_lock);
         for (size_t i = 0; i < block->transactions()->size(); i++)
         {
             if (removeTrans((*(block->transactions()))[i]->sha3(), true, block, i) == false)
@@ -526,10 +747,13 @@ void TxPool::removeInvalidTxs()
     tbb::parallel_invoke(
         [this]() {
             // remove invalid txs
-            WriteGuard l(m_lock);
             for (auto const& item : *m_invalidTxs)
             {
                 removeTrans(item.first);
+            }
+            WriteGuard l(x_dropped);
+            for (auto const& item : *m_invalidTxs)
+            {
                 m_dropped.insert(item.first);
             }
         },
@@ -541,7 +765,6 @@ void TxPool::removeInvalidTxs()
             }
         },
         [this]() {
-            WriteGuard l(x_transactionKnownBy);
             // remove transaction knownBy
             for (auto const& item : *m_invalidTxs)
             {
@@ -578,7 +801,7 @@ bool TxPool::dropBlockTrans(std::shared_ptr<Block> block)
         [this, block]() {
             // update the Nonces of txs
             // (must be updated before dropTransactions to in case of sealing the same txs)
-            m_txNonceCheck->updateCache(false);
+            m_txNonceCheck->updateCache(*block);
             dropTransactions(block, true);
             // delete the nonce cache
             m_txpoolNonceChecker->delCache(*(block->transactions()));
@@ -612,43 +835,47 @@ std::shared_ptr<Transactions> TxPool::topTransactions(
 
     {
         WriteGuard wl(x_invalidTxs);
-        ReadGuard l(m_lock);
-        for (auto it = m_txsQueue.begin(); txCnt < limit && it != m_txsQueue.end(); it++)
-        {
-            if (m_invalidTxs->count((*it)->sha3()))
+        // the lanes of the senders are sealed in turn, a sender can't fill a block alone
+        m_senderLanes->forEach([&](Transaction::Ptr const& _tx) {
+            if (txCnt >= limit)
             {
-                continue;
+                return false;
+            }
+            if (m_invalidTxs->count(_tx->sha3()))
+            {
+                return true;
             }
             /// check nonce again when obtain transactions
             // since the invalid nonce has already been checked before the txs import into the
             // txPool the txs with duplicated nonce here are already-committed, but have not been
             // dropped, so no need to insert the already-committed transaction into m_invalidTxs
-            if (!m_txNonceCheck->isNonceOk(*(*it), false))
+            if (!m_txNonceCheck->isNonceOk(*_tx, false))
             {
                 TXPOOL_LOG(DEBUG) << LOG_DESC(
                                          "Duplicated nonce: transaction maybe already-committed")
-                                  << LOG_KV("nonce", (*it)->nonce())
-                                  << LOG_KV("hash", (*it)->sha3().abridged());
-                continue;
+                                  << LOG_KV("nonce", _tx->nonce())
+                                  << LOG_KV("hash", _tx->sha3().abridged());
+                return true;
             }
             // check block limit(only insert txs with invalid blockLimit into m_invalidTxs)
-            if (!m_txNonceCheck->isBlockLimitOk(*(*it)))
+            if (!m_txNonceCheck->isBlockLimitOk(*_tx))
             {
-                m_invalidTxs->insert(std::pair<h256, u256>((*it)->sha3(), (*it)->nonce()));
+                m_invalidTxs->insert(std::pair<h256, u256>(_tx->sha3(), _tx->nonce()));
                 TXPOOL_LOG(WARNING)
-                    << LOG_DESC("Invalid blocklimit") << LOG_KV("hash", (*it)->sha3().abridged())
-                    << LOG_KV("blockLimit", (*it)->blockLimit())
+                    << LOG_DESC("Invalid blocklimit") << LOG_KV("hash", _tx->sha3().abridged())
+                    << LOG_KV("blockLimit", _tx->blockLimit())
                     << LOG_KV("blockNumber", m_blockChain->number());
-                continue;
+                return true;
             }
-            if (!_avoid.count((*it)->sha3()))
+            if (!_avoid.count(_tx->sha3()))
             {
-                ret->push_back(*it);
+                ret->push_back(_tx);
                 txCnt++;
                 if (_updateAvoid)
-                    _avoid.insert((*it)->sha3());
+                    _avoid.insert(_tx->sha3());
             }
-        }
+            return true;
+        });
     }
     // TXPOOL_LOG(DEBUG) << "topTransaction done, ignore: " << ignoreCount;
     m_workerPool->enqueue([this]() { removeInvalidTxs(); });
@@ -658,24 +885,24 @@ std::shared_ptr<Transactions> TxPool::topTransactions(
 std::shared_ptr<Transactions> TxPool::topTransactionsCondition(
     uint64_t const& _limit, dev::h512 const&)
 {
-    ReadGuard l(m_lock);
     std::shared_ptr<Transactions> ret = std::make_shared<Transactions>();
 
     // size_t ignoreCount = 0;
     uint64_t limit = min(m_limit, _limit);
-    {
-        uint64_t txCnt = 0;
-        ReadGuard l_kownTrans(x_transactionKnownBy);
-        for (auto it = m_txsQueue.begin(); txCnt < limit && it != m_txsQueue.end(); it++)
+    uint64_t txCnt = 0;
+    m_txsQueue->forEach([&](Transaction::Ptr const& _tx) {
+        if (txCnt >= limit)
         {
-            if (!(*it)->synced())
-            {
-                ret->push_back(*it);
-                txCnt++;
-                (*it)->setSynced(true);
-            }
+            return false;
         }
-    }
+        if (!_tx->synced())
+        {
+            ret->push_back(_tx);
+            txCnt++;
+            _tx->setSynced(true);
+        }
+        return true;
+    });
 
     // TXPOOL_LOG(DEBUG) << "topTransactionCondition done, ignore: " << ignoreCount;
 
@@ -685,28 +912,26 @@ std::shared_ptr<Transactions> TxPool::topTransactionsCondition(
 /// get all transactions(maybe blocksync module need this interface)
 std::shared_ptr<Transactions> TxPool::pendingList() const
 {
-    ReadGuard l(m_lock);
     std::shared_ptr<Transactions> ret = std::make_shared<Transactions>();
-    for (auto t = m_txsQueue.begin(); t != m_txsQueue.end(); ++t)
-    {
-        ret->push_back(*t);
-    }
+    m_txsQueue->forEach([ret](Transaction::Ptr const& _tx) {
+        ret->push_back(_tx);
+        return true;
+    });
     return ret;
 }
 
 /// get current transaction num
 size_t TxPool::pendingSize()
 {
-    ReadGuard l(m_lock);
-    return m_txsQueue.size();
+    return m_txsQueue->size();
 }
 
 /// @returns the status of the transaction queue.
 TxPoolStatus TxPool::status() const
 {
     TxPoolStatus status;
-    ReadGuard l(m_lock);
-    status.current = m_txsQueue.size();
+    status.current = m_txsQueue->size();
+    ReadGuard l(x_dropped);
     status.dropped = m_dropped.size();
     return status;
 }
@@ -714,18 +939,19 @@ TxPoolStatus TxPool::status() const
 /// Clear the queue
 void TxPool::clear()
 {
-    WriteGuard l(m_lock);
-    m_txsQueue.clear();
-    m_txsHash.clear();
-    m_dropped.clear();
-    WriteGuard l_trans(x_transactionKnownBy);
-    m_transactionKnownBy.clear();
+    m_txsQueue->clear();
+    m_senderLanes->clear();
+    {
+        WriteGuard l(x_dropped);
+        m_dropped.clear();
+    }
+    m_transactionKnownBy->clear();
 }
 
 /// Set transaction is known by a node
 void TxPool::setTransactionIsKnownBy(h256 const& _txHash, h512 const& _nodeId)
 {
-    m_transactionKnownBy[_txHash].insert(_nodeId);
+    m_transactionKnownBy->set(_txHash, _nodeId);
 }
 
 /// set transactions is known by a node
@@ -738,29 +964,24 @@ void TxPool::setTransactionsAreKnownBy(
 /// Is the transaction is known by someone
 bool TxPool::isTransactionKnownBySomeone(h256 const& _txHash)
 {
-    auto p = m_transactionKnownBy.find(_txHash);
-    if (p == m_transactionKnownBy.end())
-        return false;
-    return !p->second.empty();
+    return m_transactionKnownBy->isKnownBySomeone(_txHash);
 }
 
 // Remove the record of transaction know by some peers
 void TxPool::removeTransactionKnowBy(h256 const& _txHash)
 {
-    auto p = m_transactionKnownBy.find(_txHash);
-    if (p != m_transactionKnownBy.end())
-        m_transactionKnownBy.erase(p);
+    m_transactionKnownBy->erase(_txHash);
 }
 
 std::shared_ptr<Transactions> TxPool::obtainTransactions(std::vector<dev::h256> const& _reqTxs)
 {
     std::shared_ptr<Transactions> ret = std::make_shared<Transactions>();
-    ReadGuard l(m_lock);
     for (auto const& txHash : _reqTxs)
     {
-        if (m_txsHash.count(txHash))
+        auto tx = m_txsQueue->find(txHash);
+        if (tx)
         {
-            ret->push_back(*(m_txsHash[txHash]));
+            ret->push_back(tx);
         }
     }
     return ret;
@@ -793,21 +1014,19 @@ bool TxPool::initPartiallyBlock(dev::eth::Block::Ptr _block)
     auto transactions = partiallyBlock->transactions();
     auto missedTxs = partiallyBlock->missedTxs();
     // fetch all the hitted transactions
+    int64_t index = 0;
+    for (auto const& hash : *txsHash)
     {
-        ReadGuard l(m_lock);
-        int64_t index = 0;
-        for (auto const& hash : *txsHash)
+        auto tx = m_txsQueue->find(hash);
+        if (tx)
         {
-            if (m_txsHash.count(hash))
-            {
-                (*transactions)[index] = *(m_txsHash[hash]);
-            }
-            else
-            {
-                missedTxs->push_back(std::make_pair(hash, index));
-            }
-            index++;
+            (*transactions)[index] = tx;
+        }
+        else
+        {
+            missedTxs->push_back(std::make_pair(hash, index));
         }
+        index++;
     }
     // missed some transactions
     if (missedTxs->size() > 0)
@@ -22,6 +22,9 @@
  * @date: 2018-09-23
  */
 #pragma once
+#include "SenderLanes.h"
+#include "ShardedTransactionQueue.h"
+#include "TransactionKnownBy.h"
 #include "TransactionNonceCheck.h"
 #include "TxPoolInterface.h"
 #include <libblockchain/BlockChainInterface.h>
@@ -56,13 +59,6 @@ class TxPoolNonceManager
 {
 public:
 };
-struct transactionCompare
-{
-    bool operator()(dev::eth::Transaction::Ptr _first, dev::eth::Transaction::Ptr _second) const
-    {
-        return _first->importTime() <= _second->importTime();
-    }
-};
 class TxPool : public TxPoolInterface, public std::enable_shared_from_this<TxPool>
 {
 public:
@@ -86,6 +82,10 @@ public:
             std::make_shared<dev::ThreadPool>("txPool-" + std::to_string(m_groupId), workThreads);
         m_invalidTxs = std::make_shared<std::map<dev::h256, dev::u256>>();
         m_txsHashFilter = std::make_shared<std::set<h256>>();
+        m_txsCache = std::make_shared<tbb::concurrent_queue<dev::eth::Transaction::Ptr>>();
+        m_txsQueue = std::make_shared<ShardedTransactionQueue>();
+        m_senderLanes = std::make_shared<SenderLanes>();
+        m_transactionKnownBy = std::make_shared<TransactionKnownBy>();
     }
     void start() override {}
     void stop() override
@@ -118,6 +118,21 @@ public:
 
     std::pair<h256, Address> submitTransactions(dev::eth::Transaction::Ptr _tx) override;
 
+    /**
+     * @brief : verify and add transactions to the queue synchronously, the senders are recovered in
+     * parallel, the nonces are checked in batches and the transactions are inserted under one lock
+     *
+     * @param _txs : the transactions
+     * @return the import results of _txs
+     */
+    std::shared_ptr<std::vector<ImportResult>> batchImport(
+        std::shared_ptr<dev::eth::Transactions> _txs);
+    /// the max number of the submitted transactions imported in a batch
+    void setMaxSubmitBatchSize(size_t const& _size)
+    {
+        m_maxSubmitBatchSize = std::max(_size, (size_t)1);
+    }
+
     /**
      * @brief Remove transaction from the queue
      * @param _txHash: Remove bad transaction from the queue
@@ -150,6 +165,13 @@ public:
     /// protocol id used when register handler to p2p module
     virtual PROTOCOL_ID const& getProtocolId() const override { return m_protocolId; }
     void setTxPoolLimit(uint64_t const& _limit) { m_limit = _limit; }
+    /// the max number of pending transactions of a sender of weight 1, 0 means no limit
+    void setSenderLimit(size_t const& _limit) { m_senderLanes->setSenderLimit(_limit); }
+    /// the weights of the senders when sealing and evicting, the default weight is 1
+    void setSenderWeights(std::map<Address, size_t> const& _weights)
+    {
+        m_senderLanes->setWeights(_weights);
+    }
 
     /// Set transaction is known by a node
     void setTransactionIsKnownBy(h256 const& _txHash, h512 const& _nodeId) override;
@@ -157,10 +179,7 @@ public:
     /// Is the transaction is known by the node ?
     bool isTransactionKnownBy(h256 const& _txHash, h512 const& _nodeId) override
     {
-        auto p = m_transactionKnownBy.find(_txHash);
-        if (p == m_transactionKnownBy.end())
-            return false;
-        return p->second.find(_nodeId) != p->second.end();
+        return m_transactionKnownBy->isKnownBy(_txHash, _nodeId);
     }
 
     void setTransactionsAreKnownBy(
@@ -173,11 +192,7 @@ public:
     template <typename T>
     void markTransactionsAreKnownBy(T const& _txsHash, h512 const& _nodeId)
     {
-        WriteGuard l(x_transactionKnownBy);
-        for (auto const& tx_hash : _txsHash)
-        {
-            m_transactionKnownBy[tx_hash].insert(_nodeId);
-        }
+        m_transactionKnownBy->set(_txsHash, _nodeId);
     }
 
     /// Is the transaction is known by someone
@@ -190,8 +205,7 @@ public:
 
     bool isFull() override
     {
-        // UpgradableGuard l(m_lock);
-        return m_txsQueue.size() >= m_limit;
+        return m_txsQueue->size() >= m_limit;
     }
 
     dev::ThreadPool::Ptr workerPool() { return m_workerPool; }
@@ -214,6 +228,8 @@ protected:
     ImportResult import(dev::eth::Transaction::Ptr _tx, IfDropped _ik = IfDropped::Ignore) override;
     /// verify transaction
     virtual ImportResult verify(Transaction::Ptr trans, IfDropped _ik = IfDropped::Ignore);
+    /// verify the fields and the signature of the transaction, which need no lock of the txPool
+    ImportResult verifyTransaction(Transaction::Ptr _tx);
     /// interface for filter check
     virtual u256 filterCheck(Transaction::Ptr) const { return u256(0); };
     void clear();
@@ -225,6 +241,9 @@ protected:
 private:
     void startSubmitThread();
     void stopSubmitThread();
+    /// import the submitted transactions of m_txsCache in batches
+    void importSubmittedTxs();
+    void importSubmittedBatch(std::shared_ptr<dev::eth::Transactions> _txs);
 
     dev::eth::LocalisedTransactionReceipt::Ptr constructTransactionReceipt(
         dev::eth::Transaction::Ptr tx, dev::eth::TransactionReceipt::Ptr receipt,
@@ -235,7 +254,11 @@ private:
     bool removeTrans(h256 const& _txHash, bool _needTriggerCallback = true,
         std::shared_ptr<dev::eth::Block> _block = nullptr, size_t _index = 0);
 
-    bool insert(dev::eth::Transaction::Ptr _tx);
+    /// insert the transaction into the queue and the lane of its sender, evict a transaction of
+    /// a heavier lane if the txPool is full
+    ImportResult insert(dev::eth::Transaction::Ptr _tx);
+    /// evict the newest transaction of the heaviest lane if it's heavier than the lane of _sender
+    bool evict(Address const& _sender);
     void removeTransactionKnowBy(h256 const& _txHash);
     bool inline txPoolNonceCheck(dev::eth::Transaction::Ptr const& tx)
     {
@@ -264,26 +287,32 @@ private:
     std::shared_ptr<CommonTransactionNonceCheck> m_txpoolNonceChecker;
     /// Max number of pending transactions
     uint64_t m_limit;
-    mutable SharedMutex m_lock;
     /// protocolId
     PROTOCOL_ID m_protocolId;
     GROUP_ID m_groupId;
-    /// transaction queue
-    using TransactionQueue = std::set<dev::eth::Transaction::Ptr, transactionCompare>;
-    TransactionQueue m_txsQueue;
-    std::unordered_map<h256, TransactionQueue::iterator> m_txsHash;
+    /// transaction queue, ordered by the import order
+    ShardedTransactionQueue::Ptr m_txsQueue;
+    /// the transactions of m_txsQueue grouped by the senders, the transactions are sealed from
+    /// the lanes in turn
+    SenderLanes::Ptr m_senderLanes;
     mutable SharedMutex x_txsHashFilter;
     std::shared_ptr<std::set<h256>> m_txsHashFilter;
     /// hash of dropped transactions
+    mutable SharedMutex x_dropped;
     h256Hash m_dropped;
     /// Transaction is known by some peers
+    TransactionKnownBy::Ptr m_transactionKnownBy;
+    /// m_transactionKnownBy is synchronized by itself, the lock is kept for xtransactionKnownBy
     mutable SharedMutex x_transactionKnownBy;
-    std::unordered_map<h256, std::unordered_set<h512>> m_transactionKnownBy;
 
     dev::ThreadPool::Ptr m_submitPool;
     dev::ThreadPool::Ptr m_workerPool;
 
+    /// the submitted transactions to be imported
     std::shared_ptr<tbb::concurrent_queue<dev::eth::Transaction::Ptr>> m_txsCache;
+    /// there is an import task of m_txsCache in m_submitPool
+    std::atomic_bool m_importingTxsCache = {false};
+    size_t m_maxSubmitBatchSize = 1000;
     std::atomic_bool m_running = {false};
     std::condition_variable m_signalled;
     std::shared_ptr<std::map<dev::h256, dev::u256>> m_invalidTxs;
@@ -27,12 +27,16 @@
 #include <libethcore/Block.h>
 #include <libethcore/BlockHeader.h>
 #include <libethcore/Transaction.h>
+#include <libstorage/CachedStorage.h>
 #include <libstorage/Common.h>
 #include <libstorage/MemoryTable.h>
+#include <libstorage/MemoryTableFactoryFactory2.h>
+#include <libstorage/StorageException.h>
 #include <libstoragestate/StorageState.h>
 #include <libstoragestate/StorageStateFactory.h>
 #include <test/tools/libutils/TestOutputHelper.h>
 #include <test/unittests/libethcore/FakeBlock.h>
+#include <test/unittests/libstorage/MemoryStorage2.h>
 #include <boost/lexical_cast.hpp>
 #include <boost/test/unit_test.hpp>
 #include <unordered_map>
@@ -338,6 +342,73 @@ BOOST_AUTO_TEST_CASE(commitBlock)
     BOOST_CHECK_EQUAL(m_blockChainImp->totalTransactionCount().second, 2);
 }
 
+class FailedState : public MockState
+{
+public:
+    void dbCommit(h256 const&, int64_t) override
+    {
+        BOOST_THROW_EXCEPTION(StorageException(-1, "dbCommit failed"));
+    }
+};
+
+BOOST_AUTO_TEST_CASE(asyncIndex)
+{
+    auto cachedStorage = std::make_shared<CachedStorage>();
+    cachedStorage->setBackend(std::make_shared<MemoryStorage2>());
+    cachedStorage->setMaxForwardBlock(100);
+    auto tableFactoryFactory = std::make_shared<MemoryTableFactoryFactory2>();
+    tableFactoryFactory->setStorage(cachedStorage);
+
+    auto blockChain = std::make_shared<BlockChainImp>();
+    blockChain->setStateStorage(cachedStorage);
+    blockChain->setTableFactoryFactory(tableFactoryFactory);
+    blockChain->setStateFactory(m_storageStateFactory);
+    blockChain->setEnableAsyncCommit(true);
+    GenesisBlockParam initParam{"", dev::h512s(), dev::h512s(), "", "", "", 0, 0, 0, -1, -1, 0};
+    blockChain->checkAndBuildGenesisBlock(initParam);
+
+    auto newContext = [&](int64_t _number, std::shared_ptr<StorageState> _state) {
+        auto context = std::make_shared<ExecutiveContext>();
+        context->setMemoryTableFactory(tableFactoryFactory->newTableFactory(h256(), _number));
+        context->setState(_state);
+        return context;
+    };
+    auto newBlock = [&](size_t _size) {
+        auto block = std::make_shared<FakeBlock>(_size)->getBlock();
+        block->header().setNumber(blockChain->number() + 1);
+        block->header().setParentHash(blockChain->numberHash(blockChain->number()));
+        return block;
+    };
+
+    // the number is published at once, and the readers wait for the index of the block
+    auto block1 = newBlock(10);
+    auto commitResult =
+        blockChain->commitBlock(block1, newContext(1, std::make_shared<MockState>()));
+    BOOST_CHECK(commitResult == CommitResult::OK);
+    BOOST_CHECK_EQUAL(blockChain->number(), 1);
+    auto txHash = (*block1->transactions())[0]->sha3();
+    BOOST_CHECK_EQUAL(blockChain->getTxByHash(txHash)->sha3(), txHash);
+    BOOST_CHECK_EQUAL(blockChain->indexedNumber(), 1);
+    BOOST_CHECK_EQUAL(blockChain->getNonces(1)->size(), 10u);
+    BOOST_CHECK_EQUAL(blockChain->getBlockByNumber(1)->headerHash(), block1->headerHash());
+
+    // the deferred commit is given up if the block fails to commit
+    auto block2 = newBlock(5);
+    commitResult = blockChain->commitBlock(block2, newContext(2, std::make_shared<FailedState>()));
+    BOOST_CHECK(commitResult == CommitResult::ERROR_COMMITTING);
+    BOOST_CHECK_EQUAL(blockChain->number(), 1);
+    commitResult = blockChain->commitBlock(block2, newContext(2, std::make_shared<MockState>()));
+    BOOST_CHECK(commitResult == CommitResult::OK);
+    BOOST_CHECK_EQUAL(blockChain->getBlockByNumber(2)->headerHash(), block2->headerHash());
+    BOOST_CHECK_EQUAL(blockChain->totalTransactionCount().first, 15);
+
+    // the block was committed in two parts, and no commit is still deferred
+    BOOST_CHECK(cachedStorage->deferCommit(3));
+    cachedStorage->cancelDefer(3);
+    blockChain.reset();
+    cachedStorage->stop();
+}
+
 BOOST_AUTO_TEST_CASE(query)
 {
     dev::h512s sealerList = m_blockChainImp->sealerList();
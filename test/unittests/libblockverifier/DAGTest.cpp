@@ -24,7 +24,9 @@
 #include <test/tools/libutils/TestOutputHelper.h>
 #include <boost/test/unit_test.hpp>
 #include <iostream>
+#include <mutex>
 #include <set>
+#include <thread>
 
 using namespace std;
 using namespace dev;
@@ -172,6 +174,102 @@ BOOST_AUTO_TEST_CASE(DAGPopConsumeTest)
     BOOST_CHECK_EQUAL(topSet.size(), 0);
 }
 
+BOOST_AUTO_TEST_CASE(DAGPriorityTest)
+{
+    DAG dag;
+    dag.init(6);
+    // chain 3 -> 4 -> 5 is the critical path
+    dag.addEdge(3, 4);
+    dag.addEdge(4, 5);
+    dag.addEdge(0, 1);
+    // single 2 vertex
+    dag.generate();
+    BOOST_CHECK_EQUAL(dag.criticalPathLength(), 3);
+
+    BOOST_CHECK_EQUAL(dag.waitPop(false), 3);
+    BOOST_CHECK_EQUAL(dag.waitPop(false), 0);
+    BOOST_CHECK_EQUAL(dag.waitPop(false), 2);
+    BOOST_CHECK_EQUAL(dag.waitPop(false), INVALID_ID);
+    BOOST_CHECK_EQUAL(dag.consume(2), INVALID_ID);
+    BOOST_CHECK_EQUAL(dag.consume(0), 1);
+    BOOST_CHECK_EQUAL(dag.consume(3), 4);
+    BOOST_CHECK_EQUAL(dag.consume(1), INVALID_ID);
+    BOOST_CHECK_EQUAL(dag.consume(4), 5);
+    BOOST_CHECK_EQUAL(dag.consume(5), INVALID_ID);
+    BOOST_CHECK_EQUAL(dag.waitPop(), INVALID_ID);
+}
+
+BOOST_AUTO_TEST_CASE(DAGConsumeReturnsHighestPriorityTest)
+{
+    DAG dag;
+    dag.init(5);
+    dag.addEdge(0, 1);
+    dag.addEdge(0, 2);
+    dag.addEdge(0, 3);
+    dag.addEdge(2, 4);
+    dag.generate();
+
+    BOOST_CHECK_EQUAL(dag.waitPop(false), 0);
+    // 2 leads to 4, the others are queued
+    BOOST_CHECK_EQUAL(dag.consume(0), 2);
+    BOOST_CHECK_EQUAL(dag.waitPop(false), 1);
+    BOOST_CHECK_EQUAL(dag.waitPop(false), 3);
+    BOOST_CHECK_EQUAL(dag.waitPop(false), INVALID_ID);
+}
+
+BOOST_AUTO_TEST_CASE(DAGParallelConsumeTest)
+{
+    ID size = 2000;
+    DAG dag;
+    dag.init(size);
+    for (ID id = 1; id < size; ++id)
+    {
+        // some long chains and some wide levels
+        dag.addEdge(id % 7 == 0 ? id - 1 : id / 2, id);
+    }
+    dag.generate();
+
+    std::mutex x_executed;
+    std::vector<ID> executed;
+    std::vector<std::atomic<bool>> finished(size);
+    std::atomic<bool> ordered{true};
+    std::atomic<ID> consumed{0};
+    auto worker = [&]() {
+        // waitPop returns INVALID_ID if nothing is ready for a while
+        while (consumed < size)
+        {
+            ID id = dag.waitPop();
+            while (id != INVALID_ID)
+            {
+                // the parent must have been consumed
+                if ((id > 0 && !finished[id % 7 == 0 ? id - 1 : id / 2]) || finished[id])
+                {
+                    ordered = false;
+                }
+                finished[id] = true;
+                {
+                    std::lock_guard<std::mutex> l(x_executed);
+                    executed.push_back(id);
+                }
+                auto next = dag.consume(id);
+                ++consumed;
+                id = next;
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i)
+    {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    BOOST_CHECK(ordered);
+    BOOST_CHECK_EQUAL(executed.size(), size);
+    BOOST_CHECK_EQUAL(set<ID>(executed.begin(), executed.end()).size(), size);
+}
 
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
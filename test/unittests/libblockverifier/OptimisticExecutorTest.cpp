@@ -0,0 +1,241 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+/**
+ * @brief : unitest for the optimistic parallel execution
+ */
+
+#include <libblockverifier/OptimisticExecutor.h>
+#include <libstorage/Common.h>
+#include <libstorage/SpeculativeTableFactory.h>
+#include <libstorage/Storage.h>
+#include <boost/lexical_cast.hpp>
+#include <boost/test/unit_test.hpp>
+#include <map>
+#include <mutex>
+
+using namespace std;
+using namespace dev;
+using namespace dev::blockverifier;
+using namespace dev::storage;
+
+namespace test_OptimisticExecutor
+{
+// returns copies of the rows like CachedStorage
+class MockStorage : public Storage
+{
+public:
+    Entries::Ptr select(int64_t, TableInfo::Ptr tableInfo, const std::string& key,
+        Condition::Ptr condition) override
+    {
+        lock_guard<mutex> lock(m_mutex);
+        auto entries = make_shared<Entries>();
+        auto it = m_rows.find(make_pair(tableInfo->name, key));
+        if (it == m_rows.end())
+        {
+            return entries;
+        }
+        for (auto& row : it->second)
+        {
+            if (condition && !condition->process(row))
+            {
+                continue;
+            }
+            auto entry = make_shared<Entry>();
+            entry->copyFrom(row);
+            entries->addEntry(entry);
+        }
+        return entries;
+    }
+    size_t commit(int64_t, const std::vector<TableData::Ptr>&) override { return 0; }
+
+    void put(string const& _table, string const& _keyField, string const& _key,
+        map<string, string> const& _fields)
+    {
+        auto entry = make_shared<Entry>();
+        entry->setID(++m_ID);
+        entry->setNum(0);
+        entry->setStatus(0);
+        entry->setField(_keyField, _key);
+        for (auto& field : _fields)
+        {
+            entry->setField(field.first, field.second);
+        }
+        m_rows[make_pair(_table, _key)].push_back(entry);
+    }
+
+private:
+    mutex m_mutex;
+    uint64_t m_ID = 0;
+    map<pair<string, string>, vector<Entry::Ptr>> m_rows;
+};
+
+struct Transfer
+{
+    string from;
+    string to;
+    int amount;
+    // create a table named by the transaction
+    bool createTable;
+};
+
+struct OptimisticExecutorFixture
+{
+    OptimisticExecutorFixture()
+    {
+        storage = make_shared<MockStorage>();
+        storage->put(SYS_TABLES, "table_name", "t_balance",
+            {{"key_field", "key"}, {"value_field", "value"}});
+        storage->put(
+            SYS_TABLES, "table_name", "t_log", {{"key_field", "key"}, {"value_field", "value"}});
+        for (int i = 0; i < 10; ++i)
+        {
+            storage->put("t_balance", "key", "u" + to_string(i), {{"value", "100"}});
+        }
+    }
+
+    MemoryTableFactory2::Ptr newBlockFactory()
+    {
+        auto tableFactory = make_shared<MemoryTableFactory2>();
+        tableFactory->setStateStorage(storage);
+        tableFactory->init();
+        return tableFactory;
+    }
+
+    // a transfer that fails if the balance is not enough and is reverted if the amount is odd
+    int transfer(TableFactory& _tableFactory, size_t _index, Transfer const& _transfer)
+    {
+        if (_transfer.createTable)
+        {
+            auto table = _tableFactory.createTable(
+                "t_new_" + to_string(_index), "key", "value", true, Address(), true);
+            auto entry = table->newEntry();
+            entry->setField("value", to_string(_index));
+            table->insert(_transfer.from, entry);
+        }
+        auto balance = _tableFactory.openTable("t_balance");
+        auto fromEntries = balance->select(_transfer.from, balance->newCondition());
+        auto toEntries = balance->select(_transfer.to, balance->newCondition());
+        auto fromBalance = boost::lexical_cast<int>(fromEntries->get(0)->getField("value"));
+        auto toBalance = boost::lexical_cast<int>(toEntries->get(0)->getField("value"));
+        if (fromBalance < _transfer.amount)
+        {
+            return -1;
+        }
+        auto savepoint = _tableFactory.savepoint();
+        auto entry = balance->newEntry();
+        entry->setField("value", to_string(fromBalance - _transfer.amount));
+        balance->update(_transfer.from, entry, balance->newCondition());
+        entry = balance->newEntry();
+        entry->setField("value", to_string(toBalance + _transfer.amount));
+        balance->update(_transfer.to, entry, balance->newCondition());
+        if (_transfer.amount % 2)
+        {
+            _tableFactory.rollback(savepoint);
+            return 0;
+        }
+        // every transaction writes the same key without reading it
+        auto log = _tableFactory.openTable("t_log");
+        entry = log->newEntry();
+        entry->setField("value", _transfer.from + "->" + _transfer.to);
+        log->insert("log", entry);
+        return fromBalance - _transfer.amount;
+    }
+
+    // execute the transfers serially and optimistically, the hashes and results must be the same
+    size_t check(vector<Transfer> const& _transfers)
+    {
+        auto serialFactory = newBlockFactory();
+        vector<int> serialResults;
+        for (size_t i = 0; i < _transfers.size(); ++i)
+        {
+            serialResults.push_back(transfer(*serialFactory, i, _transfers[i]));
+            serialFactory->commit();
+        }
+
+        auto blockFactory = newBlockFactory();
+        vector<int> results(_transfers.size());
+        OptimisticExecutor executor(blockFactory);
+        executor.run(
+            _transfers.size(),
+            [&](size_t _index) {
+                auto tableFactory = make_shared<SpeculativeTableFactory>();
+                tableFactory->setStateStorage(storage);
+                results[_index] = transfer(*tableFactory, _index, _transfers[_index]);
+                return tableFactory;
+            },
+            [&](size_t _index) {
+                results[_index] = transfer(*blockFactory, _index, _transfers[_index]);
+            });
+
+        BOOST_CHECK(results == serialResults);
+        BOOST_CHECK_EQUAL(blockFactory->hash(), serialFactory->hash());
+        BOOST_CHECK_EQUAL(blockFactory->savepoint(), 0u);
+        return executor.reexecutedNumber();
+    }
+
+    shared_ptr<MockStorage> storage;
+};
+
+BOOST_FIXTURE_TEST_SUITE(OptimisticExecutor, OptimisticExecutorFixture)
+
+BOOST_AUTO_TEST_CASE(disjoint)
+{
+    vector<Transfer> transfers;
+    for (int i = 0; i < 5; ++i)
+    {
+        transfers.push_back(
+            Transfer{"u" + to_string(2 * i), "u" + to_string(2 * i + 1), 10 + i, i == 2});
+    }
+    BOOST_CHECK_EQUAL(check(transfers), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(conflicting)
+{
+    vector<Transfer> transfers;
+    for (int i = 0; i < 40; ++i)
+    {
+        transfers.push_back(Transfer{"u" + to_string(i % 10), "u" + to_string((i * 7 + 3) % 10),
+            (i * 13) % 60, i % 9 == 0});
+    }
+    auto reexecuted = check(transfers);
+    BOOST_CHECK_GT(reexecuted, 0u);
+    BOOST_CHECK_LT(reexecuted, transfers.size());
+}
+
+BOOST_AUTO_TEST_CASE(validate)
+{
+    auto blockFactory = newBlockFactory();
+    auto tableFactory = make_shared<SpeculativeTableFactory>();
+    tableFactory->setStateStorage(storage);
+    transfer(*tableFactory, 0, Transfer{"u0", "u1", 10, false});
+    BOOST_CHECK(tableFactory->readKeys().count(make_pair(string("t_balance"), string("u1"))));
+    BOOST_CHECK(!tableFactory->readKeys().count(make_pair(string("t_log"), string("log"))));
+
+    TableKeySet writtenKeys;
+    writtenKeys.insert(make_pair("t_log", "log"));
+    BOOST_CHECK(tableFactory->validate(*blockFactory, writtenKeys));
+    writtenKeys.insert(make_pair("t_balance", "u1"));
+    BOOST_CHECK(!tableFactory->validate(*blockFactory, writtenKeys));
+
+    // the table is open in the block factory with other authorized addresses
+    blockFactory->openTable("t_balance")->tableInfo()->authorizedAddress.push_back(Address(1));
+    BOOST_CHECK(!tableFactory->validate(*blockFactory, TableKeySet()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test_OptimisticExecutor
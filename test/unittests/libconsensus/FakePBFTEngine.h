@@ -114,6 +114,8 @@ public:
         PBFTEngine::onRecvPBFTMessage(exception, session, message);
     }
 
+    bool checkSignWrapper(PBFTMsg const& _req) const { return PBFTEngine::checkSign(_req); }
+
     P2PMessage::Ptr transDataToMessageWrapper(
         bytesConstRef data, PACKET_TYPE const& packetType, unsigned const& ttl)
     {
@@ -234,6 +236,41 @@ public:
 
     void setOmitEmpty(bool value) { m_omitEmptyBlock = value; }
 
+    /// pretend the block _hash has been executed ahead on the parent (_parentNumber, _parentHash)
+    dev::storage::OverlayStorage::Ptr fakeExecutedAhead(h256 const& _hash, int64_t _parentNumber,
+        h256 const& _parentHash, dev::blockverifier::ExecutiveContext::Ptr _context)
+    {
+        auto ahead = std::make_shared<ExecutedAhead>();
+        ahead->blockHash = _hash;
+        ahead->parentNumber = _parentNumber;
+        ahead->parentHash = _parentHash;
+        ahead->block = m_blockFactory->createBlock();
+        ahead->stateStorage = std::make_shared<dev::storage::OverlayStorage>(nullptr,
+            _parentNumber, std::vector<dev::storage::TableData::Ptr>(), []() { return false; });
+        std::promise<dev::blockverifier::ExecutiveContext::Ptr> promise;
+        promise.set_value(_context);
+        ahead->context = promise.get_future().share();
+        std::lock_guard<std::mutex> l(x_executedAhead);
+        m_executedAhead = ahead;
+        return ahead->stateStorage;
+    }
+    bool hasExecutedAhead()
+    {
+        std::lock_guard<std::mutex> l(x_executedAhead);
+        return m_executedAhead != nullptr;
+    }
+    h256 executedAheadHash()
+    {
+        std::lock_guard<std::mutex> l(x_executedAhead);
+        return m_executedAhead ? m_executedAhead->blockHash : h256();
+    }
+    void executeAhead(PrepareReq::Ptr _futureReq) { PBFTEngine::executeAhead(_futureReq); }
+    dev::blockverifier::ExecutiveContext::Ptr takeExecutedAhead(
+        Sealing& _sealing, PrepareReq const& _req)
+    {
+        return PBFTEngine::takeExecutedAhead(_sealing, _req);
+    }
+
     /// handle sign
     bool handleSignMsg(SignReq::Ptr sign_req, PBFTMsgPacket const& pbftMsg)
     {
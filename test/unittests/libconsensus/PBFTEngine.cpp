@@ -23,6 +23,7 @@
  */
 #include "PBFTEngine.h"
 #include "Common.h"
+#include <libstorage/MemoryTableFactory2.h>
 #include <test/tools/libutils/TestOutputHelper.h>
 #include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
@@ -302,6 +303,48 @@ BOOST_AUTO_TEST_CASE(testOnRecvPBFTMessage)
     CheckOnRecvPBFTMessage(
         fake_pbft.consensus(), session2, viewChange_req, ViewChangeReqPacket, true);
 }
+
+/// test the verification stage ahead of the work loop
+BOOST_AUTO_TEST_CASE(testVerifyPBFTMsg)
+{
+    FakeConsensus<FakePBFTEngine> fake_pbft(1, ProtocolID::PBFT);
+    FakePBFTSealer(fake_pbft);
+    fake_pbft.consensus()->setVerifyThreadNum(2);
+    KeyPair key_pair;
+    PrepareReq prepare_req = FakePrepareReq(key_pair);
+    std::shared_ptr<FakeSession> session = FakeSessionFunc(fake_pbft.m_sealerList[0]);
+
+    /// the message signed by the sealer of its index is decoded and verified
+    SignReq sign_req(prepare_req, fake_pbft.m_keyPair[0], 0);
+    P2PMessage::Ptr message =
+        FakeReqMessage(fake_pbft.consensus(), sign_req, SignReqPacket, ProtocolID::PBFT);
+    fake_pbft.consensus()->onRecvPBFTMessage(NetworkException(), session, message);
+    auto ret = fake_pbft.consensus()->mutableMsgQueue().tryPop(1000);
+    BOOST_CHECK(ret.first == true);
+    auto signReq = std::dynamic_pointer_cast<SignReq>(ret.second->decodedMsg);
+    BOOST_REQUIRE(signReq);
+    BOOST_CHECK(*signReq == sign_req);
+    BOOST_CHECK(signReq->signVerifiedBy == fake_pbft.m_sealerList[0]);
+    BOOST_CHECK(fake_pbft.consensus()->checkSignWrapper(*signReq));
+
+    /// the message with invalid signature is left to the work loop
+    CommitReq commit_req(prepare_req, KeyPair::create(), 0);
+    message = FakeReqMessage(fake_pbft.consensus(), commit_req, CommitReqPacket, ProtocolID::PBFT);
+    fake_pbft.consensus()->onRecvPBFTMessage(NetworkException(), session, message);
+    ret = fake_pbft.consensus()->mutableMsgQueue().tryPop(1000);
+    BOOST_CHECK(ret.first == true);
+    auto commitReq = std::dynamic_pointer_cast<CommitReq>(ret.second->decodedMsg);
+    BOOST_REQUIRE(commitReq);
+    BOOST_CHECK(commitReq->signVerifiedBy == h512());
+    BOOST_CHECK(!fake_pbft.consensus()->checkSignWrapper(*commitReq));
+
+    /// the message failed to decode is dropped
+    bytes invalidData(32, 0xff);
+    message = fake_pbft.consensus()->transDataToMessageWrapper(ref(invalidData), SignReqPacket, 1);
+    fake_pbft.consensus()->onRecvPBFTMessage(NetworkException(), session, message);
+    ret = fake_pbft.consensus()->mutableMsgQueue().tryPop(100);
+    BOOST_CHECK(ret.first == false);
+}
 /// test broadcastMsg
 BOOST_AUTO_TEST_CASE(testBroadcastMsg)
 {
@@ -856,6 +899,103 @@ BOOST_AUTO_TEST_CASE(testHandleFutureBlock)
         fake_pbft.consensus()->reqCache()->futurePrepareCache(prepareReq->height) == nullptr);
 }
 
+/// test the block executed ahead is only used for the prepare it is executed for, on the parent
+/// committed
+BOOST_AUTO_TEST_CASE(testTakeExecutedAhead)
+{
+    FakeConsensus<FakePBFTEngine> fake_pbft(1, ProtocolID::PBFT);
+    auto engine = fake_pbft.consensus();
+    auto number = engine->blockChain()->number();
+    auto parentHash = engine->blockChain()->numberHash(number);
+    auto context = std::make_shared<dev::blockverifier::ExecutiveContext>();
+    Sealing sealing(std::make_shared<dev::eth::BlockFactory>());
+    PrepareReq req;
+    req.height = number + 1;
+    req.block_hash = sha3("executedAhead");
+
+    /// nothing is executed ahead
+    BOOST_CHECK(engine->takeExecutedAhead(sealing, req) == nullptr);
+
+    /// the parent committed is not the one the block is executed on
+    auto stateStorage = engine->fakeExecutedAhead(req.block_hash, number, sha3("fork"), context);
+    BOOST_CHECK(engine->takeExecutedAhead(sealing, req) == nullptr);
+    BOOST_CHECK(stateStorage->cancelled());
+    BOOST_CHECK(!engine->hasExecutedAhead());
+
+    /// the block is executed on an older parent
+    stateStorage = engine->fakeExecutedAhead(req.block_hash, number - 1, parentHash, context);
+    BOOST_CHECK(engine->takeExecutedAhead(sealing, req) == nullptr);
+    BOOST_CHECK(stateStorage->cancelled());
+    BOOST_CHECK(!engine->hasExecutedAhead());
+
+    /// another block of the same number is in consensus
+    stateStorage = engine->fakeExecutedAhead(sha3("other"), number, parentHash, context);
+    BOOST_CHECK(engine->takeExecutedAhead(sealing, req) == nullptr);
+    BOOST_CHECK(stateStorage->cancelled());
+
+    /// the block is executed for a later prepare, it is kept
+    stateStorage = engine->fakeExecutedAhead(req.block_hash, number + 1, sha3("next"), context);
+    BOOST_CHECK(engine->takeExecutedAhead(sealing, req) == nullptr);
+    BOOST_CHECK(!stateStorage->cancelled());
+    BOOST_CHECK(engine->hasExecutedAhead());
+
+    /// the block and its parent match, the context executed ahead is taken
+    stateStorage = engine->fakeExecutedAhead(req.block_hash, number, parentHash, context);
+    auto block = sealing.block;
+    BOOST_CHECK(engine->takeExecutedAhead(sealing, req) == context);
+    BOOST_CHECK(!stateStorage->cancelled());
+    BOOST_CHECK(!engine->hasExecutedAhead());
+    BOOST_CHECK(sealing.block != block);
+}
+
+/// test only the signed prepare of the leader of the next block is executed ahead, and it is
+/// never replaced on the same parent
+BOOST_AUTO_TEST_CASE(testExecuteAheadLeaderPrepare)
+{
+    FakeConsensus<FakePBFTEngine> fake_pbft(4, ProtocolID::PBFT);
+    auto engine = fake_pbft.consensus();
+    engine->setEnableExecuteAhead(true);
+    /// the prepare in consensus, executed and not committed
+    PrepareReq::Ptr parentReq = std::make_shared<PrepareReq>();
+    fakeValidPrepare(fake_pbft, *parentReq);
+    auto parentContext = std::make_shared<dev::blockverifier::ExecutiveContext>();
+    parentContext->setMemoryTableFactory(std::make_shared<dev::storage::MemoryTableFactory2>());
+    parentReq->p_execContext = parentContext;
+    engine->reqCache()->addPrepareReq(parentReq);
+
+    /// the prepare of the next block from _idx, signed with the key of _signer
+    auto futureReq = [&](IDXTYPE _idx, IDXTYPE _signer, VIEWTYPE _view, std::string const& _data) {
+        PrepareReq::Ptr req = std::make_shared<PrepareReq>();
+        req->height = parentReq->height + 1;
+        req->view = _view;
+        req->idx = _idx;
+        req->block_hash = sha3(_data);
+        req->sig = dev::sign(fake_pbft.m_keyPair[_signer], req->block_hash);
+        req->sig2 = dev::sign(fake_pbft.m_keyPair[_signer], req->fieldsWithoutBlock());
+        return req;
+    };
+    IDXTYPE leader = parentReq->height % fake_pbft.m_keyPair.size();
+    IDXTYPE other = (leader + 1) % fake_pbft.m_keyPair.size();
+
+    /// the prepare forged for the leader
+    engine->executeAhead(futureReq(leader, other, 0, "forged"));
+    BOOST_CHECK(!engine->hasExecutedAhead());
+    /// the prepare of a sealer not the leader
+    engine->executeAhead(futureReq(other, other, 0, "notLeader"));
+    BOOST_CHECK(!engine->hasExecutedAhead());
+    /// the prepare of the leader of another view
+    engine->executeAhead(futureReq(other, other, 1, "otherView"));
+    BOOST_CHECK(!engine->hasExecutedAhead());
+
+    /// the prepare of the leader is executed ahead
+    engine->executeAhead(futureReq(leader, leader, 0, "leader"));
+    BOOST_CHECK(engine->executedAheadHash() == sha3("leader"));
+    /// neither a forged nor another signed prepare replaces it
+    engine->executeAhead(futureReq(leader, other, 0, "forged"));
+    engine->executeAhead(futureReq(leader, leader, 0, "another"));
+    BOOST_CHECK(engine->executedAheadHash() == sha3("leader"));
+}
+
 /// test handleViewChangeMsg
 BOOST_AUTO_TEST_CASE(testHandleViewchangeMsg)
 {
@@ -0,0 +1,133 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ *
+ * @brief Construct a new boost auto test case object for Arena
+ *
+ * @file Arena.cpp
+ */
+
+#include <libdevcore/Arena.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace dev;
+using namespace std;
+
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(Arena, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(testAlignment)
+{
+    dev::Arena arena(1024);
+    for (size_t alignment : {1, 2, 4, 8, 16, 64})
+    {
+        arena.allocate(3, 1);
+        auto pointer = arena.allocate(5, alignment);
+        BOOST_CHECK(reinterpret_cast<uintptr_t>(pointer) % alignment == 0);
+    }
+    BOOST_CHECK(arena.allocations() == 12);
+    BOOST_CHECK(arena.chunks() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(testLargeAllocation)
+{
+    dev::Arena arena(1024);
+    auto small = static_cast<char*>(arena.allocate(16, 8));
+    // a large object that does not fit has a chunk of its own, the current chunk is still used
+    auto large = arena.allocate(1020, 8);
+    auto next = static_cast<char*>(arena.allocate(16, 8));
+    BOOST_CHECK(large != nullptr);
+    BOOST_CHECK(next == small + 16);
+    BOOST_CHECK(arena.chunks() == 2);
+    BOOST_CHECK(arena.memorySize() == 1024 + 1020 + 8);
+
+    // a full chunk is replaced
+    for (size_t i = 0; i < 100; ++i)
+    {
+        arena.allocate(16, 8);
+    }
+    BOOST_CHECK(arena.chunks() == 3);
+}
+
+BOOST_AUTO_TEST_CASE(testAllocateShared)
+{
+    auto arena = make_shared<dev::Arena>();
+    auto value = allocateShared<string>(arena, 100, 'a');
+    BOOST_CHECK(arena.use_count() == 2);
+    weak_ptr<dev::Arena> weakArena = arena;
+    arena.reset();
+    // the object keeps the arena alive
+    BOOST_CHECK(!weakArena.expired());
+    BOOST_CHECK(*value == string(100, 'a'));
+    value.reset();
+    BOOST_CHECK(weakArena.expired());
+
+    // the heap is used without an arena
+    value = allocateShared<string>(nullptr, "abc");
+    BOOST_CHECK(*value == "abc");
+
+    arena = make_shared<dev::Arena>();
+    vector<int, ArenaAllocator<int>> values{ArenaAllocator<int>(arena)};
+    for (int i = 0; i < 100; ++i)
+    {
+        values.push_back(i);
+    }
+    BOOST_CHECK(values[99] == 99);
+    BOOST_CHECK(arena->allocations() > 1);
+}
+
+BOOST_AUTO_TEST_CASE(testThreads)
+{
+    dev::Arena arena(1024);
+    size_t threadNum = 8;
+    vector<thread> threads;
+    vector<vector<uint64_t*>> pointers(threadNum);
+    for (size_t i = 0; i < threadNum; ++i)
+    {
+        threads.emplace_back([&, i]() {
+            for (size_t j = 0; j < 1000; ++j)
+            {
+                auto pointer = static_cast<uint64_t*>(arena.allocate(8, 8));
+                *pointer = i * 1000 + j;
+                pointers[i].push_back(pointer);
+            }
+        });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    BOOST_CHECK(arena.allocations() == threadNum * 1000);
+    // 128 allocations of a thread fill a chunk
+    BOOST_CHECK(arena.chunks() == threadNum * 8);
+    for (size_t i = 0; i < threadNum; ++i)
+    {
+        for (size_t j = 0; j < 1000; ++j)
+        {
+            BOOST_CHECK(*pointers[i][j] == i * 1000 + j);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
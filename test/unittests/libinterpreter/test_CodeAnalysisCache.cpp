@@ -0,0 +1,142 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ *
+ * @brief: unit test for CodeAnalysisCache
+ *
+ * @file test_CodeAnalysisCache.cpp
+ */
+#include <libinterpreter/CodeAnalysisCache.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+#include <thread>
+
+using namespace dev::eth;
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(CodeAnalysisCacheTest, TestOutputHelperFixture)
+
+CodeAnalysis::Ptr createAnalysis(size_t _codeSize)
+{
+    auto analysis = std::make_shared<CodeAnalysis>();
+    analysis->codeSize = _codeSize;
+    analysis->code.resize(_codeSize + 33);
+    analysis->jumpDests.push_back(0);
+    return analysis;
+}
+
+BOOST_AUTO_TEST_CASE(getAndPut)
+{
+    CodeAnalysisCache cache;
+    h256 codeHash(1);
+    BOOST_CHECK(!cache.get(codeHash, 100));
+    auto analysis = createAnalysis(100);
+    cache.put(codeHash, analysis);
+    BOOST_CHECK(cache.get(codeHash, 100) == analysis);
+    // the code of the hash is not of the size
+    BOOST_CHECK(!cache.get(codeHash, 99));
+    BOOST_CHECK(!cache.get(h256(2), 100));
+    BOOST_CHECK_EQUAL(cache.queryTimes(), 4);
+    BOOST_CHECK_EQUAL(cache.hitTimes(), 1);
+    BOOST_CHECK_EQUAL(cache.size(), 1);
+    BOOST_CHECK_EQUAL(cache.memorySize(), analysis->memorySize());
+
+    // replace the analysis of the same hash
+    auto other = createAnalysis(100);
+    cache.put(codeHash, other);
+    BOOST_CHECK(cache.get(codeHash, 100) == other);
+    BOOST_CHECK_EQUAL(cache.size(), 1);
+    BOOST_CHECK_EQUAL(cache.memorySize(), other->memorySize());
+
+    cache.clear();
+    BOOST_CHECK(!cache.get(codeHash, 100));
+    BOOST_CHECK_EQUAL(cache.size(), 0);
+    BOOST_CHECK_EQUAL(cache.queryTimes(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(evict)
+{
+    auto memorySize = createAnalysis(1000)->memorySize();
+    // 3 analyses a shard
+    CodeAnalysisCache cache(memorySize * 3 * 16);
+    // the hashes of the same first byte are in the same shard
+    std::vector<h256> hashes;
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        hashes.push_back(h256(i + 1));
+    }
+    for (unsigned i = 0; i < 3; ++i)
+    {
+        cache.put(hashes[i], createAnalysis(1000));
+    }
+    // hashes[0] is used recently, hashes[1] is evicted
+    BOOST_CHECK(cache.get(hashes[0], 1000));
+    cache.put(hashes[3], createAnalysis(1000));
+    BOOST_CHECK(cache.get(hashes[0], 1000));
+    BOOST_CHECK(!cache.get(hashes[1], 1000));
+    BOOST_CHECK(cache.get(hashes[2], 1000));
+    BOOST_CHECK(cache.get(hashes[3], 1000));
+    BOOST_CHECK_EQUAL(cache.size(), 3);
+
+    // too large to be cached
+    cache.put(h256(5), createAnalysis(memorySize * 4));
+    BOOST_CHECK(!cache.get(h256(5), memorySize * 4));
+
+    cache.setCapacity(memorySize * 16);
+    BOOST_CHECK_EQUAL(cache.size(), 1);
+    BOOST_CHECK(cache.get(hashes[3], 1000));
+}
+
+BOOST_AUTO_TEST_CASE(disable)
+{
+    CodeAnalysisCache cache(0);
+    BOOST_CHECK(!cache.enabled());
+    cache.put(h256(1), createAnalysis(100));
+    BOOST_CHECK(!cache.get(h256(1), 100));
+    BOOST_CHECK_EQUAL(cache.size(), 0);
+    BOOST_CHECK_EQUAL(cache.queryTimes(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(concurrentAccess)
+{
+    CodeAnalysisCache cache;
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < 8; ++t)
+    {
+        threads.emplace_back([&cache]() {
+            for (unsigned i = 0; i < 1000; ++i)
+            {
+                h256 codeHash(i % 64);
+                if (!cache.get(codeHash, 100 + i % 64))
+                {
+                    cache.put(codeHash, createAnalysis(100 + i % 64));
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    BOOST_CHECK_EQUAL(cache.size(), 64);
+    BOOST_CHECK_EQUAL(cache.queryTimes(), 8000);
+    BOOST_CHECK_GE(cache.hitTimes(), 8000 - 64 * 8);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
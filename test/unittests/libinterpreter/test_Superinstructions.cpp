@@ -0,0 +1,209 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ *
+ * @brief: the results and the gas of the code with superinstructions are the same as without them
+ *
+ * @file test_Superinstructions.cpp
+ */
+#include <libinterpreter/VM.h>
+#include <test/tools/libutils/FakeEvmc.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace dev::eth;
+namespace dev
+{
+namespace test
+{
+class SuperinstructionsFixture : public TestOutputHelperFixture
+{
+public:
+    SuperinstructionsFixture() : evmc(evmc_create_interpreter()) {}
+    ~SuperinstructionsFixture() { VM::setEnableSuperinstructions(true); }
+
+    struct Result
+    {
+        evmc_status_code status;
+        int64_t gasLeft;
+        bytes output;
+        map<string, u256> storage;
+
+        bool operator==(Result const& _other) const
+        {
+            return status == _other.status && gasLeft == _other.gasLeft &&
+                   output == _other.output && storage == _other.storage;
+        }
+    };
+
+    Result execute(bytes const& _code, bytes const& _data, int64_t _gas, bool _superinstructions,
+        bool _isCreate = false)
+    {
+        VM::setEnableSuperinstructions(_superinstructions);
+        Address destination = right160(sha3(to_string(++m_index)));
+        auto result = evmc.execute(DefaultSchedule, _code, _data, destination, destination, 0,
+            _gas, 0, _isCreate, false);
+        Result r{result.status_code, result.gas_left,
+            bytes(result.output_data, result.output_data + result.output_size), {}};
+        if (result.release)
+        {
+            result.release(&result);
+        }
+        for (auto const& item : evmc.getState()[destination.hex()])
+        {
+            r.storage[item.first] = fromEvmC(item.second);
+        }
+        return r;
+    }
+
+    // executes _code with the gas from 0 up to what it needs, so that every instruction runs out
+    // of gas once, the results must be the same with and without superinstructions
+    Result check(bytes const& _code, bool _isCreate = false, int64_t _gas = 1000000)
+    {
+        auto expected = execute(_code, bytes(), _gas, false, _isCreate);
+        BOOST_CHECK(execute(_code, bytes(), _gas, true, _isCreate) == expected);
+        for (int64_t gas = 0; gas <= _gas; ++gas)
+        {
+            auto withoutSuperinstructions = execute(_code, bytes(), gas, false, _isCreate);
+            BOOST_CHECK(execute(_code, bytes(), gas, true, _isCreate) == withoutSuperinstructions);
+            if (withoutSuperinstructions.status != EVMC_OUT_OF_GAS)
+            {
+                break;
+            }
+        }
+        return expected;
+    }
+
+    // the analysed code of the last call of _code
+    bytes analysedCode(bytes const& _code)
+    {
+        auto analysis = CodeAnalysisCache::instance().get(sha3(_code), _code.size());
+        return analysis ? analysis->code : bytes();
+    }
+
+    FakeEvmc evmc;
+    size_t m_index = 0;
+};
+
+BOOST_FIXTURE_TEST_SUITE(SuperinstructionsTest, SuperinstructionsFixture)
+
+BOOST_AUTO_TEST_CASE(fuse)
+{
+    // PUSH1 1 PUSH1 2 ADD PUSH1 0 MSTORE PUSH1 0 MLOAD CALLVALUE ISZERO PUSH1 0x11 JUMPI STOP
+    // JUMPDEST DUP1 DUP2 SWAP1 POP POP PUSH1 0x20 PUSH1 0 RETURN
+    bytes code = fromHex("60016002016000526000513415601157005b808190505060206000f3");
+    auto result = check(code);
+    BOOST_CHECK(result.status == EVMC_SUCCESS);
+    BOOST_CHECK(u256(3) == fromBigEndian<u256>(result.output));
+
+    auto analysed = analysedCode(code);
+    BOOST_REQUIRE(analysed.size() > code.size());
+    BOOST_CHECK(analysed[2] == (byte)Instruction::PUSHADD);
+    BOOST_CHECK(analysed[5] == (byte)Instruction::PUSHMSTORE);
+    BOOST_CHECK(analysed[8] == (byte)Instruction::PUSHMLOAD);
+    BOOST_CHECK(analysed[12] == (byte)Instruction::ISZEROJUMPI);
+    BOOST_CHECK(analysed[18] == (byte)Instruction::STACKRUN);
+    // the other instructions of the sequences are kept
+    BOOST_CHECK(bytes(analysed.begin() + 19, analysed.begin() + code.size()) ==
+                bytes(code.begin() + 19, code.end()));
+
+    VM::setEnableSuperinstructions(false);
+    execute(code, bytes(), 1000000, false);
+    BOOST_CHECK(analysedCode(code)[2] == (byte)Instruction::PUSH1);
+}
+
+BOOST_AUTO_TEST_CASE(arithmetic)
+{
+    // the operands of the 64-bit boundaries, the results are returned
+    // PUSH8 0xffffffffffffffff PUSH1 1 ADD PUSH1 0 MSTORE
+    // PUSH1 1 PUSH1 0 SUB PUSH1 0x20 MSTORE
+    // PUSH8 0xffffffffffffffff DUP1 MUL PUSH1 0x40 MSTORE
+    // PUSH1 0 PUSH1 7 DIV PUSH1 0x60 MSTORE
+    // PUSH1 0 PUSH1 7 MOD PUSH1 0x80 MSTORE
+    // PUSH9 0x010000000000000000 PUSH1 1 LT PUSH1 0xa0 MSTORE
+    // PUSH1 1 PUSH9 0x010000000000000000 GT PUSH1 0xc0 MSTORE
+    // PUSH9 0x010000000000000000 PUSH1 0 EQ PUSH1 0xe0 MSTORE PUSH2 0x0100 PUSH1 0 RETURN
+    bytes code = fromHex(
+        "67ffffffffffffffff6001016000526001600003602052"
+        "67ffffffffffffffff8002604052600060070460605260006007066080526801000000000000000060"
+        "011060a0526001680100000000000000001160c0526801000000000000000060001460e052610100"
+        "6000f3");
+    auto result = check(code);
+    BOOST_REQUIRE(result.output.size() == 0x100u);
+    vector<u256> expected{u256(1) << 64, ~u256(0), (u256(1) << 128) - (u256(1) << 65) + 1, 0, 0,
+        1, 1, 0};
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        BOOST_CHECK(expected[i] == fromBigEndian<u256>(bytesConstRef(&result.output[i * 32], 32)));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(exceptions)
+{
+    // ADD of PUSHADD underflows
+    BOOST_CHECK(check(fromHex("600101")).status == EVMC_STACK_UNDERFLOW);
+    // DUP1 of STACKRUN underflows
+    BOOST_CHECK(check(fromHex("8081")).status == EVMC_STACK_UNDERFLOW);
+    // the offset of PUSHMSTORE is too large
+    BOOST_CHECK(check(fromHex("600167ffffffffffffffff52"), false, 100).status == EVMC_OUT_OF_GAS);
+    // ISZERO of ISZEROJUMPI underflows
+    BOOST_CHECK(check(fromHex("15600457005b")).status == EVMC_STACK_UNDERFLOW);
+    // the destination is not a JUMPDEST, not fused
+    BOOST_CHECK(check(fromHex("6000156005570000")).status == EVMC_BAD_JUMP_DESTINATION);
+    // the PUSH at the end of code is truncated
+    BOOST_CHECK(check(fromHex("600060")).status == EVMC_SUCCESS);
+    // the superinstructions in the user code are invalid
+    BOOST_CHECK(check(fromHex("6001a5")).status == EVMC_UNDEFINED_INSTRUCTION);
+
+    // DUP1 of STACKRUN overflows
+    bytes code;
+    for (size_t i = 0; i < 1024; ++i)
+    {
+        code += fromHex("6001");
+    }
+    code += fromHex("8080");
+    auto withoutSuperinstructions = execute(code, bytes(), 1000000, false);
+    BOOST_CHECK(withoutSuperinstructions.status == EVMC_STACK_OVERFLOW);
+    BOOST_CHECK(execute(code, bytes(), 1000000, true) == withoutSuperinstructions);
+}
+
+BOOST_AUTO_TEST_CASE(contract)
+{
+    /*
+    pragma solidity ^0.4.11;
+    contract C {
+        uint256 a;
+        uint256 b;
+        function C(uint256 _a) {
+            a = _a;
+            b = _a;
+        }
+    }
+    */
+    bytes code = fromHex(
+        string(
+            "60606040523415600b57fe5b6040516020806078833981016040528080519060200190919050505b806000"
+            "81905550806001819055505b505b60338060456000396000f30060606040525bfe00a165627a7a72305820"
+            "4a8d7ec58458a207cc1e6ab502444332fe0648d29f307852289dbc1b87b07d510029") +
+        string("0000000000000000000000000000000000000000000000000000000000000042"));
+    auto result = check(code, true);
+    BOOST_CHECK(result.status == EVMC_SUCCESS);
+    BOOST_CHECK(result.storage.size() == 2u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
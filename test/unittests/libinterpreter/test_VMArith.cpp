@@ -0,0 +1,80 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ *
+ * @brief: unit test for the 64-bit fast paths of VM
+ *
+ * @file test_VMArith.cpp
+ */
+#include <libinterpreter/VMArith.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+#include <limits>
+#include <random>
+
+using namespace dev::eth;
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(VMArithTest, TestOutputHelperFixture)
+
+std::vector<u256> operands()
+{
+    u256 max64 = std::numeric_limits<uint64_t>::max();
+    std::vector<u256> values{0, 1, 2, 3, 0xff, u256(1) << 32, (u256(1) << 63) - 1, u256(1) << 63,
+        max64 - 1, max64, max64 + 1, u256(1) << 128, ~u256(0) - 1, ~u256(0)};
+    std::mt19937_64 random(0);
+    for (size_t i = 0; i < 16; ++i)
+    {
+        values.push_back(random());
+        values.push_back(random() >> 32);
+        values.push_back((u256(random()) << 64) | random());
+    }
+    return values;
+}
+
+BOOST_AUTO_TEST_CASE(fits)
+{
+    BOOST_CHECK(fitsUint64(0));
+    BOOST_CHECK(fitsUint64(std::numeric_limits<uint64_t>::max()));
+    BOOST_CHECK(!fitsUint64(u256(std::numeric_limits<uint64_t>::max()) + 1));
+    BOOST_CHECK(!fitsUint64(~u256(0)));
+    BOOST_CHECK_EQUAL(lowUint64(12345), 12345u);
+    // the limbs are normalized after the operations
+    BOOST_CHECK(fitsUint64((u256(1) << 64) - (u256(1) << 64) + 5));
+}
+
+BOOST_AUTO_TEST_CASE(sameAs256Bit)
+{
+    auto values = operands();
+    for (auto const& a : values)
+    {
+        for (auto const& b : values)
+        {
+            BOOST_CHECK_EQUAL(add256(a, b), a + b);
+            BOOST_CHECK_EQUAL(sub256(a, b), a - b);
+            BOOST_CHECK_EQUAL(mul256(a, b), a * b);
+            BOOST_CHECK_EQUAL(div256(a, b), b ? u256(a / b) : u256(0));
+            BOOST_CHECK_EQUAL(mod256(a, b), b ? u256(a % b) : u256(0));
+            BOOST_CHECK_EQUAL(lt256(a, b), a < b);
+            BOOST_CHECK_EQUAL(eq256(a, b), a == b);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
@@ -187,8 +187,13 @@ BOOST_AUTO_TEST_CASE(testGensisConfig)
     configurationPath = getTestPath().string() + "/fisco-bcos-data/group.10.ini";
     fakeLedger.initIniConfig(configurationPath);
     BOOST_CHECK(fakeLedger.getParam()->mutableTxPoolParam().txPoolLimit == 150000);
+    BOOST_CHECK(fakeLedger.getParam()->mutableTxPoolParam().senderLimit == 1000);
+    auto const& senderWeights = fakeLedger.getParam()->mutableTxPoolParam().senderWeights;
+    BOOST_CHECK(senderWeights.size() == 1);
+    BOOST_CHECK(senderWeights.at(Address("0x3ee7f2c5b5fa8f7cc5fd1a1c1b0fd8a2b4d2a2a1")) == 4);
     BOOST_CHECK(fakeLedger.getParam()->mutableTxParam().enableParallel == false);
     BOOST_CHECK(fakeLedger.getParam()->mutableConsensusParam().maxTTL == 3);
+    BOOST_CHECK(fakeLedger.getParam()->mutableConsensusParam().verifyThreadNum == 4);
     param->mutableStateParam().type = "storage";
     /// modify state to storage(the default option)
     boost::property_tree::ptree pt;
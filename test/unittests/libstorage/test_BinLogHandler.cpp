@@ -20,6 +20,7 @@
  */
 
 #include <libstorage/BinLogHandler.h>
+#include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
 
 using namespace dev;
@@ -29,13 +30,79 @@ namespace test_BinLogHandler
 {
 struct BinLogHandlerFixture
 {
-    BinLogHandlerFixture() : binLogHandler(std::make_shared<BinLogHandler>("./binlog/")) {}
+    BinLogHandlerFixture()
+      : path((boost::filesystem::temp_directory_path() /
+                 boost::filesystem::unique_path("binlog-%%%%-%%%%-%%%%"))
+                 .string()),
+        binLogHandler(std::make_shared<BinLogHandler>(path))
+    {}
 
+    std::string path;
     std::shared_ptr<BinLogHandler> binLogHandler;
 
-    ~BinLogHandlerFixture() {}
+    ~BinLogHandlerFixture()
+    {
+        binLogHandler.reset();
+        boost::filesystem::remove_all(path);
+    }
 };
+std::vector<TableData::Ptr> createBlockData(int64_t num)
+{
+    auto data = std::make_shared<TableData>();
+    data->info = std::make_shared<TableInfo>();
+    data->info->name = "t_test";
+    data->info->key = "key";
+    data->info->fields = std::vector<std::string>{"value"};
+    auto entry = std::make_shared<Entry>();
+    entry->setField("key", "key" + std::to_string(num));
+    entry->setField("value", std::string(100, 'v'));
+    entry->setID(num);
+    data->newEntries->addEntry(entry);
+    return std::vector<TableData::Ptr>{data};
+}
+
 BOOST_FIXTURE_TEST_SUITE(BinLogHandler, BinLogHandlerFixture)
+BOOST_AUTO_TEST_CASE(syncPolicy)
+{
+    for (auto policy : {"none", "block", "group"})
+    {
+        std::string policyPath = path + "/" + policy;
+        {
+            auto handler = std::make_shared<dev::storage::BinLogHandler>(policyPath);
+            handler->setSyncPolicy(binLogSyncPolicyFromString(policy), 10);
+            // every file holds only a few blocks
+            handler->setBinaryLogSize(1024);
+            for (int64_t num = 1; num <= 50; ++num)
+            {
+                BOOST_CHECK(handler->writeBlocktoBinLog(num, createBlockData(num)));
+            }
+            BOOST_CHECK(handler->flush());
+            BOOST_CHECK_EQUAL(handler->getLastBlockNum(), 50);
+            auto blocks = handler->getMissingBlocksFromBinLog(10, 50);
+            BOOST_CHECK_EQUAL(blocks->size(), 40u);
+            BOOST_CHECK_EQUAL((*blocks)[11][0]->newEntries->get(0)->getField("key"), "key11");
+        }
+        size_t files = 0;
+        for (boost::filesystem::directory_iterator it(policyPath), end; it != end; ++it)
+        {  // the preallocated space is released when the file is closed
+            BOOST_CHECK_LE(boost::filesystem::file_size(it->path()), 1024u);
+            ++files;
+        }
+        BOOST_CHECK_GT(files, 1u);
+
+        auto handler = std::make_shared<dev::storage::BinLogHandler>(policyPath);
+        BOOST_CHECK_EQUAL(handler->getLastBlockNum(), 50);
+        auto blocks = handler->getMissingBlocksFromBinLog(0, 50);
+        BOOST_CHECK_EQUAL(blocks->size(), 50u);
+        for (auto const& it : *blocks)
+        {
+            BOOST_CHECK_EQUAL(it.second[0]->newEntries->get(0)->getID(), (uint64_t)it.first);
+        }
+        boost::filesystem::remove_all(policyPath);
+    }
+    BOOST_CHECK_THROW(binLogSyncPolicyFromString("always"), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_CASE(testTableData)
 {
     std::vector<TableData::Ptr> oirDatas;
@@ -25,6 +25,29 @@ using namespace dev::storage;
 
 namespace test_BinaryLogStorage
 {
+class BatchRecordStorage : public MemoryStorage2
+{
+public:
+    std::vector<Entries::Ptr> selectBatch(int64_t num, const TableKeys& keys) override
+    {
+        ++selectBatchCalls;
+        return Storage::selectBatch(num, keys);
+    }
+    void prefetch(int64_t, const TableKeys& keys) override { prefetchedKeys += keys.size(); }
+    bool deferCommit(int64_t) override { return true; }
+    void cancelDefer(int64_t num) override { cancelledNum = num; }
+    size_t commit(int64_t num, const std::vector<TableData::Ptr>& datas) override
+    {
+        commitNum = num;
+        return MemoryStorage2::commit(num, datas);
+    }
+
+    size_t selectBatchCalls = 0;
+    size_t prefetchedKeys = 0;
+    int64_t cancelledNum = -1;
+    int64_t commitNum = -1;
+};
+
 struct StorageFixture
 {
     StorageFixture()
@@ -113,6 +136,60 @@ BOOST_AUTO_TEST_CASE(exception)
         boost::exception);
 }
 
+BOOST_AUTO_TEST_CASE(batchForward)
+{
+    auto backend = std::make_shared<BatchRecordStorage>();
+    binlogStorage->setBackend(backend);
+
+    dev::storage::TableData::Ptr tableData = std::make_shared<dev::storage::TableData>();
+    tableData->info->name = "t_test";
+    tableData->info->key = "Name";
+    tableData->info->fields.push_back("id");
+    tableData->newEntries = getEntries();
+    binlogStorage->commit(1, std::vector<dev::storage::TableData::Ptr>{tableData});
+
+    TableKeys keys;
+    keys.push_back(std::make_pair(tableData->info, std::string("LiSi")));
+    keys.push_back(std::make_pair(tableData->info, std::string("ZhangSan")));
+    auto entriesList = binlogStorage->selectBatch(1, keys);
+    BOOST_CHECK_EQUAL(backend->selectBatchCalls, 1u);
+    BOOST_CHECK_EQUAL(entriesList.size(), 2u);
+    BOOST_CHECK_EQUAL(entriesList[0]->size(), 1u);
+    BOOST_CHECK_EQUAL(entriesList[1]->size(), 0u);
+
+    binlogStorage->prefetch(1, keys);
+    BOOST_CHECK_EQUAL(backend->prefetchedKeys, 2u);
+
+    binlogStorage->setBackend(nullptr);
+    BOOST_CHECK_THROW(binlogStorage->selectBatch(1, keys), boost::exception);
+    binlogStorage->prefetch(1, keys);
+}
+
+BOOST_AUTO_TEST_CASE(cancelDefer)
+{
+    auto backend = std::make_shared<BatchRecordStorage>();
+    binlogStorage->setBackend(backend);
+
+    dev::storage::TableData::Ptr tableData = std::make_shared<dev::storage::TableData>();
+    tableData->info->name = "t_test";
+    tableData->info->key = "Name";
+    tableData->info->fields.push_back("id");
+    tableData->newEntries = getEntries();
+    BOOST_CHECK(binlogStorage->deferCommit(1));
+    binlogStorage->commit(1, std::vector<dev::storage::TableData::Ptr>{tableData});
+    BOOST_CHECK_EQUAL(backend->commitNum, 1);
+
+    // the cancel of another block is forwarded, the deferred block is kept
+    binlogStorage->cancelDefer(2);
+    BOOST_CHECK_EQUAL(backend->cancelledNum, 2);
+    binlogStorage->cancelDefer(1);
+    BOOST_CHECK_EQUAL(backend->cancelledNum, 1);
+
+    // the next commit of the block is not merged with the cancelled part
+    binlogStorage->commit(1, std::vector<dev::storage::TableData::Ptr>{tableData});
+    BOOST_CHECK_EQUAL(backend->commitNum, 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
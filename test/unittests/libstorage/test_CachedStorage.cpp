@@ -31,6 +31,7 @@
 #include <boost/random/uniform_int.hpp>
 #include <boost/test/unit_test.hpp>
 #include <chrono>
+#include <future>
 #include <thread>
 
 using namespace dev;
@@ -294,6 +295,173 @@ BOOST_AUTO_TEST_CASE(select_condition)
     BOOST_CHECK_EQUAL(entries->size(), 1u);
 }
 
+BOOST_AUTO_TEST_CASE(prefetch)
+{
+    int num = 1;
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = "t_test";
+    TableKeys keys{std::make_pair(tableInfo, std::string("LiSi")),
+        std::make_pair(tableInfo, std::string("ZhangSan"))};
+    cachedStorage->prefetch(num, keys);
+
+    // all keys are loaded into the cache, the backend should not be touched again
+    mockStorage->commited = true;
+    auto entries = cachedStorage->select(num, tableInfo, "LiSi", std::make_shared<Condition>());
+    BOOST_CHECK_EQUAL(entries->size(), 1u);
+    entries = cachedStorage->select(num, tableInfo, "ZhangSan", std::make_shared<Condition>());
+    BOOST_CHECK_EQUAL(entries->size(), 0u);
+
+    auto result = cachedStorage->selectBatch(num, keys);
+    BOOST_CHECK_EQUAL(result.size(), 2u);
+    BOOST_CHECK_EQUAL(result[0]->size(), 1u);
+    BOOST_CHECK_EQUAL(result[0]->get(0)->getField("Name"), "LiSi");
+    BOOST_CHECK_EQUAL(result[1]->size(), 0u);
+}
+
+class PrefetchHookMock : public MockStorage
+{
+public:
+    std::vector<Entries::Ptr> selectBatch(int64_t num, const TableKeys& keys) override
+    {
+        if (beforeSelectBatch)
+        {
+            beforeSelectBatch();
+        }
+        return MockStorage::selectBatch(num, keys);
+    }
+
+    std::function<void()> beforeSelectBatch;
+};
+
+BOOST_AUTO_TEST_CASE(prefetchWithoutLock)
+{
+    auto backend = std::make_shared<PrefetchHookMock>();
+    cachedStorage->setBackend(backend);
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = "t_test";
+    TableKeys keys{std::make_pair(tableInfo, std::string("LiSi"))};
+
+    // the backend waits for another thread selecting the prefetched key, which blocks forever if
+    // the cache of the key is still locked
+    bool selected = false;
+    backend->beforeSelectBatch = [&]() {
+        auto result = std::async(std::launch::async, [&]() {
+            return cachedStorage->select(1, tableInfo, "LiSi", std::make_shared<Condition>());
+        });
+        selected = result.wait_for(std::chrono::seconds(10)) == std::future_status::ready;
+        if (selected)
+        {
+            BOOST_CHECK_EQUAL(result.get()->size(), 1u);
+        }
+    };
+    cachedStorage->prefetch(1, keys);
+    BOOST_CHECK(selected);
+
+    // the rows loaded by the select are kept
+    backend->commited = true;
+    auto entries = cachedStorage->select(1, tableInfo, "LiSi", std::make_shared<Condition>());
+    BOOST_CHECK_EQUAL(entries->size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(scan)
+{
+    int num = 1;
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = "t_test";
+    tableInfo->indices.push_back("id");
+    auto range = KeyRange::single("LiSi");
+    auto condition = std::make_shared<Condition>();
+    condition->EQ("id", "1");
+
+    // the key is not cached, the indexed scan goes to the backend without filling the cache
+    auto entries = cachedStorage->scan(num, tableInfo, range, condition);
+    BOOST_CHECK_EQUAL(entries->size(), 1u);
+    entries = cachedStorage->select(num, tableInfo, "LiSi", std::make_shared<Condition>());
+    BOOST_CHECK_EQUAL(entries->size(), 1u);
+
+    // the key is cached, the backend should not be touched again
+    mockStorage->commited = true;
+    entries = cachedStorage->scan(num, tableInfo, range, condition);
+    BOOST_CHECK_EQUAL(entries->size(), 1u);
+    entries = cachedStorage->scan(num, tableInfo, range, std::make_shared<Condition>(), 1);
+    BOOST_CHECK_EQUAL(entries->size(), 1u);
+    condition->EQ("id", "2");
+    entries = cachedStorage->scan(num, tableInfo, range, condition);
+    BOOST_CHECK_EQUAL(entries->size(), 0u);
+
+    // the backend does not support range scan
+    BOOST_CHECK_THROW(cachedStorage->scan(num, tableInfo, KeyRange("A", "Z"), nullptr),
+        StorageException);
+}
+
+BOOST_AUTO_TEST_CASE(shardEvict)
+{
+    cachedStorage = std::make_shared<CachedStorage>();
+    cachedStorage->setShardCount(3);
+    BOOST_CHECK_EQUAL(cachedStorage->shardStatus().size(), 4u);
+    cachedStorage->setMaxCapacity(1024);
+    cachedStorage->setMaxForwardBlock(100);
+
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = "t_test";
+    tableInfo->key = "key";
+    tableInfo->fields.push_back("value");
+    auto data = std::make_shared<TableData>();
+    data->info = tableInfo;
+    for (size_t i = 0; i < 100; ++i)
+    {
+        auto entry = std::make_shared<Entry>();
+        entry->setID(i + 1);
+        entry->setField("key", boost::lexical_cast<std::string>(i));
+        entry->setField("value", std::string(100, '0'));
+        entry->setForce(true);
+        data->newEntries->addEntry(entry);
+    }
+    // no backend, the block is synced once committed
+    cachedStorage->commit(1, std::vector<TableData::Ptr>{data});
+
+    int64_t capacity = 0;
+    for (auto const& status : cachedStorage->shardStatus())
+    {
+        capacity += status.capacity;
+    }
+    BOOST_CHECK_GT(capacity, 1024);
+    auto evicted = [&]() {
+        for (auto const& status : cachedStorage->shardStatus())
+        {
+            if (status.capacity > 1024 / 4)
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    cachedStorage->setClearInterval(1);
+    cachedStorage->startClearThread();
+    // wait until the clear thread evicts enough caches, no matter how slow the thread is scheduled
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!evicted() && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    // join the clear thread, so the status of shards is not changed while checking
+    cachedStorage->stop();
+
+    capacity = 0;
+    size_t size = 0;
+    uint64_t evictTimes = 0;
+    for (auto const& status : cachedStorage->shardStatus())
+    {
+        BOOST_CHECK_LE(status.capacity, 1024 / 4);
+        capacity += status.capacity;
+        size += status.size;
+        evictTimes += status.evictTimes;
+    }
+    BOOST_CHECK_LE(capacity, 1024);
+    BOOST_CHECK_EQUAL(size + evictTimes, 100u);
+}
+
 BOOST_AUTO_TEST_CASE(commit_single_data)
 {
     h256 h;
@@ -886,6 +1054,144 @@ BOOST_AUTO_TEST_CASE(clearCommitCheck)
     cachedStorage->stop();
 }
 
+class DeferCommitMock : public Storage
+{
+public:
+    Entries::Ptr select(int64_t, TableInfo::Ptr, const std::string&, Condition::Ptr) override
+    {
+        return std::make_shared<Entries>();
+    }
+
+    size_t commit(int64_t num, const std::vector<TableData::Ptr>& datas) override
+    {
+        m_num = num;
+        m_datas = datas;
+        return 0;
+    }
+
+    tbb::atomic<int64_t> m_num = 0;
+    std::vector<TableData::Ptr> m_datas;
+};
+
+BOOST_AUTO_TEST_CASE(deferCommit)
+{
+    cachedStorage = std::make_shared<CachedStorage>();
+    // every submitted block is synced before commit returns
+    cachedStorage->setMaxForwardBlock(0);
+    auto backend = std::make_shared<DeferCommitMock>();
+    cachedStorage->setBackend(backend);
+
+    auto newTableData = [](const std::string& name, const std::string& key) {
+        auto tableData = std::make_shared<TableData>();
+        tableData->info->name = name;
+        tableData->info->key = "key";
+        tableData->info->fields.push_back("value");
+        auto entry = std::make_shared<Entry>();
+        entry->setField("key", key);
+        entry->setField("value", "value");
+        entry->setID(1000);
+        entry->setForce(true);
+        tableData->newEntries->addEntry(entry);
+        return tableData;
+    };
+
+    BOOST_TEST(cachedStorage->deferCommit(1));
+    BOOST_TEST(!cachedStorage->deferCommit(1));
+    // the first part is held, it is not submitted to the commit thread
+    cachedStorage->commit(1, std::vector<TableData::Ptr>{newTableData("t_state", "a")});
+    BOOST_TEST(backend->m_num == 0);
+    BOOST_TEST(cachedStorage->syncNum() == 0);
+
+    // the first part is visible before it is persisted
+    auto info = std::make_shared<TableInfo>();
+    info->name = "t_state";
+    info->key = "key";
+    BOOST_TEST(cachedStorage->select(1, info, "a", std::make_shared<Condition>())->size() == 1u);
+
+    cachedStorage->commit(1, std::vector<TableData::Ptr>{newTableData("t_index", "b")});
+    BOOST_TEST(backend->m_num == 1);
+    BOOST_TEST(backend->m_datas.size() == 2u);
+    BOOST_TEST(cachedStorage->syncNum() == 1);
+
+    // the next block is committed as usual
+    cachedStorage->commit(2, std::vector<TableData::Ptr>{newTableData("t_state", "c")});
+    BOOST_TEST(backend->m_num == 2);
+
+    // the first part is submitted alone if the deferred commit is given up
+    BOOST_TEST(cachedStorage->deferCommit(3));
+    cachedStorage->commit(3, std::vector<TableData::Ptr>{newTableData("t_state", "d")});
+    BOOST_TEST(backend->m_num == 2);
+    cachedStorage->cancelDefer(2);
+    BOOST_TEST(backend->m_num == 2);
+    cachedStorage->cancelDefer(3);
+    BOOST_TEST(backend->m_num == 3);
+    BOOST_TEST(backend->m_datas.size() == 1u);
+    BOOST_TEST(cachedStorage->syncNum() == 3);
+
+    // nothing is held if the deferred commit is given up before the first part
+    BOOST_TEST(cachedStorage->deferCommit(4));
+    cachedStorage->cancelDefer(4);
+    BOOST_TEST(cachedStorage->deferCommit(4));
+    cachedStorage->commit(4, std::vector<TableData::Ptr>{newTableData("t_state", "e")});
+    cachedStorage->commit(4, std::vector<TableData::Ptr>{newTableData("t_index", "f")});
+    BOOST_TEST(backend->m_num == 4);
+    BOOST_TEST(backend->m_datas.size() == 2u);
+    cachedStorage->stop();
+}
+
+class RangeScanMock : public DeferCommitMock
+{
+public:
+    size_t commit(int64_t num, const std::vector<TableData::Ptr>& datas) override
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        return DeferCommitMock::commit(num, datas);
+    }
+
+    // the block number committed when the scan comes is returned as the number of rows
+    Entries::Ptr scan(int64_t, TableInfo::Ptr, const KeyRange&, Condition::Ptr, size_t) override
+    {
+        auto entries = std::make_shared<Entries>();
+        for (int64_t i = 0; i < m_num; ++i)
+        {
+            entries->addEntry(std::make_shared<Entry>());
+        }
+        return entries;
+    }
+};
+
+BOOST_AUTO_TEST_CASE(rangeScanWait)
+{
+    cachedStorage = std::make_shared<CachedStorage>();
+    auto backend = std::make_shared<RangeScanMock>();
+    cachedStorage->setBackend(backend);
+
+    auto tableData = std::make_shared<TableData>();
+    tableData->info->name = "t_state";
+    auto entry = std::make_shared<Entry>();
+    entry->setField("key", "a");
+    entry->setID(1000);
+    entry->setForce(true);
+    tableData->newEntries->addEntry(entry);
+
+    auto info = std::make_shared<TableInfo>();
+    info->name = "t_state";
+    // the commit is still in flight, the range scan waits until the backend has the block
+    cachedStorage->commit(1, std::vector<TableData::Ptr>{tableData});
+    BOOST_TEST(cachedStorage->scan(1, info, KeyRange("a", "z"), nullptr)->size() == 1u);
+    BOOST_TEST(cachedStorage->syncNum() == 1);
+
+    // the held part of a deferred commit is never synced, stop wakes up the waiting scan
+    BOOST_TEST(cachedStorage->deferCommit(2));
+    cachedStorage->commit(2, std::vector<TableData::Ptr>{tableData});
+    auto result = std::async(std::launch::async,
+        [&]() { return cachedStorage->scan(2, info, KeyRange("a", "z"), nullptr)->size(); });
+    BOOST_TEST(
+        (result.wait_for(std::chrono::milliseconds(200)) == std::future_status::timeout));
+    cachedStorage->stop();
+    BOOST_TEST(result.get() == 1u);
+}
+
 BOOST_AUTO_TEST_CASE(exception)
 {
 #if 0
@@ -61,6 +61,49 @@ BOOST_AUTO_TEST_CASE(copyFrom)
     BOOST_TEST(entry2->refCount() == 1);
 }
 
+BOOST_AUTO_TEST_CASE(fields)
+{
+    auto entry = std::make_shared<Entry>();
+    entry->setField("value", "1");
+    entry->setField("key", "LiSi");
+    entry->setField("index", "");
+    BOOST_TEST(entry->size() == 3u);
+    BOOST_TEST(entry->capacity() == 18);
+
+    std::vector<std::string> names;
+    for (auto& it : *entry)
+    {
+        names.push_back(it.first);
+    }
+    BOOST_TEST(names == std::vector<std::string>({"index", "key", "value"}));
+
+    entry->setField("value", "100");
+    BOOST_TEST(entry->size() == 3u);
+    BOOST_TEST(entry->capacity() == 20);
+    BOOST_TEST(entry->find("value")->second == "100");
+    BOOST_TEST(entry->getField("index") == "");
+    BOOST_TEST((entry->find("name") == entry->end()));
+    BOOST_TEST(entry->getField("name") == "");
+}
+
+BOOST_AUTO_TEST_CASE(reserveFields)
+{
+    auto entry = std::make_shared<Entry>();
+    entry->setField("key", "LiSi");
+    auto entry2 = std::make_shared<Entry>();
+    entry2->copyFrom(entry);
+
+    // the shared fields are copied before reserving
+    entry2->reserveFields(3);
+    entry2->setField("value", "1");
+    entry2->setField("index", "2");
+    BOOST_TEST(entry->size() == 1u);
+    BOOST_TEST(entry2->size() == 3u);
+    BOOST_TEST(entry2->begin()->first == "index");
+    BOOST_TEST(entry2->getField("key") == "LiSi");
+    BOOST_TEST(entry2->capacity() == 19);
+}
+
 BOOST_AUTO_TEST_CASE(parallel_copyFrom)
 {
 #if 0
@@ -46,6 +46,15 @@ public:
     }
 
     size_t commit(int64_t, const std::vector<TableData::Ptr>&) override { return 0; }
+
+    Entries::Ptr scan(int64_t num, TableInfo::Ptr tableInfo, const KeyRange& range,
+        Condition::Ptr condition, size_t limit) override
+    {
+        lastLimit = limit;
+        return Storage::scan(num, tableInfo, range, condition, limit);
+    }
+
+    size_t lastLimit = 0;
 };
 
 struct MemoryTableFactoryFixture2
@@ -230,6 +239,26 @@ BOOST_AUTO_TEST_CASE(parallel_openTable)
     memoryDBFactory->commitDB(h256(0), 2);
 }
 
+BOOST_AUTO_TEST_CASE(indexedTable)
+{
+    memoryDBFactory->createIndexedTable(
+        "t_index", "key", "value,item", "item,value", true, Address(), false);
+    auto table = memoryDBFactory->openTable("t_index", true, false);
+    BOOST_CHECK(table->tableInfo()->indices == std::vector<std::string>({"item", "value"}));
+    memoryDBFactory->createTable("t_test", "key", "value", true, Address(), false);
+    table = memoryDBFactory->openTable("t_test", true, false);
+    BOOST_CHECK(table->tableInfo()->indices.empty());
+
+    // at most offset + count rows are read from the storage
+    auto storage = std::dynamic_pointer_cast<MockAMOPDB>(memoryDBFactory->stateStorage());
+    auto condition = table->newCondition();
+    condition->limit(2, 3);
+    table->select("name", condition);
+    BOOST_CHECK_EQUAL(storage->lastLimit, 5u);
+    table->select("name", table->newCondition());
+    BOOST_CHECK_EQUAL(storage->lastLimit, 0u);
+}
+
 BOOST_AUTO_TEST_CASE(open_sysTables)
 {
     auto table = memoryDBFactory->openTable(SYS_CURRENT_STATE);
@@ -254,6 +283,72 @@ BOOST_AUTO_TEST_CASE(init)
     BOOST_TEST(memoryDBFactory->ID() == 1);
 }
 
+BOOST_AUTO_TEST_CASE(upsert)
+{
+    memoryDBFactory->createTable("t_test", "key", "value", true, Address(), false);
+    auto table = memoryDBFactory->openTable("t_test", true, false);
+    auto entry = table->newEntry();
+    entry->setField("value", "1");
+    BOOST_TEST(table->upsert("a", entry) == 1);
+    auto savepoint = memoryDBFactory->savepoint();
+    entry = table->newEntry();
+    entry->setField("value", "2");
+    BOOST_TEST(table->upsert("a", entry) == 1);
+    auto entries = table->select("a", table->newCondition());
+    BOOST_TEST(entries->size() == 1u);
+    BOOST_TEST(entries->get(0)->getField("value") == "2");
+    BOOST_TEST(entries->get(0)->getField("key") == "a");
+
+    // the same changes as selecting and inserting or updating
+    auto other = std::make_shared<dev::storage::MemoryTableFactory2>();
+    other->setStateStorage(memoryDBFactory->stateStorage());
+    other->createTable("t_test", "key", "value", true, Address(), false);
+    auto otherTable = other->openTable("t_test", true, false);
+    entry = otherTable->newEntry();
+    entry->setField("value", "1");
+    otherTable->insert("a", entry);
+    entry = otherTable->newEntry();
+    entry->setField("value", "2");
+    otherTable->update("a", entry, otherTable->newCondition());
+    BOOST_TEST(other->hash() == memoryDBFactory->hash());
+
+    memoryDBFactory->rollback(savepoint);
+    entries = table->select("a", table->newCondition());
+    BOOST_TEST(entries->size() == 1u);
+    BOOST_TEST(entries->get(0)->getField("value") == "1");
+}
+
+BOOST_AUTO_TEST_CASE(arena)
+{
+    auto write = [](dev::storage::MemoryTableFactory2::Ptr _factory) {
+        _factory->createTable("t_test", "key", "value", true, Address(), false);
+        auto table = _factory->openTable("t_test", true, false);
+        for (size_t i = 0; i < 10; ++i)
+        {
+            auto entry = table->newEntry();
+            entry->setField("value", std::to_string(i));
+            table->insert(std::to_string(i), entry);
+        }
+        auto entry = table->newEntry();
+        entry->setField("value", "10");
+        table->update("0", entry, table->newCondition());
+        auto entries = table->select("0", table->newCondition());
+        BOOST_TEST(entries->size() == 1u);
+        BOOST_TEST(entries->get(0)->getField("value") == "10");
+        return _factory->hash();
+    };
+    auto arena = std::make_shared<dev::Arena>();
+    memoryDBFactory->setArena(arena);
+    BOOST_TEST(memoryDBFactory->arena() == arena);
+    auto hash = write(memoryDBFactory);
+    BOOST_TEST(arena->allocations() > 22u);
+
+    auto other = std::make_shared<dev::storage::MemoryTableFactory2>();
+    other->setStateStorage(memoryDBFactory->stateStorage());
+    BOOST_TEST(other->hash() != hash);
+    BOOST_TEST(write(other) == hash);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }  // namespace test_MemoryTableFactory2
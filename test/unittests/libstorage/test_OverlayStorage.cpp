@@ -0,0 +1,189 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+/** @file test_OverlayStorage.cpp
+ */
+
+#include "MemoryStorage2.h"
+#include <libstorage/MemoryTableFactory2.h>
+#include <libstorage/OverlayStorage.h>
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <chrono>
+#include <future>
+
+using namespace std;
+using namespace dev;
+using namespace dev::storage;
+
+namespace test_OverlayStorage
+{
+struct OverlayStorageFixture
+{
+    OverlayStorageFixture()
+    {
+        storage = make_shared<MemoryStorage2>();
+        // block 0 creates the table
+        auto tableFactory = newTableFactory(storage, 0);
+        tableFactory->init();
+        auto table = tableFactory->createTable(tableName, "name", "value", false);
+        insert(table, "alice", "1");
+        insert(table, "bob", "2");
+        commit(tableFactory, 0);
+
+        // block 1 is executed and not committed
+        parent = newTableFactory(storage, 0);
+        parent->init();
+        table = parent->openTable(tableName, false);
+        auto entry = table->newEntry();
+        entry->setField("value", "10");
+        table->update("alice", entry, table->newCondition());
+        insert(table, "carol", "3");
+        parent->hash();
+        overlay = make_shared<OverlayStorage>(
+            storage, 1, parent->exportData(), [this]() { return committed.load(); });
+        // block 2 is executed on the overlay
+        child = newTableFactory(overlay, 1);
+    }
+
+    MemoryTableFactory2::Ptr newTableFactory(Storage::Ptr _storage, int64_t _number)
+    {
+        auto tableFactory = make_shared<MemoryTableFactory2>();
+        tableFactory->setStateStorage(_storage);
+        tableFactory->setBlockHash(h256(_number));
+        tableFactory->setBlockNum(_number);
+        return tableFactory;
+    }
+
+    void insert(Table::Ptr _table, string const& _name, string const& _value)
+    {
+        auto entry = _table->newEntry();
+        entry->setField("name", _name);
+        entry->setField("value", _value);
+        _table->insert(_name, entry);
+    }
+
+    // the current number is written after the execution, as BlockChainImp::commitBlock does
+    void commit(MemoryTableFactory2::Ptr _tableFactory, int64_t _number)
+    {
+        auto table = _tableFactory->openTable(SYS_CURRENT_STATE, false);
+        auto entry = table->newEntry();
+        entry->setField(SYS_KEY, SYS_KEY_CURRENT_NUMBER);
+        entry->setField(SYS_VALUE, to_string(_number));
+        if (_number == 0)
+        {
+            table->insert(SYS_KEY_CURRENT_NUMBER, entry);
+        }
+        else
+        {
+            table->update(SYS_KEY_CURRENT_NUMBER, entry, table->newCondition());
+        }
+        _tableFactory->commitDB(h256(_number), _number);
+    }
+
+    void commitParent()
+    {
+        commit(parent, 1);
+        committed = true;
+    }
+
+    Entries::ConstPtr select(string const& _key)
+    {
+        auto table = child->openTable(tableName, false);
+        return table->select(_key, table->newCondition());
+    }
+
+    const string tableName = "t_overlay";
+    MemoryStorage2::Ptr storage;
+    MemoryTableFactory2::Ptr parent;
+    OverlayStorage::Ptr overlay;
+    MemoryTableFactory2::Ptr child;
+    atomic_bool committed = {false};
+};
+
+BOOST_FIXTURE_TEST_SUITE(OverlayStorage, OverlayStorageFixture)
+
+BOOST_AUTO_TEST_CASE(selectDirty)
+{
+    auto entries = select("alice");
+    BOOST_TEST(entries->size() == 1u);
+    BOOST_TEST(entries->get(0)->getField("value") == "10");
+    BOOST_TEST(entries->get(0)->num() == 1);
+
+    auto condition = make_shared<Condition>();
+    condition->EQ("value", "1");
+    auto rows = overlay->select(1, parent->openTable(tableName, false)->tableInfo(), "alice",
+        condition);
+    BOOST_TEST(rows->size() == 0u);
+    condition = make_shared<Condition>();
+    condition->EQ("value", "10");
+    rows = overlay->select(1, parent->openTable(tableName, false)->tableInfo(), "alice",
+        condition);
+    BOOST_TEST(rows->size() == 1u);
+
+    entries = select("bob");
+    BOOST_TEST(entries->size() == 1u);
+    BOOST_TEST(entries->get(0)->getField("value") == "2");
+    BOOST_TEST(overlay->parentCommitted() == false);
+}
+
+BOOST_AUTO_TEST_CASE(selectInserted)
+{
+    auto result = std::async(std::launch::async, [this]() { return select("carol"); });
+    BOOST_TEST((result.wait_for(std::chrono::milliseconds(50)) == std::future_status::timeout));
+    commitParent();
+    auto entries = result.get();
+    BOOST_TEST(entries->size() == 1u);
+    BOOST_TEST(entries->get(0)->getField("value") == "3");
+    BOOST_TEST(overlay->parentCommitted() == true);
+
+    entries = select("alice");
+    BOOST_TEST(entries->size() == 1u);
+    BOOST_TEST(entries->get(0)->getField("value") == "10");
+}
+
+BOOST_AUTO_TEST_CASE(cancel)
+{
+    auto result = std::async(std::launch::async, [this]() { return select("carol"); });
+    BOOST_TEST((result.wait_for(std::chrono::milliseconds(50)) == std::future_status::timeout));
+    overlay->cancel();
+    BOOST_TEST(overlay->cancelled() == true);
+    BOOST_TEST(result.get()->size() == 0u);
+    BOOST_TEST(overlay->parentCommitted() == false);
+}
+
+BOOST_AUTO_TEST_CASE(sameHash)
+{
+    // the block executed on the overlay has the same hash as the one executed after the commit
+    auto execute = [this](Storage::Ptr _storage) {
+        auto tableFactory = newTableFactory(_storage, 1);
+        auto table = tableFactory->openTable(tableName, false);
+        auto entry = table->newEntry();
+        entry->setField("value", "11");
+        table->update("alice", entry, table->newCondition());
+        entry = table->newEntry();
+        entry->setField("value", "21");
+        table->update("bob", entry, table->newCondition());
+        return tableFactory->hash();
+    };
+    auto aheadHash = execute(overlay);
+    commitParent();
+    BOOST_TEST(aheadHash == execute(storage));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test_OverlayStorage
@@ -169,6 +169,53 @@ BOOST_AUTO_TEST_CASE(registerParallelFunction)
     BOOST_CHECK(hasRegistered(contractAddr, TRANSFER_FUNC) == false);
 }
 
+BOOST_AUTO_TEST_CASE(getCriticalConfig)
+{
+    Address contractAddr = Address(0x23333333);
+    const string TRANSFER_FUNC = "transfer(string,string,uint256)";
+    const string SET_FUNC = "set(string,uint256)";
+    uint32_t selector = getFuncSelector(TRANSFER_FUNC);
+    Address origin(0x12345);
+    BOOST_CHECK(!parallelConfigPrecompiled->getCriticalConfig(
+        context, contractAddr, selector, origin));
+
+    // the negative result is dropped when the function is registered
+    ContractABI abi;
+    bytes param =
+        abi.abiIn(PARA_CONFIG_REGISTER_METHOD_ADDR_STR_UINT, contractAddr, TRANSFER_FUNC, 2);
+    callPrecompiled(ref(param));
+    auto config =
+        parallelConfigPrecompiled->getCriticalConfig(context, contractAddr, selector, origin);
+    BOOST_REQUIRE(config);
+    BOOST_CHECK(config->criticalTypes == vector<string>({"string", "string"}));
+    auto cachedConfig =
+        parallelConfigPrecompiled->getCriticalConfig(context, contractAddr, selector, origin);
+    BOOST_CHECK(cachedConfig == config);
+
+    // registering another function of the contract drops the cached configs of the contract
+    param = abi.abiIn(PARA_CONFIG_REGISTER_METHOD_ADDR_STR_UINT, contractAddr, SET_FUNC, 1);
+    callPrecompiled(ref(param));
+    auto setConfig = parallelConfigPrecompiled->getCriticalConfig(
+        context, contractAddr, getFuncSelector(SET_FUNC), origin);
+    BOOST_REQUIRE(setConfig);
+    BOOST_CHECK(setConfig->criticalTypes == vector<string>({"string"}));
+    auto newConfig =
+        parallelConfigPrecompiled->getCriticalConfig(context, contractAddr, selector, origin);
+    BOOST_REQUIRE(newConfig);
+    BOOST_CHECK(newConfig != config);
+
+    // the critical size is larger than the params
+    param = abi.abiIn(PARA_CONFIG_REGISTER_METHOD_ADDR_STR_UINT, contractAddr, TRANSFER_FUNC, 4);
+    callPrecompiled(ref(param));
+    BOOST_CHECK(!parallelConfigPrecompiled->getCriticalConfig(
+        context, contractAddr, selector, origin));
+
+    param = abi.abiIn(PARA_CONFIG_UNREGISTER_METHOD_ADDR_STR, contractAddr, SET_FUNC);
+    callPrecompiled(ref(param));
+    BOOST_CHECK(!parallelConfigPrecompiled->getCriticalConfig(
+        context, contractAddr, getFuncSelector(SET_FUNC), origin));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }  // namespace test
@@ -74,8 +74,13 @@ public:
             }
             if (key == "e_Exception")
                 return Status::InvalidArgument(Slice("InvalidArgument"));
+            if (tag == 0x0)
+            {  // kTypeDeletion
+                db.erase(key.ToString());
+                continue;
+            }
             LOG(INFO) << "write key=" << key.ToString();
-            db.insert(std::make_pair(key.ToString(), value.ToString()));
+            db[key.ToString()] = value.ToString();
         }
         return Status::OK();
     }
@@ -90,6 +95,20 @@ public:
         value = it->second;
         return Status::OK();
     }
+
+    void Scan(ReadOptions const&, std::string const& begin, std::string const& end,
+        std::function<bool(std::string const&, std::string&)> const& onValue) override
+    {
+        for (auto it = db.lower_bound(begin); it != db.end() && (end.empty() || it->first < end);
+             ++it)
+        {
+            auto value = it->second;
+            if (!onValue(it->first, value))
+            {
+                break;
+            }
+        }
+    }
 #if 0
     virtual Status Delete(const WriteOptions&, ColumnFamilyHandle*, const Slice& key)
     {
@@ -297,6 +316,113 @@ BOOST_AUTO_TEST_CASE(commitDirty)
     BOOST_CHECK_EQUAL(entries->size(), 1u);
 }
 
+BOOST_AUTO_TEST_CASE(commitLegacyFormat)
+{
+    int num = 1;
+    std::vector<dev::storage::TableData::Ptr> datas;
+    dev::storage::TableData::Ptr tableData = std::make_shared<dev::storage::TableData>();
+    tableData->info->name = "t_test";
+    tableData->info->key = "Name";
+    tableData->info->fields.push_back("id");
+    tableData->newEntries = getEntries();
+    datas.push_back(tableData);
+    rocksDB->setRowFormat(RowFormat::Legacy);
+    BOOST_CHECK_EQUAL(rocksDB->commit(num, datas), 1u);
+
+    // rows of the legacy format are readable and rewritten with the v1 format
+    rocksDB->setRowFormat(RowFormat::V1);
+    tableData->newEntries = getEntries();
+    tableData->newEntries->get(0)->setField("id", "2");
+    BOOST_CHECK_EQUAL(rocksDB->commit(num + 1, datas), 1u);
+
+    auto tableInfo = std::make_shared<TableInfo>();
+    tableInfo->name = "t_test";
+    auto entries = rocksDB->select(num, tableInfo, "LiSi", std::make_shared<Condition>());
+    BOOST_CHECK_EQUAL(entries->size(), 2u);
+    BOOST_CHECK_EQUAL(entries->get(0)->getField("id"), "1");
+    BOOST_CHECK_EQUAL(entries->get(1)->getField("id"), "2");
+}
+
+BOOST_AUTO_TEST_CASE(indexScan)
+{
+    auto tableData = std::make_shared<dev::storage::TableData>();
+    tableData->info->name = "t_test";
+    tableData->info->key = "Name";
+    tableData->info->indices.push_back("item");
+    auto newEntry = [](uint64_t id, const string& item) {
+        auto entry = std::make_shared<Entry>();
+        entry->setID(id);
+        entry->setField("Name", "LiSi");
+        if (!item.empty())
+        {
+            entry->setField("item", item);
+        }
+        return entry;
+    };
+    tableData->newEntries->addEntry(newEntry(1, "apple"));
+    tableData->newEntries->addEntry(newEntry(2, "pear"));
+    tableData->newEntries->addEntry(newEntry(3, ""));
+    tableData->newEntries->addEntry(newEntry(4, "apple"));
+    rocksDB->commit(1, std::vector<TableData::Ptr>{tableData});
+
+    auto condition = std::make_shared<Condition>();
+    condition->EQ("Name", "LiSi");
+    condition->EQ("item", "apple");
+    auto range = KeyRange::single("LiSi");
+    auto entries = rocksDB->scan(1, tableData->info, range, condition);
+    BOOST_CHECK_EQUAL(entries->size(), 2u);
+    BOOST_CHECK_EQUAL(entries->get(0)->getID(), 1u);
+    BOOST_CHECK_EQUAL(entries->get(1)->getID(), 4u);
+    entries = rocksDB->scan(1, tableData->info, range, condition, 1);
+    BOOST_CHECK_EQUAL(entries->size(), 1u);
+    BOOST_CHECK_EQUAL(entries->get(0)->getID(), 1u);
+
+    // the index of an updated row is moved and the index of a removed row is deleted
+    tableData->newEntries = std::make_shared<Entries>();
+    tableData->dirtyEntries = std::make_shared<Entries>();
+    tableData->dirtyEntries->addEntry(newEntry(1, "pear"));
+    tableData->dirtyEntries->addEntry(newEntry(3, "pear"));
+    tableData->dirtyEntries->addEntry(newEntry(4, "apple"));
+    tableData->dirtyEntries->get(2)->setStatus(Entry::Status::DELETED);
+    rocksDB->commit(2, std::vector<TableData::Ptr>{tableData});
+    entries = rocksDB->scan(2, tableData->info, range, condition);
+    BOOST_CHECK_EQUAL(entries->size(), 0u);
+    condition->EQ("item", "pear");
+    entries = rocksDB->scan(2, tableData->info, range, condition);
+    BOOST_CHECK_EQUAL(entries->size(), 2u);
+    BOOST_CHECK_EQUAL(entries->get(0)->getID(), 1u);
+    BOOST_CHECK_EQUAL(entries->get(1)->getID(), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(rangeScan)
+{
+    auto newData = [](const string& table, const vector<string>& keys) {
+        auto tableData = std::make_shared<dev::storage::TableData>();
+        tableData->info->name = table;
+        tableData->info->key = "Name";
+        for (auto const& key : keys)
+        {
+            auto entry = std::make_shared<Entry>();
+            entry->setField("Name", key);
+            tableData->newEntries->addEntry(entry);
+        }
+        return tableData;
+    };
+    // rows of t_test_a share the key space of t_test and must be skipped
+    auto tableData = newData("t_test", {"a", "b", "c", "d"});
+    rocksDB->commit(1, std::vector<TableData::Ptr>{tableData, newData("t_test_a", {"x"})});
+
+    auto entries = rocksDB->scan(1, tableData->info, KeyRange("b", "d"), nullptr);
+    BOOST_CHECK_EQUAL(entries->size(), 2u);
+    BOOST_CHECK_EQUAL(entries->get(0)->getField("Name"), "b");
+    BOOST_CHECK_EQUAL(entries->get(1)->getField("Name"), "c");
+    entries = rocksDB->scan(1, tableData->info, KeyRange(), nullptr);
+    BOOST_CHECK_EQUAL(entries->size(), 4u);
+    entries = rocksDB->scan(1, tableData->info, KeyRange("b", ""), nullptr, 2);
+    BOOST_CHECK_EQUAL(entries->size(), 2u);
+    BOOST_CHECK_EQUAL(entries->get(1)->getField("Name"), "c");
+}
+
 BOOST_AUTO_TEST_CASE(exception)
 {
     h256 h(0x01);
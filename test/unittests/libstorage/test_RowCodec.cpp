@@ -0,0 +1,133 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+/** @file test_RowCodec.cpp
+ */
+
+#include <libstorage/RowCodec.h>
+#include <libstorage/StorageException.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace std;
+using namespace dev::storage;
+
+namespace test_RowCodec
+{
+struct RowCodecFixture
+{
+    RowCodecFixture()
+    {
+        Row row;
+        row[ID_FIELD] = "1";
+        row[NUM_FIELD] = "10";
+        row[STATUS] = "0";
+        row["name"] = "LiSi";
+        row["value"] = string("\0\x01\xfb", 3);
+        rows.push_back(row);
+        row[ID_FIELD] = "2";
+        row[STATUS] = "1";
+        row.erase("value");
+        row["extra"] = "";
+        rows.push_back(row);
+    }
+    Rows rows;
+};
+
+BOOST_FIXTURE_TEST_SUITE(RowCodec, RowCodecFixture)
+
+BOOST_AUTO_TEST_CASE(encodeDecode)
+{
+    for (auto format : {RowFormat::Legacy, RowFormat::V1})
+    {
+        string value;
+        encodeRows(rows, value, format);
+        BOOST_CHECK(rowFormat(value) == format);
+        Rows decoded;
+        decodeRows(value, decoded);
+        BOOST_CHECK(decoded == rows);
+    }
+    string value;
+    encodeRows(Rows(), value);
+    Rows decoded;
+    decodeRows(value, decoded);
+    BOOST_CHECK_EQUAL(decoded.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(decodeToEntries)
+{
+    for (auto format : {RowFormat::Legacy, RowFormat::V1})
+    {
+        string value;
+        encodeRows(rows, value, format);
+        vector<Entry::Ptr> entries;
+        decodeEntries(value, [&](Entry::Ptr entry) { entries.push_back(entry); });
+        BOOST_CHECK_EQUAL(entries.size(), 2u);
+        BOOST_CHECK_EQUAL(entries[0]->getID(), 1u);
+        BOOST_CHECK_EQUAL(entries[0]->num(), 10u);
+        BOOST_CHECK_EQUAL(entries[0]->getStatus(), Entry::Status::NORMAL);
+        BOOST_CHECK_EQUAL(entries[0]->getField("name"), "LiSi");
+        BOOST_CHECK_EQUAL(entries[0]->getField("value"), string("\0\x01\xfb", 3));
+        BOOST_CHECK_EQUAL(entries[0]->size(), 2u);
+        BOOST_CHECK_EQUAL(entries[1]->getID(), 2u);
+        BOOST_CHECK_EQUAL(entries[1]->getStatus(), Entry::Status::DELETED);
+        BOOST_CHECK(entries[1]->find("extra") != entries[1]->end());
+        BOOST_CHECK(entries[1]->find("value") == entries[1]->end());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(malformed)
+{
+    string value;
+    encodeRows(rows, value);
+    Rows decoded;
+    BOOST_CHECK_THROW(decodeRows(value.substr(0, value.size() - 1), decoded), StorageException);
+    BOOST_CHECK_THROW(decodeRows(value + "x", decoded), StorageException);
+    value[1] = 0x7f;
+    BOOST_CHECK_THROW(
+        decodeEntries(value, [](Entry::Ptr) {}), StorageException);
+}
+
+BOOST_AUTO_TEST_CASE(orderedKey)
+{
+    vector<string> parts{"", string("\0", 1), string("\0\x01", 2), "a", string("a\0", 2), "ab",
+        "b", "\xff"};
+    vector<string> keys;
+    for (auto const& part : parts)
+    {
+        string key;
+        appendOrderedKey(key, part);
+        appendOrderedKey(key, "z");
+        keys.push_back(key);
+    }
+    for (size_t i = 1; i < keys.size(); ++i)
+    {
+        BOOST_CHECK(keys[i - 1] < keys[i]);
+    }
+
+    auto prefix = indexKeyPrefix("t_test", "key", "field", "v");
+    auto key = indexKey("t_test", "key", "field", "v", 0x0102);
+    BOOST_CHECK_EQUAL(key.compare(0, prefix.size(), prefix), 0);
+    BOOST_CHECK(indexKey("t_test", "key", "field", "v", 0xff) < key);
+    // the value "v" is not a prefix of the value "vw" in the index
+    auto otherKey = indexKey("t_test", "key", "field", "vw", 1);
+    BOOST_CHECK_NE(otherKey.compare(0, prefix.size(), prefix), 0);
+    BOOST_CHECK(key[0] == '\0');
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test_RowCodec
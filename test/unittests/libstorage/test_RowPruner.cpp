@@ -0,0 +1,135 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+/** @file test_RowPruner.cpp
+ */
+
+#include <libstorage/Common.h>
+#include <libstorage/RowCodec.h>
+#include <libstorage/RowPruner.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace std;
+using namespace dev::storage;
+
+namespace test_RowPruner
+{
+Row newRow(uint64_t _id, int64_t _num, int _status)
+{
+    Row row;
+    row["name"] = "n" + to_string(_id);
+    row[ID_FIELD] = to_string(_id);
+    row[NUM_FIELD] = to_string(_num);
+    row[STATUS] = to_string(_status);
+    return row;
+}
+
+BOOST_AUTO_TEST_SUITE(RowPruner)
+
+BOOST_AUTO_TEST_CASE(prune)
+{
+    Rows rows{newRow(1, 5, 1), newRow(2, 5, 0), newRow(3, 20, 1)};
+    string value;
+    encodeRows(rows, value);
+    string pruned;
+    // nothing can be pruned
+    BOOST_CHECK(!dev::storage::RowPruner::prune("t_test_k", value, -1, pruned));
+    BOOST_CHECK(!dev::storage::RowPruner::prune("t_test_k", value, 4, pruned));
+
+    BOOST_CHECK(dev::storage::RowPruner::prune("t_test_k", value, 10, pruned));
+    Rows prunedRows;
+    decodeRows(pruned, prunedRows);
+    BOOST_CHECK(prunedRows == (Rows{rows[1], rows[2]}));
+
+    BOOST_CHECK(dev::storage::RowPruner::prune("t_test_k", value, 20, pruned));
+    decodeRows(pruned, prunedRows);
+    BOOST_CHECK(prunedRows == Rows{rows[1]});
+
+    // the legacy format is kept
+    encodeRows(rows, value, RowFormat::Legacy);
+    BOOST_CHECK(dev::storage::RowPruner::prune("t_test_k", value, 20, pruned));
+    BOOST_CHECK(rowFormat(pruned) == RowFormat::Legacy);
+
+    // a key of tombstones only is removed
+    encodeRows(Rows{rows[0], rows[2]}, value);
+    BOOST_CHECK(dev::storage::RowPruner::prune("t_test_k", value, 20, pruned));
+    BOOST_CHECK(pruned.empty());
+
+    // index keys, marker keys and values which are not rows are kept
+    BOOST_CHECK(!dev::storage::RowPruner::prune(string("\0t", 2), value, 20, pruned));
+    BOOST_CHECK(!dev::storage::RowPruner::prune("\x01marker", value, 20, pruned));
+    BOOST_CHECK(!dev::storage::RowPruner::prune("t_test_k", "not rows", 20, pruned));
+}
+
+BOOST_AUTO_TEST_CASE(pin)
+{
+    dev::storage::RowPruner pruner(10);
+    BOOST_CHECK_EQUAL(pruner.pruneNumber(), -1);
+    pruner.setCurrentNumber(5);
+    BOOST_CHECK_EQUAL(pruner.pruneNumber(), -1);
+    pruner.setCurrentNumber(30);
+    BOOST_CHECK_EQUAL(pruner.pruneNumber(), 20);
+
+    BOOST_CHECK_EQUAL(pruner.pin(), 20);
+    pruner.setCurrentNumber(40);
+    BOOST_CHECK_EQUAL(pruner.pin(), 20);
+    pruner.unpin();
+    BOOST_CHECK_EQUAL(pruner.pruneNumber(), 20);
+    pruner.unpin();
+    BOOST_CHECK_EQUAL(pruner.pruneNumber(), 30);
+    // unbalanced unpin is ignored
+    pruner.unpin();
+    pruner.setCurrentNumber(41);
+    BOOST_CHECK_EQUAL(pruner.pruneNumber(), 31);
+}
+
+BOOST_AUTO_TEST_CASE(compactionFilter)
+{
+    auto pruner = make_shared<dev::storage::RowPruner>(0);
+    auto encrypt = [](string const& _data, string& _out) { _out = "enc" + _data; };
+    auto decrypt = [](string& _data) { _data = _data.substr(3); };
+    RowCompactionFilter filter(pruner, decrypt, encrypt);
+    BOOST_CHECK(filter.IgnoreSnapshots());
+
+    Rows rows{newRow(1, 5, 1), newRow(2, 5, 0)};
+    string value;
+    encodeRows(rows, value);
+    string encrypted;
+    encrypt(value, encrypted);
+    string newValue;
+    bool changed = false;
+    BOOST_CHECK(!filter.Filter(0, "t_test_k", encrypted, &newValue, &changed));
+    BOOST_CHECK(!changed);
+
+    pruner->setCurrentNumber(5);
+    BOOST_CHECK(!filter.Filter(0, "t_test_k", encrypted, &newValue, &changed));
+    BOOST_CHECK(changed);
+    decrypt(newValue);
+    Rows prunedRows;
+    decodeRows(newValue, prunedRows);
+    BOOST_CHECK(prunedRows == Rows{rows[1]});
+
+    encodeRows(Rows{rows[0]}, value);
+    encrypt(value, encrypted);
+    changed = false;
+    BOOST_CHECK(filter.Filter(0, "t_test_k", encrypted, &newValue, &changed));
+    BOOST_CHECK(!changed);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test_RowPruner
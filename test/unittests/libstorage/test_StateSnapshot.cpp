@@ -0,0 +1,295 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+/** @file test_StateSnapshot.cpp
+ */
+
+#include <libstorage/Common.h>
+#include <libstorage/RowCodec.h>
+#include <libstorage/StateSnapshot.h>
+#include <libstorage/StorageException.h>
+#include <boost/test/unit_test.hpp>
+#include <map>
+
+using namespace dev;
+using namespace std;
+using namespace dev::storage;
+
+namespace test_StateSnapshot
+{
+class MockRocksDB : public BasicRocksDB
+{
+public:
+    rocksdb::Status Get(
+        rocksdb::ReadOptions const&, std::string const& key, std::string& value) override
+    {
+        lock_guard<mutex> lock(m_mutex);
+        auto it = data.find(key);
+        if (it == data.end())
+        {
+            value.clear();
+            return rocksdb::Status::NotFound();
+        }
+        value = it->second;
+        return rocksdb::Status::OK();
+    }
+    rocksdb::Status Put(
+        rocksdb::WriteBatch& batch, std::string const& key, std::string& value) override
+    {
+        return batch.Put(key, value);
+    }
+    rocksdb::Status Write(rocksdb::WriteOptions const&, rocksdb::WriteBatch& batch) override
+    {
+        lock_guard<mutex> lock(m_mutex);
+        MockBatchHandler handler(data);
+        batch.Iterate(&handler);
+        return rocksdb::Status::OK();
+    }
+    void Scan(rocksdb::ReadOptions const&, std::string const& begin, std::string const& end,
+        std::function<bool(std::string const&, std::string&)> const& onValue) override
+    {
+        map<string, string> copy;
+        {
+            lock_guard<mutex> lock(m_mutex);
+            copy = data;
+        }
+        for (auto it = copy.lower_bound(begin); it != copy.end(); ++it)
+        {
+            if (!end.empty() && it->first >= end)
+            {
+                break;
+            }
+            if (!onValue(it->first, it->second))
+            {
+                break;
+            }
+        }
+    }
+    std::shared_ptr<const rocksdb::Snapshot> GetSnapshot() override { return nullptr; }
+
+    map<string, string> data;
+
+private:
+    class MockBatchHandler : public rocksdb::WriteBatch::Handler
+    {
+    public:
+        MockBatchHandler(map<string, string>& _data) : m_data(_data) {}
+        void Put(rocksdb::Slice const& key, rocksdb::Slice const& value) override
+        {
+            m_data[key.ToString()] = value.ToString();
+        }
+        void Delete(rocksdb::Slice const& key) override { m_data.erase(key.ToString()); }
+
+    private:
+        map<string, string>& m_data;
+    };
+    mutex m_mutex;
+};
+
+struct StateSnapshotFixture
+{
+    StateSnapshotFixture()
+    {
+        source = make_shared<MockRocksDB>();
+        putSystemValue(SYS_CURRENT_STATE + "_" + SYS_KEY_CURRENT_NUMBER, "10");
+        putSystemValue(SYS_NUMBER_2_HASH + "_10", blockHash.hex());
+        Row table;
+        table["table_name"] = "t_test";
+        table["key_field"] = "key";
+        table["value_field"] = "value";
+        table["index_field"] = "value";
+        Rows tables{table};
+        encodeRows(tables, source->data[SYS_TABLES + "_t_test"]);
+        auto tableInfo = make_shared<TableInfo>();
+        tableInfo->name = "t_test";
+        tableInfo->key = "key";
+        tableInfo->indices.push_back("value");
+        for (int i = 0; i < 200; ++i)
+        {
+            Row row;
+            row["key"] = "k" + to_string(i);
+            row["value"] = string(100, 'a' + i % 26);
+            row[ID_FIELD] = to_string(i + 1);
+            Rows rows{row};
+            encodeRows(rows, source->data["t_test_k" + to_string(i)]);
+            for (auto const& key : rowIndexKeys(tableInfo, "k" + to_string(i), row))
+            {
+                encodeRows(rows, source->data[key]);
+                ++indexKeys;
+            }
+        }
+    }
+
+    void putSystemValue(string const& _key, string const& _value)
+    {
+        Row row;
+        row[SYS_VALUE] = _value;
+        row[NUM_FIELD] = "10";
+        Rows rows{row};
+        encodeRows(rows, source->data[_key]);
+    }
+
+    h256 blockHash = h256(0x1234);
+    shared_ptr<MockRocksDB> source;
+    size_t indexKeys = 0;
+};
+
+BOOST_FIXTURE_TEST_SUITE(StateSnapshot, StateSnapshotFixture)
+
+BOOST_AUTO_TEST_CASE(manifest)
+{
+    StateSnapshotExporter exporter(source, 4096);
+    auto manifest = exporter.prepare();
+    BOOST_CHECK_EQUAL(manifest->number, 10);
+    BOOST_CHECK(manifest->blockHash == blockHash);
+    BOOST_CHECK_GT(manifest->chunks.size(), 1u);
+    // the index keys are not exported
+    BOOST_CHECK_EQUAL(indexKeys, 200u);
+    BOOST_CHECK(isIndexKey(source->data.begin()->first));
+    auto firstRow = source->data.upper_bound(string(1, MARKER_KEY_PREFIX));
+    BOOST_CHECK(manifest->chunks.front().begin == firstRow->first);
+
+    uint64_t keys = 0;
+    for (auto const& chunk : manifest->chunks)
+    {
+        keys += chunk.keys;
+    }
+    BOOST_CHECK_EQUAL(keys, source->data.size() - indexKeys);
+
+    auto encoded = manifest->encode();
+    auto decoded = SnapshotManifest::decode(&encoded);
+    BOOST_CHECK(decoded->hash() == manifest->hash());
+    BOOST_CHECK_EQUAL(decoded->size(), manifest->size());
+
+    // chunks must cover the key space without gaps
+    auto broken = *manifest;
+    broken.chunks[1].begin = broken.chunks[0].begin;
+    encoded = broken.encode();
+    BOOST_CHECK_THROW(SnapshotManifest::decode(&encoded), StorageException);
+    broken = *manifest;
+    broken.chunks.pop_back();
+    encoded = broken.encode();
+    BOOST_CHECK_THROW(SnapshotManifest::decode(&encoded), StorageException);
+    encoded = bytes{0x01, 0x02};
+    BOOST_CHECK_THROW(SnapshotManifest::decode(&encoded), StorageException);
+
+    BOOST_CHECK(!exporter.chunk(h256(1), 0));
+    BOOST_CHECK(!exporter.chunk(manifest->hash(), manifest->chunks.size()));
+    exporter.release();
+    BOOST_CHECK(!exporter.manifest());
+    BOOST_CHECK(!exporter.chunk(manifest->hash(), 0));
+}
+
+BOOST_AUTO_TEST_CASE(exportImport)
+{
+    StateSnapshotExporter exporter(source, 4096);
+    auto manifest = exporter.prepare();
+    auto hash = manifest->hash();
+
+    auto target = make_shared<MockRocksDB>();
+    // stale keys of the local db before, inside and after the ranges of the chunks
+    target->data[string("\0\0", 2)] = "stale";
+    target->data["t_test_k1000"] = "stale";
+    target->data["t_test_k1"] = "stale";
+    target->data["zz"] = "stale";
+    StateSnapshotImporter importer(target);
+    importer.begin(*manifest);
+    BOOST_CHECK(StateSnapshotImporter::unfinished(target));
+
+    // import in reverse order, the current number is held back until finish
+    for (size_t i = manifest->chunks.size(); i > 0; --i)
+    {
+        auto data = exporter.chunk(hash, i - 1);
+        BOOST_REQUIRE(data);
+        BOOST_CHECK(importer.importChunk(manifest->chunks[i - 1], bytesConstRef(data.get())));
+        BOOST_CHECK_EQUAL(StateSnapshotExporter::currentNumber(target, rocksdb::ReadOptions()), -1);
+    }
+    importer.finish();
+    BOOST_CHECK(!StateSnapshotImporter::unfinished(target));
+    BOOST_CHECK_EQUAL(StateSnapshotExporter::currentNumber(target, rocksdb::ReadOptions()), 10);
+    // the index keys are rebuilt from the rows
+    BOOST_CHECK(target->data == source->data);
+}
+
+BOOST_AUTO_TEST_CASE(prunedExport)
+{
+    Row tombstone;
+    tombstone["key"] = "removed";
+    tombstone[NUM_FIELD] = "5";
+    tombstone[STATUS] = "1";
+    Rows rows{tombstone};
+    encodeRows(rows, source->data["t_test_removed"]);
+    auto pruner = make_shared<RowPruner>(2);
+    pruner->setCurrentNumber(10);
+
+    StateSnapshotExporter exporter(source, 4096);
+    exporter.setRowPruner(pruner);
+    auto manifest = exporter.prepare();
+    uint64_t keys = 0;
+    for (auto const& chunk : manifest->chunks)
+    {
+        keys += chunk.keys;
+    }
+    BOOST_CHECK_EQUAL(keys, source->data.size() - indexKeys - 1);
+    // the prune number is pinned while the snapshot is held
+    pruner->setCurrentNumber(20);
+    BOOST_CHECK_EQUAL(pruner->pruneNumber(), 8);
+
+    auto target = make_shared<MockRocksDB>();
+    StateSnapshotImporter importer(target);
+    importer.begin(*manifest);
+    for (size_t i = 0; i < manifest->chunks.size(); ++i)
+    {
+        auto data = exporter.chunk(manifest->hash(), i);
+        BOOST_REQUIRE(data);
+        BOOST_CHECK(importer.importChunk(manifest->chunks[i], bytesConstRef(data.get())));
+    }
+    importer.finish();
+    source->data.erase("t_test_removed");
+    BOOST_CHECK(target->data == source->data);
+
+    exporter.release();
+    BOOST_CHECK_EQUAL(pruner->pruneNumber(), 18);
+}
+
+BOOST_AUTO_TEST_CASE(tamperedChunk)
+{
+    StateSnapshotExporter exporter(source, 4096);
+    auto manifest = exporter.prepare();
+    auto target = make_shared<MockRocksDB>();
+    StateSnapshotImporter importer(target);
+    importer.begin(*manifest);
+
+    auto data = exporter.chunk(manifest->hash(), 0);
+    BOOST_REQUIRE(data);
+    auto tampered = *data;
+    tampered.back() ^= 0x01;
+    BOOST_CHECK(!importer.importChunk(manifest->chunks[0], &tampered));
+    // a valid chunk presented as another chunk is out of its key range
+    auto chunk = manifest->chunks[1];
+    chunk.hash = manifest->chunks[0].hash;
+    chunk.keys = manifest->chunks[0].keys;
+    BOOST_CHECK(!importer.importChunk(chunk, bytesConstRef(data.get())));
+    BOOST_CHECK_EQUAL(target->data.size(), 1u);
+
+    // the current number has not been imported
+    BOOST_CHECK_THROW(importer.finish(), StorageException);
+    BOOST_CHECK(StateSnapshotImporter::unfinished(target));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test_StateSnapshot
@@ -16,12 +16,14 @@
  */
 
 #include "MemoryStorage.h"
+#include "MemoryStorage2.h"
 #include <json/json.h>
 #include <libblockverifier/ExecutiveContext.h>
 #include <libdevcrypto/Common.h>
 #include <libethcore/ABI.h>
 #include <libprecompiled/TableFactoryPrecompiled.h>
 #include <libstorage/MemoryTableFactory.h>
+#include <libstorage/MemoryTableFactory2.h>
 #include <libstorage/Storage.h>
 #include <libstorage/Table.h>
 #include <boost/test/unit_test.hpp>
@@ -126,6 +128,51 @@ BOOST_AUTO_TEST_CASE(call_afterBlock)
     BOOST_TEST(addressOut == Address(++addressCount));
 }
 
+BOOST_AUTO_TEST_CASE(createIndexedTable)
+{
+    auto supportedVersion = g_BCOSConfig.supportedVersion();
+    auto version = g_BCOSConfig.version();
+    g_BCOSConfig.setSupportedVersion("2.4.0", V2_4_0);
+    auto tableFactory = std::make_shared<MemoryTableFactory2>();
+    tableFactory->setStateStorage(std::make_shared<MemoryStorage2>());
+    context->setMemoryTableFactory(tableFactory);
+    tableFactoryPrecompiled->setMemoryTableFactory(tableFactory);
+    context->setAddress2Precompiled(Address(0x1001), tableFactoryPrecompiled);
+
+    dev::eth::ContractABI abi;
+    // every index must be a value field
+    bytes param = abi.abiIn("createTable(string,string,string,string)", std::string("t_test"),
+        std::string("id"), std::string("item_name,item_id"), std::string("id"));
+    BOOST_CHECK_THROW(
+        tableFactoryPrecompiled->call(context, bytesConstRef(&param)), StorageException);
+    param = abi.abiIn("createTable(string,string,string,string)", std::string("t_test"),
+        std::string("id"), std::string("item_name,item_id"), std::string("item_id, item_id"));
+    BOOST_CHECK_THROW(
+        tableFactoryPrecompiled->call(context, bytesConstRef(&param)), StorageException);
+
+    param = abi.abiIn("createTable(string,string,string,string)", std::string("t_test"),
+        std::string("id"), std::string("item_name,item_id"), std::string("item_id, item_name"));
+    auto callResult = tableFactoryPrecompiled->call(context, bytesConstRef(&param));
+    bytes out = callResult->execResult();
+    s256 errCode;
+    abi.abiOut(&out, errCode);
+    BOOST_TEST(errCode == 0);
+    auto table = tableFactory->openTable("u_t_test");
+    BOOST_REQUIRE(table);
+    BOOST_TEST(table->tableInfo()->indices.size() == 2u);
+    BOOST_TEST(table->tableInfo()->indices[0] == "item_id");
+    BOOST_TEST(table->tableInfo()->indices[1] == "item_name");
+
+    // the table without indices
+    param = abi.abiIn("createTable(string,string,string)", std::string("t_test2"),
+        std::string("id"), std::string("item_name,item_id"));
+    tableFactoryPrecompiled->call(context, bytesConstRef(&param));
+    table = tableFactory->openTable("u_t_test2");
+    BOOST_REQUIRE(table);
+    BOOST_TEST(table->tableInfo()->indices.empty());
+    g_BCOSConfig.setSupportedVersion(supportedVersion, version);
+}
+
 BOOST_AUTO_TEST_CASE(hash)
 {
     h256 h = tableFactoryPrecompiled->hash();
@@ -36,12 +36,13 @@ struct StorageStateFixture
     StorageStateFixture() : m_state(dev::u256(0))
     {
         auto storage = std::make_shared<dev::storage::MemoryStorage>();
-        auto tableFactory = std::make_shared<dev::storage::MemoryTableFactory2>();
-        tableFactory->setStateStorage(storage);
-        m_state.setMemoryTableFactory(tableFactory);
+        m_tableFactory = std::make_shared<dev::storage::MemoryTableFactory2>();
+        m_tableFactory->setStateStorage(storage);
+        m_state.setMemoryTableFactory(m_tableFactory);
     }
 
     dev::storagestate::StorageState m_state;
+    dev::storage::MemoryTableFactory2::Ptr m_tableFactory;
 };
 
 BOOST_FIXTURE_TEST_SUITE(StorageState, StorageStateFixture)
@@ -105,6 +106,40 @@ BOOST_AUTO_TEST_CASE(Storage)
     m_state.clearStorage(addr1);
 }
 
+BOOST_AUTO_TEST_CASE(BinaryStorage)
+{
+    Address addr1(0x100001);
+    m_state.addBalance(addr1, u256(10));
+    m_state.setStorage(addr1, u256(123), u256(456));
+    auto decimalRoot = m_state.storageRoot(addr1);
+
+    dev::storagestate::StorageState state(dev::u256(0));
+    auto tableFactory = std::make_shared<dev::storage::MemoryTableFactory2>();
+    tableFactory->setStateStorage(m_tableFactory->stateStorage());
+    state.setMemoryTableFactory(tableFactory);
+    state.setBinaryStorage(true);
+    state.addBalance(addr1, u256(10));
+    BOOST_TEST(state.storage(addr1, u256(123)) == u256());
+    u256 largeValue = u256(sha3(bytes{1}));
+    state.setStorage(addr1, u256(123), largeValue);
+    BOOST_TEST(state.storage(addr1, u256(123)) == largeValue);
+    state.setStorage(addr1, u256(123), u256(456));
+    BOOST_TEST(state.storage(addr1, u256(123)) == u256(456));
+    // the same slots are stored differently
+    BOOST_TEST(state.storageRoot(addr1) != decimalRoot);
+    state.setStorage(addr1, u256(0), u256(1));
+    BOOST_TEST(state.storage(addr1, u256(0)) == u256(1));
+    state.setStorage(addr1, ~u256(0), ~u256(0));
+    BOOST_TEST(state.storage(addr1, ~u256(0)) == ~u256(0));
+    BOOST_TEST(state.storage(addr1, u256(123)) == u256(456));
+
+    auto savepoint = state.savepoint();
+    state.setStorage(addr1, u256(123), u256(789));
+    BOOST_TEST(state.storage(addr1, u256(123)) == u256(789));
+    state.rollback(savepoint);
+    BOOST_TEST(state.storage(addr1, u256(123)) == u256(456));
+}
+
 BOOST_AUTO_TEST_CASE(Code)
 {
     Address addr1(0x100001);
@@ -185,6 +220,81 @@ BOOST_AUTO_TEST_CASE(Operate)
     m_state.commit();
 }
 
+BOOST_AUTO_TEST_CASE(AccountCache)
+{
+    Address addr1(0x100001);
+    m_state.addBalance(addr1, u256(10));
+    m_state.setNonce(addr1, u256(5));
+    BOOST_TEST(m_state.frozen(addr1) == false);
+
+    // rollback drops the cached fields written after the savepoint
+    auto savepoint = m_state.savepoint();
+    m_state.addBalance(addr1, u256(10));
+    m_state.incNonce(addr1);
+    BOOST_TEST(m_state.balance(addr1) == u256(20));
+    BOOST_TEST(m_state.getNonce(addr1) == u256(6));
+    m_state.rollback(savepoint);
+    BOOST_TEST(m_state.balance(addr1) == u256(10));
+    BOOST_TEST(m_state.getNonce(addr1) == u256(5));
+
+    // the table written without the state is read after the cache is cleared
+    BOOST_TEST(m_state.frozen(addr1) == false);
+    std::string tableName("_contract_data_" + addr1.hex() + "_");
+    if (g_BCOSConfig.version() >= V2_2_0)
+    {
+        tableName = std::string("c_" + addr1.hex());
+    }
+    auto table = m_tableFactory->openTable(tableName);
+    auto entry = table->newEntry();
+    entry->setField(dev::storagestate::STORAGE_KEY, dev::storagestate::ACCOUNT_FROZEN);
+    entry->setField(dev::storagestate::STORAGE_VALUE, "true");
+    table->insert(dev::storagestate::ACCOUNT_FROZEN, entry);
+    BOOST_TEST(m_state.frozen(addr1) == false);
+    m_state.clearAccountCache();
+    BOOST_TEST(m_state.frozen(addr1) == true);
+
+    // kill resets the account
+    m_state.kill(addr1);
+    BOOST_TEST(m_state.balance(addr1) == u256(0));
+    BOOST_TEST(m_state.getNonce(addr1) == m_state.accountStartNonce());
+}
+
+BOOST_AUTO_TEST_CASE(CodeCache)
+{
+    auto codeCache = std::make_shared<dev::storagestate::CodeCache>();
+    m_state.setCodeCache(codeCache);
+    Address addr1(0x100001);
+    Address addr2(0x100002);
+    std::string codeString("aaaaaaaaaaaaa");
+    bytes code(codeString.begin(), codeString.end());
+    m_state.addBalance(addr1, u256(10));
+    m_state.setCode(addr1, bytes(code));
+    BOOST_TEST(codeCache->size() == 1u);
+    BOOST_TEST(codeCache->memorySize() == code.size());
+    BOOST_TEST(m_state.code(addr1) == code);
+    BOOST_TEST(codeCache->hitTimes() == 1u);
+
+    // another state of the same tables shares the code cache
+    dev::storagestate::StorageState state(dev::u256(0));
+    state.setMemoryTableFactory(m_tableFactory);
+    state.setCodeCache(codeCache);
+    BOOST_TEST(state.code(addr1) == code);
+    BOOST_TEST(codeCache->hitTimes() == 2u);
+    // accounts without code never query the cache
+    BOOST_TEST(state.code(addr2) == NullBytes);
+    BOOST_TEST(codeCache->queryTimes() == 2u);
+
+    // the oldest code is evicted
+    dev::storagestate::CodeCache smallCache(code.size() * 2);
+    for (unsigned i = 0; i < 3; ++i)
+    {
+        smallCache.put(h256(i), std::make_shared<bytes const>(code));
+    }
+    BOOST_TEST(smallCache.size() == 2u);
+    BOOST_TEST(!smallCache.get(h256(0)));
+    BOOST_TEST(smallCache.get(h256(2)) != nullptr);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }  // namespace test_StorageState
@@ -184,6 +184,35 @@ BOOST_AUTO_TEST_CASE(SyncReqBlockPacketTest)
     BOOST_CHECK(rlpReqBlock[1].toInt<unsigned>() == 0x40);
 }
 
+BOOST_AUTO_TEST_CASE(SyncSnapshotPacketTest)
+{
+    SyncSnapshotManifestPacket manifestPacket;
+    bytes manifest{0x01, 0x02, 0x03};
+    FakeBlock fakeBlock;
+    manifestPacket.encode(manifest, fakeBlock.getBlock()->rlp());
+    auto msgPtr = manifestPacket.toMessage(0x03);
+    manifestPacket.decode(fakeSessionPtr, msgPtr);
+    BOOST_CHECK(manifestPacket.rlp()[0].toBytes() == manifest);
+    Block block(manifestPacket.rlp()[1].toBytes());
+    BOOST_CHECK(block.equalAll(*fakeBlock.getBlock()));
+
+    SyncSnapshotChunkReqPacket chunkReqPacket;
+    chunkReqPacket.encode(h256(0xab), 0x10);
+    msgPtr = chunkReqPacket.toMessage(0x03);
+    chunkReqPacket.decode(fakeSessionPtr, msgPtr);
+    BOOST_CHECK(chunkReqPacket.rlp()[0].toHash<h256>() == h256(0xab));
+    BOOST_CHECK(chunkReqPacket.rlp()[1].toInt<uint64_t>() == 0x10);
+
+    SyncSnapshotChunkPacket chunkPacket;
+    bytes chunk(1024, 0xcd);
+    chunkPacket.encode(h256(0xab), 0x10, &chunk);
+    msgPtr = chunkPacket.toMessage(0x03);
+    chunkPacket.decode(fakeSessionPtr, msgPtr);
+    BOOST_CHECK(chunkPacket.rlp()[0].toHash<h256>() == h256(0xab));
+    BOOST_CHECK(chunkPacket.rlp()[1].toInt<uint64_t>() == 0x10);
+    BOOST_CHECK(chunkPacket.rlp()[2].toBytes() == chunk);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace dev
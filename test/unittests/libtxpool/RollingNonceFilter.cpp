@@ -0,0 +1,143 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+
+/**
+ * @brief: unit test for RollingNonceFilter
+ * @file: RollingNonceFilter.cpp
+ */
+#include <libtxpool/RollingNonceFilter.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::txpool;
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(RollingNonceFilterTest, TestOutputHelperFixture)
+
+/// the nonces of a block, the nonces of different blocks are different
+std::vector<NonceKeyType> fakeBlockNonces(int64_t _blockNumber, size_t _count)
+{
+    std::vector<NonceKeyType> nonces;
+    for (size_t i = 0; i < _count; i++)
+    {
+        nonces.push_back((u256(_blockNumber) << 128) + u256(i));
+    }
+    return nonces;
+}
+
+BOOST_AUTO_TEST_CASE(testBlockedBloomFilter)
+{
+    BlockedBloomFilter filter(1 << 16);
+    BOOST_CHECK(filter.bytes() == (1 << 16) / 8);
+    /// rounded up to a block
+    BOOST_CHECK(BlockedBloomFilter(1).bytes() == BlockedBloomFilter::c_wordsPerBlock * 8);
+
+    for (uint64_t i = 0; i < 4096; i++)
+    {
+        filter.insert(RollingNonceFilter::hash(u256(i)));
+    }
+    size_t falsePositives = 0;
+    for (uint64_t i = 0; i < 4096; i++)
+    {
+        /// no false negative
+        BOOST_CHECK(filter.mayContain(RollingNonceFilter::hash(u256(i))));
+        if (filter.mayContain(RollingNonceFilter::hash(u256(i + 4096))))
+        {
+            falsePositives++;
+        }
+    }
+    /// 16 bits a key, the false positive rate is about 0.3%
+    BOOST_CHECK(falsePositives < 4096 / 50);
+
+    filter.clear();
+    BOOST_CHECK(!filter.mayContain(RollingNonceFilter::hash(u256(0))));
+}
+
+BOOST_AUTO_TEST_CASE(testHash)
+{
+    /// all the limbs of the nonce are hashed
+    BOOST_CHECK(RollingNonceFilter::hash(u256(1)) != RollingNonceFilter::hash(u256(1) << 64));
+    BOOST_CHECK(RollingNonceFilter::hash(u256(1) << 192) != RollingNonceFilter::hash(u256(0)));
+    BOOST_CHECK(RollingNonceFilter::hash(u256(7)) == RollingNonceFilter::hash(u256(7)));
+}
+
+BOOST_AUTO_TEST_CASE(testRollingExpiry)
+{
+    int64_t blockLimit = 1000;
+    RollingNonceFilter filter(blockLimit, 1 << 14);
+    auto segments = blockLimit / RollingNonceFilter::c_segmentBlocks + 2;
+    BOOST_CHECK(filter.bytes() == (size_t)segments * (1 << 14) / 8);
+
+    /// commit the blocks one by one, expire the blocks before the block limit
+    int64_t latest = 3000;
+    for (int64_t number = 1; number <= latest; number++)
+    {
+        filter.insert(number, fakeBlockNonces(number, 4));
+        filter.expire(std::max(number - blockLimit, (int64_t)0));
+    }
+    /// the nonces of the blocks not expired are never missed
+    for (int64_t number = latest - blockLimit; number <= latest; number++)
+    {
+        for (auto const& nonce : fakeBlockNonces(number, 4))
+        {
+            BOOST_CHECK(filter.mayContain(nonce));
+        }
+    }
+    /// the nonces of the blocks expired long ago are dropped
+    size_t falsePositives = 0;
+    for (int64_t number = 1; number < latest - blockLimit - RollingNonceFilter::c_segmentBlocks;
+         number++)
+    {
+        for (auto const& nonce : fakeBlockNonces(number, 4))
+        {
+            if (filter.mayContain(nonce))
+            {
+                falsePositives++;
+            }
+        }
+    }
+    BOOST_CHECK(falsePositives < 100);
+
+    filter.clear();
+    BOOST_CHECK(!filter.mayContain(fakeBlockNonces(latest, 1)[0]));
+}
+
+BOOST_AUTO_TEST_CASE(testEnlargedBlockLimit)
+{
+    /// the filter built for a smaller block limit keeps the nonces of a larger one
+    RollingNonceFilter filter(64, 1 << 14);
+    for (int64_t number = 1; number <= 1000; number++)
+    {
+        filter.insert(number, fakeBlockNonces(number, 2));
+    }
+    filter.expire(500);
+    for (int64_t number = 500; number <= 1000; number++)
+    {
+        for (auto const& nonce : fakeBlockNonces(number, 2))
+        {
+            BOOST_CHECK(filter.mayContain(nonce));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
@@ -0,0 +1,179 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+
+/**
+ * @brief: unit test for SenderLanes
+ * @file: SenderLanes.cpp
+ */
+#include <libtxpool/SenderLanes.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::txpool;
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(SenderLanesTest, TestOutputHelperFixture)
+
+Transaction::Ptr fakeLaneTransaction(Address const& _sender, size_t _index)
+{
+    auto tx =
+        std::make_shared<Transaction>(0, 0, 100000, Address(0x5002), bytes(), u256(_index + 1));
+    tx->updateTransactionHashWithSig(sha3(_sender.hex() + std::to_string(_index)));
+    tx->forceSender(_sender);
+    return tx;
+}
+
+/// insert _count transactions of _sender from _start, return the transactions
+Transactions insertLane(
+    SenderLanes& _lanes, Address const& _sender, size_t _count, size_t _start = 0)
+{
+    Transactions txs;
+    for (size_t i = _start; i < _start + _count; i++)
+    {
+        txs.push_back(fakeLaneTransaction(_sender, i));
+        BOOST_CHECK(_lanes.insert(txs.back()) == ImportResult::Success);
+    }
+    return txs;
+}
+
+Transactions traverseLanes(SenderLanes const& _lanes)
+{
+    Transactions txs;
+    _lanes.forEach([&txs](Transaction::Ptr const& _tx) {
+        txs.push_back(_tx);
+        return true;
+    });
+    return txs;
+}
+
+BOOST_AUTO_TEST_CASE(testInsertAndErase)
+{
+    SenderLanes lanes(4);
+    Address senderA(0xa);
+    Address senderB(0xb);
+    auto txsA = insertLane(lanes, senderA, 3);
+    auto txsB = insertLane(lanes, senderB, 1);
+    BOOST_CHECK(lanes.insert(fakeLaneTransaction(senderA, 1)) == ImportResult::AlreadyKnown);
+    BOOST_CHECK(lanes.size(senderA) == 3);
+    BOOST_CHECK(lanes.size(senderB) == 1);
+    BOOST_CHECK(lanes.size(Address(0xc)) == 0);
+
+    BOOST_CHECK(lanes.erase(txsA[1]));
+    BOOST_CHECK(!lanes.erase(txsA[1]));
+    BOOST_CHECK(lanes.size(senderA) == 2);
+    /// the lane is removed with its last transaction
+    BOOST_CHECK(lanes.erase(txsB[0]));
+    BOOST_CHECK(lanes.size(senderB) == 0);
+    BOOST_CHECK(traverseLanes(lanes) == (Transactions{txsA[0], txsA[2]}));
+
+    lanes.clear();
+    BOOST_CHECK(lanes.size(senderA) == 0);
+    BOOST_CHECK(traverseLanes(lanes).empty());
+}
+
+BOOST_AUTO_TEST_CASE(testSenderLimit)
+{
+    SenderLanes lanes;
+    Address senderA(0xa);
+    Address senderB(0xb);
+    lanes.setSenderLimit(2);
+    lanes.setWeights(std::map<Address, size_t>{{senderB, 2}});
+    BOOST_CHECK(lanes.weight(senderA) == 1);
+    BOOST_CHECK(lanes.weight(senderB) == 2);
+    insertLane(lanes, senderA, 2);
+    BOOST_CHECK(
+        lanes.insert(fakeLaneTransaction(senderA, 2)) == ImportResult::TransactionPoolIsFull);
+    /// the limit of a sender is multiplied by its weight
+    insertLane(lanes, senderB, 4);
+    BOOST_CHECK(
+        lanes.insert(fakeLaneTransaction(senderB, 4)) == ImportResult::TransactionPoolIsFull);
+    lanes.setSenderLimit(0);
+    BOOST_CHECK(lanes.insert(fakeLaneTransaction(senderA, 2)) == ImportResult::Success);
+}
+
+BOOST_AUTO_TEST_CASE(testFairTraversal)
+{
+    SenderLanes lanes;
+    Address senderA(0xa);
+    Address senderB(0xb);
+    Address senderC(0xc);
+    lanes.setWeights(std::map<Address, size_t>{{senderB, 2}});
+    /// the lanes are visited in the order of their first transactions
+    auto txsA = insertLane(lanes, senderA, 5);
+    auto txsB = insertLane(lanes, senderB, 3);
+    auto txsC = insertLane(lanes, senderC, 1);
+    Transactions expected{txsA[0], txsB[0], txsB[1], txsC[0], txsA[1], txsB[2], txsA[2],
+        txsA[3], txsA[4]};
+    BOOST_CHECK(traverseLanes(lanes) == expected);
+
+    /// stop the traversal
+    Transactions visited;
+    lanes.forEach([&visited](Transaction::Ptr const& _tx) {
+        visited.push_back(_tx);
+        return visited.size() < 4;
+    });
+    BOOST_CHECK(visited == Transactions(expected.begin(), expected.begin() + 4));
+
+    /// the lanes longer than a chunk
+    SenderLanes longLanes;
+    txsA = insertLane(longLanes, senderA, SenderLanes::c_traverseChunkSize * 3);
+    txsB = insertLane(longLanes, senderB, SenderLanes::c_traverseChunkSize * 2);
+    expected.clear();
+    for (size_t i = 0; i < txsA.size(); i++)
+    {
+        expected.push_back(txsA[i]);
+        if (i < txsB.size())
+        {
+            expected.push_back(txsB[i]);
+        }
+    }
+    BOOST_CHECK(traverseLanes(longLanes) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(testEvictionCandidate)
+{
+    SenderLanes lanes;
+    Address senderA(0xa);
+    Address senderB(0xb);
+    Address senderC(0xc);
+    auto txsA = insertLane(lanes, senderA, 3);
+    insertLane(lanes, senderB, 1);
+    /// the newest transaction of the heaviest lane
+    BOOST_CHECK(lanes.evictionCandidate(senderB) == txsA[2]);
+    BOOST_CHECK(lanes.evictionCandidate(senderC) == txsA[2]);
+    /// the heaviest sender can't evict its own transactions
+    BOOST_CHECK(lanes.evictionCandidate(senderA) == nullptr);
+    /// the lane of B is as heavy as the lane of A
+    insertLane(lanes, senderB, 2, 1);
+    BOOST_CHECK(lanes.evictionCandidate(senderB) == nullptr);
+
+    /// the loads are divided by the weights
+    SenderLanes weightedLanes;
+    weightedLanes.setWeights(std::map<Address, size_t>{{senderA, 3}});
+    insertLane(weightedLanes, senderA, 3);
+    BOOST_CHECK(weightedLanes.evictionCandidate(senderC) == nullptr);
+    auto txsB = insertLane(weightedLanes, senderB, 2);
+    BOOST_CHECK(weightedLanes.evictionCandidate(senderC) == txsB[1]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
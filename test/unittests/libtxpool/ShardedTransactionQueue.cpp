@@ -0,0 +1,205 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+
+/**
+ * @brief: unit test for ShardedTransactionQueue and TransactionKnownBy
+ * @file: ShardedTransactionQueue.cpp
+ */
+#include <libtxpool/ShardedTransactionQueue.h>
+#include <libtxpool/TransactionKnownBy.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+#include <thread>
+
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::txpool;
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(ShardedTransactionQueueTest, TestOutputHelperFixture)
+
+Transaction::Ptr fakeShardedTransaction(size_t _index)
+{
+    auto tx =
+        std::make_shared<Transaction>(0, 0, 100000, Address(0x5002), bytes(), u256(_index + 1));
+    tx->updateTransactionHashWithSig(sha3(std::to_string(_index)));
+    return tx;
+}
+
+Transactions traverse(ShardedTransactionQueue const& _queue)
+{
+    Transactions txs;
+    _queue.forEach([&txs](Transaction::Ptr const& _tx) {
+        txs.push_back(_tx);
+        return true;
+    });
+    return txs;
+}
+
+BOOST_AUTO_TEST_CASE(testInsertAndErase)
+{
+    ShardedTransactionQueue queue(4);
+    Transactions txs;
+    for (size_t i = 0; i < 10; i++)
+    {
+        txs.push_back(fakeShardedTransaction(i));
+        BOOST_CHECK(queue.insert(txs.back()));
+    }
+    BOOST_CHECK(queue.size() == 10);
+    BOOST_CHECK(!queue.insert(fakeShardedTransaction(3)));
+    BOOST_CHECK(queue.size() == 10);
+    BOOST_CHECK(queue.find(txs[3]->sha3()) == txs[3]);
+    BOOST_CHECK(queue.count(txs[9]->sha3()));
+    BOOST_CHECK(!queue.count(sha3("unknown")));
+
+    BOOST_CHECK(queue.erase(txs[3]->sha3()) == txs[3]);
+    BOOST_CHECK(queue.erase(txs[3]->sha3()) == nullptr);
+    BOOST_CHECK(queue.find(txs[3]->sha3()) == nullptr);
+    BOOST_CHECK(queue.size() == 9);
+    /// the transaction inserted again is at the end
+    BOOST_CHECK(queue.insert(txs[3]));
+    auto traversed = traverse(queue);
+    BOOST_REQUIRE(traversed.size() == 10);
+    BOOST_CHECK(traversed.back() == txs[3]);
+
+    queue.clear();
+    BOOST_CHECK(queue.size() == 0);
+    BOOST_CHECK(traverse(queue).empty());
+    BOOST_CHECK(queue.find(txs[0]->sha3()) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(testForEach)
+{
+    /// the shards are read in several chunks
+    ShardedTransactionQueue queue(3);
+    Transactions txs;
+    for (size_t i = 0; i < ShardedTransactionQueue::c_traverseChunkSize * 10; i++)
+    {
+        txs.push_back(fakeShardedTransaction(i));
+        queue.insert(txs.back());
+    }
+    for (size_t i = 0; i < txs.size(); i += 7)
+    {
+        queue.erase(txs[i]->sha3());
+    }
+    Transactions expected;
+    for (size_t i = 0; i < txs.size(); i++)
+    {
+        if (i % 7)
+        {
+            expected.push_back(txs[i]);
+        }
+    }
+    BOOST_CHECK(traverse(queue) == expected);
+
+    /// stop the traversal
+    size_t visited = 0;
+    queue.forEach([&visited](Transaction::Ptr const&) { return ++visited < 5; });
+    BOOST_CHECK(visited == 5);
+
+    /// the erased transactions are not visited once their shards are read again
+    Transactions traversed;
+    queue.forEach([&](Transaction::Ptr const& _tx) {
+        if (traversed.empty())
+        {
+            for (size_t i = 1; i < expected.size(); i += 2)
+            {
+                queue.erase(expected[i]->sha3());
+            }
+        }
+        traversed.push_back(_tx);
+        return true;
+    });
+    BOOST_CHECK(traversed.size() < expected.size());
+    BOOST_CHECK(traverse(queue).size() == (expected.size() + 1) / 2);
+}
+
+BOOST_AUTO_TEST_CASE(testConcurrentInsert)
+{
+    ShardedTransactionQueue queue;
+    size_t threads = 4;
+    size_t txsPerThread = 1000;
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&queue, t, txsPerThread]() {
+            for (size_t i = 0; i < txsPerThread; i++)
+            {
+                queue.insert(fakeShardedTransaction(t * txsPerThread + i));
+            }
+        });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    BOOST_CHECK(queue.size() == threads * txsPerThread);
+    /// the transactions of a thread are visited in the order of insertion
+    std::vector<u256> lastNonces(threads, 0);
+    for (auto const& tx : traverse(queue))
+    {
+        auto t = (size_t)((tx->nonce() - 1) / txsPerThread);
+        BOOST_CHECK(tx->nonce() > lastNonces[t]);
+        lastNonces[t] = tx->nonce();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testKnownBy)
+{
+    TransactionKnownBy knownBy(4);
+    h512 node1(1);
+    h512 node2(2);
+    h512 node3(3);
+    auto txHash = sha3("tx");
+    BOOST_CHECK(!knownBy.isKnownBy(txHash, node1));
+    BOOST_CHECK(!knownBy.isKnownBySomeone(txHash));
+
+    knownBy.set(txHash, node1);
+    BOOST_CHECK(knownBy.isKnownBy(txHash, node1));
+    BOOST_CHECK(!knownBy.isKnownBy(txHash, node2));
+    BOOST_CHECK(knownBy.isKnownBySomeone(txHash));
+
+    std::vector<h256> txsHash{sha3("tx1"), sha3("tx2"), txHash};
+    knownBy.set(txsHash, node2);
+    knownBy.set(sha3("tx3"), node3);
+    for (auto const& hash : txsHash)
+    {
+        BOOST_CHECK(knownBy.isKnownBy(hash, node2));
+        BOOST_CHECK(!knownBy.isKnownBy(hash, node3));
+    }
+    BOOST_CHECK(knownBy.isKnownBy(txHash, node1));
+    BOOST_CHECK(!knownBy.isKnownBy(sha3("tx1"), node1));
+    BOOST_CHECK(knownBy.isKnownBy(sha3("tx3"), node3));
+
+    knownBy.erase(txHash);
+    BOOST_CHECK(!knownBy.isKnownBy(txHash, node1));
+    BOOST_CHECK(!knownBy.isKnownBySomeone(txHash));
+    BOOST_CHECK(knownBy.isKnownBy(sha3("tx1"), node2));
+
+    knownBy.clear();
+    BOOST_CHECK(!knownBy.isKnownBySomeone(sha3("tx1")));
+    /// the indexes of the nodes are kept
+    knownBy.set(txHash, node2);
+    BOOST_CHECK(knownBy.isKnownBy(txHash, node2));
+    BOOST_CHECK(!knownBy.isKnownBy(txHash, node1));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
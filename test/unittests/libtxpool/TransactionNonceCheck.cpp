@@ -0,0 +1,144 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2020 fisco-dev contributors.
+ */
+
+/**
+ * @brief: unit test for TransactionNonceCheck
+ * @file: TransactionNonceCheck.cpp
+ */
+#include "FakeBlockChain.h"
+#include <libtxpool/TransactionNonceCheck.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <thread>
+
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::txpool;
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(TransactionNonceCheckTest, TestOutputHelperFixture)
+
+/// a block of one transaction whose nonce is _nonce
+std::shared_ptr<Block> fakeNonceBlock(u256 const& _nonce)
+{
+    auto tx = std::make_shared<Transaction>(
+        u256(100), u256(0), u256(100000000), Address(), bytes(), _nonce);
+    SignatureStruct sig = dev::sign(KeyPair::create(), tx->sha3(WithoutSignature));
+    tx->updateSignature(sig);
+    auto block = std::make_shared<Block>();
+    block->setTransactions(std::make_shared<Transactions>(1, tx));
+    return block;
+}
+
+/// commit the block of _nonce to the blockchain and the nonce checker
+Transaction::Ptr commitNonceBlock(std::shared_ptr<FakeBlockChain> _blockChain,
+    TransactionNonceCheck& _nonceCheck, u256 const& _nonce)
+{
+    auto block = fakeNonceBlock(_nonce);
+    _blockChain->commitBlock(block, nullptr);
+    _nonceCheck.updateCache(*block);
+    return (*block->transactions())[0];
+}
+
+BOOST_AUTO_TEST_CASE(testUpdateCacheWithBlock)
+{
+    /// only the genesis block without transactions
+    auto blockChain = std::make_shared<FakeBlockChain>(1, 0);
+    TransactionNonceCheck nonceCheck(blockChain);
+    int64_t blockLimit = 3;
+    nonceCheck.setBlockLimit(blockLimit);
+
+    /// the nonce of block i is i
+    std::vector<Transaction::Ptr> txs;
+    for (int64_t number = 1; number <= blockLimit + 1; number++)
+    {
+        txs.push_back(commitNonceBlock(blockChain, nonceCheck, u256(number)));
+        BOOST_CHECK(blockChain->number() == number);
+    }
+    /// the nonces of the blocks in the window are rejected
+    for (auto const& tx : txs)
+    {
+        BOOST_CHECK(!nonceCheck.isNonceOk(*tx));
+    }
+    BOOST_CHECK(nonceCheck.isNonceOk(*(*fakeNonceBlock(u256(100))->transactions())[0]));
+
+    /// the nonces of the blocks out of the window are accepted again
+    txs.push_back(commitNonceBlock(blockChain, nonceCheck, u256(5)));
+    BOOST_CHECK(nonceCheck.isNonceOk(*txs[0]));
+    for (size_t i = 1; i < txs.size(); i++)
+    {
+        BOOST_CHECK(!nonceCheck.isNonceOk(*txs[i]));
+    }
+    txs.push_back(commitNonceBlock(blockChain, nonceCheck, u256(6)));
+    BOOST_CHECK(nonceCheck.isNonceOk(*txs[1]));
+    BOOST_CHECK(!nonceCheck.isNonceOk(*txs[2]));
+
+    /// the block not following the cache is loaded from the blockchain
+    auto skipped = fakeNonceBlock(u256(7));
+    blockChain->commitBlock(skipped, nullptr);
+    auto tx = commitNonceBlock(blockChain, nonceCheck, u256(8));
+    BOOST_CHECK(!nonceCheck.isNonceOk(*(*skipped->transactions())[0]));
+    BOOST_CHECK(!nonceCheck.isNonceOk(*tx));
+    BOOST_CHECK(nonceCheck.isNonceOk(*txs[2]));
+    BOOST_CHECK(nonceCheck.isNonceOk(*txs[3]));
+    BOOST_CHECK(!nonceCheck.isNonceOk(*txs[4]));
+}
+
+BOOST_AUTO_TEST_CASE(testRebuildKeepsRejecting)
+{
+    auto blockChain = std::make_shared<FakeBlockChain>(1, 0);
+    TransactionNonceCheck nonceCheck(blockChain);
+    nonceCheck.setBlockLimit(10);
+    std::vector<Transaction::Ptr> txs;
+    for (int64_t number = 1; number <= 5; number++)
+    {
+        txs.push_back(commitNonceBlock(blockChain, nonceCheck, u256(number)));
+    }
+    /// the committed nonces are rejected by the checks racing with the rebuilds
+    std::atomic<bool> stop(false);
+    std::atomic<size_t> accepted(0);
+    std::thread checker([&]() {
+        while (!stop)
+        {
+            for (auto const& tx : txs)
+            {
+                if (nonceCheck.isNonceOk(*tx))
+                {
+                    accepted++;
+                }
+            }
+        }
+    });
+    for (size_t i = 0; i < 200; i++)
+    {
+        nonceCheck.updateCache(true);
+    }
+    stop = true;
+    checker.join();
+    BOOST_CHECK(accepted == 0);
+    for (auto const& tx : txs)
+    {
+        BOOST_CHECK(!nonceCheck.isNonceOk(*tx));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
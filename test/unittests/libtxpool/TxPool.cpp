@@ -153,6 +153,198 @@ BOOST_AUTO_TEST_CASE(BlockLimitCheck)
     BOOST_CHECK(result == ImportResult::BlockLimitCheckFailed);
 }
 
+Transaction::Ptr fakeTransaction(TxPoolFixture& _poolTest, KeyPair const& _keyPair,
+    u256 const& _nonce, u256 const& _blockLimit)
+{
+    Transactions trans =
+        *(_poolTest.m_blockChain->getBlockByHash(_poolTest.m_blockChain->numberHash(0))
+                ->transactions());
+    bytes trans_data;
+    trans[0]->encode(trans_data);
+    Transaction::Ptr tx = std::make_shared<Transaction>(trans_data, CheckTransaction::None);
+    tx->setNonce(_nonce);
+    tx->setBlockLimit(_blockLimit);
+    Signature sig = sign(_keyPair, tx->sha3(WithoutSignature));
+    tx->updateSignature(SignatureStruct(sig));
+    return tx;
+}
+
+Transaction::Ptr fakeTransaction(
+    TxPoolFixture& _poolTest, u256 const& _nonce, u256 const& _blockLimit)
+{
+    return fakeTransaction(_poolTest, _poolTest.m_blockChain->m_keyPair, _nonce, _blockLimit);
+}
+
+BOOST_AUTO_TEST_CASE(testBatchImport)
+{
+    TxPoolFixture pool_test(5, 5);
+    u256 blockLimit = pool_test.m_blockChain->number() + u256(1);
+    u256 nonce = u256(1) << 200;
+    auto txs = std::make_shared<Transactions>();
+    for (size_t i = 0; i < 5; i++)
+    {
+        txs->push_back(fakeTransaction(pool_test, nonce + i, blockLimit));
+    }
+    /// the same transaction
+    txs->push_back((*txs)[0]);
+    /// the same nonce as a transaction of the batch
+    txs->push_back(fakeTransaction(pool_test, nonce, blockLimit + u256(1)));
+    /// the nonce has been committed
+    auto committedTx = (*pool_test.m_blockChain->getBlockByNumber(1)->transactions())[0];
+    txs->push_back(fakeTransaction(pool_test, committedTx->nonce(), blockLimit));
+    /// invalid block limit
+    txs->push_back(fakeTransaction(pool_test, nonce + 5, blockLimit + u256(10000)));
+    auto results = pool_test.m_txPool->batchImport(txs);
+    BOOST_CHECK(results->size() == txs->size());
+    for (size_t i = 0; i < 5; i++)
+    {
+        BOOST_CHECK((*results)[i] == ImportResult::Success);
+    }
+    BOOST_CHECK((*results)[5] == ImportResult::AlreadyKnown);
+    BOOST_CHECK((*results)[6] == ImportResult::TxPoolNonceCheckFail);
+    BOOST_CHECK((*results)[7] == ImportResult::TransactionNonceCheckFail);
+    BOOST_CHECK((*results)[8] == ImportResult::BlockLimitCheckFailed);
+    BOOST_CHECK(pool_test.m_txPool->pendingSize() == 5);
+    /// the transactions imported in a batch are imported already
+    BOOST_CHECK(pool_test.m_txPool->import((*txs)[1]) == ImportResult::AlreadyKnown);
+
+    /// the nonces of the transactions refused for the txPool is full are released
+    pool_test.m_txPool->setTxPoolLimit(6);
+    txs = std::make_shared<Transactions>();
+    txs->push_back(fakeTransaction(pool_test, nonce + 6, blockLimit));
+    txs->push_back(fakeTransaction(pool_test, nonce + 7, blockLimit));
+    results = pool_test.m_txPool->batchImport(txs);
+    BOOST_CHECK((*results)[0] == ImportResult::Success);
+    BOOST_CHECK((*results)[1] == ImportResult::TransactionPoolIsFull);
+    BOOST_CHECK(pool_test.m_txPool->pendingSize() == 6);
+    pool_test.m_txPool->setTxPoolLimit(7);
+    BOOST_CHECK(pool_test.m_txPool->import((*txs)[1]) == ImportResult::Success);
+    BOOST_CHECK(pool_test.m_txPool->pendingSize() == 7);
+}
+
+BOOST_AUTO_TEST_CASE(testSubmitInBatches)
+{
+    TxPoolFixture pool_test(5, 5);
+    pool_test.m_blockChain->setSealerList(dev::h512s{pool_test.m_topicService->id()});
+    pool_test.m_txPool->setMaxSubmitBatchSize(3);
+    u256 blockLimit = pool_test.m_blockChain->number() + u256(1);
+    u256 nonce = u256(1) << 200;
+    std::atomic<size_t> refused = {0};
+    auto callback = [&refused](LocalisedTransactionReceipt::Ptr _receipt, bytesConstRef,
+                        dev::eth::Block::Ptr) {
+        BOOST_CHECK(_receipt->status() == dev::executive::TransactionException::NonceCheckFail);
+        refused++;
+    };
+    for (size_t i = 0; i < 10; i++)
+    {
+        auto tx = fakeTransaction(pool_test, nonce + i, blockLimit);
+        tx->setRpcCallback(callback);
+        pool_test.m_txPool->submit(tx);
+        /// the same nonce
+        tx = fakeTransaction(pool_test, nonce + i, blockLimit + u256(1));
+        tx->setRpcCallback(callback);
+        pool_test.m_txPool->submit(tx);
+    }
+    for (size_t i = 0; i < 100 && (refused < 10 || pool_test.m_txPool->pendingSize() < 10); i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    BOOST_CHECK(pool_test.m_txPool->pendingSize() == 10);
+    BOOST_CHECK(refused == 10);
+    /// the transactions submitted first are imported
+    auto pending = pool_test.m_txPool->pendingList();
+    for (auto const& tx : *pending)
+    {
+        BOOST_CHECK(tx->blockLimit() == blockLimit);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testSubmitFailedBatch)
+{
+    TxPoolFixture pool_test(5, 5);
+    pool_test.m_blockChain->setSealerList(dev::h512s{pool_test.m_topicService->id()});
+    pool_test.m_txPool->setMaxSubmitBatchSize(3);
+    /// every batch fails
+    TxPoolInterface& txPool = *pool_test.m_txPool;
+    txPool.registerSyncStatusChecker(
+        []() -> bool { BOOST_THROW_EXCEPTION(std::runtime_error("sync status unknown")); });
+    u256 blockLimit = pool_test.m_blockChain->number() + u256(1);
+    u256 nonce = u256(1) << 200;
+    std::atomic<size_t> refused = {0};
+    auto callback = [&refused](LocalisedTransactionReceipt::Ptr _receipt, bytesConstRef,
+                        dev::eth::Block::Ptr) {
+        BOOST_CHECK(
+            _receipt->status() == dev::executive::TransactionException::TransactionRefused);
+        refused++;
+    };
+    for (size_t i = 0; i < 10; i++)
+    {
+        auto tx = fakeTransaction(pool_test, nonce + i, blockLimit);
+        tx->setRpcCallback(callback);
+        pool_test.m_txPool->submit(tx);
+    }
+    /// every transaction of the failed batches is refused
+    for (size_t i = 0; i < 100 && refused < 10; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    BOOST_CHECK(refused == 10);
+    BOOST_CHECK(pool_test.m_txPool->pendingSize() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(testFairSealingAndEviction)
+{
+    TxPoolFixture pool_test(5, 5);
+    u256 blockLimit = pool_test.m_blockChain->number() + u256(1);
+    u256 nonce = u256(1) << 200;
+    KeyPair lightKeyPair = KeyPair::create();
+    pool_test.m_txPool->setTxPoolLimit(6);
+    Transactions hotTxs;
+    for (size_t i = 0; i < 5; i++)
+    {
+        hotTxs.push_back(fakeTransaction(pool_test, nonce + i, blockLimit));
+        BOOST_CHECK(pool_test.m_txPool->import(hotTxs.back()) == ImportResult::Success);
+    }
+    Transactions lightTxs;
+    for (size_t i = 0; i < 3; i++)
+    {
+        lightTxs.push_back(fakeTransaction(pool_test, lightKeyPair, nonce + 10 + i, blockLimit));
+    }
+    BOOST_CHECK(pool_test.m_txPool->import(lightTxs[0]) == ImportResult::Success);
+
+    /// the newest transaction of the hot sender is evicted for the light sender
+    std::atomic_bool evicted = {false};
+    hotTxs[4]->setRpcCallback([&evicted](LocalisedTransactionReceipt::Ptr _receipt, bytesConstRef,
+                                  dev::eth::Block::Ptr) {
+        BOOST_CHECK(
+            _receipt->status() == dev::executive::TransactionException::TransactionRefused);
+        evicted = true;
+    });
+    BOOST_CHECK(pool_test.m_txPool->import(lightTxs[1]) == ImportResult::Success);
+    BOOST_CHECK(pool_test.m_txPool->pendingSize() == 6);
+    auto pending = *(pool_test.m_txPool->pendingList());
+    BOOST_CHECK(std::find(pending.begin(), pending.end(), hotTxs[4]) == pending.end());
+    for (size_t i = 0; i < 100 && !evicted; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    BOOST_CHECK(evicted);
+    /// the hot sender can't evict its own transactions
+    BOOST_CHECK(pool_test.m_txPool->import(fakeTransaction(pool_test, nonce + 5, blockLimit)) ==
+                ImportResult::TransactionPoolIsFull);
+
+    /// the lanes of the senders are sealed in turn
+    auto sealed = *(pool_test.m_txPool->topTransactions(4));
+    BOOST_CHECK(sealed == (Transactions{hotTxs[0], lightTxs[0], hotTxs[1], lightTxs[1]}));
+
+    /// the nonce of the transaction refused for the limit of the sender is released
+    pool_test.m_txPool->setTxPoolLimit(100);
+    pool_test.m_txPool->setSenderLimit(2);
+    BOOST_CHECK(pool_test.m_txPool->import(lightTxs[2]) == ImportResult::TransactionPoolIsFull);
+    pool_test.m_txPool->setSenderLimit(0);
+    BOOST_CHECK(pool_test.m_txPool->import(lightTxs[2]) == ImportResult::Success);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace dev